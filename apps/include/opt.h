@@ -162,7 +162,8 @@
         OPT_S_PRIORITIZE_CHACHA, \
         OPT_S_STRICT, OPT_S_SIGALGS, OPT_S_CLIENTSIGALGS, OPT_S_GROUPS, \
         OPT_S_CURVES, OPT_S_NAMEDCURVE, OPT_S_CIPHER, OPT_S_CIPHERSUITES, \
-        OPT_S_RECORD_PADDING, OPT_S_DEBUGBROKE, OPT_S_COMP, \
+        OPT_S_RECORD_PADDING, OPT_S_DYN_RECORD_SIZING, OPT_S_DEBUGBROKE, \
+        OPT_S_COMP, \
         OPT_S_MINPROTO, OPT_S_MAXPROTO, \
         OPT_S_NO_RENEGOTIATION, OPT_S_NO_MIDDLEBOX, OPT_S_NO_ETM, \
         OPT_S_NO_EMS, \
@@ -222,6 +223,8 @@
         {"max_protocol", OPT_S_MAXPROTO, 's', "Specify the maximum protocol version to be used"}, \
         {"record_padding", OPT_S_RECORD_PADDING, 's', \
             "Block size to pad TLS 1.3 records to."}, \
+        {"dynamic_record_sizing", OPT_S_DYN_RECORD_SIZING, 's', \
+            "Record size after idle periods[,bytes until full size[,idle ms]]"}, \
         {"debug_broken_protocol", OPT_S_DEBUGBROKE, '-', \
             "Perform all sorts of protocol violations for testing purposes"}, \
         {"no_middlebox", OPT_S_NO_MIDDLEBOX, '-', \
@@ -262,6 +265,7 @@
         case OPT_S_CIPHER: \
         case OPT_S_CIPHERSUITES: \
         case OPT_S_RECORD_PADDING: \
+        case OPT_S_DYN_RECORD_SIZING: \
         case OPT_S_NO_RENEGOTIATION: \
         case OPT_S_MINPROTO: \
         case OPT_S_MAXPROTO: \
@@ -710,6 +710,12 @@ void msg_cb(int write_p, int version, int content_type, const void *buf,
         case SSL3_RT_HEADER:
             /* type 256 */
             str_content_type = ", RecordHeader";
+            /* The length field is last in TLS and DTLS record headers */
+            if (len >= SSL3_RT_HEADER_LENGTH) {
+                BIO_snprintf(tmpbuf, sizeof(tmpbuf) - 1, ", %u bytes",
+                             (unsigned int)((bp[len - 2] << 8) | bp[len - 1]));
+                str_details1 = tmpbuf;
+            }
             break;
         case SSL3_RT_INNER_CONTENT_TYPE:
             /* type 257 */
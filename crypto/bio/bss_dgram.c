@@ -1,5 +1,5 @@
 /*
- * Copyright 2005-2024 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2005-2025 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -137,8 +137,33 @@
 #  endif
 # endif
 
+/*
+ * UDP segmentation offload: with UDP_SEGMENT a single sendmsg() carries a
+ * train of equally sized datagrams which the kernel (or the NIC) splits, and
+ * with UDP_GRO the kernel may deliver several datagrams of one flow as a single
+ * super-datagram. Both are Linux specific.
+ */
+# if M_METHOD == M_METHOD_RECVMMSG && defined(OPENSSL_SYS_LINUX)
+#  include <netinet/udp.h>
+#  if defined(UDP_SEGMENT) && defined(UDP_GRO)
+#   define SUPPORT_UDP_SEGMENTATION
+/* Maximum number of datagrams the kernel accepts in one GSO send */
+#   define DGRAM_GSO_MAX_SEGS       64
+/* Maximum payload of a GSO send or of a GRO super-datagram */
+#   define DGRAM_SEG_MAX_BYTES      65507
+/* Number of GRO super-datagrams received in one recvmmsg() call */
+#   define DGRAM_GRO_MAX_BUFS       4
+#   define DGRAM_SEG_CMSG_ALLOC_LEN                                 \
+        (BIO_CMSG_ALLOC_LEN + BIO_CMSG_SPACE(sizeof(int)))
+#  endif
+# endif
+
 # define BIO_MSG_N(array, stride, n) (*(BIO_MSG *)((char *)(array) + (n)*(stride)))
 
+# if M_METHOD == M_METHOD_RECVMMSG
+#  define BIO_MAX_MSGS_PER_CALL   64
+# endif
+
 static int dgram_write(BIO *h, const char *buf, int num);
 static int dgram_read(BIO *h, char *buf, int size);
 static int dgram_puts(BIO *h, const char *str);
@@ -216,6 +241,20 @@ typedef struct bio_dgram_data_st {
     OSSL_TIME socket_timeout;
     unsigned int peekmode;
     char local_addr_enabled;
+    uint32_t segmentation;      /* BIO_DGRAM_SEGMENTATION_* enabled */
+# if defined(SUPPORT_UDP_SEGMENTATION)
+    /*
+     * GRO super-datagrams received but not yet handed out in full, gro_next
+     * being the first of gro_num such entries.
+     */
+    unsigned char *gro_mem;
+    size_t gro_next, gro_num;
+    struct {
+        unsigned char *buf;
+        size_t off, len, seg_len;
+        BIO_ADDR peer, local;
+    } gro[DGRAM_GRO_MAX_BUFS];
+# endif
 } bio_dgram_data;
 
 # ifndef OPENSSL_NO_SCTP
@@ -281,6 +320,9 @@ static int dgram_free(BIO *a)
         return 0;
 
     data = (bio_dgram_data *)a->ptr;
+# if defined(SUPPORT_UDP_SEGMENTATION)
+    OPENSSL_free(data->gro_mem);
+# endif
     OPENSSL_free(data);
 
     return 1;
@@ -405,6 +447,33 @@ static void dgram_reset_rcv_timeout(BIO *b)
 # endif
 }
 
+# if defined(SUPPORT_UDP_SEGMENTATION)
+static int dgram_recvmmsg_gro(BIO *b, BIO_MSG *msg, size_t stride,
+                              size_t num_msg, int sysflags,
+                              size_t *num_processed);
+
+/* Reads one datagram at a time out of the GRO super-datagrams */
+static int dgram_read_gro(BIO *b, char *out, int outl, int flags,
+                          BIO_ADDR *peer)
+{
+    BIO_MSG msg;
+    size_t num;
+    int ret;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.data = out;
+    msg.data_len = (size_t)outl;
+    msg.peer = peer;
+    /* Like recvfrom(), a failed read leaves nothing on the error queue */
+    ERR_set_mark();
+    ret = dgram_recvmmsg_gro(b, &msg, sizeof(msg), 1, flags, &num);
+    ERR_pop_to_mark();
+    if (!ret || num == 0)
+        return -1;
+    return (int)msg.data_len;
+}
+# endif
+
 static int dgram_read(BIO *b, char *out, int outl)
 {
     int ret = 0;
@@ -420,6 +489,12 @@ static int dgram_read(BIO *b, char *out, int outl)
         dgram_adjust_rcv_timeout(b);
         if (data->peekmode)
             flags = MSG_PEEK;
+# if defined(SUPPORT_UDP_SEGMENTATION)
+        if ((data->segmentation & BIO_DGRAM_SEGMENTATION_RX) != 0
+            || data->gro_num > 0)
+            ret = dgram_read_gro(b, out, outl, flags, &peer);
+        else
+# endif
         ret = recvfrom(b->num, out, outl, flags,
                        BIO_ADDR_sockaddr_noconst(&peer), &len);
 
@@ -544,6 +619,63 @@ static int enable_local_addr(BIO *b, int enable) {
 }
 # endif
 
+# if defined(SUPPORT_UDP_SEGMENTATION)
+/* Determines which kinds of segmentation offload the socket supports. */
+static uint32_t dgram_get_segmentation_cap(BIO *b)
+{
+    uint32_t caps = 0;
+    int val;
+    socklen_t len;
+
+    if (!b->init)
+        return 0;
+
+    /* Only UDP sockets on kernels supporting the options pass these */
+    len = sizeof(val);
+    if (getsockopt(b->num, IPPROTO_UDP, UDP_SEGMENT, &val, &len) == 0)
+        caps |= BIO_DGRAM_SEGMENTATION_TX;
+
+    len = sizeof(val);
+    if (getsockopt(b->num, IPPROTO_UDP, UDP_GRO, &val, &len) == 0)
+        caps |= BIO_DGRAM_SEGMENTATION_RX;
+
+    return caps;
+}
+
+/*
+ * Enables the given kinds of segmentation offload. Sending needs no socket
+ * option as the segment size is passed with each sendmsg().
+ */
+static int dgram_set_segmentation(BIO *b, uint32_t flags)
+{
+    bio_dgram_data *data = b->ptr;
+    int on = (flags & BIO_DGRAM_SEGMENTATION_RX) != 0;
+
+    if ((flags & ~dgram_get_segmentation_cap(b)) != 0)
+        return 0;
+
+    if (((flags ^ data->segmentation) & BIO_DGRAM_SEGMENTATION_RX) != 0
+        && setsockopt(b->num, IPPROTO_UDP, UDP_GRO, &on, sizeof(on)) < 0)
+        return 0;
+
+    if (on && data->gro_mem == NULL) {
+        size_t i;
+
+        data->gro_mem = OPENSSL_malloc(DGRAM_GRO_MAX_BUFS * DGRAM_SEG_MAX_BYTES);
+        if (data->gro_mem == NULL) {
+            on = 0;
+            setsockopt(b->num, IPPROTO_UDP, UDP_GRO, &on, sizeof(on));
+            return 0;
+        }
+        for (i = 0; i < DGRAM_GRO_MAX_BUFS; ++i)
+            data->gro[i].buf = data->gro_mem + i * DGRAM_SEG_MAX_BYTES;
+    }
+
+    data->segmentation = flags;
+    return 1;
+}
+# endif
+
 static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
 {
     long ret = 1;
@@ -588,6 +720,17 @@ static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
             if (enable_local_addr(b, 1) < 1)
                 data->local_addr_enabled = 0;
         }
+# endif
+# if defined(SUPPORT_UDP_SEGMENTATION)
+        data->gro_num = 0;
+        if (data->segmentation != 0) {
+            uint32_t flags = data->segmentation;
+
+            /* Apply the settings to the new socket */
+            data->segmentation &= ~BIO_DGRAM_SEGMENTATION_RX;
+            if (!dgram_set_segmentation(b, flags))
+                data->segmentation = 0;
+        }
 # endif
         break;
     case BIO_C_GET_FD:
@@ -606,6 +749,19 @@ static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
         b->shutdown = (int)num;
         break;
     case BIO_CTRL_PENDING:
+        ret = 0;
+# if defined(SUPPORT_UDP_SEGMENTATION)
+        {
+            size_t i, k;
+
+            /* Datagrams received in GRO super-datagrams but not read yet */
+            for (i = 0; i < data->gro_num; ++i) {
+                k = data->gro_next + i;
+                ret += (long)(data->gro[k].len - data->gro[k].off);
+            }
+        }
+# endif
+        break;
     case BIO_CTRL_WPENDING:
         ret = 0;
         break;
@@ -999,6 +1155,26 @@ static long dgram_ctrl(BIO *b, int cmd, long num, void *ptr)
         *(int *)ptr = data->local_addr_enabled;
         break;
 
+    case BIO_CTRL_DGRAM_GET_SEGMENTATION_CAP:
+# if defined(SUPPORT_UDP_SEGMENTATION)
+        ret = (long)dgram_get_segmentation_cap(b);
+# else
+        ret = 0;
+# endif
+        break;
+
+    case BIO_CTRL_DGRAM_SET_SEGMENTATION:
+# if defined(SUPPORT_UDP_SEGMENTATION)
+        ret = dgram_set_segmentation(b, (uint32_t)num);
+# else
+        ret = num == 0;
+# endif
+        break;
+
+    case BIO_CTRL_DGRAM_GET_SEGMENTATION:
+        ret = (long)data->segmentation;
+        break;
+
     case BIO_CTRL_DGRAM_GET_EFFECTIVE_CAPS:
         ret = (long)(BIO_DGRAM_CAP_HANDLES_DST_ADDR
                      | BIO_DGRAM_CAP_HANDLES_SRC_ADDR
@@ -1313,6 +1489,235 @@ static int translate_flags(uint64_t flags) {
 }
 # endif
 
+# if defined(SUPPORT_UDP_SEGMENTATION)
+static int dgram_addr_eq(const BIO_ADDR *a, const BIO_ADDR *b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+
+    return BIO_ADDR_family(a) == BIO_ADDR_family(b)
+        && memcmp(BIO_ADDR_sockaddr(a), BIO_ADDR_sockaddr(b),
+                  BIO_ADDR_sockaddr_size(a)) == 0;
+}
+
+/* Appends a UDP_SEGMENT control message to any added by pack_local(). */
+static void pack_segment_size(struct msghdr *mh, unsigned char *control,
+                              size_t seg_len)
+{
+    struct cmsghdr *cmsg;
+    uint16_t seg = (uint16_t)seg_len;
+
+    if (mh->msg_control == NULL) {
+        mh->msg_control    = control;
+        mh->msg_controllen = 0;
+    }
+
+    cmsg = (struct cmsghdr *)((unsigned char *)mh->msg_control
+                              + mh->msg_controllen);
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(seg));
+    cmsg->cmsg_level = IPPROTO_UDP;
+    cmsg->cmsg_type  = UDP_SEGMENT;
+    memcpy(CMSG_DATA(cmsg), &seg, sizeof(seg));
+    mh->msg_controllen += CMSG_SPACE(sizeof(seg));
+}
+
+/*
+ * Sends the messages using UDP GSO. Runs of messages with the same addresses
+ * and the same length, except for the last which may be shorter, are sent as
+ * one datagram train with one msghdr each, whose iovecs point to the data of
+ * each message. Returns -1 if the kernel rejected GSO without sending anything,
+ * in which case the caller should fall back to sending the messages one by
+ * one.
+ */
+static int dgram_sendmmsg_gso(BIO *b, BIO_MSG *msg, size_t stride,
+                              size_t num_msg, int sysflags,
+                              size_t *num_processed)
+{
+    bio_dgram_data *data = (bio_dgram_data *)b->ptr;
+    struct mmsghdr mh[BIO_MAX_MSGS_PER_CALL];
+    struct iovec iov[BIO_MAX_MSGS_PER_CALL];
+    unsigned char control[BIO_MAX_MSGS_PER_CALL][DGRAM_SEG_CMSG_ALLOC_LEN];
+    size_t num_segs[BIO_MAX_MSGS_PER_CALL];
+    size_t i, j, n, seg_len, total;
+    int ret, used_gso = 0;
+
+    for (i = 0, n = 0; i < num_msg; i = j, ++n) {
+        BIO_MSG *first = &BIO_MSG_N(msg, stride, i);
+
+        translate_msg(b, &mh[n].msg_hdr, &iov[i], control[n], first);
+
+        if (first->local != NULL) {
+            if (!data->local_addr_enabled
+                || pack_local(b, &mh[n].msg_hdr, first->local) < 1) {
+                ERR_raise(ERR_LIB_BIO, BIO_R_LOCAL_ADDR_NOT_AVAILABLE);
+                *num_processed = 0;
+                return 0;
+            }
+        }
+
+        seg_len = total = first->data_len;
+        for (j = i + 1; j < num_msg && j - i < DGRAM_GSO_MAX_SEGS; ++j) {
+            BIO_MSG *m = &BIO_MSG_N(msg, stride, j);
+
+            /* Only the last segment of a train may be shorter */
+            if (BIO_MSG_N(msg, stride, j - 1).data_len != seg_len
+                || m->data_len == 0
+                || m->data_len > seg_len
+                || total + m->data_len > DGRAM_SEG_MAX_BYTES
+                || !dgram_addr_eq(m->peer, first->peer)
+                || !dgram_addr_eq(m->local, first->local))
+                break;
+
+            iov[j].iov_base = m->data;
+            iov[j].iov_len  = m->data_len;
+            total += m->data_len;
+        }
+
+        mh[n].msg_hdr.msg_iovlen = j - i;
+        num_segs[n] = j - i;
+        if (j - i > 1) {
+            pack_segment_size(&mh[n].msg_hdr, control[n], seg_len);
+            used_gso = 1;
+        }
+    }
+
+    ret = sendmmsg(b->num, mh, n, sysflags);
+    if (ret < 0) {
+        int err = get_last_socket_error();
+
+        /*
+         * EIO means the route does not support checksum offload, which GSO
+         * needs, and EINVAL that a segment does not fit the path MTU.
+         */
+        if (used_gso && (err == EIO || err == EINVAL))
+            return -1;
+
+        ERR_raise(ERR_LIB_SYS, err);
+        *num_processed = 0;
+        return 0;
+    }
+
+    /* UDP sends each datagram in full or not at all */
+    for (n = 0, i = 0; n < (size_t)ret; ++n)
+        for (j = 0; j < num_segs[n]; ++j, ++i)
+            BIO_MSG_N(msg, stride, i).flags = 0;
+
+    *num_processed = i;
+    return 1;
+}
+
+/*
+ * Receives using UDP GRO. As a super-datagram may be larger than the buffers
+ * of the caller, we receive into our own buffers and split the super-datagrams
+ * into the caller's messages, keeping any remainder for the next call.
+ */
+static int dgram_recvmmsg_gro(BIO *b, BIO_MSG *msg, size_t stride,
+                              size_t num_msg, int sysflags,
+                              size_t *num_processed)
+{
+    bio_dgram_data *data = (bio_dgram_data *)b->ptr;
+    struct mmsghdr mh[DGRAM_GRO_MAX_BUFS];
+    struct iovec iov[DGRAM_GRO_MAX_BUFS];
+    unsigned char control[DGRAM_GRO_MAX_BUFS][DGRAM_SEG_CMSG_ALLOC_LEN];
+    struct cmsghdr *cmsg;
+    size_t i, j, len;
+    int ret, seg, peek = (sysflags & MSG_PEEK) != 0;
+
+    /*
+     * Super-datagrams are always taken off the socket, as they are kept here
+     * anyway, a peek only leaves the next datagram in place.
+     */
+    sysflags &= ~MSG_PEEK;
+    if (peek && num_msg > 1)
+        num_msg = 1;
+
+    for (i = 0; i < num_msg; ++i)
+        if (BIO_MSG_N(msg, stride, i).local != NULL
+            && !data->local_addr_enabled) {
+            ERR_raise(ERR_LIB_BIO, BIO_R_LOCAL_ADDR_NOT_AVAILABLE);
+            *num_processed = 0;
+            return 0;
+        }
+
+    if (data->gro_num == 0) {
+        memset(mh, 0, sizeof(mh));
+        for (j = 0; j < DGRAM_GRO_MAX_BUFS; ++j) {
+            iov[j].iov_base                = data->gro[j].buf;
+            iov[j].iov_len                 = DGRAM_SEG_MAX_BYTES;
+            mh[j].msg_hdr.msg_name         = &data->gro[j].peer.sa;
+            mh[j].msg_hdr.msg_namelen      = sizeof(data->gro[j].peer);
+            mh[j].msg_hdr.msg_iov          = &iov[j];
+            mh[j].msg_hdr.msg_iovlen       = 1;
+            mh[j].msg_hdr.msg_control      = control[j];
+            mh[j].msg_hdr.msg_controllen   = sizeof(control[j]);
+            BIO_ADDR_clear(&data->gro[j].peer);
+        }
+
+        /* Do not wait for more super-datagrams once one has arrived */
+        ret = recvmmsg(b->num, mh, DGRAM_GRO_MAX_BUFS,
+                       sysflags | MSG_WAITFORONE, NULL);
+        if (ret < 0) {
+            ERR_raise(ERR_LIB_SYS, get_last_socket_error());
+            *num_processed = 0;
+            return 0;
+        }
+
+        for (j = 0; j < (size_t)ret; ++j) {
+            data->gro[j].off     = 0;
+            data->gro[j].len     = mh[j].msg_len;
+            data->gro[j].seg_len = mh[j].msg_len;
+
+            for (cmsg = CMSG_FIRSTHDR(&mh[j].msg_hdr); cmsg != NULL;
+                 cmsg = CMSG_NXTHDR(&mh[j].msg_hdr, cmsg))
+                if (cmsg->cmsg_level == IPPROTO_UDP
+                    && cmsg->cmsg_type == UDP_GRO) {
+                    memcpy(&seg, CMSG_DATA(cmsg), sizeof(seg));
+                    if (seg > 0)
+                        data->gro[j].seg_len = (size_t)seg;
+                }
+
+            if (!data->local_addr_enabled
+                || extract_local(b, &mh[j].msg_hdr, &data->gro[j].local) < 1)
+                BIO_ADDR_clear(&data->gro[j].local);
+        }
+
+        data->gro_next = 0;
+        data->gro_num  = (size_t)ret;
+    }
+
+    /* Hand out one segment per message, truncating like recvmmsg() does */
+    for (i = 0; i < num_msg && data->gro_num > 0; ++i) {
+        BIO_MSG *m = &BIO_MSG_N(msg, stride, i);
+        size_t k = data->gro_next;
+
+        len = data->gro[k].len - data->gro[k].off;
+        if (len > data->gro[k].seg_len)
+            len = data->gro[k].seg_len;
+
+        memcpy(m->data, data->gro[k].buf + data->gro[k].off,
+               len < m->data_len ? len : m->data_len);
+        if (len < m->data_len)
+            m->data_len = len;
+        m->flags = 0;
+        if (m->peer != NULL)
+            *m->peer = data->gro[k].peer;
+        if (m->local != NULL)
+            *m->local = data->gro[k].local;
+
+        if (peek)
+            continue;
+        data->gro[k].off += len;
+        if (data->gro[k].off >= data->gro[k].len) {
+            ++data->gro_next;
+            --data->gro_num;
+        }
+    }
+
+    *num_processed = i;
+    return 1;
+}
+# endif
+
 static int dgram_sendmmsg(BIO *b, BIO_MSG *msg, size_t stride,
                           size_t num_msg, uint64_t flags, size_t *num_processed)
 {
@@ -1320,7 +1725,6 @@ static int dgram_sendmmsg(BIO *b, BIO_MSG *msg, size_t stride,
     int ret;
 # endif
 # if M_METHOD == M_METHOD_RECVMMSG
-#  define BIO_MAX_MSGS_PER_CALL   64
     int sysflags;
     bio_dgram_data *data = (bio_dgram_data *)b->ptr;
     size_t i;
@@ -1371,6 +1775,18 @@ static int dgram_sendmmsg(BIO *b, BIO_MSG *msg, size_t stride,
     if (num_msg > BIO_MAX_MSGS_PER_CALL)
         num_msg = BIO_MAX_MSGS_PER_CALL;
 
+#  if defined(SUPPORT_UDP_SEGMENTATION)
+    if ((data->segmentation & BIO_DGRAM_SEGMENTATION_TX) != 0) {
+        ret = dgram_sendmmsg_gso(b, msg, stride, num_msg, sysflags,
+                                 num_processed);
+        if (ret >= 0)
+            return ret;
+
+        /* GSO does not work for this socket, stop trying */
+        data->segmentation &= ~BIO_DGRAM_SEGMENTATION_TX;
+    }
+#  endif
+
     for (i = 0; i < num_msg; ++i) {
         translate_msg(b, &mh[i].msg_hdr, &iov[i],
                       control[i], &BIO_MSG_N(msg, stride, i));
@@ -1573,6 +1989,14 @@ static int dgram_recvmmsg(BIO *b, BIO_MSG *msg,
     if (num_msg > BIO_MAX_MSGS_PER_CALL)
         num_msg = BIO_MAX_MSGS_PER_CALL;
 
+#  if defined(SUPPORT_UDP_SEGMENTATION)
+    /* Also drain what is left over after GRO has been disabled again */
+    if ((data->segmentation & BIO_DGRAM_SEGMENTATION_RX) != 0
+        || data->gro_num > 0)
+        return dgram_recvmmsg_gro(b, msg, stride, num_msg, sysflags,
+                                  num_processed);
+#  endif
+
     for (i = 0; i < num_msg; ++i) {
         translate_msg(b, &mh[i].msg_hdr, &iov[i],
                       control[i], &BIO_MSG_N(msg, stride, i));
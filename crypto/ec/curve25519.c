@@ -17,6 +17,7 @@
 #include "crypto/ecx.h"
 #include "ec_local.h"
 #include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/sha.h>
 
 #include "internal/numbers.h"
@@ -771,10 +772,12 @@ static void x25519_scalar_mult(uint8_t out[32], const uint8_t scalar[32],
 typedef int32_t fe[10];
 
 static const int64_t kBottom21Bits =  0x1fffffLL;
+#if !defined(BASE_2_51_IMPLEMENTED)
 static const int64_t kBottom25Bits = 0x1ffffffLL;
 static const int64_t kBottom26Bits = 0x3ffffffLL;
 static const int64_t kTop39Bits = 0xfffffffffe000000LL;
 static const int64_t kTop38Bits = 0xfffffffffc000000LL;
+#endif
 
 static uint64_t load_3(const uint8_t *in)
 {
@@ -797,6 +800,7 @@ static uint64_t load_4(const uint8_t *in)
     return result;
 }
 
+#if !defined(BASE_2_51_IMPLEMENTED)
 static void fe_frombytes(fe h, const uint8_t *s)
 {
     /* Ignores top bit of h. */
@@ -950,6 +954,7 @@ static void fe_tobytes(uint8_t *s, const fe h)
     s[30] = (uint8_t) (h9 >> 10);
     s[31] = (uint8_t) (h9 >> 18);
 }
+#endif
 
 /* h = f */
 static void fe_copy(fe h, const fe f)
@@ -970,6 +975,7 @@ static void fe_1(fe h)
     h[0] = 1;
 }
 
+#if !defined(BASE_2_51_IMPLEMENTED)
 /*
  * h = f + g
  *
@@ -1499,6 +1505,7 @@ static void fe_invert(fe out, const fe z)
     /* Recall t0 = z ** 11; out = z ** (2 ** 255 - 21) */
     fe_mul(out, t1, t0);
 }
+#endif
 
 /*
  * h = -f
@@ -1536,6 +1543,7 @@ static void fe_cmov(fe f, const fe g, unsigned b)
     }
 }
 
+#if !defined(BASE_2_51_IMPLEMENTED)
 /*
  * return 0 if f == 0
  * return 1 if f != 0
@@ -1781,6 +1789,205 @@ static void fe_pow22523(fe out, const fe z)
     }
     fe_mul(out, t0, z);
 }
+#endif
+
+#if defined(BASE_2_51_IMPLEMENTED)
+/*
+ * Ed25519 group operations below are expressed in terms of gfe_*
+ * subroutines. When base 2^51 implementation is available, which is
+ * where x25519_fe51_mul and x25519_fe51_sqr assembly is, they map to
+ * fe51_* ones, otherwise to reference fe_* ones. Since fe51 limbs are
+ * unsigned, subtraction has to be complemented with multiple of modulus,
+ * and since group formulas chain additions and subtractions, result of
+ * subtraction is carried, so that all inputs to multiplication remain
+ * within 4*2^51 per limb.
+ */
+typedef uint64_t gfe[5];
+
+/* h = f with limbs carried */
+static void fe51_carry(fe51 h, const fe51 f)
+{
+    uint64_t h0 = f[0];
+    uint64_t h1 = f[1];
+    uint64_t h2 = f[2];
+    uint64_t h3 = f[3];
+    uint64_t h4 = f[4];
+
+    h1 += h0 >> 51; h0 &= MASK51;
+    h2 += h1 >> 51; h1 &= MASK51;
+    h3 += h2 >> 51; h2 &= MASK51;
+    h4 += h3 >> 51; h3 &= MASK51;
+    h0 += (h4 >> 51) * 19; h4 &= MASK51;
+
+    h[0] = h0;
+    h[1] = h1;
+    h[2] = h2;
+    h[3] = h3;
+    h[4] = h4;
+}
+
+/*
+ * h = f - g
+ *
+ * Unlike fe51_sub, add 4*modulus, so that g can be a sum of a few
+ * multiplication results, and carry the result.
+ */
+static void fe51_sub_carry(fe51 h, const fe51 f, const fe51 g)
+{
+    fe51 t;
+
+    t[0] = (f[0] + 0x1fffffffffffb4) - g[0];
+    t[1] = (f[1] + 0x1ffffffffffffc) - g[1];
+    t[2] = (f[2] + 0x1ffffffffffffc) - g[2];
+    t[3] = (f[3] + 0x1ffffffffffffc) - g[3];
+    t[4] = (f[4] + 0x1ffffffffffffc) - g[4];
+    fe51_carry(h, t);
+}
+
+/* h = -f */
+static void fe51_neg(fe51 h, const fe51 f)
+{
+    static const fe51 zero = { 0 };
+
+    fe51_sub_carry(h, zero, f);
+}
+
+/* h = 2 * f * f */
+static void fe51_sq2(fe51 h, const fe51 f)
+{
+    fe51_sq(h, f);
+    fe51_add(h, h, h);
+}
+
+static int fe51_isnonzero(const fe51 f)
+{
+    uint8_t s[32];
+    static const uint8_t zero[32] = {0};
+    fe51 t;
+
+    fe51_carry(t, f);
+    fe51_tobytes(s, t);
+
+    return CRYPTO_memcmp(s, zero, sizeof(zero)) != 0;
+}
+
+static int fe51_isnegative(const fe51 f)
+{
+    uint8_t s[32];
+    fe51 t;
+
+    fe51_carry(t, f);
+    fe51_tobytes(s, t);
+    return s[0] & 1;
+}
+
+static void fe51_pow22523(fe51 out, const fe51 z)
+{
+    fe51 t0;
+    fe51 t1;
+    fe51 t2;
+    int i;
+
+    fe51_sq(t0, z);
+    fe51_sq(t1, t0);
+    fe51_sq(t1, t1);
+    fe51_mul(t1, z, t1);
+    fe51_mul(t0, t0, t1);
+    fe51_sq(t0, t0);
+    fe51_mul(t0, t1, t0);
+    fe51_sq(t1, t0);
+    for (i = 1; i < 5; ++i) {
+        fe51_sq(t1, t1);
+    }
+    fe51_mul(t0, t1, t0);
+    fe51_sq(t1, t0);
+    for (i = 1; i < 10; ++i) {
+        fe51_sq(t1, t1);
+    }
+    fe51_mul(t1, t1, t0);
+    fe51_sq(t2, t1);
+    for (i = 1; i < 20; ++i) {
+        fe51_sq(t2, t2);
+    }
+    fe51_mul(t1, t2, t1);
+    fe51_sq(t1, t1);
+    for (i = 1; i < 10; ++i) {
+        fe51_sq(t1, t1);
+    }
+    fe51_mul(t0, t1, t0);
+    fe51_sq(t1, t0);
+    for (i = 1; i < 50; ++i) {
+        fe51_sq(t1, t1);
+    }
+    fe51_mul(t1, t1, t0);
+    fe51_sq(t2, t1);
+    for (i = 1; i < 100; ++i) {
+        fe51_sq(t2, t2);
+    }
+    fe51_mul(t1, t2, t1);
+    fe51_sq(t1, t1);
+    for (i = 1; i < 50; ++i) {
+        fe51_sq(t1, t1);
+    }
+    fe51_mul(t0, t1, t0);
+    fe51_sq(t0, t0);
+    fe51_sq(t0, t0);
+    fe51_mul(out, t0, z);
+}
+
+/*
+ * Convert reference representation to base 2^51, used for precomputed
+ * tables, which are kept in reference format.
+ */
+static void fe51_from_fe(fe51 h, const fe f)
+{
+    fe51 t;
+
+    /* |f[2*i] + 2^26*f[2*i+1]| < 2^52, so that adding 4*modulus is enough */
+    t[0] = (uint64_t)((int64_t)f[0] + ((int64_t)f[1] * (1 << 26))) + 0x1fffffffffffb4;
+    t[1] = (uint64_t)((int64_t)f[2] + ((int64_t)f[3] * (1 << 26))) + 0x1ffffffffffffc;
+    t[2] = (uint64_t)((int64_t)f[4] + ((int64_t)f[5] * (1 << 26))) + 0x1ffffffffffffc;
+    t[3] = (uint64_t)((int64_t)f[6] + ((int64_t)f[7] * (1 << 26))) + 0x1ffffffffffffc;
+    t[4] = (uint64_t)((int64_t)f[8] + ((int64_t)f[9] * (1 << 26))) + 0x1ffffffffffffc;
+    fe51_carry(h, t);
+}
+
+# define gfe_frombytes  fe51_frombytes
+# define gfe_tobytes    fe51_tobytes
+# define gfe_copy       fe51_copy
+# define gfe_0          fe51_0
+# define gfe_1          fe51_1
+# define gfe_add        fe51_add
+# define gfe_sub        fe51_sub_carry
+# define gfe_neg        fe51_neg
+# define gfe_mul        fe51_mul
+# define gfe_sq         fe51_sq
+# define gfe_sq2        fe51_sq2
+# define gfe_invert     fe51_invert
+# define gfe_isnonzero  fe51_isnonzero
+# define gfe_isnegative fe51_isnegative
+# define gfe_pow22523   fe51_pow22523
+# define gfe_from_fe    fe51_from_fe
+#else
+typedef int32_t gfe[10];
+
+# define gfe_frombytes  fe_frombytes
+# define gfe_tobytes    fe_tobytes
+# define gfe_copy       fe_copy
+# define gfe_0          fe_0
+# define gfe_1          fe_1
+# define gfe_add        fe_add
+# define gfe_sub        fe_sub
+# define gfe_neg        fe_neg
+# define gfe_mul        fe_mul
+# define gfe_sq         fe_sq
+# define gfe_sq2        fe_sq2
+# define gfe_invert     fe_invert
+# define gfe_isnonzero  fe_isnonzero
+# define gfe_isnegative fe_isnegative
+# define gfe_pow22523   fe_pow22523
+# define gfe_from_fe    fe_copy
+#endif
 
 /*
  * ge means group element.
@@ -1794,131 +2001,152 @@ static void fe_pow22523(fe out, const fe z)
  *   ge_p3 (extended): (X:Y:Z:T) satisfying x=X/Z, y=Y/Z, XY=ZT
  *   ge_p1p1 (completed): ((X:Z),(Y:T)) satisfying x=X/Z, y=Y/T
  *   ge_precomp (Duif): (y+x,y-x,2dxy)
+ *
+ * Precomputed tables are stored as ge_precomp_fe, i.e. in reference
+ * representation, and are converted to ge_precomp upon use.
  */
 typedef struct {
-    fe X;
-    fe Y;
-    fe Z;
+    gfe X;
+    gfe Y;
+    gfe Z;
 } ge_p2;
 
 typedef struct {
-    fe X;
-    fe Y;
-    fe Z;
-    fe T;
+    gfe X;
+    gfe Y;
+    gfe Z;
+    gfe T;
 } ge_p3;
 
 typedef struct {
-    fe X;
-    fe Y;
-    fe Z;
-    fe T;
+    gfe X;
+    gfe Y;
+    gfe Z;
+    gfe T;
 } ge_p1p1;
 
+typedef struct {
+    gfe yplusx;
+    gfe yminusx;
+    gfe xy2d;
+} ge_precomp;
+
 typedef struct {
     fe yplusx;
     fe yminusx;
     fe xy2d;
-} ge_precomp;
+} ge_precomp_fe;
 
 typedef struct {
-    fe YplusX;
-    fe YminusX;
-    fe Z;
-    fe T2d;
+    gfe YplusX;
+    gfe YminusX;
+    gfe Z;
+    gfe T2d;
 } ge_cached;
 
 static void ge_tobytes(uint8_t *s, const ge_p2 *h)
 {
-    fe recip;
-    fe x;
-    fe y;
-
-    fe_invert(recip, h->Z);
-    fe_mul(x, h->X, recip);
-    fe_mul(y, h->Y, recip);
-    fe_tobytes(s, y);
-    s[31] ^= fe_isnegative(x) << 7;
+    gfe recip;
+    gfe x;
+    gfe y;
+
+    gfe_invert(recip, h->Z);
+    gfe_mul(x, h->X, recip);
+    gfe_mul(y, h->Y, recip);
+    gfe_tobytes(s, y);
+    s[31] ^= gfe_isnegative(x) << 7;
 }
 
 static void ge_p3_tobytes(uint8_t *s, const ge_p3 *h)
 {
-    fe recip;
-    fe x;
-    fe y;
-
-    fe_invert(recip, h->Z);
-    fe_mul(x, h->X, recip);
-    fe_mul(y, h->Y, recip);
-    fe_tobytes(s, y);
-    s[31] ^= fe_isnegative(x) << 7;
+    gfe recip;
+    gfe x;
+    gfe y;
+
+    gfe_invert(recip, h->Z);
+    gfe_mul(x, h->X, recip);
+    gfe_mul(y, h->Y, recip);
+    gfe_tobytes(s, y);
+    s[31] ^= gfe_isnegative(x) << 7;
 }
 
-static const fe d = {
+#if defined(BASE_2_51_IMPLEMENTED)
+static const gfe d = {
+    0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029,
+    0x739c663a03cbb, 0x52036cee2b6ff
+};
+
+static const gfe sqrtm1 = {
+    0x61b274a0ea0b0, 0x0d5a5fc8f189d, 0x7ef5e9cbd0c60,
+    0x78595a6804c9e, 0x2b8324804fc1d
+};
+#else
+static const gfe d = {
     -10913610, 13857413, -15372611, 6949391,   114729,
     -8787816,  -6275908, -3247719,  -18696448, -12055116
 };
 
-static const fe sqrtm1 = {
+static const gfe sqrtm1 = {
     -32595792, -7943725,  9377950,  3500415, 12389472,
     -272473,   -25146209, -2005654, 326686,  11406482
 };
+#endif
 
 static int ge_frombytes_vartime(ge_p3 *h, const uint8_t *s)
 {
-    fe u;
-    fe v;
-    fe w;
-    fe vxx;
-    fe check;
-
-    fe_frombytes(h->Y, s);
-    fe_1(h->Z);
-    fe_sq(u, h->Y);
-    fe_mul(v, u, d);
-    fe_sub(u, u, h->Z); /* u = y^2-1 */
-    fe_add(v, v, h->Z); /* v = dy^2+1 */
-
-    fe_mul(w, u, v); /* w = u*v */
-
-    fe_pow22523(h->X, w); /* x = w^((q-5)/8) */
-    fe_mul(h->X, h->X, u); /* x = u * w^((q-5)/8) */
-
-    fe_sq(vxx, h->X);
-    fe_mul(vxx, vxx, v);
-    fe_sub(check, vxx, u); /* vx^2-u */
-    if (fe_isnonzero(check)) {
-        fe_add(check, vxx, u); /* vx^2+u */
-        if (fe_isnonzero(check)) {
+    gfe u;
+    gfe v;
+    gfe w;
+    gfe vxx;
+    gfe check;
+
+    gfe_frombytes(h->Y, s);
+    gfe_1(h->Z);
+    gfe_sq(u, h->Y);
+    gfe_mul(v, u, d);
+    gfe_sub(u, u, h->Z); /* u = y^2-1 */
+    gfe_add(v, v, h->Z); /* v = dy^2+1 */
+
+    gfe_mul(w, u, v); /* w = u*v */
+
+    gfe_pow22523(h->X, w); /* x = w^((q-5)/8) */
+    gfe_mul(h->X, h->X, u); /* x = u * w^((q-5)/8) */
+
+    gfe_sq(vxx, h->X);
+    gfe_mul(vxx, vxx, v);
+    gfe_sub(check, vxx, u); /* vx^2-u */
+    if (gfe_isnonzero(check)) {
+        gfe_add(check, vxx, u); /* vx^2+u */
+        if (gfe_isnonzero(check)) {
             return -1;
         }
-        fe_mul(h->X, h->X, sqrtm1);
+        gfe_mul(h->X, h->X, sqrtm1);
     }
 
-    if (fe_isnegative(h->X) != (s[31] >> 7)) {
-        fe_neg(h->X, h->X);
+    if (gfe_isnegative(h->X) != (s[31] >> 7)) {
+        gfe_neg(h->X, h->X);
     }
 
-    fe_mul(h->T, h->X, h->Y);
+    gfe_mul(h->T, h->X, h->Y);
     return 0;
 }
 
 static void ge_p2_0(ge_p2 *h)
 {
-    fe_0(h->X);
-    fe_1(h->Y);
-    fe_1(h->Z);
+    gfe_0(h->X);
+    gfe_1(h->Y);
+    gfe_1(h->Z);
 }
 
 static void ge_p3_0(ge_p3 *h)
 {
-    fe_0(h->X);
-    fe_1(h->Y);
-    fe_1(h->Z);
-    fe_0(h->T);
+    gfe_0(h->X);
+    gfe_1(h->Y);
+    gfe_1(h->Z);
+    gfe_0(h->T);
 }
 
-static void ge_precomp_0(ge_precomp *h)
+static void ge_precomp_0(ge_precomp_fe *h)
 {
     fe_1(h->yplusx);
     fe_1(h->yminusx);
@@ -1928,56 +2156,63 @@ static void ge_precomp_0(ge_precomp *h)
 /* r = p */
 static void ge_p3_to_p2(ge_p2 *r, const ge_p3 *p)
 {
-    fe_copy(r->X, p->X);
-    fe_copy(r->Y, p->Y);
-    fe_copy(r->Z, p->Z);
+    gfe_copy(r->X, p->X);
+    gfe_copy(r->Y, p->Y);
+    gfe_copy(r->Z, p->Z);
 }
 
-static const fe d2 = {
+#if defined(BASE_2_51_IMPLEMENTED)
+static const gfe d2 = {
+    0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052,
+    0x6738cc7407977, 0x2406d9dc56dff
+};
+#else
+static const gfe d2 = {
     -21827239, -5839606,  -30745221, 13898782, 229458,
     15978800,  -12551817, -6495438,  29715968, 9444199
 };
+#endif
 
 /* r = p */
 static void ge_p3_to_cached(ge_cached *r, const ge_p3 *p)
 {
-    fe_add(r->YplusX, p->Y, p->X);
-    fe_sub(r->YminusX, p->Y, p->X);
-    fe_copy(r->Z, p->Z);
-    fe_mul(r->T2d, p->T, d2);
+    gfe_add(r->YplusX, p->Y, p->X);
+    gfe_sub(r->YminusX, p->Y, p->X);
+    gfe_copy(r->Z, p->Z);
+    gfe_mul(r->T2d, p->T, d2);
 }
 
 /* r = p */
 static void ge_p1p1_to_p2(ge_p2 *r, const ge_p1p1 *p)
 {
-    fe_mul(r->X, p->X, p->T);
-    fe_mul(r->Y, p->Y, p->Z);
-    fe_mul(r->Z, p->Z, p->T);
+    gfe_mul(r->X, p->X, p->T);
+    gfe_mul(r->Y, p->Y, p->Z);
+    gfe_mul(r->Z, p->Z, p->T);
 }
 
 /* r = p */
 static void ge_p1p1_to_p3(ge_p3 *r, const ge_p1p1 *p)
 {
-    fe_mul(r->X, p->X, p->T);
-    fe_mul(r->Y, p->Y, p->Z);
-    fe_mul(r->Z, p->Z, p->T);
-    fe_mul(r->T, p->X, p->Y);
+    gfe_mul(r->X, p->X, p->T);
+    gfe_mul(r->Y, p->Y, p->Z);
+    gfe_mul(r->Z, p->Z, p->T);
+    gfe_mul(r->T, p->X, p->Y);
 }
 
 /* r = 2 * p */
 static void ge_p2_dbl(ge_p1p1 *r, const ge_p2 *p)
 {
-    fe t0;
-
-    fe_sq(r->X, p->X);
-    fe_sq(r->Z, p->Y);
-    fe_sq2(r->T, p->Z);
-    fe_add(r->Y, p->X, p->Y);
-    fe_sq(t0, r->Y);
-    fe_add(r->Y, r->Z, r->X);
-    fe_sub(r->Z, r->Z, r->X);
-    fe_sub(r->X, t0, r->Y);
-    fe_sub(r->T, r->T, r->Z);
+    gfe t0;
+
+    gfe_sq(r->X, p->X);
+    gfe_sq(r->Z, p->Y);
+    gfe_sq2(r->T, p->Z);
+    gfe_add(r->Y, p->X, p->Y);
+    gfe_sq(t0, r->Y);
+    gfe_add(r->Y, r->Z, r->X);
+    gfe_sub(r->Z, r->Z, r->X);
+    gfe_sub(r->X, t0, r->Y);
+    gfe_sub(r->T, r->T, r->Z);
 }
 
 /* r = 2 * p */
@@ -1991,71 +2226,71 @@ static void ge_p3_dbl(ge_p1p1 *r, const ge_p3 *p)
 /* r = p + q */
 static void ge_madd(ge_p1p1 *r, const ge_p3 *p, const ge_precomp *q)
 {
-    fe t0;
-
-    fe_add(r->X, p->Y, p->X);
-    fe_sub(r->Y, p->Y, p->X);
-    fe_mul(r->Z, r->X, q->yplusx);
-    fe_mul(r->Y, r->Y, q->yminusx);
-    fe_mul(r->T, q->xy2d, p->T);
-    fe_add(t0, p->Z, p->Z);
-    fe_sub(r->X, r->Z, r->Y);
-    fe_add(r->Y, r->Z, r->Y);
-    fe_add(r->Z, t0, r->T);
-    fe_sub(r->T, t0, r->T);
+    gfe t0;
+
+    gfe_add(r->X, p->Y, p->X);
+    gfe_sub(r->Y, p->Y, p->X);
+    gfe_mul(r->Z, r->X, q->yplusx);
+    gfe_mul(r->Y, r->Y, q->yminusx);
+    gfe_mul(r->T, q->xy2d, p->T);
+    gfe_add(t0, p->Z, p->Z);
+    gfe_sub(r->X, r->Z, r->Y);
+    gfe_add(r->Y, r->Z, r->Y);
+    gfe_add(r->Z, t0, r->T);
+    gfe_sub(r->T, t0, r->T);
 }
 
 /* r = p - q */
 static void ge_msub(ge_p1p1 *r, const ge_p3 *p, const ge_precomp *q)
 {
-    fe t0;
-
-    fe_add(r->X, p->Y, p->X);
-    fe_sub(r->Y, p->Y, p->X);
-    fe_mul(r->Z, r->X, q->yminusx);
-    fe_mul(r->Y, r->Y, q->yplusx);
-    fe_mul(r->T, q->xy2d, p->T);
-    fe_add(t0, p->Z, p->Z);
-    fe_sub(r->X, r->Z, r->Y);
-    fe_add(r->Y, r->Z, r->Y);
-    fe_sub(r->Z, t0, r->T);
-    fe_add(r->T, t0, r->T);
+    gfe t0;
+
+    gfe_add(r->X, p->Y, p->X);
+    gfe_sub(r->Y, p->Y, p->X);
+    gfe_mul(r->Z, r->X, q->yminusx);
+    gfe_mul(r->Y, r->Y, q->yplusx);
+    gfe_mul(r->T, q->xy2d, p->T);
+    gfe_add(t0, p->Z, p->Z);
+    gfe_sub(r->X, r->Z, r->Y);
+    gfe_add(r->Y, r->Z, r->Y);
+    gfe_sub(r->Z, t0, r->T);
+    gfe_add(r->T, t0, r->T);
 }
 
 /* r = p + q */
 static void ge_add(ge_p1p1 *r, const ge_p3 *p, const ge_cached *q)
 {
-    fe t0;
-
-    fe_add(r->X, p->Y, p->X);
-    fe_sub(r->Y, p->Y, p->X);
-    fe_mul(r->Z, r->X, q->YplusX);
-    fe_mul(r->Y, r->Y, q->YminusX);
-    fe_mul(r->T, q->T2d, p->T);
-    fe_mul(r->X, p->Z, q->Z);
-    fe_add(t0, r->X, r->X);
-    fe_sub(r->X, r->Z, r->Y);
-    fe_add(r->Y, r->Z, r->Y);
-    fe_add(r->Z, t0, r->T);
-    fe_sub(r->T, t0, r->T);
+    gfe t0;
+
+    gfe_add(r->X, p->Y, p->X);
+    gfe_sub(r->Y, p->Y, p->X);
+    gfe_mul(r->Z, r->X, q->YplusX);
+    gfe_mul(r->Y, r->Y, q->YminusX);
+    gfe_mul(r->T, q->T2d, p->T);
+    gfe_mul(r->X, p->Z, q->Z);
+    gfe_add(t0, r->X, r->X);
+    gfe_sub(r->X, r->Z, r->Y);
+    gfe_add(r->Y, r->Z, r->Y);
+    gfe_add(r->Z, t0, r->T);
+    gfe_sub(r->T, t0, r->T);
 }
 
 /* r = p - q */
 static void ge_sub(ge_p1p1 *r, const ge_p3 *p, const ge_cached *q)
 {
-    fe t0;
-
-    fe_add(r->X, p->Y, p->X);
-    fe_sub(r->Y, p->Y, p->X);
-    fe_mul(r->Z, r->X, q->YminusX);
-    fe_mul(r->Y, r->Y, q->YplusX);
-    fe_mul(r->T, q->T2d, p->T);
-    fe_mul(r->X, p->Z, q->Z);
-    fe_add(t0, r->X, r->X);
-    fe_sub(r->X, r->Z, r->Y);
-    fe_add(r->Y, r->Z, r->Y);
-    fe_sub(r->Z, t0, r->T);
-    fe_add(r->T, t0, r->T);
+    gfe t0;
+
+    gfe_add(r->X, p->Y, p->X);
+    gfe_sub(r->Y, p->Y, p->X);
+    gfe_mul(r->Z, r->X, q->YminusX);
+    gfe_mul(r->Y, r->Y, q->YplusX);
+    gfe_mul(r->T, q->T2d, p->T);
+    gfe_mul(r->X, p->Z, q->Z);
+    gfe_add(t0, r->X, r->X);
+    gfe_sub(r->X, r->Z, r->Y);
+    gfe_add(r->Y, r->Z, r->Y);
+    gfe_sub(r->Z, t0, r->T);
+    gfe_add(r->T, t0, r->T);
 }
 
 static uint8_t equal(signed char b, signed char c)
@@ -2069,15 +2304,22 @@ static uint8_t equal(signed char b, signed char c)
     return y;
 }
 
-static void cmov(ge_precomp *t, const ge_precomp *u, uint8_t b)
+static void cmov(ge_precomp_fe *t, const ge_precomp_fe *u, uint8_t b)
 {
     fe_cmov(t->yplusx, u->yplusx, b);
     fe_cmov(t->yminusx, u->yminusx, b);
     fe_cmov(t->xy2d, u->xy2d, b);
 }
 
+static void ge_precomp_from_fe(ge_precomp *r, const ge_precomp_fe *p)
+{
+    gfe_from_fe(r->yplusx, p->yplusx);
+    gfe_from_fe(r->yminusx, p->yminusx);
+    gfe_from_fe(r->xy2d, p->xy2d);
+}
+
 /* k25519Precomp[i][j] = (j+1)*256^i*B */
-static const ge_precomp k25519Precomp[32][8] = {
+static const ge_precomp_fe k25519Precomp[32][8] = {
     {
         {
             {25967493, -14356035, 29566456, 3660896, -12694345, 4014787,
@@ -4202,23 +4444,25 @@ static uint8_t negative(signed char b)
 
 static void table_select(ge_precomp *t, int pos, signed char b)
 {
-    ge_precomp minust;
+    ge_precomp_fe sel;
+    ge_precomp_fe minust;
     uint8_t bnegative = negative(b);
     uint8_t babs = b - ((uint8_t)((-bnegative) & b) << 1);
 
-    ge_precomp_0(t);
-    cmov(t, &k25519Precomp[pos][0], equal(babs, 1));
-    cmov(t, &k25519Precomp[pos][1], equal(babs, 2));
-    cmov(t, &k25519Precomp[pos][2], equal(babs, 3));
-    cmov(t, &k25519Precomp[pos][3], equal(babs, 4));
-    cmov(t, &k25519Precomp[pos][4], equal(babs, 5));
-    cmov(t, &k25519Precomp[pos][5], equal(babs, 6));
-    cmov(t, &k25519Precomp[pos][6], equal(babs, 7));
-    cmov(t, &k25519Precomp[pos][7], equal(babs, 8));
-    fe_copy(minust.yplusx, t->yminusx);
-    fe_copy(minust.yminusx, t->yplusx);
-    fe_neg(minust.xy2d, t->xy2d);
-    cmov(t, &minust, bnegative);
+    ge_precomp_0(&sel);
+    cmov(&sel, &k25519Precomp[pos][0], equal(babs, 1));
+    cmov(&sel, &k25519Precomp[pos][1], equal(babs, 2));
+    cmov(&sel, &k25519Precomp[pos][2], equal(babs, 3));
+    cmov(&sel, &k25519Precomp[pos][3], equal(babs, 4));
+    cmov(&sel, &k25519Precomp[pos][4], equal(babs, 5));
+    cmov(&sel, &k25519Precomp[pos][5], equal(babs, 6));
+    cmov(&sel, &k25519Precomp[pos][6], equal(babs, 7));
+    cmov(&sel, &k25519Precomp[pos][7], equal(babs, 8));
+    fe_copy(minust.yplusx, sel.yminusx);
+    fe_copy(minust.yminusx, sel.yplusx);
+    fe_neg(minust.xy2d, sel.xy2d);
+    cmov(&sel, &minust, bnegative);
+    ge_precomp_from_fe(t, &sel);
 }
 
 /*
@@ -4461,7 +4705,7 @@ static void slide(signed char *r, const uint8_t *a)
     }
 }
 
-static const ge_precomp Bi[8] = {
+static const ge_precomp_fe Bi[8] = {
     {
         {25967493, -14356035, 29566456, 3660896, -12694345, 4014787, 27544626,
          -11754271, -6079156, 2047605},
@@ -4541,6 +4785,7 @@ static void ge_double_scalarmult_vartime(ge_p2 *r, const uint8_t *a,
     signed char aslide[256];
     signed char bslide[256];
     ge_cached Ai[8]; /* A,3A,5A,7A,9A,11A,13A,15A */
+    ge_precomp B[8]; /* B,3B,5B,7B,9B,11B,13B,15B */
     ge_p1p1 t;
     ge_p3 u;
     ge_p3 A2;
@@ -4549,6 +4794,9 @@ static void ge_double_scalarmult_vartime(ge_p2 *r, const uint8_t *a,
     slide(aslide, a);
     slide(bslide, b);
 
+    for (i = 0; i < 8; i++)
+        ge_precomp_from_fe(&B[i], &Bi[i]);
+
     ge_p3_to_cached(&Ai[0], A);
     ge_p3_dbl(&t, A);
     ge_p1p1_to_p3(&A2, &t);
@@ -4595,16 +4843,162 @@ static void ge_double_scalarmult_vartime(ge_p2 *r, const uint8_t *a,
 
         if (bslide[i] > 0) {
             ge_p1p1_to_p3(&u, &t);
-            ge_madd(&t, &u, &Bi[bslide[i] / 2]);
+            ge_madd(&t, &u, &B[bslide[i] / 2]);
         } else if (bslide[i] < 0) {
             ge_p1p1_to_p3(&u, &t);
-            ge_msub(&t, &u, &Bi[(-bslide[i]) / 2]);
+            ge_msub(&t, &u, &B[(-bslide[i]) / 2]);
         }
 
         ge_p1p1_to_p2(r, &t);
     }
 }
 
+/*
+ * Like ge_frombytes_vartime, but additionally reject encodings that
+ * ge_tobytes can't produce, i.e. y >= q and x == 0 with sign bit set.
+ */
+static int ge_frombytes_strict_vartime(ge_p3 *h, const uint8_t *s)
+{
+    int i;
+
+    if (s[0] >= 0xed && (s[31] & 0x7f) == 0x7f) {
+        for (i = 1; i < 31 && s[i] == 0xff; i++)
+            continue;
+        if (i == 31)
+            return -1;
+    }
+    if (ge_frombytes_vartime(h, s) != 0)
+        return -1;
+    if ((s[31] >> 7) != 0 && !gfe_isnonzero(h->X))
+        return -1;
+    return 0;
+}
+
+/* Computes h = [8]p */
+static void ge_p2_mul8(ge_p2 *h, const ge_p2 *p)
+{
+    ge_p1p1 t;
+    int k;
+
+    *h = *p;
+    for (k = 0; k < 3; k++) {
+        ge_p2_dbl(&t, h);
+        ge_p1p1_to_p2(h, &t);
+    }
+}
+
+/* Returns 1 if [8]p == [8]q, i.e. p and q only differ by a small order point */
+static int ge_p2_eq_cofactored(const ge_p2 *p, const ge_p2 *q)
+{
+    ge_p2 p8, q8;
+    gfe t0, t1;
+
+    ge_p2_mul8(&p8, p);
+    ge_p2_mul8(&q8, q);
+
+    /* Compare projectively: X/Z and Y/Z */
+    gfe_mul(t0, p8.X, q8.Z);
+    gfe_mul(t1, q8.X, p8.Z);
+    gfe_sub(t0, t0, t1);
+    if (gfe_isnonzero(t0))
+        return 0;
+    gfe_mul(t0, p8.Y, q8.Z);
+    gfe_mul(t1, q8.Y, p8.Z);
+    gfe_sub(t0, t0, t1);
+    return !gfe_isnonzero(t0);
+}
+
+/* c-bit window of 128-bit little-endian scalar starting at bit |pos| */
+static unsigned int scalar128_window(const uint8_t z[16], int pos, int c)
+{
+    int i = pos / 8;
+    unsigned int v = z[i];
+
+    if (i + 1 < 16)
+        v |= (unsigned int)z[i + 1] << 8;
+    return (v >> (pos % 8)) & ((1U << c) - 1);
+}
+
+/*
+ * r = z[0] * P[0] + ... + z[num-1] * P[num-1]
+ *
+ * where z[i] are 128-bit scalars, using Pippenger's bucket method. For
+ * each c-bit window, points are added to one of 2^c - 1 buckets by their
+ * digit, and buckets are then summed with weights by a running sum.
+ */
+static int ge_multi_scalarmult_vartime(ge_p3 *r, const uint8_t (*z)[16],
+                                       const ge_cached *P, size_t num)
+{
+    ge_p3 *bucket;
+    unsigned char *used;
+    ge_p3 run, sum;
+    ge_cached tmp;
+    ge_p1p1 t;
+    ge_p2 q;
+    size_t i;
+    int c, nbuckets, w, j, k;
+
+    for (c = 3; c < 8 && ((size_t)1 << (c + 2)) < num; c++)
+        continue;
+    nbuckets = (1 << c) - 1;
+
+    bucket = OPENSSL_malloc(nbuckets * sizeof(*bucket));
+    used = OPENSSL_malloc(nbuckets);
+    if (bucket == NULL || used == NULL) {
+        OPENSSL_free(bucket);
+        OPENSSL_free(used);
+        return 0;
+    }
+
+    ge_p3_0(r);
+    for (w = (128 + c - 1) / c - 1; w >= 0; w--) {
+        if (w != (128 + c - 1) / c - 1) {
+            ge_p3_to_p2(&q, r);
+            for (k = 0; k < c; k++) {
+                ge_p2_dbl(&t, &q);
+                if (k < c - 1)
+                    ge_p1p1_to_p2(&q, &t);
+            }
+            ge_p1p1_to_p3(r, &t);
+        }
+
+        memset(used, 0, nbuckets);
+        for (i = 0; i < num; i++) {
+            unsigned int digit = scalar128_window(z[i], w * c, c);
+
+            if (digit == 0)
+                continue;
+            if (!used[digit - 1]) {
+                ge_p3_0(&bucket[digit - 1]);
+                used[digit - 1] = 1;
+            }
+            ge_add(&t, &bucket[digit - 1], &P[i]);
+            ge_p1p1_to_p3(&bucket[digit - 1], &t);
+        }
+
+        ge_p3_0(&run);
+        ge_p3_0(&sum);
+        for (j = nbuckets - 1; j >= 0; j--) {
+            if (used[j]) {
+                ge_p3_to_cached(&tmp, &bucket[j]);
+                ge_add(&t, &run, &tmp);
+                ge_p1p1_to_p3(&run, &t);
+            }
+            ge_p3_to_cached(&tmp, &run);
+            ge_add(&t, &sum, &tmp);
+            ge_p1p1_to_p3(&sum, &t);
+        }
+
+        ge_p3_to_cached(&tmp, &sum);
+        ge_add(&t, r, &tmp);
+        ge_p1p1_to_p3(r, &t);
+    }
+
+    OPENSSL_free(bucket);
+    OPENSSL_free(used);
+    return 1;
+}
+
 /*
  * The set of scalars is \Z/l
  * where l = 2^252 + 27742317777372353535851937790883648493.
@@ -5555,6 +5949,43 @@ ossl_ed25519_pubkey_verify(const uint8_t *pub, size_t pub_len)
 
 static const char allzeroes[15];
 
+/*
+ * Check 0 <= s < L where L = 2^252 + 27742317777372353535851937790883648493
+ *
+ * If not the signature is publicly invalid. Since it's public we can do the
+ * check in variable time.
+ */
+static int sc_is_reduced(const uint8_t *s)
+{
+    int i;
+    /* 27742317777372353535851937790883648493 in little endian format */
+    static const uint8_t l_low[16] = {
+        0xED, 0xD3, 0xF5, 0x5C, 0x1A, 0x63, 0x12, 0x58, 0xD6, 0x9C, 0xF7, 0xA2,
+        0xDE, 0xF9, 0xDE, 0x14
+    };
+
+    /* First check the most significant byte */
+    if (s[31] > 0x10)
+        return 0;
+    if (s[31] == 0x10) {
+        /*
+         * Most significant byte indicates a value close to 2^252 so check the
+         * rest
+         */
+        if (memcmp(s + 16, allzeroes, sizeof(allzeroes)) != 0)
+            return 0;
+        for (i = 15; i >= 0; i--) {
+            if (s[i] < l_low[i])
+                break;
+            if (s[i] > l_low[i])
+                return 0;
+        }
+        if (i < 0)
+            return 0;
+    }
+    return 1;
+}
+
 int
 ossl_ed25519_verify(const uint8_t *tbs, size_t tbs_len,
                     const uint8_t signature[64], const uint8_t public_key[32],
@@ -5562,7 +5993,6 @@ ossl_ed25519_verify(const uint8_t *tbs, size_t tbs_len,
                     const uint8_t *context, size_t context_len,
                     OSSL_LIB_CTX *libctx, const char *propq)
 {
-    int i;
     ge_p3 A;
     const uint8_t *r, *s;
     EVP_MD *sha512;
@@ -5572,11 +6002,6 @@ ossl_ed25519_verify(const uint8_t *tbs, size_t tbs_len,
     ge_p2 R;
     uint8_t rcheck[32];
     uint8_t h[SHA512_DIGEST_LENGTH];
-    /* 27742317777372353535851937790883648493 in little endian format */
-    const uint8_t l_low[16] = {
-        0xED, 0xD3, 0xF5, 0x5C, 0x1A, 0x63, 0x12, 0x58, 0xD6, 0x9C, 0xF7, 0xA2,
-        0xDE, 0xF9, 0xDE, 0x14
-    };
 
     if (context == NULL)
         context_len = 0;
@@ -5592,39 +6017,15 @@ ossl_ed25519_verify(const uint8_t *tbs, size_t tbs_len,
     r = signature;
     s = signature + 32;
 
-    /*
-     * Check 0 <= s < L where L = 2^252 + 27742317777372353535851937790883648493
-     *
-     * If not the signature is publicly invalid. Since it's public we can do the
-     * check in variable time.
-     *
-     * First check the most significant byte
-     */
-    if (s[31] > 0x10)
+    if (!sc_is_reduced(s))
         return 0;
-    if (s[31] == 0x10) {
-        /*
-         * Most significant byte indicates a value close to 2^252 so check the
-         * rest
-         */
-        if (memcmp(s + 16, allzeroes, sizeof(allzeroes)) != 0)
-            return 0;
-        for (i = 15; i >= 0; i--) {
-            if (s[i] < l_low[i])
-                break;
-            if (s[i] > l_low[i])
-                return 0;
-        }
-        if (i < 0)
-            return 0;
-    }
 
     if (ge_frombytes_vartime(&A, public_key) != 0) {
         return 0;
     }
 
-    fe_neg(A.X, A.X);
-    fe_neg(A.T, A.T);
+    gfe_neg(A.X, A.X);
+    gfe_neg(A.T, A.T);
 
     sha512 = EVP_MD_fetch(libctx, SN_sha512, propq);
     if (sha512 == NULL)
@@ -5648,16 +6049,142 @@ ossl_ed25519_verify(const uint8_t *tbs, size_t tbs_len,
 
     res = CRYPTO_memcmp(rcheck, r, sizeof(rcheck)) == 0;
 
-    /* note that we have used the strict verification equation here.
-     * we checked that  ENC( [h](-A) + [s]B ) == r
+    /*
+     * The strict verification equation checked above is
+     *          ENC( [h](-A) + [s]B ) == r
      * B is the base point.
      *
-     * the less strict verification equation uses the curve cofactor:
+     * If that fails, the cofactored equation
      *          [h*8](-A) + [s*8]B == [8]R
+     * is used, like RFC 8032 allows, which only differs for an A or R with a
+     * component of small order. That is what ossl_ed25519_verify_batch()
+     * checks, so verifying in a batch gives the same result as one by one.
      */
+    if (!res) {
+        ge_p3 Rp;
+        ge_p2 Rq;
+
+        if (ge_frombytes_strict_vartime(&Rp, r) == 0) {
+            ge_p3_to_p2(&Rq, &Rp);
+            res = ge_p2_eq_cofactored(&R, &Rq);
+        }
+    }
+err:
+    EVP_MD_free(sha512);
+    EVP_MD_CTX_free(hash_ctx);
+    return res;
+}
+
+/*
+ * Verify |num| signatures made with the same |public_key| at once. Returns 1
+ * only if all of them are valid, 0 otherwise, in which case the caller has
+ * to verify them one by one to find out which.
+ *
+ * With random 128-bit z[i], it is checked that
+ *
+ *      [sum(z[i]*s[i])]B - [sum(z[i]*h[i])]A == sum([z[i]]R[i])
+ *
+ * which holds if all of [s[i]]B - [h[i]]A == R[i] hold, and otherwise fails
+ * with overwhelming probability.
+ *
+ * Both sides are multiplied by the cofactor 8 before they are compared, so
+ * components of small order in A or any R[i] drop out instead of cancelling
+ * each other depending on z[i]. This matches the cofactored equation ossl_ed25519_verify()
+ * falls back to, so the result is the same as that of verifying the
+ * signatures one by one. A and every R[i] must have a canonical encoding,
+ * otherwise 0 is returned and the caller verifies them one by one.
+ */
+int
+ossl_ed25519_verify_batch(const uint8_t *const *tbs, const size_t *tbs_len,
+                          const uint8_t *const *signatures, size_t num,
+                          const uint8_t public_key[32],
+                          const uint8_t dom2flag, const uint8_t phflag,
+                          const uint8_t csflag, const uint8_t *context,
+                          size_t context_len, OSSL_LIB_CTX *libctx,
+                          const char *propq)
+{
+    ge_p3 A, R, M;
+    ge_p2 Q, Mq;
+    ge_cached *Rc = NULL;
+    uint8_t (*z)[16] = NULL;
+    EVP_MD *sha512 = NULL;
+    EVP_MD_CTX *hash_ctx = NULL;
+    unsigned int sz;
+    int res = 0;
+    size_t i;
+    uint8_t h[SHA512_DIGEST_LENGTH];
+    uint8_t zi[32] = { 0 };
+    uint8_t S[32] = { 0 }, H[32] = { 0 };
+
+    if (context == NULL)
+        context_len = 0;
+
+    /* Same checks as in ossl_ed25519_verify() */
+    if (csflag && context_len == 0)
+        return 0;
+    if (!dom2flag && context_len > 0)
+        return 0;
+
+    if (num == 0)
+        return 1;
+
+    if (ge_frombytes_strict_vartime(&A, public_key) != 0)
+        return 0;
+
+    gfe_neg(A.X, A.X);
+    gfe_neg(A.T, A.T);
+
+    Rc = OPENSSL_malloc(num * sizeof(*Rc));
+    z = OPENSSL_malloc(num * sizeof(*z));
+    if (Rc == NULL || z == NULL)
+        goto err;
+    if (RAND_bytes_ex(libctx, (unsigned char *)z, num * sizeof(*z), 0) <= 0)
+        goto err;
+
+    sha512 = EVP_MD_fetch(libctx, SN_sha512, propq);
+    if (sha512 == NULL)
+        goto err;
+    hash_ctx = EVP_MD_CTX_new();
+    if (hash_ctx == NULL)
+        goto err;
+
+    for (i = 0; i < num; i++) {
+        const uint8_t *r = signatures[i];
+        const uint8_t *s = signatures[i] + 32;
+
+        if (!sc_is_reduced(s) || ge_frombytes_strict_vartime(&R, r) != 0)
+            goto err;
+        ge_p3_to_cached(&Rc[i], &R);
+
+        if (!hash_init_with_dom(hash_ctx, sha512, dom2flag, phflag, context,
+                                context_len)
+            || !EVP_DigestUpdate(hash_ctx, r, 32)
+            || !EVP_DigestUpdate(hash_ctx, public_key, 32)
+            || !EVP_DigestUpdate(hash_ctx, tbs[i], tbs_len[i])
+            || !EVP_DigestFinal_ex(hash_ctx, h, &sz))
+            goto err;
+        x25519_sc_reduce(h);
+
+        memcpy(zi, z[i], sizeof(z[i]));
+        sc_muladd(S, zi, s, S);
+        sc_muladd(H, zi, h, H);
+    }
+
+    /* Q = [H](-A) + [S]B and M = sum([z[i]]R[i]) */
+    ge_double_scalarmult_vartime(&Q, H, &A, S);
+    if (!ge_multi_scalarmult_vartime(&M, (const uint8_t (*)[16])z, Rc, num))
+        goto err;
+
+    ge_p3_to_p2(&Mq, &M);
+    if (!ge_p2_eq_cofactored(&Q, &Mq))
+        goto err;
+
+    res = 1;
 err:
     EVP_MD_free(sha512);
     EVP_MD_CTX_free(hash_ctx);
+    OPENSSL_free(Rc);
+    OPENSSL_free(z);
     return res;
 }
 
@@ -5708,7 +6235,7 @@ ossl_x25519_public_from_private(uint8_t out_public_value[32],
 {
     uint8_t e[32];
     ge_p3 A;
-    fe zplusy, zminusy, zminusy_inv;
+    gfe zplusy, zminusy, zminusy_inv;
 
     memcpy(e, private_key, 32);
     e[0] &= 248;
@@ -5722,11 +6249,11 @@ ossl_x25519_public_from_private(uint8_t out_public_value[32],
      * The map is u=(y+1)/(1-y). Since y=Y/Z, this gives
      * u=(Z+Y)/(Z-Y).
      */
-    fe_add(zplusy, A.Z, A.Y);
-    fe_sub(zminusy, A.Z, A.Y);
-    fe_invert(zminusy_inv, zminusy);
-    fe_mul(zplusy, zplusy, zminusy_inv);
-    fe_tobytes(out_public_value, zplusy);
+    gfe_add(zplusy, A.Z, A.Y);
+    gfe_sub(zminusy, A.Z, A.Y);
+    gfe_invert(zminusy_inv, zminusy);
+    gfe_mul(zplusy, zplusy, zminusy_inv);
+    gfe_tobytes(out_public_value, zplusy);
 
     OPENSSL_cleanse(e, sizeof(e));
 }
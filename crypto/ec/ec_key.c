@@ -18,6 +18,8 @@
 #include <string.h>
 #include "ec_local.h"
 #include "internal/refcount.h"
+#include "internal/core.h"
+#include "internal/rcu.h"
 #include <openssl/err.h>
 #ifndef FIPS_MODULE
 # include <openssl/engine.h>
@@ -99,6 +101,8 @@ void EC_KEY_free(EC_KEY *r)
     EC_POINT_free(r->pub_key);
     BN_clear_free(r->priv_key);
     OPENSSL_free(r->propq);
+    ossl_ec_point_pre_comp_free(r->pub_pre_comp);
+    CRYPTO_THREAD_lock_free(r->lock);
 
     OPENSSL_clear_free((void *)r, sizeof(EC_KEY));
 }
@@ -690,6 +694,148 @@ err:
     return ok;
 }
 
+/*
+ * Returns nonzero if multiples of points other than the generator can be
+ * precomputed for |group|.
+ */
+static int ec_group_can_precompute_point(const EC_GROUP *group)
+{
+    return group->meth->mul == 0 || group->meth->point_precompute_mult != 0;
+}
+
+/*
+ * Returns the lock that protects the precomputed multiples of the public key
+ * of |eckey|.  Most keys never get any, so it is only made when first needed.
+ */
+static CRYPTO_RWLOCK *ec_key_get0_lock(EC_KEY *eckey)
+{
+    CRYPTO_RWLOCK *lock = ossl_rcu_deref(&eckey->lock);
+
+    if (lock != NULL)
+        return lock;
+    if (!ossl_lib_ctx_write_lock(eckey->libctx))
+        return NULL;
+    if ((lock = eckey->lock) == NULL
+        && (lock = CRYPTO_THREAD_lock_new()) != NULL)
+        ossl_rcu_assign_ptr(&eckey->lock, &lock);
+    ossl_lib_ctx_unlock(eckey->libctx);
+    return lock;
+}
+
+/*
+ * Replaces the precomputed multiples of the public key of |eckey| with new
+ * ones.  Called with the write lock held.
+ */
+static int ec_key_pub_precompute(EC_KEY *eckey, BN_CTX *ctx)
+{
+    EC_POINT_PRE_COMP *pre;
+
+    if (eckey->group == NULL || eckey->pub_key == NULL) {
+        ERR_raise(ERR_LIB_EC, EC_R_MISSING_PARAMETERS);
+        return 0;
+    }
+    if (!ossl_ec_point_precompute_mult(eckey->group, eckey->pub_key, &pre,
+                                       ctx))
+        return 0;
+
+    ossl_ec_point_pre_comp_free(eckey->pub_pre_comp);
+    eckey->pub_pre_comp = pre;
+    eckey->pub_pre_comp_dirty_cnt = eckey->dirty_cnt;
+    return 1;
+}
+
+/*
+ * Precomputes multiples of the public key of |eckey| to speed up later
+ * verifications.  Succeeds without doing anything for groups that have no
+ * support for this.
+ */
+int ossl_ec_key_precompute_public(EC_KEY *eckey)
+{
+    CRYPTO_RWLOCK *lock;
+    BN_CTX *ctx;
+    int ret = 0;
+
+    if (eckey->group != NULL && !ec_group_can_precompute_point(eckey->group))
+        return 1;
+    if ((lock = ec_key_get0_lock(eckey)) == NULL
+        || (ctx = BN_CTX_new_ex(eckey->libctx)) == NULL)
+        return 0;
+    if (CRYPTO_THREAD_write_lock(lock)) {
+        ret = ec_key_pub_precompute(eckey, ctx);
+        CRYPTO_THREAD_unlock(lock);
+    }
+    BN_CTX_free(ctx);
+    return ret;
+}
+
+/*
+ * Returns a reference to the precomputed multiples of the public key of
+ * |eckey|, or NULL if there are none.  They are made on the
+ * EC_KEY_PUB_PRE_COMP_THRESHOLD-th call, so keys that only verify a few
+ * signatures do not pay for them, nor for the lock that protects them.  They
+ * are dropped if the key has been modified since.  The caller must release
+ * the reference with ossl_ec_point_pre_comp_free(), as |eckey| may replace
+ * them at any time.
+ */
+EC_POINT_PRE_COMP *ossl_ec_key_get1_pub_pre_comp(EC_KEY *eckey, BN_CTX *ctx)
+{
+    EC_POINT_PRE_COMP *pre = NULL;
+    CRYPTO_RWLOCK *lock;
+    int stale = 0, count;
+
+    if (!ec_group_can_precompute_point(eckey->group))
+        return NULL;
+
+    /* Without a lock there cannot be any precomputed multiples yet */
+    if ((lock = ossl_rcu_deref(&eckey->lock)) != NULL) {
+        if (!CRYPTO_THREAD_read_lock(lock))
+            return NULL;
+        if (eckey->pub_pre_comp != NULL) {
+            if (eckey->pub_pre_comp_dirty_cnt == eckey->dirty_cnt)
+                pre = ossl_ec_point_pre_comp_dup(eckey->pub_pre_comp);
+            else
+                stale = 1;
+        }
+        CRYPTO_THREAD_unlock(lock);
+        if (pre != NULL)
+            return pre;
+    }
+
+    if (stale) {
+        if (!CRYPTO_THREAD_write_lock(lock))
+            return NULL;
+        if (eckey->pub_pre_comp != NULL
+            && eckey->pub_pre_comp_dirty_cnt != eckey->dirty_cnt) {
+            ossl_ec_point_pre_comp_free(eckey->pub_pre_comp);
+            eckey->pub_pre_comp = NULL;
+            eckey->verify_count = 0;
+        }
+        CRYPTO_THREAD_unlock(lock);
+    }
+
+    /*
+     * The count needs atomics as there is no lock to fall back on, without
+     * them no multiples are made.
+     */
+    if (!CRYPTO_atomic_load_int(&eckey->verify_count, &count, NULL)
+        || count >= EC_KEY_PUB_PRE_COMP_THRESHOLD
+        || !CRYPTO_atomic_add(&eckey->verify_count, 1, &count, NULL)
+        || count != EC_KEY_PUB_PRE_COMP_THRESHOLD)
+        return NULL;
+
+    /* Failing to precompute is not an error for the caller */
+    ERR_set_mark();
+    if ((lock = ec_key_get0_lock(eckey)) != NULL
+        && CRYPTO_THREAD_write_lock(lock)) {
+        if (eckey->pub_pre_comp == NULL)
+            ec_key_pub_precompute(eckey, ctx);
+        pre = ossl_ec_point_pre_comp_dup(eckey->pub_pre_comp);
+        CRYPTO_THREAD_unlock(lock);
+    }
+    ERR_pop_to_mark();
+    return pre;
+}
+
 int EC_KEY_set_public_key_affine_coordinates(EC_KEY *key, BIGNUM *x,
                                              BIGNUM *y)
 {
@@ -100,19 +100,20 @@ void EC_pre_comp_free(EC_GROUP *group)
     case PCT_nistp256:
         EC_nistp256_pre_comp_free(group->pre_comp.nistp256);
         break;
-    case PCT_nistp384:
-        ossl_ec_nistp384_pre_comp_free(group->pre_comp.nistp384);
-        break;
     case PCT_nistp521:
         EC_nistp521_pre_comp_free(group->pre_comp.nistp521);
         break;
 #else
     case PCT_nistp224:
     case PCT_nistp256:
-    case PCT_nistp384:
     case PCT_nistp521:
         break;
 #endif
+    case PCT_nistp384:
+#ifdef EC_NISTP384_ENABLED
+        ossl_ec_nistp384_pre_comp_free(group->pre_comp.nistp384);
+#endif
+        break;
     case PCT_ec:
         EC_ec_pre_comp_free(group->pre_comp.ec);
         break;
@@ -193,19 +194,20 @@ int EC_GROUP_copy(EC_GROUP *dest, const EC_GROUP *src)
     case PCT_nistp256:
         dest->pre_comp.nistp256 = EC_nistp256_pre_comp_dup(src->pre_comp.nistp256);
         break;
-    case PCT_nistp384:
-        dest->pre_comp.nistp384 = ossl_ec_nistp384_pre_comp_dup(src->pre_comp.nistp384);
-        break;
     case PCT_nistp521:
         dest->pre_comp.nistp521 = EC_nistp521_pre_comp_dup(src->pre_comp.nistp521);
         break;
 #else
     case PCT_nistp224:
     case PCT_nistp256:
-    case PCT_nistp384:
     case PCT_nistp521:
         break;
 #endif
+    case PCT_nistp384:
+#ifdef EC_NISTP384_ENABLED
+        dest->pre_comp.nistp384 = ossl_ec_nistp384_pre_comp_dup(src->pre_comp.nistp384);
+#endif
+        break;
     case PCT_ec:
         dest->pre_comp.ec = EC_ec_pre_comp_dup(src->pre_comp.ec);
         break;
@@ -1182,6 +1184,112 @@ int EC_GROUP_have_precompute_mult(const EC_GROUP *group)
 }
 #endif
 
+/*
+ * Precomputes multiples of |point| for use with ossl_ec_point_mul_pre_comp()
+ * and stores them in |*pre|.  If the group method has no support for this,
+ * |*pre| is set to NULL and success is returned, as there is nothing to do.
+ */
+int ossl_ec_point_precompute_mult(const EC_GROUP *group, const EC_POINT *point,
+                                  EC_POINT_PRE_COMP **pre, BN_CTX *ctx)
+{
+    *pre = NULL;
+    if (!ec_point_is_compat(point, group)) {
+        ERR_raise(ERR_LIB_EC, EC_R_INCOMPATIBLE_OBJECTS);
+        return 0;
+    }
+
+    if (group->meth->mul == 0)
+        /* use default */
+        *pre = ossl_ec_wNAF_point_precompute_mult(group, point, ctx);
+    else if (group->meth->point_precompute_mult != 0)
+        *pre = group->meth->point_precompute_mult(group, point, ctx);
+    else
+        return 1;               /* nothing to do, so report success */
+
+    return *pre != NULL;
+}
+
+/* r = g_scalar*generator + p_scalar*point, with |pre| made for point */
+int ossl_ec_point_mul_pre_comp(const EC_GROUP *group, EC_POINT *r,
+                               const BIGNUM *g_scalar,
+                               const EC_POINT_PRE_COMP *pre,
+                               const BIGNUM *p_scalar, BN_CTX *ctx)
+{
+    if (!ec_point_is_compat(r, group)) {
+        ERR_raise(ERR_LIB_EC, EC_R_INCOMPATIBLE_OBJECTS);
+        return 0;
+    }
+
+    if (group->meth->mul == 0)
+        /* use default */
+        return ossl_ec_wNAF_point_mul_pre_comp(group, r, g_scalar, pre,
+                                               p_scalar, ctx);
+
+    if (group->meth->point_mul_pre_comp == 0) {
+        ERR_raise(ERR_LIB_EC, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED);
+        return 0;
+    }
+    return group->meth->point_mul_pre_comp(group, r, g_scalar, pre, p_scalar,
+                                           ctx);
+}
+
+/* Allocates an empty EC_POINT_PRE_COMP for a table of the given PCT_xxx type */
+EC_POINT_PRE_COMP *ossl_ec_point_pre_comp_new(int type)
+{
+    EC_POINT_PRE_COMP *ret;
+
+    if ((ret = OPENSSL_zalloc(sizeof(*ret))) == NULL)
+        return NULL;
+    if (!CRYPTO_NEW_REF(&ret->references, 1)) {
+        OPENSSL_free(ret);
+        return NULL;
+    }
+    ret->type = type;
+    return ret;
+}
+
+EC_POINT_PRE_COMP *ossl_ec_point_pre_comp_dup(EC_POINT_PRE_COMP *pre)
+{
+    int i;
+
+    if (pre != NULL)
+        CRYPTO_UP_REF(&pre->references, &i);
+    return pre;
+}
+
+void ossl_ec_point_pre_comp_free(EC_POINT_PRE_COMP *pre)
+{
+    int i;
+
+    if (pre == NULL)
+        return;
+
+    CRYPTO_DOWN_REF(&pre->references, &i);
+    REF_PRINT_COUNT("EC_POINT_PRE_COMP", i, pre);
+    if (i > 0)
+        return;
+    REF_ASSERT_ISNT(i < 0);
+
+    switch (pre->type) {
+    case PCT_nistp384:
+#ifdef EC_NISTP384_ENABLED
+        ossl_ec_nistp384_pre_comp_free(pre->point.nistp384);
+#endif
+        break;
+    case PCT_nistz256:
+#ifdef ECP_NISTZ256_ASM
+        EC_nistz256_pre_comp_free(pre->point.nistz256);
+#endif
+        break;
+    case PCT_ec:
+        EC_ec_pre_comp_free(pre->point.ec);
+        break;
+    }
+    EC_ec_pre_comp_free(pre->generator);
+    CRYPTO_FREE_REF(&pre->references);
+    OPENSSL_free(pre);
+}
+
 /*
  * ec_precompute_mont_data sets |group->mont_data| from |group->order| and
  * returns one on success. On error it returns zero.
@@ -35,6 +35,8 @@
 typedef struct ec_method_st EC_METHOD;
 #endif
 
+typedef struct ec_point_pre_comp_st EC_POINT_PRE_COMP;
+
 /*
  * Structure details are not part of the exported interface, so all this may
  * change in future versions.
@@ -197,6 +199,23 @@ struct ec_method_st {
                        EC_POINT *r, EC_POINT *s,
                        EC_POINT *p, BN_CTX *ctx);
     int (*group_full_init)(EC_GROUP *group, const unsigned char *data);
+    /*
+     * used by ossl_ec_point_precompute_mult, ossl_ec_point_mul_pre_comp:
+     * precomputed multiples of a fixed point other than the generator, and
+     *
+     *   r := generator * g_scalar + point * p_scalar
+     *
+     * with 'point' taken from 'pre'.  Both are variable time and are only
+     * meant for public inputs such as verification keys.  Default
+     * implementations are used if the 'mul' pointer is 0.
+     */
+    EC_POINT_PRE_COMP *(*point_precompute_mult)(const EC_GROUP *group,
+                                                const EC_POINT *point,
+                                                BN_CTX *ctx);
+    int (*point_mul_pre_comp)(const EC_GROUP *group, EC_POINT *r,
+                              const BIGNUM *g_scalar,
+                              const EC_POINT_PRE_COMP *pre,
+                              const BIGNUM *p_scalar, BN_CTX *ctx);
 };
 
 /*
@@ -287,6 +306,30 @@ struct ec_group_st {
 #define HAVEPRECOMP(g, type) \
     g->pre_comp_type == PCT_##type && g->pre_comp.type != NULL
 
+/*
+ * Precomputed multiples of a fixed point other than the generator, such as
+ * a public key that verifies many signatures.  |type| is one of the PCT_xxx
+ * values above and names the member of |point| in use.  The tables are
+ * never modified once made, and are shared by reference counting.
+ */
+struct ec_point_pre_comp_st {
+    int type;
+    union {
+        NISTP384_PRE_COMP *nistp384;
+        NISTZ256_PRE_COMP *nistz256;
+        EC_PRE_COMP *ec;
+    } point;
+    /* PCT_ec only: multiples of the generator if the group has none */
+    EC_PRE_COMP *generator;
+    CRYPTO_REF_COUNT references;
+};
+
+/*
+ * Number of verifications with the same EC_KEY after which multiples of its
+ * public key are precomputed, see ossl_ec_key_get1_pub_pre_comp()
+ */
+#define EC_KEY_PUB_PRE_COMP_THRESHOLD   32
+
 struct ec_key_st {
     const EC_KEY_METHOD *meth;
     ENGINE *engine;
@@ -306,6 +349,12 @@ struct ec_key_st {
 
     /* Provider data */
     size_t dirty_cnt; /* If any key material changes, increment this */
+
+    /* Precomputed multiples of pub_key for repeated verification */
+    CRYPTO_RWLOCK *lock;
+    EC_POINT_PRE_COMP *pub_pre_comp;
+    size_t pub_pre_comp_dirty_cnt;
+    int verify_count;
 };
 
 struct ec_point_st {
@@ -349,6 +398,17 @@ void EC_nistp521_pre_comp_free(NISTP521_PRE_COMP *);
 void EC_nistz256_pre_comp_free(NISTZ256_PRE_COMP *);
 void EC_ec_pre_comp_free(EC_PRE_COMP *);
 
+int ossl_ec_point_precompute_mult(const EC_GROUP *group, const EC_POINT *point,
+                                  EC_POINT_PRE_COMP **pre, BN_CTX *ctx);
+int ossl_ec_point_mul_pre_comp(const EC_GROUP *group, EC_POINT *r,
+                               const BIGNUM *g_scalar,
+                               const EC_POINT_PRE_COMP *pre,
+                               const BIGNUM *p_scalar, BN_CTX *ctx);
+EC_POINT_PRE_COMP *ossl_ec_point_pre_comp_new(int type);
+EC_POINT_PRE_COMP *ossl_ec_point_pre_comp_dup(EC_POINT_PRE_COMP *pre);
+void ossl_ec_point_pre_comp_free(EC_POINT_PRE_COMP *pre);
+EC_POINT_PRE_COMP *ossl_ec_key_get1_pub_pre_comp(EC_KEY *eckey, BN_CTX *ctx);
+
 /*
  * method functions in ec_mult.c (ec_lib.c uses these as defaults if
  * group->method->mul is 0)
@@ -358,6 +418,13 @@ int ossl_ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
                      const BIGNUM *scalars[], BN_CTX *);
 int ossl_ec_wNAF_precompute_mult(EC_GROUP *group, BN_CTX *);
 int ossl_ec_wNAF_have_precompute_mult(const EC_GROUP *group);
+EC_POINT_PRE_COMP *ossl_ec_wNAF_point_precompute_mult(const EC_GROUP *group,
+                                                      const EC_POINT *point,
+                                                      BN_CTX *ctx);
+int ossl_ec_wNAF_point_mul_pre_comp(const EC_GROUP *group, EC_POINT *r,
+                                    const BIGNUM *g_scalar,
+                                    const EC_POINT_PRE_COMP *pre,
+                                    const BIGNUM *p_scalar, BN_CTX *ctx);
 
 /* method functions in ecp_smpl.c */
 int ossl_ec_GFp_simple_group_init(EC_GROUP *);
@@ -556,46 +623,63 @@ int ossl_ec_GFp_nistp256_points_mul(const EC_GROUP *group, EC_POINT *r,
 int ossl_ec_GFp_nistp256_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
 int ossl_ec_GFp_nistp256_have_precompute_mult(const EC_GROUP *group);
 
-/* method functions in ecp_nistp384.c */
-int ossl_ec_GFp_nistp384_group_init(EC_GROUP *group);
-int ossl_ec_GFp_nistp384_group_set_curve(EC_GROUP *group, const BIGNUM *p,
+/* method functions in ecp_nistp521.c */
+int ossl_ec_GFp_nistp521_group_init(EC_GROUP *group);
+int ossl_ec_GFp_nistp521_group_set_curve(EC_GROUP *group, const BIGNUM *p,
                                          const BIGNUM *a, const BIGNUM *n,
                                          BN_CTX *);
-int ossl_ec_GFp_nistp384_point_get_affine_coordinates(const EC_GROUP *group,
+int ossl_ec_GFp_nistp521_point_get_affine_coordinates(const EC_GROUP *group,
                                                       const EC_POINT *point,
                                                       BIGNUM *x, BIGNUM *y,
                                                       BN_CTX *ctx);
-int ossl_ec_GFp_nistp384_mul(const EC_GROUP *group, EC_POINT *r,
+int ossl_ec_GFp_nistp521_mul(const EC_GROUP *group, EC_POINT *r,
                              const BIGNUM *scalar, size_t num,
                              const EC_POINT *points[], const BIGNUM *scalars[],
                              BN_CTX *);
-int ossl_ec_GFp_nistp384_points_mul(const EC_GROUP *group, EC_POINT *r,
+int ossl_ec_GFp_nistp521_points_mul(const EC_GROUP *group, EC_POINT *r,
                                     const BIGNUM *scalar, size_t num,
                                     const EC_POINT *points[],
                                     const BIGNUM *scalars[], BN_CTX *ctx);
-int ossl_ec_GFp_nistp384_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
-int ossl_ec_GFp_nistp384_have_precompute_mult(const EC_GROUP *group);
-const EC_METHOD *ossl_ec_GFp_nistp384_method(void);
+int ossl_ec_GFp_nistp521_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
+int ossl_ec_GFp_nistp521_have_precompute_mult(const EC_GROUP *group);
 
-/* method functions in ecp_nistp521.c */
-int ossl_ec_GFp_nistp521_group_init(EC_GROUP *group);
-int ossl_ec_GFp_nistp521_group_set_curve(EC_GROUP *group, const BIGNUM *p,
+#endif
+
+/*
+ * On x86_64, ecp_nistp384.c is built even if ec_nistp_64_gcc_128 is
+ * disabled, see build.info.
+ */
+#if !defined(OPENSSL_NO_EC_NISTP_64_GCC_128) || defined(ECP_NISTP384_X86_64)
+# define EC_NISTP384_ENABLED
+
+/* method functions in ecp_nistp384.c */
+int ossl_ec_GFp_nistp384_group_init(EC_GROUP *group);
+int ossl_ec_GFp_nistp384_group_set_curve(EC_GROUP *group, const BIGNUM *p,
                                          const BIGNUM *a, const BIGNUM *n,
                                          BN_CTX *);
-int ossl_ec_GFp_nistp521_point_get_affine_coordinates(const EC_GROUP *group,
+int ossl_ec_GFp_nistp384_point_get_affine_coordinates(const EC_GROUP *group,
                                                       const EC_POINT *point,
                                                       BIGNUM *x, BIGNUM *y,
                                                       BN_CTX *ctx);
-int ossl_ec_GFp_nistp521_mul(const EC_GROUP *group, EC_POINT *r,
+int ossl_ec_GFp_nistp384_mul(const EC_GROUP *group, EC_POINT *r,
                              const BIGNUM *scalar, size_t num,
                              const EC_POINT *points[], const BIGNUM *scalars[],
                              BN_CTX *);
-int ossl_ec_GFp_nistp521_points_mul(const EC_GROUP *group, EC_POINT *r,
+int ossl_ec_GFp_nistp384_points_mul(const EC_GROUP *group, EC_POINT *r,
                                     const BIGNUM *scalar, size_t num,
                                     const EC_POINT *points[],
                                     const BIGNUM *scalars[], BN_CTX *ctx);
-int ossl_ec_GFp_nistp521_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
-int ossl_ec_GFp_nistp521_have_precompute_mult(const EC_GROUP *group);
+int ossl_ec_GFp_nistp384_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
+int ossl_ec_GFp_nistp384_have_precompute_mult(const EC_GROUP *group);
+EC_POINT_PRE_COMP *
+ossl_ec_GFp_nistp384_point_precompute_mult(const EC_GROUP *group,
+                                           const EC_POINT *point, BN_CTX *ctx);
+int ossl_ec_GFp_nistp384_point_mul_pre_comp(const EC_GROUP *group, EC_POINT *r,
+                                            const BIGNUM *g_scalar,
+                                            const EC_POINT_PRE_COMP *pre,
+                                            const BIGNUM *p_scalar,
+                                            BN_CTX *ctx);
+const EC_METHOD *ossl_ec_GFp_nistp384_method(void);
 
 /* utility functions in ecp_nistputil.c */
 void ossl_ec_GFp_nistp_points_make_affine_internal(size_t num, void *point_array,
@@ -401,33 +401,33 @@ int ossl_ec_scalar_mul_ladder(const EC_GROUP *group, EC_POINT *r,
  *      scalar*generator
  * in the addition if scalar != NULL
  */
+static int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
+                       const EC_POINT *generator, const EC_PRE_COMP *pre_comp,
+                       size_t num, const EC_POINT *points[],
+                       const BIGNUM *scalars[], BN_CTX *ctx);
+
+/*
+ * Returns the precomputed multiples of |generator| attached to |group|, or
+ * NULL if there are none or they were made for a different generator.
+ */
+static const EC_PRE_COMP *ec_wNAF_generator_pre_comp(const EC_GROUP *group,
+                                                     const EC_POINT *generator,
+                                                     BN_CTX *ctx)
+{
+    const EC_PRE_COMP *pre_comp = group->pre_comp.ec;
+
+    if (pre_comp != NULL && pre_comp->numblocks
+        && EC_POINT_cmp(group, generator, pre_comp->points[0], ctx) == 0)
+        return pre_comp;
+    return NULL;
+}
+
 int ossl_ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
                      size_t num, const EC_POINT *points[],
                      const BIGNUM *scalars[], BN_CTX *ctx)
 {
     const EC_POINT *generator = NULL;
-    EC_POINT *tmp = NULL;
-    size_t totalnum;
-    size_t blocksize = 0, numblocks = 0; /* for wNAF splitting */
-    size_t pre_points_per_block = 0;
-    size_t i, j;
-    int k;
-    int r_is_inverted = 0;
-    int r_is_at_infinity = 1;
-    size_t *wsize = NULL;       /* individual window sizes */
-    signed char **wNAF = NULL;  /* individual wNAFs */
-    size_t *wNAF_len = NULL;
-    size_t max_len = 0;
-    size_t num_val;
-    EC_POINT **val = NULL;      /* precomputation */
-    EC_POINT **v;
-    EC_POINT ***val_sub = NULL; /* pointers to sub-arrays of 'val' or
-                                 * 'pre_comp->points' */
     const EC_PRE_COMP *pre_comp = NULL;
-    int num_scalar = 0;         /* flag: will be set to 1 if 'scalar' must be
-                                 * treated like other scalars, i.e.
-                                 * precomputation is not available */
-    int ret = 0;
 
     if (!BN_is_zero(group->order) && !BN_is_zero(group->cofactor)) {
         /*-
@@ -463,15 +463,50 @@ int ossl_ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
         generator = EC_GROUP_get0_generator(group);
         if (generator == NULL) {
             ERR_raise(ERR_LIB_EC, EC_R_UNDEFINED_GENERATOR);
-            goto err;
+            return 0;
         }
 
         /* look if we can use precomputed multiples of generator */
+        pre_comp = ec_wNAF_generator_pre_comp(group, generator, ctx);
+    }
+
+    return ec_wNAF_mul(group, r, scalar, generator, pre_comp, num, points,
+                       scalars, ctx);
+}
 
-        pre_comp = group->pre_comp.ec;
-        if (pre_comp && pre_comp->numblocks
-            && (EC_POINT_cmp(group, generator, pre_comp->points[0], ctx) ==
-                0)) {
+/*
+ * Computes r = scalar*generator + sum(scalars[i]*points[i]) in variable
+ * time, using the multiples of |generator| in |pre_comp| if it is not NULL.
+ */
+static int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
+                       const EC_POINT *generator, const EC_PRE_COMP *pre_comp,
+                       size_t num, const EC_POINT *points[],
+                       const BIGNUM *scalars[], BN_CTX *ctx)
+{
+    EC_POINT *tmp = NULL;
+    size_t totalnum;
+    size_t blocksize = 0, numblocks = 0; /* for wNAF splitting */
+    size_t pre_points_per_block = 0;
+    size_t i, j;
+    int k;
+    int r_is_inverted = 0;
+    int r_is_at_infinity = 1;
+    size_t *wsize = NULL;       /* individual window sizes */
+    signed char **wNAF = NULL;  /* individual wNAFs */
+    size_t *wNAF_len = NULL;
+    size_t max_len = 0;
+    size_t num_val;
+    EC_POINT **val = NULL;      /* precomputation */
+    EC_POINT **v;
+    EC_POINT ***val_sub = NULL; /* pointers to sub-arrays of 'val' or
+                                 * 'pre_comp->points' */
+    int num_scalar = 0;         /* flag: will be set to 1 if 'scalar' must be
+                                 * treated like other scalars, i.e.
+                                 * precomputation is not available */
+    int ret = 0;
+
+    if (scalar != NULL) {
+        if (pre_comp != NULL) {
             blocksize = pre_comp->blocksize;
 
             /*
@@ -495,7 +530,6 @@ int ossl_ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
             }
         } else {
             /* can't use precomputation */
-            pre_comp = NULL;
             numblocks = 1;
             num_scalar = 1;     /* treat 'scalar' like 'num'-th element of
                                  * 'scalars' */
@@ -799,9 +833,10 @@ int ossl_ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
 }
 
 /*-
- * ossl_ec_wNAF_precompute_mult()
- * creates an EC_PRE_COMP object with preprecomputed multiples of the generator
- * for use with wNAF splitting as implemented in ossl_ec_wNAF_mul().
+ * ec_wNAF_precompute()
+ * creates an EC_PRE_COMP object with preprecomputed multiples of 'generator'
+ * for use with wNAF splitting as implemented in ossl_ec_wNAF_mul().  This is
+ * normally the group generator, but any other fixed point works the same.
  *
  * 'pre_comp->points' is an array of multiples of the generator
  * of the following form:
@@ -818,28 +853,25 @@ int ossl_ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
  * points[2^(w-1)*numblocks-1]     = (2^(w-1)) *  2^(blocksize*(numblocks-1)) * generator
  * points[2^(w-1)*numblocks]       = NULL
  */
-int ossl_ec_wNAF_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
+static EC_PRE_COMP *ec_wNAF_precompute(const EC_GROUP *group,
+                                       const EC_POINT *generator,
+                                       BN_CTX *ctx)
 {
-    const EC_POINT *generator;
     EC_POINT *tmp_point = NULL, *base = NULL, **var;
     const BIGNUM *order;
     size_t i, bits, w, pre_points_per_block, blocksize, numblocks, num;
     EC_POINT **points = NULL;
-    EC_PRE_COMP *pre_comp;
-    int ret = 0;
+    EC_PRE_COMP *pre_comp, *ret = NULL;
     int used_ctx = 0;
 #ifndef FIPS_MODULE
     BN_CTX *new_ctx = NULL;
 #endif
 
-    /* if there is an old EC_PRE_COMP object, throw it away */
-    EC_pre_comp_free(group);
     if ((pre_comp = ec_pre_comp_new(group)) == NULL)
-        return 0;
+        return NULL;
 
-    generator = EC_GROUP_get0_generator(group);
-    if (generator == NULL) {
-        ERR_raise(ERR_LIB_EC, EC_R_UNDEFINED_GENERATOR);
+    if (EC_POINT_is_at_infinity(group, generator)) {
+        ERR_raise(ERR_LIB_EC, EC_R_POINT_AT_INFINITY);
         goto err;
     }
 
@@ -954,9 +986,8 @@ int ossl_ec_wNAF_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
     pre_comp->points = points;
     points = NULL;
     pre_comp->num = num;
-    SETPRECOMP(group, ec, pre_comp);
+    ret = pre_comp;
     pre_comp = NULL;
-    ret = 1;
 
  err:
     if (used_ctx)
@@ -977,7 +1008,101 @@ int ossl_ec_wNAF_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
     return ret;
 }
 
+int ossl_ec_wNAF_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
+{
+    const EC_POINT *generator;
+    EC_PRE_COMP *pre_comp;
+
+    /* if there is an old EC_PRE_COMP object, throw it away */
+    EC_pre_comp_free(group);
+
+    generator = EC_GROUP_get0_generator(group);
+    if (generator == NULL) {
+        ERR_raise(ERR_LIB_EC, EC_R_UNDEFINED_GENERATOR);
+        return 0;
+    }
+
+    if ((pre_comp = ec_wNAF_precompute(group, generator, ctx)) == NULL)
+        return 0;
+    SETPRECOMP(group, ec, pre_comp);
+    return 1;
+}
+
 int ossl_ec_wNAF_have_precompute_mult(const EC_GROUP *group)
 {
     return HAVEPRECOMP(group, ec);
 }
+
+/*
+ * Precomputes multiples of |point| for ossl_ec_wNAF_point_mul_pre_comp().
+ * Unless the group already has them, multiples of the generator are made
+ * as well, so that both halves of a verification can use wNAF splitting.
+ */
+EC_POINT_PRE_COMP *ossl_ec_wNAF_point_precompute_mult(const EC_GROUP *group,
+                                                      const EC_POINT *point,
+                                                      BN_CTX *ctx)
+{
+    const EC_POINT *generator = EC_GROUP_get0_generator(group);
+    EC_POINT_PRE_COMP *ret;
+
+    if (generator == NULL) {
+        ERR_raise(ERR_LIB_EC, EC_R_UNDEFINED_GENERATOR);
+        return NULL;
+    }
+    if ((ret = ossl_ec_point_pre_comp_new(PCT_ec)) == NULL)
+        return NULL;
+
+    if ((ret->point.ec = ec_wNAF_precompute(group, point, ctx)) == NULL
+        || (ec_wNAF_generator_pre_comp(group, generator, ctx) == NULL
+            && (ret->generator = ec_wNAF_precompute(group, generator,
+                                                    ctx)) == NULL)) {
+        ossl_ec_point_pre_comp_free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+/*
+ * Computes r = g_scalar*generator + p_scalar*point, where |pre| holds the
+ * multiples of |point|.  This is the variable time wNAF method, so it must
+ * only be used with public scalars, as in signature verification.
+ */
+int ossl_ec_wNAF_point_mul_pre_comp(const EC_GROUP *group, EC_POINT *r,
+                                    const BIGNUM *g_scalar,
+                                    const EC_POINT_PRE_COMP *pre,
+                                    const BIGNUM *p_scalar, BN_CTX *ctx)
+{
+    const EC_POINT *generator;
+    const EC_PRE_COMP *g_pre;
+    EC_POINT *tmp;
+    int ret = 0;
+
+    if (pre->type != PCT_ec) {
+        ERR_raise(ERR_LIB_EC, ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+    if (g_scalar == NULL)
+        return ec_wNAF_mul(group, r, p_scalar, pre->point.ec->points[0],
+                           pre->point.ec, 0, NULL, NULL, ctx);
+
+    generator = EC_GROUP_get0_generator(group);
+    if (generator == NULL) {
+        ERR_raise(ERR_LIB_EC, EC_R_UNDEFINED_GENERATOR);
+        return 0;
+    }
+    if ((g_pre = pre->generator) == NULL)
+        g_pre = ec_wNAF_generator_pre_comp(group, generator, ctx);
+
+    if ((tmp = EC_POINT_new(group)) == NULL)
+        return 0;
+    if (!ec_wNAF_mul(group, r, g_scalar, generator, g_pre, 0, NULL, NULL, ctx)
+        || (p_scalar != NULL
+            && (!ec_wNAF_mul(group, tmp, p_scalar, pre->point.ec->points[0],
+                             pre->point.ec, 0, NULL, NULL, ctx)
+                || !EC_POINT_add(group, r, r, tmp, ctx))))
+        goto err;
+    ret = 1;
+ err:
+    EC_POINT_free(tmp);
+    return ret;
+}
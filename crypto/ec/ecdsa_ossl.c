@@ -451,6 +451,7 @@ int ossl_ecdsa_simple_verify_sig(const unsigned char *dgst, int dgst_len,
     EC_POINT *point = NULL;
     const EC_GROUP *group;
     const EC_POINT *pub_key;
+    EC_POINT_PRE_COMP *pre = NULL;
 
     /* check input values */
     if (eckey == NULL || (group = EC_KEY_get0_group(eckey)) == NULL ||
@@ -528,7 +529,11 @@ int ossl_ecdsa_simple_verify_sig(const unsigned char *dgst, int dgst_len,
         ERR_raise(ERR_LIB_EC, ERR_R_EC_LIB);
         goto err;
     }
-    if (!EC_POINT_mul(group, point, u1, pub_key, u2, ctx)) {
+    /* Keys that verify many signatures get a table of their multiples */
+    pre = ossl_ec_key_get1_pub_pre_comp(eckey, ctx);
+    if (pre != NULL
+        ? !ossl_ec_point_mul_pre_comp(group, point, u1, pre, u2, ctx)
+        : !EC_POINT_mul(group, point, u1, pub_key, u2, ctx)) {
         ERR_raise(ERR_LIB_EC, ERR_R_EC_LIB);
         goto err;
     }
@@ -548,5 +553,6 @@ int ossl_ecdsa_simple_verify_sig(const unsigned char *dgst, int dgst_len,
     BN_CTX_end(ctx);
     BN_CTX_free(ctx);
     EC_POINT_free(point);
+    ossl_ec_point_pre_comp_free(pre);
     return ret;
 }
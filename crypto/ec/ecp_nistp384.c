@@ -1490,6 +1490,62 @@ static void batch_mul(felem x_out, felem y_out, felem z_out,
     felem_assign(z_out, nq[2]);
 }
 
+/*
+ * Computes scalar1*P1 + scalar2*P2 with comb tables in the format of
+ * g_pre_comp for both points, doubling once per round for both.  scalar2 and
+ * pre_comp2 may be NULL.  Output point (X, Y, Z) is stored in x_out, y_out,
+ * z_out
+ */
+static void comb_mul(felem x_out, felem y_out, felem z_out,
+                     const u8 *scalar1, const felem pre_comp1[16][3],
+                     const u8 *scalar2, const felem pre_comp2[16][3])
+{
+    int i, j, skip;
+    const u8 *scalar;
+    const felem (*pre_comp)[3];
+    felem nq[3], tmp[3];
+    limb bits;
+
+    /* set nq to the point at infinity */
+    memset(nq, 0, sizeof(nq));
+
+    skip = 1;                   /* save two point operations in the first
+                                 * round */
+    for (i = 98; i >= 0; --i) {
+        /* double */
+        if (!skip)
+            point_double(nq[0], nq[1], nq[2], nq[0], nq[1], nq[2]);
+
+        for (j = 0; j < 2; j++) {
+            scalar = j == 0 ? scalar1 : scalar2;
+            pre_comp = j == 0 ? pre_comp1 : pre_comp2;
+            if (scalar == NULL)
+                continue;
+
+            bits = get_bit(scalar, i + 285) << 3;
+            if (i < 95) {
+                bits |= get_bit(scalar, i + 190) << 2;
+                bits |= get_bit(scalar, i + 95) << 1;
+                bits |= get_bit(scalar, i);
+            }
+            /* select the point to add, in constant time */
+            select_point(bits, 16, pre_comp, tmp);
+            if (!skip) {
+                /* The 1 argument below is for "mixed" */
+                point_add(nq[0],  nq[1],  nq[2],
+                          nq[0],  nq[1],  nq[2], 1,
+                          tmp[0], tmp[1], tmp[2]);
+            } else {
+                memcpy(nq, tmp, 3 * sizeof(felem));
+                skip = 0;
+            }
+        }
+    }
+    felem_assign(x_out, nq[0]);
+    felem_assign(y_out, nq[1]);
+    felem_assign(z_out, nq[2]);
+}
+
 /* Precomputation for the group generator. */
 struct nistp384_pre_comp_st {
     felem g_pre_comp[16][3];
@@ -1554,7 +1610,10 @@ const EC_METHOD *ossl_ec_GFp_nistp384_method(void)
         0, /* blind_coordinates */
         0, /* ladder_pre */
         0, /* ladder_step */
-        0  /* ladder_post */
+        0, /* ladder_post */
+        0, /* group_full_init */
+        ossl_ec_GFp_nistp384_point_precompute_mult,
+        ossl_ec_GFp_nistp384_point_mul_pre_comp
     };
 
     return &ret;
@@ -1703,8 +1762,8 @@ int ossl_ec_GFp_nistp384_point_get_affine_coordinates(const EC_GROUP *group,
 }
 
 /* points below is of size |num|, and tmp_felems is of size |num+1/ */
-static void make_points_affine(size_t num, felem points[][3],
-                               felem tmp_felems[])
+static void make_points_affine(size_t num, felem (*points)[3],
+                               felem *tmp_felems)
 {
     /*
      * Runs in constant time, unless an input is the point at infinity (which
@@ -1927,14 +1986,65 @@ int ossl_ec_GFp_nistp384_points_mul(const EC_GROUP *group, EC_POINT *r,
     return ret;
 }
 
+/*
+ * Fills |pre_comp| with the multiples of |point| that batch_mul() takes in
+ * g_pre_comp: entry i is the sum of those of P, 2^95*P, 2^190*P and 2^285*P
+ * selected by the bits of i, in affine form.
+ */
+static int nistp384_comb_precompute(felem pre_comp[16][3],
+                                    const EC_POINT *point)
+{
+    int i, j;
+    felem tmp_felems[16];
+
+    if ((!BN_to_felem(pre_comp[1][0], point->X)) ||
+        (!BN_to_felem(pre_comp[1][1], point->Y)) ||
+        (!BN_to_felem(pre_comp[1][2], point->Z)))
+        return 0;
+    /* compute 2^95*P, 2^190*P, 2^285*P */
+    for (i = 1; i <= 4; i <<= 1) {
+        point_double(pre_comp[2 * i][0], pre_comp[2 * i][1], pre_comp[2 * i][2],
+                     pre_comp[i][0],  pre_comp[i][1],    pre_comp[i][2]);
+        for (j = 0; j < 94; ++j) {
+            point_double(pre_comp[2 * i][0], pre_comp[2 * i][1], pre_comp[2 * i][2],
+                         pre_comp[2 * i][0], pre_comp[2 * i][1], pre_comp[2 * i][2]);
+        }
+    }
+    /* pre_comp[0] is the point at infinity */
+    memset(pre_comp[0], 0, sizeof(pre_comp[0]));
+    /* the remaining multiples */
+    /* 2^95*P + 2^190*P */
+    point_add(pre_comp[6][0],  pre_comp[6][1],  pre_comp[6][2],
+              pre_comp[4][0],  pre_comp[4][1],  pre_comp[4][2], 0,
+              pre_comp[2][0],  pre_comp[2][1],  pre_comp[2][2]);
+    /* 2^95*P + 2^285*P */
+    point_add(pre_comp[10][0], pre_comp[10][1], pre_comp[10][2],
+              pre_comp[8][0],  pre_comp[8][1],  pre_comp[8][2], 0,
+              pre_comp[2][0],  pre_comp[2][1],  pre_comp[2][2]);
+    /* 2^190*P + 2^285*P */
+    point_add(pre_comp[12][0], pre_comp[12][1], pre_comp[12][2],
+              pre_comp[8][0],  pre_comp[8][1],  pre_comp[8][2], 0,
+              pre_comp[4][0],  pre_comp[4][1],  pre_comp[4][2]);
+    /* 2^95*P + 2^190*P + 2^285*P */
+    point_add(pre_comp[14][0], pre_comp[14][1], pre_comp[14][2],
+              pre_comp[12][0], pre_comp[12][1], pre_comp[12][2], 0,
+              pre_comp[2][0],  pre_comp[2][1],  pre_comp[2][2]);
+    for (i = 1; i < 8; ++i) {
+        /* odd multiples: add P */
+        point_add(pre_comp[2 * i + 1][0], pre_comp[2 * i + 1][1], pre_comp[2 * i + 1][2],
+                  pre_comp[2 * i][0],     pre_comp[2 * i][1],     pre_comp[2 * i][2], 0,
+                  pre_comp[1][0],         pre_comp[1][1],         pre_comp[1][2]);
+    }
+    make_points_affine(15, &(pre_comp[1]), tmp_felems);
+    return 1;
+}
+
 int ossl_ec_GFp_nistp384_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
 {
     int ret = 0;
     NISTP384_PRE_COMP *pre = NULL;
-    int i, j;
     BIGNUM *x, *y;
     EC_POINT *generator = NULL;
-    felem tmp_felems[16];
 #ifndef FIPS_MODULE
     BN_CTX *new_ctx = NULL;
 #endif
@@ -1973,45 +2083,8 @@ int ossl_ec_GFp_nistp384_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
         memcpy(pre->g_pre_comp, gmul, sizeof(pre->g_pre_comp));
         goto done;
     }
-    if ((!BN_to_felem(pre->g_pre_comp[1][0], group->generator->X)) ||
-        (!BN_to_felem(pre->g_pre_comp[1][1], group->generator->Y)) ||
-        (!BN_to_felem(pre->g_pre_comp[1][2], group->generator->Z)))
+    if (!nistp384_comb_precompute(pre->g_pre_comp, group->generator))
         goto err;
-    /* compute 2^95*G, 2^190*G, 2^285*G */
-    for (i = 1; i <= 4; i <<= 1) {
-        point_double(pre->g_pre_comp[2 * i][0], pre->g_pre_comp[2 * i][1], pre->g_pre_comp[2 * i][2],
-                     pre->g_pre_comp[i][0],  pre->g_pre_comp[i][1],    pre->g_pre_comp[i][2]);
-        for (j = 0; j < 94; ++j) {
-            point_double(pre->g_pre_comp[2 * i][0], pre->g_pre_comp[2 * i][1], pre->g_pre_comp[2 * i][2],
-                         pre->g_pre_comp[2 * i][0], pre->g_pre_comp[2 * i][1], pre->g_pre_comp[2 * i][2]);
-        }
-    }
-    /* g_pre_comp[0] is the point at infinity */
-    memset(pre->g_pre_comp[0], 0, sizeof(pre->g_pre_comp[0]));
-    /* the remaining multiples */
-    /* 2^95*G + 2^190*G */
-    point_add(pre->g_pre_comp[6][0],  pre->g_pre_comp[6][1],  pre->g_pre_comp[6][2],
-              pre->g_pre_comp[4][0],  pre->g_pre_comp[4][1],  pre->g_pre_comp[4][2], 0,
-              pre->g_pre_comp[2][0],  pre->g_pre_comp[2][1],  pre->g_pre_comp[2][2]);
-    /* 2^95*G + 2^285*G */
-    point_add(pre->g_pre_comp[10][0], pre->g_pre_comp[10][1], pre->g_pre_comp[10][2],
-              pre->g_pre_comp[8][0],  pre->g_pre_comp[8][1],  pre->g_pre_comp[8][2], 0,
-              pre->g_pre_comp[2][0],  pre->g_pre_comp[2][1],  pre->g_pre_comp[2][2]);
-    /* 2^190*G + 2^285*G */
-    point_add(pre->g_pre_comp[12][0], pre->g_pre_comp[12][1], pre->g_pre_comp[12][2],
-              pre->g_pre_comp[8][0],  pre->g_pre_comp[8][1],  pre->g_pre_comp[8][2], 0,
-              pre->g_pre_comp[4][0],  pre->g_pre_comp[4][1],  pre->g_pre_comp[4][2]);
-    /* 2^95*G + 2^190*G + 2^285*G */
-    point_add(pre->g_pre_comp[14][0], pre->g_pre_comp[14][1], pre->g_pre_comp[14][2],
-              pre->g_pre_comp[12][0], pre->g_pre_comp[12][1], pre->g_pre_comp[12][2], 0,
-              pre->g_pre_comp[2][0],  pre->g_pre_comp[2][1],  pre->g_pre_comp[2][2]);
-    for (i = 1; i < 8; ++i) {
-        /* odd multiples: add G */
-        point_add(pre->g_pre_comp[2 * i + 1][0], pre->g_pre_comp[2 * i + 1][1], pre->g_pre_comp[2 * i + 1][2],
-                  pre->g_pre_comp[2 * i][0],     pre->g_pre_comp[2 * i][1],     pre->g_pre_comp[2 * i][2], 0,
-                  pre->g_pre_comp[1][0],         pre->g_pre_comp[1][1],         pre->g_pre_comp[1][2]);
-    }
-    make_points_affine(15, &(pre->g_pre_comp[1]), tmp_felems);
 
  done:
     SETPRECOMP(group, nistp384, pre);
@@ -2031,3 +2104,138 @@ int ossl_ec_GFp_nistp384_have_precompute_mult(const EC_GROUP *group)
 {
     return HAVEPRECOMP(group, nistp384);
 }
+
+/*
+ * Makes a table like the one of the generator for |point|, so that its
+ * multiples need a quarter of the doublings in
+ * ossl_ec_GFp_nistp384_point_mul_pre_comp().
+ */
+EC_POINT_PRE_COMP *
+ossl_ec_GFp_nistp384_point_precompute_mult(const EC_GROUP *group,
+                                           const EC_POINT *point, BN_CTX *ctx)
+{
+    EC_POINT_PRE_COMP *ret;
+
+    if (EC_POINT_is_at_infinity(group, point)) {
+        ERR_raise(ERR_LIB_EC, EC_R_POINT_AT_INFINITY);
+        return NULL;
+    }
+    if ((ret = ossl_ec_point_pre_comp_new(PCT_nistp384)) == NULL)
+        return NULL;
+    if ((ret->point.nistp384 = nistp384_pre_comp_new()) == NULL
+        || !nistp384_comb_precompute(ret->point.nistp384->g_pre_comp,
+                                     point)) {
+        ossl_ec_point_pre_comp_free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+/* Writes |scalar| reduced to 0 <= scalar < 2^384 to |out| */
+static int nistp384_scalar_to_bytes(felem_bytearray out, const BIGNUM *scalar,
+                                    const EC_GROUP *group, BIGNUM *tmp,
+                                    BN_CTX *ctx)
+{
+    if ((BN_num_bits(scalar) > 384) || (BN_is_negative(scalar))) {
+        if (!BN_nnmod(tmp, scalar, group->order, ctx)) {
+            ERR_raise(ERR_LIB_EC, ERR_R_BN_LIB);
+            return 0;
+        }
+        scalar = tmp;
+    }
+    if (BN_bn2lebinpad(scalar, out, sizeof(felem_bytearray)) < 0) {
+        ERR_raise(ERR_LIB_EC, ERR_R_BN_LIB);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Computes r = g_scalar*generator + p_scalar*point, where |pre| holds the
+ * table of |point|.  If the generator has a table too, both multiples are
+ * computed with the same doublings, otherwise they are added up at the end.
+ */
+int ossl_ec_GFp_nistp384_point_mul_pre_comp(const EC_GROUP *group, EC_POINT *r,
+                                            const BIGNUM *g_scalar,
+                                            const EC_POINT_PRE_COMP *pre,
+                                            const BIGNUM *p_scalar,
+                                            BN_CTX *ctx)
+{
+    int ret = 0, have_pre_comp;
+    BIGNUM *x, *y, *z, *tmp_scalar;
+    felem_bytearray g_secret, p_secret;
+    felem x_in, y_in, z_in, x_out, y_out, z_out;
+    const NISTP384_PRE_COMP *g_pre;
+    const felem (*g_pre_comp)[3];
+    const felem (*p_pre_comp)[3];
+
+    if (pre->type != PCT_nistp384) {
+        ERR_raise(ERR_LIB_EC, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+    p_pre_comp = (const felem(*)[3])pre->point.nistp384->g_pre_comp;
+
+    BN_CTX_start(ctx);
+    x = BN_CTX_get(ctx);
+    y = BN_CTX_get(ctx);
+    z = BN_CTX_get(ctx);
+    tmp_scalar = BN_CTX_get(ctx);
+    if (tmp_scalar == NULL)
+        goto err;
+
+    /*
+     * check that the generator table, if any, matches the generator, which
+     * is in affine form unless it has been set up unusually
+     */
+    g_pre = group->pre_comp.nistp384;
+    if (g_pre != NULL)
+        g_pre_comp = (const felem(*)[3])g_pre->g_pre_comp;
+    else
+        g_pre_comp = (const felem(*)[3])gmul;
+    if (felem_to_BN(x, g_pre_comp[1][0]) == NULL
+        || felem_to_BN(y, g_pre_comp[1][1]) == NULL) {
+        ERR_raise(ERR_LIB_EC, ERR_R_BN_LIB);
+        goto err;
+    }
+    have_pre_comp = g_scalar != NULL && group->generator->Z_is_one
+        && BN_cmp(group->generator->X, x) == 0
+        && BN_cmp(group->generator->Y, y) == 0;
+
+    if (!nistp384_scalar_to_bytes(p_secret, p_scalar, group, tmp_scalar,
+                                  ctx))
+        goto err;
+    if (have_pre_comp) {
+        if (!nistp384_scalar_to_bytes(g_secret, g_scalar, group, tmp_scalar,
+                                      ctx))
+            goto err;
+        comb_mul(x_out, y_out, z_out, g_secret, g_pre_comp,
+                 p_secret, p_pre_comp);
+    } else {
+        /* r = g_scalar*generator, treating the generator as a random point */
+        if (!ossl_ec_GFp_nistp384_points_mul(group, r, g_scalar, 0, NULL,
+                                             NULL, ctx))
+            goto err;
+        comb_mul(x_out, y_out, z_out, p_secret, p_pre_comp, NULL, NULL);
+        if ((!BN_to_felem(x_in, r->X)) || (!BN_to_felem(y_in, r->Y))
+            || (!BN_to_felem(z_in, r->Z)))
+            goto err;
+        point_add(x_out, y_out, z_out, x_out, y_out, z_out, 0,
+                  x_in, y_in, z_in);
+    }
+
+    /* reduce the output to its unique minimal representation */
+    felem_contract(x_in, x_out);
+    felem_contract(y_in, y_out);
+    felem_contract(z_in, z_out);
+    if ((!felem_to_BN(x, x_in)) || (!felem_to_BN(y, y_in)) ||
+        (!felem_to_BN(z, z_in))) {
+        ERR_raise(ERR_LIB_EC, ERR_R_BN_LIB);
+        goto err;
+    }
+    ret = ossl_ec_GFp_simple_set_Jprojective_coordinates_GFp(group, r, x, y, z,
+                                                             ctx);
+
+ err:
+    BN_CTX_end(ctx);
+    return ret;
+}
@@ -935,6 +935,121 @@ __owur static int ecp_nistz256_set_from_affine(EC_POINT *out, const EC_GROUP *gr
     return ret;
 }
 
+/*
+ * r = scalar*P, where |table| holds the multiples of P that
+ * ecp_nistz256_mult_precompute() makes for the generator.
+ */
+__owur static int ecp_nistz256_comb_mul(const EC_GROUP *group, P256_POINT *r,
+                                        const BIGNUM *scalar,
+                                        const PRECOMP256_ROW *table,
+                                        BN_CTX *ctx)
+{
+    int i, ret = 0;
+    unsigned char p_str[33] = { 0 };
+    unsigned int idx = 0;
+    const unsigned int window_size = 7;
+    const unsigned int mask = (1 << (window_size + 1)) - 1;
+    unsigned int wvalue;
+    ALIGN32 union {
+        P256_POINT p;
+        P256_POINT_AFFINE a;
+    } t, p;
+    BN_ULONG infty;
+    BIGNUM *tmp_scalar;
+
+    BN_CTX_start(ctx);
+
+    if ((BN_num_bits(scalar) > 256)
+        || BN_is_negative(scalar)) {
+        if ((tmp_scalar = BN_CTX_get(ctx)) == NULL)
+            goto err;
+
+        if (!BN_nnmod(tmp_scalar, scalar, group->order, ctx)) {
+            ERR_raise(ERR_LIB_EC, ERR_R_BN_LIB);
+            goto err;
+        }
+        scalar = tmp_scalar;
+    }
+
+    for (i = 0; i < bn_get_top(scalar) * BN_BYTES; i += BN_BYTES) {
+        BN_ULONG d = bn_get_words(scalar)[i / BN_BYTES];
+
+        p_str[i + 0] = (unsigned char)d;
+        p_str[i + 1] = (unsigned char)(d >> 8);
+        p_str[i + 2] = (unsigned char)(d >> 16);
+        p_str[i + 3] = (unsigned char)(d >>= 24);
+        if (BN_BYTES == 8) {
+            d >>= 8;
+            p_str[i + 4] = (unsigned char)d;
+            p_str[i + 5] = (unsigned char)(d >> 8);
+            p_str[i + 6] = (unsigned char)(d >> 16);
+            p_str[i + 7] = (unsigned char)(d >> 24);
+        }
+    }
+
+    for (; i < 33; i++)
+        p_str[i] = 0;
+
+    /* First window */
+    wvalue = (p_str[0] << 1) & mask;
+    idx += window_size;
+
+    wvalue = _booth_recode_w7(wvalue);
+
+    ecp_nistz256_gather_w7(&p.a, table[0], wvalue >> 1);
+
+    ecp_nistz256_neg(p.p.Z, p.p.Y);
+    copy_conditional(p.p.Y, p.p.Z, wvalue & 1);
+
+    /*
+     * Since affine infinity is encoded as (0,0) and
+     * Jacobian is (,,0), we need to harmonize them
+     * by assigning "one" or zero to Z.
+     */
+    infty = (p.p.X[0] | p.p.X[1] | p.p.X[2] | p.p.X[3] |
+             p.p.Y[0] | p.p.Y[1] | p.p.Y[2] | p.p.Y[3]);
+    if (P256_LIMBS == 8)
+        infty |= (p.p.X[4] | p.p.X[5] | p.p.X[6] | p.p.X[7] |
+                  p.p.Y[4] | p.p.Y[5] | p.p.Y[6] | p.p.Y[7]);
+
+    infty = 0 - is_zero(infty);
+    infty = ~infty;
+
+    p.p.Z[0] = ONE[0] & infty;
+    p.p.Z[1] = ONE[1] & infty;
+    p.p.Z[2] = ONE[2] & infty;
+    p.p.Z[3] = ONE[3] & infty;
+    if (P256_LIMBS == 8) {
+        p.p.Z[4] = ONE[4] & infty;
+        p.p.Z[5] = ONE[5] & infty;
+        p.p.Z[6] = ONE[6] & infty;
+        p.p.Z[7] = ONE[7] & infty;
+    }
+
+    for (i = 1; i < 37; i++) {
+        unsigned int off = (idx - 1) / 8;
+        wvalue = p_str[off] | p_str[off + 1] << 8;
+        wvalue = (wvalue >> ((idx - 1) % 8)) & mask;
+        idx += window_size;
+
+        wvalue = _booth_recode_w7(wvalue);
+
+        ecp_nistz256_gather_w7(&t.a, table[i], wvalue >> 1);
+
+        ecp_nistz256_neg(t.p.Z, t.a.Y);
+        copy_conditional(t.a.Y, t.p.Z, wvalue & 1);
+
+        ecp_nistz256_point_add_affine(&p.p, &p.p, &t.a);
+    }
+
+    memcpy(r, &p.p, sizeof(*r));
+    ret = 1;
+
+ err:
+    BN_CTX_end(ctx);
+    return ret;
+}
+
 /* r = scalar*G + sum(scalars[i]*points[i]) */
 __owur static int ecp_nistz256_points_mul(const EC_GROUP *group,
                                           EC_POINT *r,
@@ -943,22 +1058,16 @@ __owur static int ecp_nistz256_points_mul(const EC_GROUP *group,
                                           const EC_POINT *points[],
                                           const BIGNUM *scalars[], BN_CTX *ctx)
 {
-    int i = 0, ret = 0, no_precomp_for_generator = 0, p_is_infinity = 0;
-    unsigned char p_str[33] = { 0 };
+    int ret = 0, no_precomp_for_generator = 0, p_is_infinity = 0;
     const PRECOMP256_ROW *preComputedTable = NULL;
     const NISTZ256_PRE_COMP *pre_comp = NULL;
     const EC_POINT *generator = NULL;
     const BIGNUM **new_scalars = NULL;
     const EC_POINT **new_points = NULL;
-    unsigned int idx = 0;
-    const unsigned int window_size = 7;
-    const unsigned int mask = (1 << (window_size + 1)) - 1;
-    unsigned int wvalue;
     ALIGN32 union {
         P256_POINT p;
         P256_POINT_AFFINE a;
     } t, p;
-    BIGNUM *tmp_scalar;
 
     if ((num + 1) == 0 || (num + 1) > OPENSSL_MALLOC_MAX_NELEMS(void *)) {
         ERR_raise(ERR_LIB_EC, ERR_R_PASSED_INVALID_ARGUMENT);
@@ -1011,92 +1120,9 @@ __owur static int ecp_nistz256_points_mul(const EC_GROUP *group,
         }
 
         if (preComputedTable) {
-            BN_ULONG infty;
-
-            if ((BN_num_bits(scalar) > 256)
-                || BN_is_negative(scalar)) {
-                if ((tmp_scalar = BN_CTX_get(ctx)) == NULL)
-                    goto err;
-
-                if (!BN_nnmod(tmp_scalar, scalar, group->order, ctx)) {
-                    ERR_raise(ERR_LIB_EC, ERR_R_BN_LIB);
-                    goto err;
-                }
-                scalar = tmp_scalar;
-            }
-
-            for (i = 0; i < bn_get_top(scalar) * BN_BYTES; i += BN_BYTES) {
-                BN_ULONG d = bn_get_words(scalar)[i / BN_BYTES];
-
-                p_str[i + 0] = (unsigned char)d;
-                p_str[i + 1] = (unsigned char)(d >> 8);
-                p_str[i + 2] = (unsigned char)(d >> 16);
-                p_str[i + 3] = (unsigned char)(d >>= 24);
-                if (BN_BYTES == 8) {
-                    d >>= 8;
-                    p_str[i + 4] = (unsigned char)d;
-                    p_str[i + 5] = (unsigned char)(d >> 8);
-                    p_str[i + 6] = (unsigned char)(d >> 16);
-                    p_str[i + 7] = (unsigned char)(d >> 24);
-                }
-            }
-
-            for (; i < 33; i++)
-                p_str[i] = 0;
-
-            /* First window */
-            wvalue = (p_str[0] << 1) & mask;
-            idx += window_size;
-
-            wvalue = _booth_recode_w7(wvalue);
-
-            ecp_nistz256_gather_w7(&p.a, preComputedTable[0],
-                                   wvalue >> 1);
-
-            ecp_nistz256_neg(p.p.Z, p.p.Y);
-            copy_conditional(p.p.Y, p.p.Z, wvalue & 1);
-
-            /*
-             * Since affine infinity is encoded as (0,0) and
-             * Jacobian is (,,0), we need to harmonize them
-             * by assigning "one" or zero to Z.
-             */
-            infty = (p.p.X[0] | p.p.X[1] | p.p.X[2] | p.p.X[3] |
-                     p.p.Y[0] | p.p.Y[1] | p.p.Y[2] | p.p.Y[3]);
-            if (P256_LIMBS == 8)
-                infty |= (p.p.X[4] | p.p.X[5] | p.p.X[6] | p.p.X[7] |
-                          p.p.Y[4] | p.p.Y[5] | p.p.Y[6] | p.p.Y[7]);
-
-            infty = 0 - is_zero(infty);
-            infty = ~infty;
-
-            p.p.Z[0] = ONE[0] & infty;
-            p.p.Z[1] = ONE[1] & infty;
-            p.p.Z[2] = ONE[2] & infty;
-            p.p.Z[3] = ONE[3] & infty;
-            if (P256_LIMBS == 8) {
-                p.p.Z[4] = ONE[4] & infty;
-                p.p.Z[5] = ONE[5] & infty;
-                p.p.Z[6] = ONE[6] & infty;
-                p.p.Z[7] = ONE[7] & infty;
-            }
-
-            for (i = 1; i < 37; i++) {
-                unsigned int off = (idx - 1) / 8;
-                wvalue = p_str[off] | p_str[off + 1] << 8;
-                wvalue = (wvalue >> ((idx - 1) % 8)) & mask;
-                idx += window_size;
-
-                wvalue = _booth_recode_w7(wvalue);
-
-                ecp_nistz256_gather_w7(&t.a,
-                                       preComputedTable[i], wvalue >> 1);
-
-                ecp_nistz256_neg(t.p.Z, t.a.Y);
-                copy_conditional(t.a.Y, t.p.Z, wvalue & 1);
-
-                ecp_nistz256_point_add_affine(&p.p, &p.p, &t.a);
-            }
+            if (!ecp_nistz256_comb_mul(group, &p.p, scalar, preComputedTable,
+                                       ctx))
+                goto err;
         } else {
             p_is_infinity = 1;
             no_precomp_for_generator = 1;
@@ -1262,6 +1288,147 @@ static int ecp_nistz256_window_have_precompute_mult(const EC_GROUP *group)
     return HAVEPRECOMP(group, nistz256);
 }
 
+/*
+ * Makes a table of multiples of |point| in the layout of the generator table,
+ * for ecp_nistz256_comb_mul().  This is done for public keys that verify many
+ * signatures, so unlike ecp_nistz256_mult_precompute() it works on
+ * P256_POINTs and makes each row affine with a single inversion.
+ */
+static NISTZ256_PRE_COMP *ecp_nistz256_comb_precompute(const EC_GROUP *group,
+                                                       const EC_POINT *point)
+{
+    NISTZ256_PRE_COMP *pre_comp = NULL;
+    PRECOMP256_ROW *table;
+    unsigned char *precomp_storage = NULL;
+    void *row_storage = NULL;
+    P256_POINT *row;
+    BN_ULONG (*prod)[P256_LIMBS];
+    BN_ULONG z_inv[P256_LIMBS], z_inv_k[P256_LIMBS], z_inv2[P256_LIMBS];
+    ALIGN32 P256_POINT_AFFINE temp;
+    int j, k;
+
+    if (EC_POINT_is_at_infinity(group, point)) {
+        ERR_raise(ERR_LIB_EC, EC_R_POINT_AT_INFINITY);
+        return NULL;
+    }
+
+    if ((pre_comp = ecp_nistz256_pre_comp_new(group)) == NULL
+        || (precomp_storage =
+            OPENSSL_malloc(37 * 64 * sizeof(P256_POINT_AFFINE) + 64)) == NULL
+        || (row_storage =
+            OPENSSL_malloc(64 * (sizeof(P256_POINT) + sizeof(*prod))
+                           + 64)) == NULL)
+        goto err;
+
+    table = (void *)ALIGNPTR(precomp_storage, 64);
+    row = (void *)ALIGNPTR(row_storage, 64);
+    prod = (void *)(row + 64);
+
+    if (!ecp_nistz256_bignum_to_field_elem(row[0].X, point->X)
+        || !ecp_nistz256_bignum_to_field_elem(row[0].Y, point->Y)
+        || !ecp_nistz256_bignum_to_field_elem(row[0].Z, point->Z)) {
+        ERR_raise(ERR_LIB_EC, EC_R_COORDINATES_OUT_OF_RANGE);
+        goto err;
+    }
+
+    for (j = 0; j < 37; j++) {
+        /* row[k] = (k + 1) * 2^(7 * j) * point */
+        ecp_nistz256_point_double(&row[1], &row[0]);
+        for (k = 2; k < 64; k++)
+            ecp_nistz256_point_add(&row[k], &row[k - 1], &row[0]);
+
+        /* prod[k] is the product of the Z coordinates of row[0..k] */
+        memcpy(prod[0], row[0].Z, sizeof(prod[0]));
+        for (k = 1; k < 64; k++)
+            ecp_nistz256_mul_mont(prod[k], prod[k - 1], row[k].Z);
+        ecp_nistz256_mod_inverse(z_inv, prod[63]);
+
+        for (k = 63; k >= 0; k--) {
+            if (k > 0) {
+                ecp_nistz256_mul_mont(z_inv_k, z_inv, prod[k - 1]);
+                ecp_nistz256_mul_mont(z_inv, z_inv, row[k].Z);
+            } else {
+                memcpy(z_inv_k, z_inv, sizeof(z_inv_k));
+            }
+            ecp_nistz256_sqr_mont(z_inv2, z_inv_k);
+            ecp_nistz256_mul_mont(temp.X, z_inv2, row[k].X);
+            ecp_nistz256_mul_mont(z_inv2, z_inv2, z_inv_k);
+            ecp_nistz256_mul_mont(temp.Y, z_inv2, row[k].Y);
+            ecp_nistz256_scatter_w7(table[j], &temp, k);
+        }
+
+        /* the next row starts at 2^7 times the first point of this one */
+        ecp_nistz256_point_double(&row[0], &row[63]);
+    }
+
+    pre_comp->w = 7;
+    pre_comp->precomp = table;
+    pre_comp->precomp_storage = precomp_storage;
+    OPENSSL_free(row_storage);
+    return pre_comp;
+
+ err:
+    EC_nistz256_pre_comp_free(pre_comp);
+    OPENSSL_free(precomp_storage);
+    OPENSSL_free(row_storage);
+    return NULL;
+}
+
+static EC_POINT_PRE_COMP *
+ecp_nistz256_point_precompute_mult(const EC_GROUP *group,
+                                   const EC_POINT *point, BN_CTX *ctx)
+{
+    EC_POINT_PRE_COMP *ret;
+
+    if ((ret = ossl_ec_point_pre_comp_new(PCT_nistz256)) == NULL)
+        return NULL;
+    if ((ret->point.nistz256 = ecp_nistz256_comb_precompute(group,
+                                                            point)) == NULL) {
+        ossl_ec_point_pre_comp_free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+/* r = g_scalar*G + p_scalar*point, where |pre| holds the table of point */
+__owur static int ecp_nistz256_point_mul_pre_comp(const EC_GROUP *group,
+                                                  EC_POINT *r,
+                                                  const BIGNUM *g_scalar,
+                                                  const EC_POINT_PRE_COMP *pre,
+                                                  const BIGNUM *p_scalar,
+                                                  BN_CTX *ctx)
+{
+    ALIGN32 P256_POINT p, q;
+
+    if (pre->type != PCT_nistz256) {
+        ERR_raise(ERR_LIB_EC, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+
+    if (!ecp_nistz256_points_mul(group, r, g_scalar, 0, NULL, NULL, ctx)
+        || !ecp_nistz256_comb_mul(group, &p, p_scalar,
+                                  (const PRECOMP256_ROW *)
+                                  pre->point.nistz256->precomp, ctx))
+        return 0;
+
+    if (!ecp_nistz256_bignum_to_field_elem(q.X, r->X)
+        || !ecp_nistz256_bignum_to_field_elem(q.Y, r->Y)
+        || !ecp_nistz256_bignum_to_field_elem(q.Z, r->Z)) {
+        ERR_raise(ERR_LIB_EC, EC_R_COORDINATES_OUT_OF_RANGE);
+        return 0;
+    }
+    ecp_nistz256_point_add(&p, &p, &q);
+
+    /* Not constant-time, but we're only operating on the public output. */
+    if (!bn_set_words(r->X, p.X, P256_LIMBS) ||
+        !bn_set_words(r->Y, p.Y, P256_LIMBS) ||
+        !bn_set_words(r->Z, p.Z, P256_LIMBS))
+        return 0;
+    r->Z_is_one = is_one(r->Z) & 1;
+
+    return 1;
+}
+
 #if defined(__x86_64) || defined(__x86_64__) || \
     defined(_M_AMD64) || defined(_M_X64) || \
     defined(__powerpc64__) || defined(_ARCH_PP64) || \
@@ -1627,7 +1794,9 @@ const EC_METHOD *EC_GFp_nistz256_method(void)
         0,                                          /* ladder_pre */
         0,                                          /* ladder_step */
         0,                                          /* ladder_post */
-        ecp_nistz256group_full_init
+        ecp_nistz256group_full_init,
+        ecp_nistz256_point_precompute_mult,
+        ecp_nistz256_point_mul_pre_comp
     };
 
     return &ret;
@@ -143,6 +143,11 @@ static void *evp_signature_from_algorithm(int name_id,
             signature->verify_message_final
                 = OSSL_FUNC_signature_verify_message_final(fns);
             break;
+        case OSSL_FUNC_SIGNATURE_VERIFY_BATCH:
+            if (signature->verify_batch != NULL)
+                break;
+            signature->verify_batch = OSSL_FUNC_signature_verify_batch(fns);
+            break;
         case OSSL_FUNC_SIGNATURE_VERIFY_RECOVER_INIT:
             if (signature->verify_recover_init != NULL)
                 break;
@@ -1193,6 +1198,77 @@ int EVP_PKEY_verify(EVP_PKEY_CTX *ctx,
     return ctx->pmeth->verify(ctx, sig, siglen, tbs, tbslen);
 }
 
+int EVP_PKEY_verify_batch(EVP_PKEY_CTX *ctx,
+                          const unsigned char *const *sigs,
+                          const size_t *siglens,
+                          const unsigned char *const *tbs,
+                          const size_t *tbslens, size_t num, int *results)
+{
+    EVP_SIGNATURE *signature;
+    const char *desc;
+    size_t i;
+    int ret, all = 1;
+
+    if (ctx == NULL || (num > 0 && (sigs == NULL || siglens == NULL
+                                    || tbs == NULL || tbslens == NULL))) {
+        ERR_raise(ERR_LIB_EVP, ERR_R_PASSED_NULL_PARAMETER);
+        return -1;
+    }
+
+    if (ctx->operation != EVP_PKEY_OP_VERIFY
+        && ctx->operation != EVP_PKEY_OP_VERIFYMSG) {
+        ERR_raise(ERR_LIB_EVP, EVP_R_OPERATION_NOT_INITIALIZED);
+        return -1;
+    }
+
+    if (ctx->op.sig.algctx == NULL)
+        goto legacy;
+
+    signature = ctx->op.sig.signature;
+    desc = signature->description != NULL ? signature->description : "";
+    if (signature->verify_batch != NULL) {
+        ret = signature->verify_batch(ctx->op.sig.algctx, sigs, siglens,
+                                      tbs, tbslens, num, results);
+        if (ret <= 0)
+            ERR_raise_data(ERR_LIB_EVP, EVP_R_PROVIDER_SIGNATURE_FAILURE,
+                           "%s verify_batch:%s", signature->type_name, desc);
+        return ret;
+    }
+    if (signature->verify == NULL) {
+        ERR_raise_data(ERR_LIB_EVP, EVP_R_PROVIDER_SIGNATURE_NOT_SUPPORTED,
+                       "%s verify:%s", signature->type_name, desc);
+        return -2;
+    }
+
+    /* No batch support in the provider, verify one by one */
+    for (i = 0; i < num; i++) {
+        ret = signature->verify(ctx->op.sig.algctx, sigs[i], siglens[i],
+                                tbs[i], tbslens[i]);
+        if (results != NULL)
+            results[i] = ret > 0;
+        if (ret <= 0)
+            all = 0;
+    }
+    if (!all)
+        ERR_raise_data(ERR_LIB_EVP, EVP_R_PROVIDER_SIGNATURE_FAILURE,
+                       "%s verify:%s", signature->type_name, desc);
+    return all;
+ legacy:
+    if (ctx->pmeth == NULL || ctx->pmeth->verify == NULL) {
+        ERR_raise(ERR_LIB_EVP, EVP_R_OPERATION_NOT_SUPPORTED_FOR_THIS_KEYTYPE);
+        return -2;
+    }
+
+    for (i = 0; i < num; i++) {
+        ret = ctx->pmeth->verify(ctx, sigs[i], siglens[i], tbs[i], tbslens[i]);
+        if (results != NULL)
+            results[i] = ret > 0;
+        if (ret <= 0)
+            all = 0;
+    }
+    return all;
+}
+
 int EVP_PKEY_verify_recover_init(EVP_PKEY_CTX *ctx)
 {
     return evp_pkey_signature_init(ctx, NULL, EVP_PKEY_OP_VERIFYRECOVER, NULL);
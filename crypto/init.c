@@ -488,6 +488,9 @@ void OPENSSL_cleanup(void)
     OSSL_TRACE(INIT, "OPENSSL_cleanup: ossl_trace_cleanup()\n");
     ossl_trace_cleanup();
 
+    OSSL_TRACE(INIT, "OPENSSL_cleanup: ossl_mem_arena_cleanup()\n");
+    ossl_mem_arena_cleanup();
+
     base_inited = 0;
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright 1995-2024 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 1995-2025 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -208,6 +208,9 @@ void *CRYPTO_malloc(size_t num, const char *file, int line)
         allow_customize = 0;
     }
 
+    /* Arenas are only used with the default allocator */
+    if ((ptr = ossl_mem_arena_alloc(num)) != NULL)
+        return ptr;
     ptr = malloc(num);
     if (ossl_likely(ptr != NULL))
         return ptr;
@@ -299,7 +302,19 @@ void *CRYPTO_aligned_alloc(size_t num, size_t alignment, void **freeptr,
 
 void *CRYPTO_realloc(void *str, size_t num, const char *file, int line)
 {
+    size_t old_num;
+    void *ret;
+
     INCREMENT(realloc_count);
+    if (ossl_mem_arena_size(str, &old_num)) {
+        /* Arena allocations cannot grow in place */
+        ret = NULL;
+        if (num > 0 && (ret = CRYPTO_malloc(num, file, line)) != NULL)
+            memcpy(ret, str, old_num < num ? old_num : num);
+        if (num == 0 || ret != NULL)
+            CRYPTO_free(str, file, line);
+        return ret;
+    }
     if (realloc_impl != CRYPTO_realloc)
         return realloc_impl(str, num, file, line);
 
@@ -345,6 +360,8 @@ void *CRYPTO_clear_realloc(void *str, size_t old_len, size_t num,
 void CRYPTO_free(void *str, const char *file, int line)
 {
     INCREMENT(free_count);
+    if (ossl_mem_arena_free(str))
+        return;
     if (free_impl != CRYPTO_free) {
         free_impl(str, file, line);
         return;
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Thread scoped allocation arenas, see CRYPTO_arena_begin(3).
+ *
+ * While a thread is inside an arena scope, small CRYPTO_malloc() requests are
+ * carved out of the current slab of its arena with a bump pointer.  Slabs are
+ * ARENA_SLAB_SIZE bytes aligned to their size and are all taken from a single
+ * address range reserved up front, so CRYPTO_free() can tell an arena pointer
+ * from any other with two comparisons, and finds its slab by masking it.
+ *
+ * The thread owning a slab counts the allocations it makes from it without
+ * atomics, while CRYPTO_free() atomically decrements the slab's reference
+ * count, which therefore goes negative.  When the owner moves on to another
+ * slab or leaves the scope it adds its count, and whoever brings the
+ * reference count to zero puts the slab back on the free list.  Allocations
+ * that outlive the scope therefore stay valid, they merely keep their slab.
+ *
+ * Arenas are only used when the default allocator is in place, and only
+ * threads that called CRYPTO_arena_begin() have one.  Other threads only
+ * pay for an atomic load of the number of arenas while any exist.
+ */
+
+#include <string.h>
+#include "internal/cryptlib.h"
+#include "internal/thread_once.h"
+#include "crypto/cryptlib.h"
+
+#if defined(OPENSSL_SYS_UNIX)
+# include <sys/types.h>
+# include <sys/mman.h>
+# if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
+#  define MAP_ANON MAP_ANONYMOUS
+# endif
+# if defined(MAP_ANON)
+#  define ARENA_IMPLEMENTED
+# endif
+#endif
+
+#ifdef ARENA_IMPLEMENTED
+
+# define ARENA_SLAB_SIZE     (64 * 1024)
+# define ARENA_ALIGN         16
+/* Larger requests are not worth taking from a slab */
+# define ARENA_MAX_ALLOC     (4 * 1024)
+/* Address space reserved for slabs, only the slabs in use are backed */
+# if SIZE_MAX > 0xffffffffU
+#  define ARENA_NUM_SLABS    4096
+# else
+#  define ARENA_NUM_SLABS    256
+# endif
+/* Free slabs kept backed by memory, the others are given back to the system */
+# define ARENA_KEEP_SLABS    64
+
+# define ARENA_ROUND(n)      (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+typedef struct arena_slab_st {
+    int refs;
+} ARENA_SLAB;
+
+/* Each allocation is preceded by its size, padded to ARENA_ALIGN */
+# define ARENA_SLAB_HEADER   ARENA_ROUND(sizeof(ARENA_SLAB))
+# define ARENA_ALLOC_HEADER  ARENA_ROUND(sizeof(size_t))
+
+typedef struct arena_st {
+    ARENA_SLAB *slab;
+    size_t used;
+    /* Number of allocations made from |slab| */
+    int count;
+    unsigned int depth;
+} ARENA;
+
+static CRYPTO_ONCE arena_once = CRYPTO_ONCE_STATIC_INIT;
+static int arena_inited = 0;
+/* Number of threads with an arena */
+static int arena_users = 0;
+static CRYPTO_THREAD_LOCAL arena_key;
+/* Protects the slab free list, and the reference counts without atomics */
+static CRYPTO_RWLOCK *arena_lock = NULL;
+static void *arena_map = NULL;
+static size_t arena_map_size = 0;
+static unsigned char *arena_start = NULL, *arena_end = NULL;
+/* Slabs below arena_next have been used, the free ones are in arena_free */
+static size_t arena_next = 0;
+static unsigned short *arena_free = NULL;
+static size_t arena_num_free = 0;
+
+static void arena_thread_cleanup(void *arg);
+
+DEFINE_RUN_ONCE_STATIC(do_arena_init)
+{
+    uintptr_t start;
+
+    arena_map_size = (size_t)ARENA_NUM_SLABS * ARENA_SLAB_SIZE + ARENA_SLAB_SIZE;
+    arena_map = mmap(NULL, arena_map_size, PROT_READ | PROT_WRITE,
+                     MAP_ANON | MAP_PRIVATE
+# if defined(MAP_NORESERVE)
+                     | MAP_NORESERVE
+# endif
+                     , -1, 0);
+    if (arena_map == MAP_FAILED) {
+        arena_map = NULL;
+        return 0;
+    }
+    arena_free = OPENSSL_malloc(ARENA_NUM_SLABS * sizeof(*arena_free));
+    arena_lock = CRYPTO_THREAD_lock_new();
+    if (arena_free == NULL || arena_lock == NULL
+            || !CRYPTO_THREAD_init_local(&arena_key, arena_thread_cleanup)) {
+        CRYPTO_THREAD_lock_free(arena_lock);
+        arena_lock = NULL;
+        OPENSSL_free(arena_free);
+        arena_free = NULL;
+        munmap(arena_map, arena_map_size);
+        arena_map = NULL;
+        return 0;
+    }
+    start = ((uintptr_t)arena_map + ARENA_SLAB_SIZE - 1)
+        & ~(uintptr_t)(ARENA_SLAB_SIZE - 1);
+    arena_start = (unsigned char *)start;
+    arena_end = arena_start + (size_t)ARENA_NUM_SLABS * ARENA_SLAB_SIZE;
+    arena_inited = 1;
+    return 1;
+}
+
+static ARENA_SLAB *arena_slab_new(void)
+{
+    size_t i;
+
+    if (!CRYPTO_THREAD_write_lock(arena_lock))
+        return NULL;
+    if (arena_num_free > 0) {
+        i = arena_free[--arena_num_free];
+    } else if (arena_next < ARENA_NUM_SLABS) {
+        i = arena_next++;
+    } else {
+        CRYPTO_THREAD_unlock(arena_lock);
+        return NULL;
+    }
+    CRYPTO_THREAD_unlock(arena_lock);
+    return (ARENA_SLAB *)(arena_start + i * ARENA_SLAB_SIZE);
+}
+
+static void arena_slab_release(ARENA_SLAB *slab)
+{
+    size_t i = ((unsigned char *)slab - arena_start) / ARENA_SLAB_SIZE;
+
+    if (!CRYPTO_THREAD_write_lock(arena_lock))
+        return;
+# if defined(MADV_DONTNEED)
+    /*
+     * Given back outside of the lock, before the slab can be reused.  Other
+     * threads may release slabs meanwhile, so a few more than
+     * ARENA_KEEP_SLABS may end up being kept, which is harmless.
+     */
+    if (arena_num_free >= ARENA_KEEP_SLABS) {
+        CRYPTO_THREAD_unlock(arena_lock);
+        madvise(slab, ARENA_SLAB_SIZE, MADV_DONTNEED);
+        if (!CRYPTO_THREAD_write_lock(arena_lock))
+            return;
+    }
+# endif
+    arena_free[arena_num_free++] = (unsigned short)i;
+    CRYPTO_THREAD_unlock(arena_lock);
+}
+
+static void arena_slab_unref(ARENA_SLAB *slab, int n)
+{
+    int refs;
+
+    if (CRYPTO_atomic_add(&slab->refs, n, &refs, arena_lock) && refs == 0)
+        arena_slab_release(slab);
+}
+
+/* Hands the current slab over to the allocations made from it */
+static void arena_retire(ARENA *arena)
+{
+    if (arena->slab == NULL)
+        return;
+    arena_slab_unref(arena->slab, arena->count);
+    arena->slab = NULL;
+}
+
+static void arena_free_arena(ARENA *arena)
+{
+    int users;
+
+    arena_retire(arena);
+    OPENSSL_free(arena);
+    CRYPTO_atomic_add(&arena_users, -1, &users, arena_lock);
+}
+
+/* Called when a thread exits without having left all its scopes */
+static void arena_thread_cleanup(void *arg)
+{
+    if (arg != NULL)
+        arena_free_arena(arg);
+}
+
+static ossl_inline int arena_owns(const void *ptr)
+{
+    return (const unsigned char *)ptr >= arena_start
+        && (const unsigned char *)ptr < arena_end;
+}
+
+void *ossl_mem_arena_alloc(size_t num)
+{
+    ARENA *arena;
+    ARENA_SLAB *slab;
+    unsigned char *p;
+    size_t need;
+    int users;
+
+    if (!arena_inited || num == 0 || num > ARENA_MAX_ALLOC
+            || !CRYPTO_atomic_load_int(&arena_users, &users, arena_lock)
+            || users == 0)
+        return NULL;
+    arena = CRYPTO_THREAD_get_local(&arena_key);
+    if (arena == NULL)
+        return NULL;
+
+    need = ARENA_ALLOC_HEADER + ARENA_ROUND(num);
+    if (arena->slab == NULL || arena->used + need > ARENA_SLAB_SIZE) {
+        if ((slab = arena_slab_new()) == NULL)
+            return NULL;
+        arena_retire(arena);
+        slab->refs = 0;
+        arena->slab = slab;
+        arena->used = ARENA_SLAB_HEADER;
+        arena->count = 0;
+    }
+
+    p = (unsigned char *)arena->slab + arena->used;
+    arena->used += need;
+    arena->count++;
+    *(size_t *)p = num;
+    return p + ARENA_ALLOC_HEADER;
+}
+
+int ossl_mem_arena_size(const void *ptr, size_t *num)
+{
+    if (!arena_owns(ptr))
+        return 0;
+    *num = *(const size_t *)((const unsigned char *)ptr - ARENA_ALLOC_HEADER);
+    return 1;
+}
+
+int ossl_mem_arena_free(void *ptr)
+{
+    if (!arena_owns(ptr))
+        return 0;
+    arena_slab_unref((ARENA_SLAB *)((uintptr_t)ptr
+                                    & ~(uintptr_t)(ARENA_SLAB_SIZE - 1)), -1);
+    return 1;
+}
+
+void ossl_mem_arena_cleanup(void)
+{
+    /* The reserved range stays mapped if allocations from it were leaked */
+    if (!arena_inited || arena_num_free != arena_next)
+        return;
+    arena_inited = 0;
+    munmap(arena_map, arena_map_size);
+    arena_map = NULL;
+    arena_start = arena_end = NULL;
+    arena_next = arena_num_free = 0;
+    OPENSSL_free(arena_free);
+    arena_free = NULL;
+    CRYPTO_THREAD_lock_free(arena_lock);
+    arena_lock = NULL;
+    CRYPTO_THREAD_cleanup_local(&arena_key);
+}
+
+int CRYPTO_arena_begin(void)
+{
+    ARENA *arena;
+    CRYPTO_malloc_fn malloc_fn;
+    int users;
+
+    /* Allocators set with CRYPTO_set_mem_functions() must see every request */
+    CRYPTO_get_mem_functions(&malloc_fn, NULL, NULL);
+    if (malloc_fn != CRYPTO_malloc)
+        return 0;
+    if (!RUN_ONCE(&arena_once, do_arena_init) || !arena_inited)
+        return 0;
+    arena = CRYPTO_THREAD_get_local(&arena_key);
+    if (arena == NULL) {
+        /* Not taken from the arena, which is not set up for this thread yet */
+        arena = OPENSSL_zalloc(sizeof(*arena));
+        if (arena == NULL)
+            return 0;
+        if (!CRYPTO_THREAD_set_local(&arena_key, arena)) {
+            OPENSSL_free(arena);
+            return 0;
+        }
+        CRYPTO_atomic_add(&arena_users, 1, &users, arena_lock);
+    }
+    arena->depth++;
+    return 1;
+}
+
+void CRYPTO_arena_end(void)
+{
+    ARENA *arena;
+
+    if (!arena_inited)
+        return;
+    arena = CRYPTO_THREAD_get_local(&arena_key);
+    if (arena == NULL || --arena->depth > 0)
+        return;
+    CRYPTO_THREAD_set_local(&arena_key, NULL);
+    arena_free_arena(arena);
+}
+
+#else /* ARENA_IMPLEMENTED */
+
+void *ossl_mem_arena_alloc(size_t num)
+{
+    return NULL;
+}
+
+int ossl_mem_arena_size(const void *ptr, size_t *num)
+{
+    return 0;
+}
+
+int ossl_mem_arena_free(void *ptr)
+{
+    return 0;
+}
+
+void ossl_mem_arena_cleanup(void)
+{
+}
+
+int CRYPTO_arena_begin(void)
+{
+    return 0;
+}
+
+void CRYPTO_arena_end(void)
+{
+}
+
+#endif /* ARENA_IMPLEMENTED */
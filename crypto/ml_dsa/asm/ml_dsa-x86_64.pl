@@ -0,0 +1,896 @@
+#! /usr/bin/env perl
+# Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# AVX2 kernels for the ML-DSA (FIPS 204) polynomial arithmetic.
+#
+# Coefficients are 32-bit, eight to a %ymm register.  Products are formed
+# with vpmuldq, which multiplies the even dwords only, so each Montgomery
+# multiplication is done twice, once for the even and once for the odd
+# lanes, and the high halves blended back together.  Intermediate values
+# are signed; every routine returns fully reduced coefficients in [0, q),
+# or for the decomposition functions exactly the values the C code in
+# ml_dsa_key_compress.c would produce, so the portable code remains the
+# reference and the fallback.
+#
+# The following are provided:
+#
+# ossl_ml_dsa_avx2_eligible		- whether the CPU has AVX2 and POPCNT;
+# ossl_ml_dsa_poly_ntt_avx2		- FIPS 204 Algorithm 41, NTT();
+# ossl_ml_dsa_poly_ntt_inverse_avx2	- Algorithm 42, NTT^-1(), with the
+#					  same Montgomery factor as the C;
+# ossl_ml_dsa_poly_ntt_mult_avx2	- Algorithm 45, MultiplyNTT();
+# ossl_ml_dsa_poly_ntt_mult_add_avx2	- the above added to the output, the
+#					  inner step of the matrix-vector
+#					  product;
+# ossl_ml_dsa_poly_high_bits_avx2	- Algorithm 37, HighBits();
+# ossl_ml_dsa_poly_low_bits_avx2	- Algorithm 38, LowBits();
+# ossl_ml_dsa_poly_make_hint_avx2	- Algorithm 39, MakeHint();
+# ossl_ml_dsa_poly_use_hint_avx2	- Algorithm 40, UseHint();
+# ossl_ml_dsa_rej_ntt_avx2		- RejNTTPoly() candidate selection
+#					  (Algorithm 30, CoeffFromThreeBytes).
+#
+# As in the ML-KEM module only %ymm0-%ymm5 are used, with constants as
+# memory operands.
+#
+# TSC ticks per call, best of 2000 (Sapphire Rapids, gcc 12 -O3 for C):
+#
+#			C		AVX2
+# NTT			22000		850
+# inverse NTT		6250		950
+# MultiplyNTT		680		220
+# HighBits		160		120
+# MakeHint		630		300
+# UseHint		740		280
+# RejNTTPoly, 168 bytes	150		60
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+$avx=0;
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22);
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.09) + ($1>=2.10);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+######################################################################
+# Constants
+#
+my $q = 8380417;
+my $qinv = 58728449;			# q^-1 mod 2^32
+my $gamma2_32 = ($q - 1) / 32;
+my $gamma2_88 = ($q - 1) / 88;
+my $f = 41978;				# 256^-1 * 2^64 mod q, as in the C
+
+use Math::BigInt;
+
+sub mulmod { my ($x, $y) = @_; return ($x * $y) % $q; }	# q^2 < 2^53
+sub modexp {
+    my ($b, $e) = @_;
+    my $r = 1;
+
+    while ($e > 0) {
+	$r = mulmod($r, $b) if ($e & 1);
+	$b = mulmod($b, $b);
+	$e >>= 1;
+    }
+    return $r;
+}
+sub bitrev8 {
+    my $i = shift;
+    my $r = 0;
+
+    for (my $n = 0; $n < 8; $n++) { $r = ($r << 1) | ($i & 1); $i >>= 1; }
+    return $r;
+}
+sub s32 { my $v = shift() & 0xffffffff; return $v >= 0x80000000 ? $v - 0x100000000 : $v; }
+# |z| * 2^32 mod q, centered, and its product with q^-1 mod 2^32
+sub mont {
+    my $z = mulmod(shift, modexp(2, 32));
+
+    $z -= $q if ($z > ($q - 1) / 2);
+    return ($z, s32(mulmod_2_32($z + 2**32, $qinv)));
+}
+sub mulmod_2_32 {
+    my ($x, $y) = @_;
+
+    return ((Math::BigInt->new("$x") * $y) % 2**32)->numify();
+}
+
+# zeta[k] = 1753^bitrev8(k) mod q, the roots of FIPS 204 Appendix B
+my @zetas = map { modexp(1753, bitrev8($_)) } (0..255);
+
+# Root used by the forward NTT for coefficient |w| at half-width |len|.
+sub ntt_zeta {
+    my ($w, $len) = @_;
+    my $step = 256 / (2 * $len);
+
+    return $zetas[$step + int($w / (2 * $len))];
+}
+
+# Root used by the inverse NTT, -zeta[step + (step - 1 - i)] as in the C.
+sub intt_zeta {
+    my ($w, $len) = @_;
+    my $step = 256 / (2 * $len);
+    my $i = int($w / (2 * $len));
+
+    return $q - $zetas[$step + ($step - 1 - $i)];
+}
+
+# Coefficient held in each dword of the "X" register for the pair of
+# vectors at coefficients 16p..16p+15 shuffled for layer |len|.
+sub lane_words {
+    my ($p, $len) = @_;
+    my @w;
+
+    @w = ((0..3), (8..11))			if ($len == 4);
+    @w = (0, 1, 8, 9, 4, 5, 12, 13)		if ($len == 2);
+    @w = (0, 8, 2, 10, 4, 12, 6, 14)		if ($len == 1);
+    return map { 16 * $p + $_ } @w;
+}
+
+sub dwords { return join(",", map { s32($_) } @_); }
+
+my ($out,$a,$b,$c,$d) = ("%rdi","%rsi","%rdx","%rcx","%r8");
+my ($A,$B,$X,$Y,$t,$u) = map("%ymm$_",(0..5));
+
+# Memory operand |$off| bytes into table |$base|, either a register or
+# a label.
+sub mem {
+    my ($base, $off) = @_;
+
+    return $base =~ /^%/ ? "$off($base)" : "$base+$off(%rip)";
+}
+
+# Montgomery multiplication of the dwords of |$x| by the per-lane
+# constants at |$off| in |$base|, followed by their products with q^-1
+# mod 2^32.  The odd lanes are loaded 4 bytes further on.  |$x| is
+# destroyed, the result is left in |$r|.
+sub mont_mul {
+    my ($x, $base, $off, $r, $t) = @_;
+    my ($z, $zq, $zo, $zqo) = map { mem($base, $off + $_) } (0, 32, 4, 36);
+
+    return <<___;
+	vpmuldq		$zq,$x,$t
+	vpmuldq		$z,$x,$r
+	vpmuldq		.Lq(%rip),$t,$t
+	vpsubq		$t,$r,$r
+	vmovshdup	$x,$x
+	vpmuldq		$zqo,$x,$t
+	vpmuldq		$zo,$x,$x
+	vpmuldq		.Lq(%rip),$t,$t
+	vpsubq		$t,$x,$x
+	vmovshdup	$r,$r
+	vpblendd	\$0xaa,$x,$r,$r
+___
+}
+
+# Reduce signed dwords of |$x| to within about 2^22 of zero.
+sub reduce32 {
+    my ($x, $t) = @_;
+
+    return <<___;
+	vpaddd		.L2pow22(%rip),$x,$t
+	vpsrad		\$23,$t,$t
+	vpmulld		.Lq(%rip),$t,$t
+	vpsubd		$t,$x,$x
+___
+}
+
+# Map |$x|, with |x| < q, to [0, q).
+sub caddq {
+    my ($x, $t) = @_;
+
+    return <<___;
+	vpsrad		\$31,$x,$t
+	vpand		.Lq(%rip),$t,$t
+	vpaddd		$t,$x,$x
+___
+}
+
+sub shuffle {
+    my ($len, $A, $B, $X, $Y, $t) = @_;
+
+    return <<___ if ($len == 4);
+	vperm2i128	\$0x20,$B,$A,$X
+	vperm2i128	\$0x31,$B,$A,$Y
+___
+    return <<___ if ($len == 2);
+	vpunpcklqdq	$B,$A,$X
+	vpunpckhqdq	$B,$A,$Y
+___
+    return <<___;
+	vpsllq		\$32,$B,$t
+	vpblendd	\$0xaa,$t,$A,$X
+	vpsrlq		\$32,$A,$t
+	vpblendd	\$0xaa,$B,$t,$Y
+___
+}
+sub unshuffle {
+    my ($len, $X, $Y, $A, $B, $t) = @_;
+
+    return <<___ if ($len == 4);
+	vperm2i128	\$0x20,$Y,$X,$A
+	vperm2i128	\$0x31,$Y,$X,$B
+___
+    return <<___ if ($len == 2);
+	vpunpcklqdq	$Y,$X,$A
+	vpunpckhqdq	$Y,$X,$B
+___
+    return <<___;
+	vpsllq		\$32,$Y,$t
+	vpblendd	\$0xaa,$t,$X,$A
+	vpsrlq		\$32,$X,$t
+	vpblendd	\$0xaa,$Y,$t,$B
+___
+}
+
+# HighBits() of the dwords of |$x| (in [0, q)) into |$r|.
+sub high_bits {
+    my ($g, $x, $r, $t) = @_;
+    my $code = <<___;
+	vpaddd		.L127(%rip),$x,$r
+	vpsrld		\$7,$r,$r
+___
+    $code .= <<___ if ($g == 32);
+	vpmulld		.L1025(%rip),$r,$r
+	vpaddd		.L2pow21(%rip),$r,$r
+	vpsrad		\$22,$r,$r
+	vpand		.L15(%rip),$r,$r
+___
+    $code .= <<___ if ($g == 88);
+	vpmulld		.L11275(%rip),$r,$r
+	vpaddd		.L2pow23(%rip),$r,$r
+	vpsrad		\$24,$r,$r
+	vmovdqa		.L43(%rip),$t
+	vpsubd		$r,$t,$t
+	vpsrad		\$31,$t,$t
+	vpand		$r,$t,$t
+	vpxor		$t,$r,$r
+___
+    return $code;
+}
+
+# LowBits() of |$x| given its HighBits() |$r1|, into |$r0|.
+sub low_bits {
+    my ($g, $x, $r1, $r0, $t) = @_;
+
+    return <<___;
+	vpmulld		.L2gamma2_$g(%rip),$r1,$t
+	vpsubd		$t,$x,$r0
+	vmovdqa		.Lqm1div2(%rip),$t
+	vpsubd		$r0,$t,$t
+	vpsrad		\$31,$t,$t
+	vpand		.Lq(%rip),$t,$t
+	vpsubd		$t,$r0,$r0
+___
+}
+
+if ($avx>1) {{{
+
+$code.=<<___;
+.text
+
+.extern	OPENSSL_ia32cap_P
+
+.globl	ossl_ml_dsa_avx2_eligible
+.type	ossl_ml_dsa_avx2_eligible,\@abi-omnipotent
+.align	32
+ossl_ml_dsa_avx2_eligible:
+.cfi_startproc
+	mov	OPENSSL_ia32cap_P+4(%rip),%ecx
+	mov	OPENSSL_ia32cap_P+8(%rip),%edx
+	xor	%eax,%eax
+	and	\$`1<<23`,%ecx			# POPCNT
+	and	\$`1<<5`,%edx			# AVX2
+	shr	\$23,%ecx
+	shr	\$5,%edx
+	and	%edx,%ecx
+	mov	%ecx,%eax
+	ret
+.cfi_endproc
+.size	ossl_ml_dsa_avx2_eligible,.-ossl_ml_dsa_avx2_eligible
+___
+
+######################################################################
+# void ossl_ml_dsa_poly_ntt_avx2(uint32_t c[256]);
+#
+# Five layers on whole vectors with broadcast roots, then the last three
+# per pair of vectors after shuffling coefficients into place.
+{
+$code.=<<___;
+.globl	ossl_ml_dsa_poly_ntt_avx2
+.type	ossl_ml_dsa_poly_ntt_avx2,\@function,1
+.align	32
+ossl_ml_dsa_poly_ntt_avx2:
+.cfi_startproc
+___
+for (my $len = 128, my $k = 1; $len >= 8; $len >>= 1) {
+    my $lv = $len / 8;
+
+    for (my $start = 0; $start < 32; $start += 2 * $lv, $k++) {
+	for (my $j = $start; $j < $start + $lv; $j++) {
+	    $code.=<<___;
+	vmovdqu		`32*($j+$lv)`($out),$B
+___
+	    $code.=mont_mul($B, ".Lntt_zetas", 64 * $k, $Y, $t);
+	    $code.=<<___;
+	vmovdqu		`32*$j`($out),$A
+	vpsubd		$Y,$A,$X
+	vpaddd		$Y,$A,$A
+	vmovdqu		$A,`32*$j`($out)
+	vmovdqu		$X,`32*($j+$lv)`($out)
+___
+	}
+    }
+}
+$code.=<<___;
+	lea		.Lntt_zetas_fused(%rip),%rax
+	lea		1024($out),%rcx
+.Lntt_loop:
+	vmovdqu		0($out),$A
+	vmovdqu		32($out),$B
+___
+for (my $i = 0, my $len = 4; $len >= 1; $len >>= 1, $i++) {
+    $code.=shuffle($len, $A, $B, $X, $Y, $t);
+    $code.=mont_mul($Y, "%rax", 64 * $i, $u, $t);
+    $code.=<<___;
+	vpsubd		$u,$X,$Y
+	vpaddd		$u,$X,$X
+___
+    $code.=unshuffle($len, $X, $Y, $A, $B, $t);
+}
+$code.=reduce32($A, $t) . caddq($A, $t) . reduce32($B, $t) . caddq($B, $t);
+$code.=<<___;
+	vmovdqu		$A,0($out)
+	vmovdqu		$B,32($out)
+	lea		`64*3+32`(%rax),%rax
+	lea		64($out),$out
+	cmp		%rcx,$out
+	jne		.Lntt_loop
+
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_dsa_poly_ntt_avx2,.-ossl_ml_dsa_poly_ntt_avx2
+___
+}
+
+######################################################################
+# void ossl_ml_dsa_poly_ntt_inverse_avx2(uint32_t c[256]);
+#
+# The multiplication by 256^-1, in Montgomery form, is folded into the
+# last layer.
+{
+$code.=<<___;
+.globl	ossl_ml_dsa_poly_ntt_inverse_avx2
+.type	ossl_ml_dsa_poly_ntt_inverse_avx2,\@function,1
+.align	32
+ossl_ml_dsa_poly_ntt_inverse_avx2:
+.cfi_startproc
+	lea		.Lintt_zetas_fused(%rip),%rax
+	mov		$out,%rdx
+	lea		1024($out),%rcx
+.Lintt_loop:
+	vmovdqu		0(%rdx),$A
+	vmovdqu		32(%rdx),$B
+___
+for (my $i = 0, my $len = 1; $len <= 4; $len <<= 1, $i++) {
+    $code.=shuffle($len, $A, $B, $X, $Y, $t);
+    $code.=<<___;
+	vpsubd		$Y,$X,$u
+	vpaddd		$Y,$X,$X
+___
+    $code.=reduce32($X, $t);
+    $code.=mont_mul($u, "%rax", 64 * $i, $Y, $t);
+    $code.=unshuffle($len, $X, $Y, $A, $B, $t);
+}
+$code.=<<___;
+	vmovdqu		$A,0(%rdx)
+	vmovdqu		$B,32(%rdx)
+	lea		`64*3+32`(%rax),%rax
+	lea		64(%rdx),%rdx
+	cmp		%rcx,%rdx
+	jne		.Lintt_loop
+___
+for (my $len = 8, my $k = 0; $len <= 128; $len <<= 1) {
+    my $lv = $len / 8;
+
+    for (my $start = 0; $start < 32; $start += 2 * $lv, $k++) {
+	for (my $j = $start; $j < $start + $lv; $j++) {
+	    $code.=<<___;
+	vmovdqu		`32*$j`($out),$A
+	vmovdqu		`32*($j+$lv)`($out),$B
+	vpsubd		$B,$A,$X
+	vpaddd		$B,$A,$A
+___
+	    if ($len < 128) {
+		$code.=reduce32($A, $t);
+	    } else {
+		$code.=mont_mul($A, ".Lintt_f", 0, $u, $t);
+		$code.=caddq($u, $t);
+		$code.="\tvmovdqa\t\t$u,$A\n";
+	    }
+	    $code.=mont_mul($X, ".Lintt_zetas", 64 * $k, $Y, $t);
+	    $code.=caddq($Y, $t) if ($len == 128);
+	    $code.=<<___;
+	vmovdqu		$A,`32*$j`($out)
+	vmovdqu		$Y,`32*($j+$lv)`($out)
+___
+	}
+    }
+}
+$code.=<<___;
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_dsa_poly_ntt_inverse_avx2,.-ossl_ml_dsa_poly_ntt_inverse_avx2
+___
+}
+
+######################################################################
+# void ossl_ml_dsa_poly_ntt_mult_avx2(const uint32_t lhs[256],
+#                                     const uint32_t rhs[256],
+#                                     uint32_t out[256]);
+# void ossl_ml_dsa_poly_ntt_mult_add_avx2(const uint32_t lhs[256],
+#                                         const uint32_t rhs[256],
+#                                         uint32_t out[256]);
+#
+# Arguments are in the order of ossl_ml_dsa_poly_ntt_mult().
+for my $add (0, 1) {
+my $name = $add ? "ossl_ml_dsa_poly_ntt_mult_add_avx2"
+		: "ossl_ml_dsa_poly_ntt_mult_avx2";
+my $lbl = $add ? "mult_add" : "mult";
+my ($L,$R,$M,$P,$t) = map("%ymm$_",(0..4));
+my ($lhs,$rhs,$dst) = ($out,$a,$b);
+
+$code.=<<___;
+.globl	$name
+.type	$name,\@function,3
+.align	32
+$name:
+.cfi_startproc
+	lea		1024($dst),%rcx
+.L${lbl}_loop:
+	vmovdqu		($lhs),$L
+	vmovdqu		($rhs),$R
+	vpmulld		$R,$L,$M
+	vpmulld		.Lqinv(%rip),$M,$M	# m = l*r*q^-1 mod 2^32
+	vpmuldq		$R,$L,$P
+	vpmuldq		.Lq(%rip),$M,$t
+	vpsubq		$t,$P,$P
+	vmovshdup	$L,$L
+	vmovshdup	$R,$R
+	vmovshdup	$M,$M
+	vpmuldq		$R,$L,$L
+	vpmuldq		.Lq(%rip),$M,$M
+	vpsubq		$M,$L,$L
+	vmovshdup	$P,$P
+	vpblendd	\$0xaa,$L,$P,$P
+___
+$code.=caddq($P, $t);
+$code.=<<___ if ($add);
+	vpaddd		($dst),$P,$P		# reduce_once(out + product)
+	vpsubd		.Lq(%rip),$P,$P
+___
+$code.=caddq($P, $t) if ($add);
+$code.=<<___;
+	vmovdqu		$P,($dst)
+	lea		32($lhs),$lhs
+	lea		32($rhs),$rhs
+	lea		32($dst),$dst
+	cmp		%rcx,$dst
+	jne		.L${lbl}_loop
+
+	vzeroupper
+	ret
+.cfi_endproc
+.size	$name,.-$name
+___
+}
+
+######################################################################
+# void ossl_ml_dsa_poly_high_bits_avx2(uint32_t out[256],
+#                                      const uint32_t in[256],
+#                                      uint32_t gamma2);
+# void ossl_ml_dsa_poly_low_bits_avx2(uint32_t out[256],
+#                                     const uint32_t in[256],
+#                                     uint32_t gamma2);
+for my $low (0, 1) {
+my $name = $low ? "ossl_ml_dsa_poly_low_bits_avx2"
+		: "ossl_ml_dsa_poly_high_bits_avx2";
+my $lbl = $low ? "low" : "high";
+
+$code.=<<___;
+.globl	$name
+.type	$name,\@function,3
+.align	32
+$name:
+.cfi_startproc
+	lea		1024($out),%rcx
+	cmp		\$$gamma2_32,%edx
+	jne		.L${lbl}_88
+___
+for my $g (32, 88) {
+    $code.=<<___;
+.L${lbl}_$g:
+	vmovdqu		($a),$A
+___
+    $code.=high_bits($g, $A, $B, $t);
+    $code.=low_bits($g, $A, $B, $B, $t) if ($low);
+    $code.=<<___;
+	vmovdqu		$B,($out)
+	lea		32($a),$a
+	lea		32($out),$out
+	cmp		%rcx,$out
+	jne		.L${lbl}_$g
+___
+    $code.="\tjmp\t\t.L${lbl}_done\n" if ($g == 32);
+}
+$code.=<<___;
+.L${lbl}_done:
+	vzeroupper
+	ret
+.cfi_endproc
+.size	$name,.-$name
+___
+}
+
+######################################################################
+# void ossl_ml_dsa_poly_make_hint_avx2(uint32_t out[256],
+#                                      const uint32_t ct0[256],
+#                                      const uint32_t cs2[256],
+#                                      const uint32_t w[256],
+#                                      uint32_t gamma2);
+{
+$code.=<<___;
+.globl	ossl_ml_dsa_poly_make_hint_avx2
+.type	ossl_ml_dsa_poly_make_hint_avx2,\@function,5
+.align	32
+ossl_ml_dsa_poly_make_hint_avx2:
+.cfi_startproc
+	lea		1024($out),%rax
+	cmp		\$$gamma2_32,%r8d
+	jne		.Lhint_88
+___
+for my $g (32, 88) {
+    $code.=<<___;
+.Lhint_$g:
+	vmovdqu		($c),$A			# r + z = mod_sub(w, cs2)
+	vpsubd		($b),$A,$A
+___
+    $code.=caddq($A, $t);
+    $code.=<<___;
+	vpaddd		($a),$A,$B		# r = reduce_once(r + z + ct0)
+	vpsubd		.Lq(%rip),$B,$B
+___
+    $code.=caddq($B, $t);
+    $code.=high_bits($g, $A, $X, $t);
+    $code.=high_bits($g, $B, $Y, $t);
+    $code.=<<___;
+	vpcmpeqd	$X,$Y,$Y
+	vpandn		.L1(%rip),$Y,$Y
+	vmovdqu		$Y,($out)
+	lea		32($a),$a
+	lea		32($b),$b
+	lea		32($c),$c
+	lea		32($out),$out
+	cmp		%rax,$out
+	jne		.Lhint_$g
+___
+    $code.="\tjmp\t\t.Lhint_done\n" if ($g == 32);
+}
+$code.=<<___;
+.Lhint_done:
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_dsa_poly_make_hint_avx2,.-ossl_ml_dsa_poly_make_hint_avx2
+___
+}
+
+######################################################################
+# void ossl_ml_dsa_poly_use_hint_avx2(uint32_t out[256],
+#                                     const uint32_t h[256],
+#                                     const uint32_t r[256],
+#                                     uint32_t gamma2);
+#
+# r1 + (h ? (r0 > 0 ? 1 : -1) : 0), wrapped modulo 16 or 44.
+{
+$code.=<<___;
+.globl	ossl_ml_dsa_poly_use_hint_avx2
+.type	ossl_ml_dsa_poly_use_hint_avx2,\@function,4
+.align	32
+ossl_ml_dsa_poly_use_hint_avx2:
+.cfi_startproc
+	lea		1024($out),%rax
+	cmp		\$$gamma2_32,%ecx
+	jne		.Luse_88
+___
+for my $g (32, 88) {
+    $code.=<<___;
+.Luse_$g:
+	vmovdqu		($b),$A
+___
+    $code.=high_bits($g, $A, $B, $t);
+    $code.=low_bits($g, $A, $B, $X, $t);
+    $code.=<<___;
+	vmovdqu		($a),$Y			# h
+	vpxor		$t,$t,$t
+	vpcmpgtd	$t,$X,$X		# r0 > 0
+	vpsubd		$Y,$t,$t		# -h
+	vpblendvb	$X,$Y,$t,$t		# r0 > 0 ? h : -h
+	vpaddd		$t,$B,$B
+___
+    $code.=<<___ if ($g == 32);
+	vpand		.L15(%rip),$B,$B
+___
+    $code.=<<___ if ($g == 88);
+	vpcmpeqd	.L44(%rip),$B,$t	# 44 -> 0
+	vpandn		$B,$t,$B
+	vpsrad		\$31,$B,$t		# -1 -> 43
+	vpand		.L44(%rip),$t,$t
+	vpaddd		$t,$B,$B
+___
+    $code.=<<___;
+	vmovdqu		$B,($out)
+	lea		32($a),$a
+	lea		32($b),$b
+	lea		32($out),$out
+	cmp		%rax,$out
+	jne		.Luse_$g
+___
+    $code.="\tjmp\t\t.Luse_done\n" if ($g == 32);
+}
+$code.=<<___;
+.Luse_done:
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_dsa_poly_use_hint_avx2,.-ossl_ml_dsa_poly_use_hint_avx2
+___
+}
+
+######################################################################
+# size_t ossl_ml_dsa_rej_ntt_avx2(uint32_t *out, size_t n,
+#                                 const uint8_t *in, size_t len,
+#                                 size_t *used);
+#
+# Consumes 24-byte groups of |in| for as long as at least 8 output slots
+# remain and a whole group remains in |in|.  Returns the number of
+# coefficients written and sets |*used| to the number of bytes consumed.
+{
+my ($V,$M,$I) = map("%ymm$_",(0..2));
+
+$code.=<<___;
+.globl	ossl_ml_dsa_rej_ntt_avx2
+.type	ossl_ml_dsa_rej_ntt_avx2,\@function,5
+.align	32
+ossl_ml_dsa_rej_ntt_avx2:
+.cfi_startproc
+	xor		%eax,%eax		# coefficients written
+	mov		$b,($d)			# start of input, for *used
+	lea		.Lrej_idx(%rip),%r10
+	sub		\$8,$a			# last start of an 8-element write
+	jb		.Lrej_done
+	sub		\$24,$c
+	jb		.Lrej_done
+	add		$b,$c			# last start of a 24-byte group
+	jmp		.Lrej_check
+
+.align	16
+.Lrej_loop:
+	vmovdqu		($b),%xmm0
+	vinserti128	\$1,8($b),$V,$V
+	vpshufb		.Lrej_shuf(%rip),$V,$V
+	vpand		.Lmask23(%rip),$V,$V
+	vmovdqa		.Lq(%rip),$M
+	vpcmpgtd	$V,$M,$M
+	vmovmskps	$M,%r9d
+	vpmovzxbd	(%r10,%r9,8),$I
+	vpermd		$V,$I,$V
+	vmovdqu		$V,($out,%rax,4)
+	popcnt		%r9d,%r9d
+	add		%r9,%rax
+	lea		24($b),$b
+.Lrej_check:
+	cmp		$a,%rax
+	ja		.Lrej_done
+	cmp		$c,$b
+	jbe		.Lrej_loop
+
+.Lrej_done:
+	sub		($d),$b
+	mov		$b,($d)
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_dsa_rej_ntt_avx2,.-ossl_ml_dsa_rej_ntt_avx2
+___
+}
+
+######################################################################
+# Tables
+{
+my (@z, @zq, $m, $mq);
+
+sub splat { my $v = shift; return join(",", ($v) x 8); }
+
+$code.=<<___;
+.section .rodata align=64
+.align	64
+.Lq:
+	.long	`splat($q)`
+.Lqinv:
+	.long	`splat($qinv)`
+.Lqm1div2:
+	.long	`splat(($q - 1) / 2)`
+.L2pow21:
+	.long	`splat(1 << 21)`
+.L2pow22:
+	.long	`splat(1 << 22)`
+.L2pow23:
+	.long	`splat(1 << 23)`
+.L2gamma2_32:
+	.long	`splat(2 * $gamma2_32)`
+.L2gamma2_88:
+	.long	`splat(2 * $gamma2_88)`
+.L127:
+	.long	`splat(127)`
+.L1025:
+	.long	`splat(1025)`
+.L11275:
+	.long	`splat(11275)`
+.L1:
+	.long	`splat(1)`
+.L15:
+	.long	`splat(15)`
+.L43:
+	.long	`splat(43)`
+.L44:
+	.long	`splat(44)`
+.Lmask23:
+	.long	`splat(0x7fffff)`
+___
+($m, $mq) = mont(mulmod($f, modexp(modexp(2, 32), $q - 2)));
+$code.=".Lintt_f:\n";
+$code.="\t.long\t" . dwords(($m) x 8) . "\n";
+$code.="\t.long\t" . dwords(($mq) x 8) . "\n";
+
+my @shuf;
+for my $lane (0, 1) {
+    for (my $i = 0; $i < 4; $i++) {
+	my $o = 3 * $i + 4 * $lane;
+	push @shuf, $o, $o + 1, $o + 2, 0x80;
+    }
+}
+$code.=".Lrej_shuf:\n\t.byte\t" . join(",", @shuf) . "\n";
+
+# Broadcast roots for the whole-vector layers, indexed by group number,
+# the forward ones in the order of use, k = 1..31.
+$code.=".Lntt_zetas:\n";
+for (my $k = 0; $k < 32; $k++) {
+    ($m, $mq) = mont($zetas[$k]);
+    $code.="\t.long\t" . dwords(($m) x 8) . "\n";
+    $code.="\t.long\t" . dwords(($mq) x 8) . "\n";
+}
+$code.=".Lintt_zetas:\n";
+for (my $len = 8; $len <= 128; $len <<= 1) {
+    for (my $w = 0; $w < 256; $w += 2 * $len) {
+	my $z = intt_zeta($w, $len);
+
+	# fold the scaling by f * 2^-32 into the last layer
+	$z = mulmod(mulmod($z, $f), modexp(modexp(2, 32), $q - 2))
+	    if ($len == 128);
+	($m, $mq) = mont($z);
+	$code.="\t.long\t" . dwords(($m) x 8) . "\n";
+	$code.="\t.long\t" . dwords(($mq) x 8) . "\n";
+    }
+}
+
+# Per-lane roots for the three shuffled layers of each pair of vectors;
+# each group is padded by 32 bytes so that the odd-lane loads 4 bytes
+# past a vector stay inside the table.
+for my $inv (0, 1) {
+    $code.=$inv ? ".Lintt_zetas_fused:\n" : ".Lntt_zetas_fused:\n";
+    for (my $p = 0; $p < 16; $p++) {
+	foreach my $len ($inv ? (1, 2, 4) : (4, 2, 1)) {
+	    @z = (); @zq = ();
+	    foreach my $w (lane_words($p, $len)) {
+		($m, $mq) = mont($inv ? intt_zeta($w, $len) : ntt_zeta($w, $len));
+		push @z, $m; push @zq, $mq;
+	    }
+	    $code.="\t.long\t" . dwords(@z) . "\n";
+	    $code.="\t.long\t" . dwords(@zq) . "\n";
+	}
+	$code.="\t.long\t" . dwords((0) x 8) . "\n";
+    }
+}
+
+# vpermd indices that compact the accepted dwords for each 8-bit mask
+$code.=".Lrej_idx:\n";
+for (my $msk = 0; $msk < 256; $msk++) {
+    my @idx;
+
+    for (my $i = 0; $i < 8; $i++) {
+	push @idx, $i if ($msk & (1 << $i));
+    }
+    push @idx, 0 while (@idx < 8);
+    $code.="\t.byte\t" . join(",", @idx) . "\n";
+}
+$code.=".text\n";
+}
+
+}}} else {{{
+
+$code.=<<___;
+.text
+
+.globl	ossl_ml_dsa_avx2_eligible
+.type	ossl_ml_dsa_avx2_eligible,\@abi-omnipotent
+ossl_ml_dsa_avx2_eligible:
+	xor	%eax,%eax
+	ret
+.size	ossl_ml_dsa_avx2_eligible,.-ossl_ml_dsa_avx2_eligible
+
+.globl	ossl_ml_dsa_poly_ntt_avx2
+.globl	ossl_ml_dsa_poly_ntt_inverse_avx2
+.globl	ossl_ml_dsa_poly_ntt_mult_avx2
+.globl	ossl_ml_dsa_poly_ntt_mult_add_avx2
+.globl	ossl_ml_dsa_poly_high_bits_avx2
+.globl	ossl_ml_dsa_poly_low_bits_avx2
+.globl	ossl_ml_dsa_poly_make_hint_avx2
+.globl	ossl_ml_dsa_poly_use_hint_avx2
+.globl	ossl_ml_dsa_rej_ntt_avx2
+.type	ossl_ml_dsa_poly_ntt_avx2,\@abi-omnipotent
+ossl_ml_dsa_poly_ntt_avx2:
+ossl_ml_dsa_poly_ntt_inverse_avx2:
+ossl_ml_dsa_poly_ntt_mult_avx2:
+ossl_ml_dsa_poly_ntt_mult_add_avx2:
+ossl_ml_dsa_poly_high_bits_avx2:
+ossl_ml_dsa_poly_low_bits_avx2:
+ossl_ml_dsa_poly_make_hint_avx2:
+ossl_ml_dsa_poly_use_hint_avx2:
+ossl_ml_dsa_rej_ntt_avx2:
+	.byte	0x0f,0x0b	# ud2
+	ret
+.size	ossl_ml_dsa_poly_ntt_avx2,.-ossl_ml_dsa_poly_ntt_avx2
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval $1/gem;
+print $code;
+close STDOUT or die "error closing STDOUT: $!";
@@ -88,6 +88,36 @@ int32_t ossl_ml_dsa_key_compress_make_hint(uint32_t ct0, uint32_t cs2,
 uint32_t ossl_ml_dsa_key_compress_use_hint(uint32_t hint, uint32_t r,
                                            uint32_t gamma2);
 
+/*
+ * x86_64 AVX2 kernels, see asm/ml_dsa-x86_64.pl.  They produce exactly the
+ * same output as the portable C code, which they replace at runtime when
+ * OPENSSL_ia32cap reports AVX2 and POPCNT.
+ */
+# if defined(ML_DSA_AVX2_ASM)
+int ossl_ml_dsa_avx2_eligible(void);
+void ossl_ml_dsa_poly_ntt_avx2(uint32_t c[256]);
+void ossl_ml_dsa_poly_ntt_inverse_avx2(uint32_t c[256]);
+void ossl_ml_dsa_poly_ntt_mult_avx2(const uint32_t lhs[256],
+                                    const uint32_t rhs[256],
+                                    uint32_t out[256]);
+void ossl_ml_dsa_poly_ntt_mult_add_avx2(const uint32_t lhs[256],
+                                        const uint32_t rhs[256],
+                                        uint32_t out[256]);
+void ossl_ml_dsa_poly_high_bits_avx2(uint32_t out[256],
+                                     const uint32_t in[256], uint32_t gamma2);
+void ossl_ml_dsa_poly_low_bits_avx2(uint32_t out[256],
+                                    const uint32_t in[256], uint32_t gamma2);
+void ossl_ml_dsa_poly_make_hint_avx2(uint32_t out[256],
+                                     const uint32_t ct0[256],
+                                     const uint32_t cs2[256],
+                                     const uint32_t w[256], uint32_t gamma2);
+void ossl_ml_dsa_poly_use_hint_avx2(uint32_t out[256], const uint32_t h[256],
+                                    const uint32_t r[256], uint32_t gamma2);
+size_t ossl_ml_dsa_rej_ntt_avx2(uint32_t *out, size_t n,
+                                const uint8_t *in, size_t len, size_t *used);
+#  define ML_DSA_AVX2_CAPABLE ossl_ml_dsa_avx2_eligible()
+# endif
+
 int ossl_ml_dsa_pk_encode(ML_DSA_KEY *key);
 int ossl_ml_dsa_sk_encode(ML_DSA_KEY *key);
 
@@ -28,6 +28,16 @@ void ossl_ml_dsa_matrix_mult_vector(const MATRIX *a, const VECTOR *s,
 
     vector_zero(t);
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        for (i = 0; i < a->k; i++)
+            for (j = 0; j < a->l; j++)
+                ossl_ml_dsa_poly_ntt_mult_add_avx2((poly++)->coeff,
+                                                   s->poly[j].coeff,
+                                                   t->poly[i].coeff);
+        return;
+    }
+#endif
     for (i = 0; i < a->k; i++) {
         for (j = 0; j < a->l; j++) {
             POLY product;
@@ -112,6 +112,12 @@ void ossl_ml_dsa_poly_ntt_mult(const POLY *lhs, const POLY *rhs, POLY *out)
 {
     int i;
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        ossl_ml_dsa_poly_ntt_mult_avx2(lhs->coeff, rhs->coeff, out->coeff);
+        return;
+    }
+#endif
     for (i = 0; i < ML_DSA_NUM_POLY_COEFFICIENTS; i++)
         out->coeff[i] =
             reduce_montgomery((uint64_t)lhs->coeff[i] * (uint64_t)rhs->coeff[i]);
@@ -132,6 +138,12 @@ void ossl_ml_dsa_poly_ntt(POLY *p)
     int step;
     int offset = ML_DSA_NUM_POLY_COEFFICIENTS;
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        ossl_ml_dsa_poly_ntt_avx2(p->coeff);
+        return;
+    }
+#endif
     /* Step: 1, 2, 4, 8, ..., 128 */
     for (step = 1; step < ML_DSA_NUM_POLY_COEFFICIENTS; step <<= 1) {
         k = 0;
@@ -173,6 +185,12 @@ void ossl_ml_dsa_poly_ntt_inverse(POLY *p)
      */
     static const uint32_t inverse_degree_montgomery = 41978;
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        ossl_ml_dsa_poly_ntt_inverse_avx2(p->coeff);
+        return;
+    }
+#endif
     for (offset = 1; offset < ML_DSA_NUM_POLY_COEFFICIENTS; offset <<= 1) {
         step >>= 1;
         k = 0;
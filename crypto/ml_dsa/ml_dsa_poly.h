@@ -122,6 +122,12 @@ poly_high_bits(const POLY *in, uint32_t gamma2, POLY *out)
 {
     int i;
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        ossl_ml_dsa_poly_high_bits_avx2(out->coeff, in->coeff, gamma2);
+        return;
+    }
+#endif
     for (i = 0; i < ML_DSA_NUM_POLY_COEFFICIENTS; i++)
         out->coeff[i] = ossl_ml_dsa_key_compress_high_bits(in->coeff[i], gamma2);
 }
@@ -131,6 +137,12 @@ poly_low_bits(const POLY *in, uint32_t gamma2, POLY *out)
 {
     int i;
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        ossl_ml_dsa_poly_low_bits_avx2(out->coeff, in->coeff, gamma2);
+        return;
+    }
+#endif
     for (i = 0; i < ML_DSA_NUM_POLY_COEFFICIENTS; i++)
         out->coeff[i] = ossl_ml_dsa_key_compress_low_bits(in->coeff[i], gamma2);
 }
@@ -141,6 +153,13 @@ poly_make_hint(const POLY *ct0, const POLY *cs2, const POLY *w, uint32_t gamma2,
 {
     int i;
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        ossl_ml_dsa_poly_make_hint_avx2(out->coeff, ct0->coeff, cs2->coeff,
+                                        w->coeff, gamma2);
+        return;
+    }
+#endif
     for (i = 0; i < ML_DSA_NUM_POLY_COEFFICIENTS; i++)
         out->coeff[i] = ossl_ml_dsa_key_compress_make_hint(ct0->coeff[i],
                                                            cs2->coeff[i],
@@ -152,6 +171,12 @@ poly_use_hint(const POLY *h, const POLY *r, uint32_t gamma2, POLY *out)
 {
     int i;
 
+#ifdef ML_DSA_AVX2_CAPABLE
+    if (ML_DSA_AVX2_CAPABLE) {
+        ossl_ml_dsa_poly_use_hint_avx2(out->coeff, h->coeff, r->coeff, gamma2);
+        return;
+    }
+#endif
     for (i = 0; i < ML_DSA_NUM_POLY_COEFFICIENTS; i++)
         out->coeff[i] = ossl_ml_dsa_key_compress_use_hint(h->coeff[i],
                                                           r->coeff[i], gamma2);
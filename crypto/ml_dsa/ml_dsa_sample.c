@@ -94,6 +94,31 @@ static ossl_inline int coeff_from_nibble_2(uint32_t nibble, uint32_t *out)
     return 0;
 }
 
+/*
+ * Rejection-samples the |len| bytes at |blocks| into out->coeff[j..255],
+ * returning the updated number of coefficients.
+ */
+static int rej_ntt_block(POLY *out, int j, const uint8_t *blocks, size_t len)
+{
+    const uint8_t *b = blocks, *end = blocks + len;
+
+#ifdef ML_DSA_AVX2_CAPABLE
+    /* The vector kernel leaves any tail of the block to the loop below */
+    if (ML_DSA_AVX2_CAPABLE) {
+        size_t used;
+
+        j += (int)ossl_ml_dsa_rej_ntt_avx2(out->coeff + j,
+                                           ML_DSA_NUM_POLY_COEFFICIENTS - j,
+                                           blocks, len, &used);
+        b += used;
+    }
+#endif
+    for (; b < end && j < ML_DSA_NUM_POLY_COEFFICIENTS; b += 3)
+        if (coeff_from_three_bytes(b, &(out->coeff[j])))
+            j++;
+    return j;
+}
+
 /**
  * @brief Use a seed value to generate a polynomial with coefficients in the
  * range of 0..q-1 using rejection sampling.
@@ -117,7 +142,7 @@ static int rej_ntt_poly(EVP_MD_CTX *g_ctx, const EVP_MD *md,
                         const uint8_t *seed, size_t seed_len, POLY *out)
 {
     int j = 0;
-    uint8_t blocks[SHAKE128_BLOCKSIZE], *b, *end = blocks + sizeof(blocks);
+    uint8_t blocks[SHAKE128_BLOCKSIZE];
 
     /*
      * Instead of just squeezing 3 bytes at a time, we grab a whole block
@@ -126,16 +151,36 @@ static int rej_ntt_poly(EVP_MD_CTX *g_ctx, const EVP_MD *md,
     if (!shake_xof(g_ctx, md, seed, seed_len, blocks, sizeof(blocks)))
         return 0;
 
-    while (1) {
-        for (b = blocks; b < end; b += 3) {
-            if (coeff_from_three_bytes(b, &(out->coeff[j]))) {
-                if (++j >= ML_DSA_NUM_POLY_COEFFICIENTS)
-                    return 1;   /* finished */
-            }
-        }
+    while ((j = rej_ntt_block(out, j, blocks, sizeof(blocks)))
+           < ML_DSA_NUM_POLY_COEFFICIENTS)
         if (!EVP_DigestSqueeze(g_ctx, blocks, sizeof(blocks)))
             return 0;
-    }
+    return 1;
+}
+
+/*
+ * As rej_ntt_poly(), for four polynomials at once, with the SHAKE128
+ * instances seeded from |seeds| computed in parallel.
+ */
+static void rej_ntt_poly_x4(const uint8_t *const seeds[4], size_t seed_len,
+                            POLY *out[4])
+{
+    KECCAK1600_X4_CTX ctx;
+    uint8_t blocks[4][SHAKE128_BLOCKSIZE];
+    uint8_t *const b[4] = { blocks[0], blocks[1], blocks[2], blocks[3] };
+    int j[4] = { 0, 0, 0, 0 };
+    int i, more;
+
+    ossl_shake_x4_init(&ctx, 128);
+    ossl_shake_x4_absorb(&ctx, seeds, seed_len);
+    do {
+        ossl_shake_x4_squeeze(&ctx, b, 1);
+        for (more = 0, i = 0; i < 4; i++) {
+            if (j[i] < ML_DSA_NUM_POLY_COEFFICIENTS)
+                j[i] = rej_ntt_block(out[i], j[i], blocks[i], sizeof(blocks[i]));
+            more |= j[i] < ML_DSA_NUM_POLY_COEFFICIENTS;
+        }
+    } while (more);
 }
 
 /**
@@ -208,8 +253,33 @@ int ossl_ml_dsa_matrix_expand_A(EVP_MD_CTX *g_ctx, const EVP_MD *md,
     /* The seed used for each matrix element is rho + column_index + row_index */
     memcpy(derived_seed, rho, ML_DSA_RHO_BYTES);
 
-    for (i = 0; i < out->k; i++) {
-        for (j = 0; j < out->l; j++) {
+    i = j = 0;
+    /*
+     * Where four-way Keccak is faster, take the elements four at a time and
+     * leave any remainder to the loop below.
+     */
+    if (ossl_keccak1600_x4_capable()) {
+        uint8_t seeds[4][sizeof(derived_seed)];
+        const uint8_t *const in[4] = { seeds[0], seeds[1], seeds[2], seeds[3] };
+        POLY *polys[4];
+        size_t n, m;
+
+        for (n = out->k * out->l; n >= 4; n -= 4) {
+            for (m = 0; m < 4; m++) {
+                memcpy(seeds[m], rho, ML_DSA_RHO_BYTES);
+                seeds[m][ML_DSA_RHO_BYTES + 1] = (uint8_t)i;
+                seeds[m][ML_DSA_RHO_BYTES] = (uint8_t)j;
+                polys[m] = poly++;
+                if (++j == out->l) {
+                    j = 0;
+                    ++i;
+                }
+            }
+            rej_ntt_poly_x4(in, sizeof(derived_seed), polys);
+        }
+    }
+    for (; i < out->k; i++, j = 0) {
+        for (; j < out->l; j++) {
             derived_seed[ML_DSA_RHO_BYTES + 1] = (uint8_t)i;
             derived_seed[ML_DSA_RHO_BYTES] = (uint8_t)j;
             /* Generate the polynomial for each matrix element using a unique seed */
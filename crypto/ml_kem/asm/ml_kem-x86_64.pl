@@ -0,0 +1,714 @@
+#! /usr/bin/env perl
+# Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# AVX2 kernels for the ML-KEM (FIPS 203) polynomial arithmetic.
+#
+# The portable code in crypto/ml_kem/ml_kem.c keeps every coefficient in
+# canonical form [0, q) on entry to and exit from each primitive, using
+# Barrett reduction on 32-bit intermediates.  Here the coefficients are
+# treated as signed 16-bit values in Montgomery form (R = 2^16) so that
+# sixteen of them fit a %ymm register and the products can be computed
+# with vpmullw/vpmulhw.  Intermediate results are only kept in (-q, q),
+# or in the case of the forward NTT (-8q, 8q), and each routine maps its
+# output back to [0, q), so results are bit-for-bit identical to the C
+# code, which remains the reference and the fallback.
+#
+# The following are provided:
+#
+# ossl_ml_kem_avx2_eligible	- whether the CPU has AVX2 and POPCNT;
+# ossl_ml_kem_ntt_avx2		- forward NTT (Algorithm 9);
+# ossl_ml_kem_inverse_ntt_avx2	- inverse NTT (Algorithm 10), including
+#				  the final scaling by 128^-1;
+# ossl_ml_kem_mult_avx2		- MultiplyNTTs (Algorithm 11);
+# ossl_ml_kem_mult_add_avx2	- MultiplyNTTs added to the output;
+# ossl_ml_kem_rej_uniform_avx2	- SampleNTT rejection sampling of 12-bit
+#				  candidates (steps 3-17 of Algorithm 7).
+#
+# Only %ymm0-%ymm5 are used, all constants are memory operands, which
+# keeps the routines free of Win64 non-volatile register spills.
+#
+# TSC ticks per call, best of 2000 (Sapphire Rapids, gcc 12 -O3 for C):
+#
+#			C		AVX2
+# NTT			3610		300
+# inverse NTT		4160		350
+# MultiplyNTTs		850		240
+# SampleNTT, 168 bytes	220		80
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+$avx=0;
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22);
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.09) + ($1>=2.10);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+######################################################################
+# Constants, all derived here rather than pasted, so that the tables
+# below are self-evidently those of FIPS 203.
+#
+my $q = 3329;
+my $qinv = 0;				# q^-1 mod 2^16
+for (my $i = 1; $i < 65536; $i += 2) {
+    if (($q * $i) % 65536 == 1) { $qinv = $i; last; }
+}
+my $barrett = int(((1 << 26) + int($q / 2)) / $q);	# 20159
+
+sub modexp {
+    my ($b, $e) = @_;
+    my $r = 1;
+
+    $b %= $q;
+    while ($e > 0) {
+	$r = ($r * $b) % $q if ($e & 1);
+	$b = ($b * $b) % $q;
+	$e >>= 1;
+    }
+    return $r;
+}
+sub bitrev7 {
+    my $i = shift;
+    my $r = 0;
+
+    for (my $n = 0; $n < 7; $n++) { $r = ($r << 1) | ($i & 1); $i >>= 1; }
+    return $r;
+}
+sub s16 { my $v = shift() & 0xffff; return $v >= 0x8000 ? $v - 0x10000 : $v; }
+# Montgomery form of |z|, centered, and its product with q^-1 mod 2^16
+sub mont {
+    my $z = (shift() * 65536) % $q;
+
+    $z -= $q if ($z > ($q - 1) / 2);
+    return ($z, s16($z * $qinv));
+}
+
+my @roots    = map { modexp(17, bitrev7($_)) } (0..127);
+# 17^-bitrev(i), listed in order of use as in ml_kem.c: 0, 64..127, 32..63, ...
+my @invroots = map { modexp(17, (256 - bitrev7($_)) % 256) }
+		   (0, (64..127), (32..63), (16..31), (8..15), (4..7), 2, 3, 1);
+my @modroots = map { modexp(17, 2 * bitrev7($_) + 1) } (0..127);
+my $f = modexp(128, $q - 2);		# 128^-1 mod q
+
+# Forward NTT root for coefficient |w| in the layer of half-width |len|.
+sub ntt_zeta {
+    my ($w, $len) = @_;
+
+    return $roots[128 / $len + int($w / (2 * $len))];
+}
+
+# Inverse NTT root, in the order of use of ml_kem.c's kInverseNTTRoots.
+sub intt_zeta {
+    my ($w, $len) = @_;
+    my $base = 1;
+
+    for (my $l = 2; $l < $len; $l <<= 1) { $base += 128 / $l; }
+    return $invroots[$base + int($w / (2 * $len))];
+}
+
+# Coefficient index held in each word of the "X" register when the pair
+# of vectors at coefficients 32p..32p+31 is shuffled for layer |len|, see
+# the shuffle_* subroutines below.
+sub lane_words {
+    my ($p, $len) = @_;
+    my @w;
+
+    if ($len == 8) {
+	@w = ((0..7), (16..23));
+    } elsif ($len == 4) {
+	@w = ((0..3), (16..19), (8..11), (24..27));
+    } else {
+	for (my $d = 0; $d < 8; $d++) {
+	    my $base = ($d & 1 ? 16 : 0) + 4 * ($d >> 1);
+	    push @w, $base, $base + 1;
+	}
+    }
+    return map { 32 * $p + $_ } @w;
+}
+
+sub words { return join(",", map { s16($_) } @_); }
+
+my ($out,$a,$b,$n,$len) = ("%rdi","%rsi","%rdx","%rcx","%r8");
+my @T = map("%ymm$_",(0..5));
+my ($A,$B,$X,$Y,$t,$u) = @T;
+
+# Montgomery multiplication of each word of |$x| by a constant whose
+# Montgomery form is at |$z| and product with q^-1 at |$zq|.
+sub mont_mul {
+    my ($x, $z, $zq, $t) = @_;
+
+    return <<___;
+	vpmullw		$zq,$x,$t
+	vpmulhw		$z,$x,$x
+	vpmulhw		.Lq(%rip),$t,$t
+	vpsubw		$t,$x,$x
+___
+}
+
+# Barrett reduction of signed words of |$x| to a centered representative,
+# within about q/2 of zero; the final shift by 10 is rounding, vpmulhrsw
+# by 2^5 computes (t + 2^9) >> 10.
+sub barrett {
+    my ($x, $t) = @_;
+
+    return <<___;
+	vpmulhw		.Lbarrett(%rip),$x,$t
+	vpmulhrsw	.Lround10(%rip),$t,$t
+	vpmullw		.Lq(%rip),$t,$t
+	vpsubw		$t,$x,$x
+___
+}
+
+# Map signed words of |$x| to [0, q).
+sub canonical {
+    my ($x, $t) = @_;
+
+    return barrett($x, $t) . <<___;
+	vpsraw		\$15,$x,$t
+	vpand		.Lq(%rip),$t,$t
+	vpaddw		$t,$x,$x
+___
+}
+
+# Cooley-Tukey butterfly, (x, y) -> (x + z*y, x - z*y), the latter in |$t|
+sub ct_butterfly {
+    my ($x, $y, $z, $zq, $t) = @_;
+
+    return mont_mul($y, $z, $zq, $t) . <<___;
+	vpsubw		$y,$x,$t
+	vpaddw		$y,$x,$x
+___
+}
+
+# Gentleman-Sande butterfly, (x, y) -> (x + y, z*(x - y)), the latter in |$t|
+sub gs_butterfly {
+    my ($x, $y, $z, $zq, $t, $u) = @_;
+
+    return <<___ . barrett($x, $u) . mont_mul($t, $z, $zq, $u);
+	vpsubw		$y,$x,$t
+	vpaddw		$y,$x,$x
+___
+}
+
+# Split the vectors |$A| (coefficients 0..15) and |$B| (16..31) into |$X|
+# and |$Y| so that each word of |$Y| is |len| coefficients after the
+# matching word of |$X|, and the inverse operation.
+sub shuffle {
+    my ($len, $A, $B, $X, $Y, $t) = @_;
+
+    return <<___ if ($len == 8);
+	vperm2i128	\$0x20,$B,$A,$X
+	vperm2i128	\$0x31,$B,$A,$Y
+___
+    return <<___ if ($len == 4);
+	vpunpcklqdq	$B,$A,$X
+	vpunpckhqdq	$B,$A,$Y
+___
+    return <<___;
+	vpsllq		\$32,$B,$t
+	vpblendd	\$0xaa,$t,$A,$X
+	vpsrlq		\$32,$A,$t
+	vpblendd	\$0xaa,$B,$t,$Y
+___
+}
+sub unshuffle {
+    my ($len, $X, $Y, $A, $B, $t) = @_;
+
+    return <<___ if ($len == 8);
+	vperm2i128	\$0x20,$Y,$X,$A
+	vperm2i128	\$0x31,$Y,$X,$B
+___
+    return <<___ if ($len == 4);
+	vpunpcklqdq	$Y,$X,$A
+	vpunpckhqdq	$Y,$X,$B
+___
+    return <<___;
+	vpsllq		\$32,$Y,$t
+	vpblendd	\$0xaa,$t,$X,$A
+	vpsrlq		\$32,$X,$t
+	vpblendd	\$0xaa,$Y,$t,$B
+___
+}
+
+if ($avx>1) {{{
+
+$code.=<<___;
+.text
+
+.extern	OPENSSL_ia32cap_P
+
+.globl	ossl_ml_kem_avx2_eligible
+.type	ossl_ml_kem_avx2_eligible,\@abi-omnipotent
+.align	32
+ossl_ml_kem_avx2_eligible:
+.cfi_startproc
+	mov	OPENSSL_ia32cap_P+4(%rip),%ecx
+	mov	OPENSSL_ia32cap_P+8(%rip),%edx
+	xor	%eax,%eax
+	and	\$`1<<23`,%ecx			# POPCNT
+	and	\$`1<<5`,%edx			# AVX2
+	shr	\$23,%ecx
+	shr	\$5,%edx
+	and	%edx,%ecx
+	mov	%ecx,%eax
+	ret
+.cfi_endproc
+.size	ossl_ml_kem_avx2_eligible,.-ossl_ml_kem_avx2_eligible
+___
+
+######################################################################
+# void ossl_ml_kem_ntt_avx2(uint16_t c[256]);
+#
+# Layers with len >= 16 operate on whole vectors, the last three are
+# done per pair of vectors after shuffling words into place.
+{
+$code.=<<___;
+.globl	ossl_ml_kem_ntt_avx2
+.type	ossl_ml_kem_ntt_avx2,\@function,1
+.align	32
+ossl_ml_kem_ntt_avx2:
+.cfi_startproc
+___
+for (my $len = 128, my $k = 1; $len >= 16; $len >>= 1) {
+    my $lv = $len / 16;
+
+    for (my $start = 0; $start < 16; $start += 2 * $lv, $k++) {
+	$code.=<<___;
+	vpbroadcastw	`2*$k`+.Lntt_zetas(%rip),$u
+	vpbroadcastw	`2*$k`+.Lntt_zetas_qinv(%rip),$t
+___
+	for (my $j = $start; $j < $start + $lv; $j++) {
+	    $code.=<<___;
+	vmovdqu		`32*$j`($out),$A
+	vmovdqu		`32*($j+$lv)`($out),$B
+___
+	    $code.=ct_butterfly($A, $B, $u, $t, $X);
+	    $code.=<<___;
+	vmovdqu		$A,`32*$j`($out)
+	vmovdqu		$X,`32*($j+$lv)`($out)
+___
+	}
+    }
+}
+$code.=<<___;
+	lea		.Lntt_zetas_fused(%rip),%rax
+	lea		512($out),%rcx
+.Lntt_loop:
+	vmovdqu		0($out),$A
+	vmovdqu		32($out),$B
+___
+for (my $i = 0, my $len = 8; $len >= 2; $len >>= 1, $i++) {
+    $code.=shuffle($len, $A, $B, $X, $Y, $t);
+    $code.=ct_butterfly($X, $Y, 64*$i."(%rax)", 64*$i+32 ."(%rax)", $t);
+    $code.=unshuffle($len, $X, $t, $A, $B, $Y);
+}
+$code.=canonical($A, $t) . canonical($B, $u);
+$code.=<<___;
+	vmovdqu		$A,0($out)
+	vmovdqu		$B,32($out)
+	lea		192(%rax),%rax
+	lea		64($out),$out
+	cmp		%rcx,$out
+	jne		.Lntt_loop
+
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_kem_ntt_avx2,.-ossl_ml_kem_ntt_avx2
+___
+}
+
+######################################################################
+# void ossl_ml_kem_inverse_ntt_avx2(uint16_t c[256]);
+#
+# The mirror image of the above, with the scaling by 128^-1 folded into
+# the last layer.
+{
+$code.=<<___;
+.globl	ossl_ml_kem_inverse_ntt_avx2
+.type	ossl_ml_kem_inverse_ntt_avx2,\@function,1
+.align	32
+ossl_ml_kem_inverse_ntt_avx2:
+.cfi_startproc
+	lea		.Lintt_zetas_fused(%rip),%rax
+	mov		$out,%rdx
+	lea		512($out),%rcx
+.Lintt_loop:
+	vmovdqu		0(%rdx),$A
+	vmovdqu		32(%rdx),$B
+___
+for (my $i = 0, my $len = 2; $len <= 8; $len <<= 1, $i++) {
+    $code.=shuffle($len, $A, $B, $X, $Y, $t);
+    $code.=gs_butterfly($X, $Y, 64*$i."(%rax)", 64*$i+32 ."(%rax)", $t, $u);
+    $code.=unshuffle($len, $X, $t, $A, $B, $Y);
+}
+$code.=<<___;
+	vmovdqu		$A,0(%rdx)
+	vmovdqu		$B,32(%rdx)
+	lea		192(%rax),%rax
+	lea		64(%rdx),%rdx
+	cmp		%rcx,%rdx
+	jne		.Lintt_loop
+___
+for (my $len = 16, my $k = 113; $len <= 64; $len <<= 1) {
+    my $lv = $len / 16;
+
+    for (my $start = 0; $start < 16; $start += 2 * $lv, $k++) {
+	$code.=<<___;
+	vpbroadcastw	`2*$k`+.Lintt_zetas(%rip),%ymm4
+	vpbroadcastw	`2*$k`+.Lintt_zetas_qinv(%rip),%ymm5
+___
+	for (my $j = $start; $j < $start + $lv; $j++) {
+	    $code.=<<___;
+	vmovdqu		`32*$j`($out),$A
+	vmovdqu		`32*($j+$lv)`($out),$B
+___
+	    $code.=gs_butterfly($A, $B, "%ymm4", "%ymm5", $X, $Y);
+	    $code.=<<___;
+	vmovdqu		$A,`32*$j`($out)
+	vmovdqu		$X,`32*($j+$lv)`($out)
+___
+	}
+    }
+}
+# Last layer: x' = f*(x + y), y' = f*zeta*(x - y)
+for (my $j = 0; $j < 8; $j++) {
+    $code.=<<___;
+	vmovdqu		`32*$j`($out),$A
+	vmovdqu		`32*($j+8)`($out),$B
+	vpsubw		$B,$A,$X
+	vpaddw		$B,$A,$A
+___
+    $code.=mont_mul($A, ".Lintt_f(%rip)", ".Lintt_f_qinv(%rip)", $Y);
+    $code.=mont_mul($X, ".Lintt_fz(%rip)", ".Lintt_fz_qinv(%rip)", $Y);
+    $code.=canonical($A, $Y) . canonical($X, $Y);
+    $code.=<<___;
+	vmovdqu		$A,`32*$j`($out)
+	vmovdqu		$X,`32*($j+8)`($out)
+___
+}
+$code.=<<___;
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_kem_inverse_ntt_avx2,.-ossl_ml_kem_inverse_ntt_avx2
+___
+}
+
+######################################################################
+# void ossl_ml_kem_mult_avx2(uint16_t out[256], const uint16_t lhs[256],
+#                            const uint16_t rhs[256]);
+# void ossl_ml_kem_mult_add_avx2(uint16_t out[256], const uint16_t lhs[256],
+#                                const uint16_t rhs[256]);
+#
+# Words 2i and 2i+1 are the coefficients of a degree-one polynomial in
+# GF(q)[X]/(X^2 - zeta_i).  Even output words need l0*r0 + zeta*l1*r1 and
+# odd ones l0*r1 + l1*r0; both are computed in all lanes and blended.
+for my $add (0, 1) {
+my $name = $add ? "ossl_ml_kem_mult_add_avx2" : "ossl_ml_kem_mult_avx2";
+my $lbl = $add ? "mult_add" : "mult";
+my ($L,$R,$P,$t) = map("%ymm$_",(0..3));
+
+$code.=<<___;
+.globl	$name
+.type	$name,\@function,3
+.align	32
+$name:
+.cfi_startproc
+	lea		.Lmult_zetas(%rip),%rax
+	lea		512($out),%rcx
+.L${lbl}_loop:
+	vmovdqu		($a),$L
+	vmovdqu		($b),$R
+
+	vpmullw		$R,$L,$t		# [l0*r0, l1*r1] / R
+	vpmullw		.Lqinv(%rip),$t,$t
+	vpmulhw		$R,$L,$P
+	vpmulhw		.Lq(%rip),$t,$t
+	vpsubw		$t,$P,$P
+
+	vpshufb		.Lswap16(%rip),$R,$R	# [l0*r1, l1*r0] / R
+	vpmullw		$R,$L,$t
+	vpmullw		.Lqinv(%rip),$t,$t
+	vpmulhw		$R,$L,$L
+	vpmulhw		.Lq(%rip),$t,$t
+	vpsubw		$t,$L,$L
+
+	vpmullw		32(%rax),$P,$t		# zeta*l1*r1 / R
+	vpmulhw		(%rax),$P,$R
+	vpmulhw		.Lq(%rip),$t,$t
+	vpsubw		$t,$R,$R
+
+	vpsrld		\$16,$R,$R
+	vpaddw		$R,$P,$P		# even words
+	vpslld		\$16,$L,$t
+	vpaddw		$t,$L,$L		# odd words
+	vpblendw	\$0xaa,$L,$P,$P
+___
+$code.=mont_mul($P, ".Lr2(%rip)", ".Lr2_qinv(%rip)", $t);
+$code.=<<___ if ($add);
+	vpaddw		($out),$P,$P
+___
+$code.=canonical($P, $t);
+$code.=<<___;
+	vmovdqu		$P,($out)
+	lea		64(%rax),%rax
+	lea		32($a),$a
+	lea		32($b),$b
+	lea		32($out),$out
+	cmp		%rcx,$out
+	jne		.L${lbl}_loop
+
+	vzeroupper
+	ret
+.cfi_endproc
+.size	$name,.-$name
+___
+}
+
+######################################################################
+# size_t ossl_ml_kem_rej_uniform_avx2(uint16_t *out, size_t n,
+#                                     const uint8_t *in, size_t len,
+#                                     size_t *used);
+#
+# Consumes 24-byte groups of |in| for as long as at least 16 output
+# slots remain in |out| and a whole group remains in |in|.  Returns the
+# number of elements written and sets |*used| to the number of input
+# bytes consumed; the caller completes the tail in C.
+{
+my ($V,$T,$M) = map("%ymm$_",(0..2));
+
+$code.=<<___;
+.globl	ossl_ml_kem_rej_uniform_avx2
+.type	ossl_ml_kem_rej_uniform_avx2,\@function,5
+.align	32
+ossl_ml_kem_rej_uniform_avx2:
+.cfi_startproc
+	xor		%eax,%eax		# elements written
+	mov		$b,($len)		# start of input, for *used
+	lea		.Lrej_idx(%rip),%r10
+	sub		\$16,$a			# last start of a 16-element write
+	jb		.Lrej_done
+	sub		\$24,$n
+	jb		.Lrej_done
+	add		$b,$n			# last start of a 24-byte group
+	jmp		.Lrej_check
+
+.align	16
+.Lrej_loop:
+	vmovdqu		($b),%xmm0
+	vinserti128	\$1,8($b),$V,$V
+	vpshufb		.Lrej_shuf(%rip),$V,$V
+	vpsrlw		\$4,$V,$T
+	vpblendw	\$0xaa,$T,$V,$V
+	vpand		.Lmask12(%rip),$V,$V
+	vmovdqa		.Lq(%rip),$M
+	vpcmpgtw	$V,$M,$M
+	vpacksswb	$M,$M,$M
+	vpmovmskb	$M,%r11d
+
+	movzb		%r11b,%r9d
+	shl		\$4,%r9d
+	vpshufb		(%r10,%r9),%xmm0,%xmm2
+	vmovdqu		%xmm2,($out,%rax,2)
+	shr		\$4,%r9d
+	popcnt		%r9d,%r9d
+	add		%r9,%rax
+
+	shr		\$16,%r11d
+	movzb		%r11b,%r9d
+	shl		\$4,%r9d
+	vextracti128	\$1,$V,%xmm1
+	vpshufb		(%r10,%r9),%xmm1,%xmm2
+	vmovdqu		%xmm2,($out,%rax,2)
+	shr		\$4,%r9d
+	popcnt		%r9d,%r9d
+	add		%r9,%rax
+
+	lea		24($b),$b
+.Lrej_check:
+	cmp		$a,%rax
+	ja		.Lrej_done
+	cmp		$n,$b
+	jbe		.Lrej_loop
+
+.Lrej_done:
+	sub		($len),$b
+	mov		$b,($len)
+	vzeroupper
+	ret
+.cfi_endproc
+.size	ossl_ml_kem_rej_uniform_avx2,.-ossl_ml_kem_rej_uniform_avx2
+___
+}
+
+######################################################################
+# Tables
+{
+my (@z, @zq);
+
+$code.=<<___;
+.section .rodata align=64
+.align	64
+.Lq:
+	.value	`join(",", ($q) x 16)`
+.Lqinv:
+	.value	`words(($qinv) x 16)`
+.Lbarrett:
+	.value	`join(",", ($barrett) x 16)`
+.Lround10:
+	.value	`join(",", (32) x 16)`
+.Lmask12:
+	.value	`join(",", (0xfff) x 16)`
+___
+my ($r2, $r2q) = mont(65536 % $q);	# R^2 mod q, i.e. R in Montgomery form
+my ($fm, $fmq) = mont($f);
+my ($fz, $fzq) = mont(($f * $invroots[127]) % $q);
+$code.=<<___;
+.Lr2:
+	.value	`words(($r2) x 16)`
+.Lr2_qinv:
+	.value	`words(($r2q) x 16)`
+.Lintt_f:
+	.value	`words(($fm) x 16)`
+.Lintt_f_qinv:
+	.value	`words(($fmq) x 16)`
+.Lintt_fz:
+	.value	`words(($fz) x 16)`
+.Lintt_fz_qinv:
+	.value	`words(($fzq) x 16)`
+.Lswap16:
+	.byte	2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13
+	.byte	2,3,0,1,6,7,4,5,10,11,8,9,14,15,12,13
+___
+# Rejection sampling: lane 0 holds bytes 0..15 and lane 1 bytes 8..23 of
+# a group, each dword is made [b0,b1,b1,b2] for a pair of candidates.
+my @shuf;
+for my $lane (0, 1) {
+    for (my $g = 0; $g < 4; $g++) {
+	my $o = 3 * $g + 4 * $lane;
+	push @shuf, $o, $o + 1, $o + 1, $o + 2;
+    }
+}
+$code.=".Lrej_shuf:\n\t.byte\t" . join(",", @shuf) . "\n";
+
+@z = (); @zq = ();
+foreach my $k (0..127) { my ($m, $mq) = mont($roots[$k]); push @z, $m; push @zq, $mq; }
+$code.=".Lntt_zetas:\n\t.value\t" . words(@z) . "\n";
+$code.=".Lntt_zetas_qinv:\n\t.value\t" . words(@zq) . "\n";
+@z = (); @zq = ();
+foreach my $k (0..127) { my ($m, $mq) = mont($invroots[$k]); push @z, $m; push @zq, $mq; }
+$code.=".Lintt_zetas:\n\t.value\t" . words(@z) . "\n";
+$code.=".Lintt_zetas_qinv:\n\t.value\t" . words(@zq) . "\n";
+
+# Per-word roots for the three shuffled layers of each pair of vectors
+for my $inv (0, 1) {
+    $code.=$inv ? ".Lintt_zetas_fused:\n" : ".Lntt_zetas_fused:\n";
+    for (my $p = 0; $p < 8; $p++) {
+	my @lens = $inv ? (2, 4, 8) : (8, 4, 2);
+
+	foreach my $len (@lens) {
+	    @z = (); @zq = ();
+	    foreach my $w (lane_words($p, $len)) {
+		my ($m, $mq) = mont($inv ? intt_zeta($w, $len)
+					 : ntt_zeta($w, $len));
+		push @z, $m; push @zq, $mq;
+	    }
+	    $code.="\t.value\t" . words(@z) . "\n";
+	    $code.="\t.value\t" . words(@zq) . "\n";
+	}
+    }
+}
+
+# MultiplyNTTs roots, two words per pair of coefficients
+$code.=".Lmult_zetas:\n";
+for (my $v = 0; $v < 16; $v++) {
+    @z = (); @zq = ();
+    for (my $i = 8 * $v; $i < 8 * $v + 8; $i++) {
+	my ($m, $mq) = mont($modroots[$i]);
+	push @z, $m, $m; push @zq, $mq, $mq;
+    }
+    $code.="\t.value\t" . words(@z) . "\n";
+    $code.="\t.value\t" . words(@zq) . "\n";
+}
+
+# vpshufb masks that compact the accepted words of an 8-word lane
+$code.=".Lrej_idx:\n";
+for (my $m = 0; $m < 256; $m++) {
+    my @idx;
+
+    for (my $i = 0; $i < 8; $i++) {
+	push @idx, 2 * $i, 2 * $i + 1 if ($m & (1 << $i));
+    }
+    push @idx, 0x80 while (@idx < 16);
+    $code.="\t.byte\t" . join(",", @idx) . "\n";
+}
+$code.=".text\n";
+}
+
+}}} else {{{
+
+$code.=<<___;
+.text
+
+.globl	ossl_ml_kem_avx2_eligible
+.type	ossl_ml_kem_avx2_eligible,\@abi-omnipotent
+ossl_ml_kem_avx2_eligible:
+	xor	%eax,%eax
+	ret
+.size	ossl_ml_kem_avx2_eligible,.-ossl_ml_kem_avx2_eligible
+
+.globl	ossl_ml_kem_ntt_avx2
+.globl	ossl_ml_kem_inverse_ntt_avx2
+.globl	ossl_ml_kem_mult_avx2
+.globl	ossl_ml_kem_mult_add_avx2
+.globl	ossl_ml_kem_rej_uniform_avx2
+.type	ossl_ml_kem_ntt_avx2,\@abi-omnipotent
+ossl_ml_kem_ntt_avx2:
+ossl_ml_kem_inverse_ntt_avx2:
+ossl_ml_kem_mult_avx2:
+ossl_ml_kem_mult_add_avx2:
+ossl_ml_kem_rej_uniform_avx2:
+	.byte	0x0f,0x0b	# ud2
+	ret
+.size	ossl_ml_kem_ntt_avx2,.-ossl_ml_kem_ntt_avx2
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval $1/gem;
+print $code;
+close STDOUT or die "error closing STDOUT: $!";
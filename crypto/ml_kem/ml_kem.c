@@ -19,6 +19,27 @@
 #include <valgrind/memcheck.h>
 #endif
 
+/*
+ * x86_64 AVX2 kernels, see asm/ml_kem-x86_64.pl.  They produce exactly the
+ * same (fully reduced) output as the portable C below, and are selected at
+ * runtime when OPENSSL_ia32cap reports AVX2 and POPCNT.
+ */
+#if defined(ML_KEM_AVX2_ASM)
+int ossl_ml_kem_avx2_eligible(void);
+void ossl_ml_kem_ntt_avx2(uint16_t c[ML_KEM_DEGREE]);
+void ossl_ml_kem_inverse_ntt_avx2(uint16_t c[ML_KEM_DEGREE]);
+void ossl_ml_kem_mult_avx2(uint16_t out[ML_KEM_DEGREE],
+                           const uint16_t lhs[ML_KEM_DEGREE],
+                           const uint16_t rhs[ML_KEM_DEGREE]);
+void ossl_ml_kem_mult_add_avx2(uint16_t out[ML_KEM_DEGREE],
+                               const uint16_t lhs[ML_KEM_DEGREE],
+                               const uint16_t rhs[ML_KEM_DEGREE]);
+size_t ossl_ml_kem_rej_uniform_avx2(uint16_t *out, size_t n,
+                                    const uint8_t *in, size_t len,
+                                    size_t *used);
+# define ML_KEM_AVX2_CAPABLE ossl_ml_kem_avx2_eligible()
+#endif
+
 #if ML_KEM_SEED_BYTES != ML_KEM_SHARED_SECRET_BYTES + ML_KEM_RANDOM_BYTES
 # error "ML-KEM keygen seed length != shared secret + random bytes length"
 #endif
@@ -428,6 +449,45 @@ int kdf(uint8_t out[ML_KEM_SHARED_SECRET_BYTES],
         && EVP_DigestFinalXOF(mdctx, out, ML_KEM_SHARED_SECRET_BYTES);
 }
 
+/*
+ * Rejection-samples the |len| bytes at |in| into coefficients in [0,q),
+ * stopping when |endout| is reached, and returns the next output position.
+ * |len| must be a multiple of 3.
+ */
+static uint16_t *rej_uniform(uint16_t *curr, uint16_t *endout,
+                             const uint8_t *in, size_t len)
+{
+    const uint8_t *endin = in + len;
+    uint16_t d;
+    uint8_t b1, b2, b3;
+
+#ifdef ML_KEM_AVX2_CAPABLE
+    /* The vector kernel leaves any tail of the buffer to the loop below */
+    if (ML_KEM_AVX2_CAPABLE) {
+        size_t used;
+
+        curr += ossl_ml_kem_rej_uniform_avx2(curr, endout - curr,
+                                             in, len, &used);
+        in += used;
+    }
+#endif
+    while (in < endin) {
+        b1 = *in++;
+        b2 = *in++;
+        b3 = *in++;
+
+        if (curr >= endout)
+            break;
+        if ((d = ((b2 & 0x0f) << 8) + b1) < kPrime)
+            *curr++ = d;
+        if (curr >= endout)
+            break;
+        if ((d = (b3 << 4) + (b2 >> 4)) < kPrime)
+            *curr++ = d;
+    }
+    return curr;
+}
+
 /*
  * FIPS 203, Section 4.2.2, Algorithm 7: "SampleNTT" (steps 3-17, steps 1, 2
  * are performed by the caller). Rejection-samples a Keccak stream to get
@@ -438,32 +498,43 @@ static __owur
 int sample_scalar(scalar *out, EVP_MD_CTX *mdctx)
 {
     uint16_t *curr = out->c, *endout = curr + DEGREE;
-    uint8_t buf[SCALAR_SAMPLING_BUFSIZE], *in;
-    uint8_t *endin = buf + sizeof(buf);
-    uint16_t d;
-    uint8_t b1, b2, b3;
+    uint8_t buf[SCALAR_SAMPLING_BUFSIZE];
 
     do {
-        if (!EVP_DigestSqueeze(mdctx, in = buf, sizeof(buf)))
+        if (!EVP_DigestSqueeze(mdctx, buf, sizeof(buf)))
             return 0;
-        do {
-            b1 = *in++;
-            b2 = *in++;
-            b3 = *in++;
-
-            if (curr >= endout)
-                break;
-            if ((d = ((b2 & 0x0f) << 8) + b1) < kPrime)
-                *curr++ = d;
-            if (curr >= endout)
-                break;
-            if ((d = (b3 << 4) + (b2 >> 4)) < kPrime)
-                *curr++ = d;
-        } while (in < endin);
+        curr = rej_uniform(curr, endout, buf, sizeof(buf));
     } while (curr < endout);
     return 1;
 }
 
+/*
+ * As sample_scalar(), for four matrix entries at once, with the SHAKE128
+ * instances seeded from |in| computed in parallel.
+ */
+static void sample_scalar_x4(scalar *out[4], const uint8_t *const in[4],
+                             size_t inlen)
+{
+    KECCAK1600_X4_CTX ctx;
+    uint8_t buf[4][SHA3_BLOCKSIZE(128)];
+    uint8_t *const bufs[4] = { buf[0], buf[1], buf[2], buf[3] };
+    uint16_t *curr[4];
+    int i, more;
+
+    for (i = 0; i < 4; i++)
+        curr[i] = out[i]->c;
+    ossl_shake_x4_init(&ctx, 128);
+    ossl_shake_x4_absorb(&ctx, in, inlen);
+    do {
+        ossl_shake_x4_squeeze(&ctx, bufs, 1);
+        for (more = 0, i = 0; i < 4; i++) {
+            curr[i] = rej_uniform(curr[i], out[i]->c + DEGREE,
+                                  buf[i], sizeof(buf[i]));
+            more |= curr[i] < out[i]->c + DEGREE;
+        }
+    } while (more);
+}
+
 /*-
  * reduce_once reduces 0 <= x < 2*kPrime, mod kPrime.
  *
@@ -520,6 +591,13 @@ static void scalar_ntt(scalar *s)
     uint16_t *end = s->c + DEGREE;
     int offset = DEGREE / 2;
 
+#ifdef ML_KEM_AVX2_CAPABLE
+    if (ML_KEM_AVX2_CAPABLE) {
+        ossl_ml_kem_ntt_avx2(s->c);
+        return;
+    }
+#endif
+
     do {
         uint16_t *curr = s->c, *peer;
 
@@ -552,6 +630,13 @@ static void scalar_inverse_ntt(scalar *s)
     uint16_t *end = s->c + DEGREE;
     int offset = 2;
 
+#ifdef ML_KEM_AVX2_CAPABLE
+    if (ML_KEM_AVX2_CAPABLE) {
+        ossl_ml_kem_inverse_ntt_avx2(s->c);
+        return;
+    }
+#endif
+
     do {
         uint16_t *curr = s->c, *peer;
 
@@ -607,6 +692,13 @@ static void scalar_mult(scalar *out, const scalar *lhs,
     const uint16_t *lc = lhs->c, *rc = rhs->c;
     const uint16_t *roots = kModRoots;
 
+#ifdef ML_KEM_AVX2_CAPABLE
+    if (ML_KEM_AVX2_CAPABLE) {
+        ossl_ml_kem_mult_avx2(out->c, lhs->c, rhs->c);
+        return;
+    }
+#endif
+
     do {
         uint32_t l0 = *lc++, r0 = *rc++;
         uint32_t l1 = *lc++, r1 = *rc++;
@@ -626,6 +718,13 @@ void scalar_mult_add(scalar *out, const scalar *lhs,
     const uint16_t *lc = lhs->c, *rc = rhs->c;
     const uint16_t *roots = kModRoots;
 
+#ifdef ML_KEM_AVX2_CAPABLE
+    if (ML_KEM_AVX2_CAPABLE) {
+        ossl_ml_kem_mult_add_avx2(out->c, lhs->c, rhs->c);
+        return;
+    }
+#endif
+
     do {
         uint32_t l0 = *lc++, r0 = *rc++;
         uint32_t l1 = *lc++, r1 = *rc++;
@@ -997,8 +1096,35 @@ int matrix_expand(EVP_MD_CTX *mdctx, ML_KEM_KEY *key)
     int i, j;
 
     memcpy(input, key->rho, ML_KEM_RANDOM_BYTES);
-    for (i = 0; i < rank; i++) {
-        for (j = 0; j < rank; j++) {
+    i = j = 0;
+    /*
+     * Where four-way Keccak is faster, take the entries four at a time and
+     * leave any remainder, one entry for ML-KEM-768, to the loop below.
+     */
+    if (ossl_keccak1600_x4_capable()) {
+        uint8_t inputs[4][sizeof(input)];
+        const uint8_t *const in[4] = {
+            inputs[0], inputs[1], inputs[2], inputs[3]
+        };
+        scalar *outs[4];
+        int n, k;
+
+        for (n = rank * rank; n >= 4; n -= 4) {
+            for (k = 0; k < 4; k++) {
+                memcpy(inputs[k], key->rho, ML_KEM_RANDOM_BYTES);
+                inputs[k][ML_KEM_RANDOM_BYTES] = i;
+                inputs[k][ML_KEM_RANDOM_BYTES + 1] = j;
+                outs[k] = out++;
+                if (++j == rank) {
+                    j = 0;
+                    ++i;
+                }
+            }
+            sample_scalar_x4(outs, in, sizeof(input));
+        }
+    }
+    for (; i < rank; i++, j = 0) {
+        for (; j < rank; j++) {
             input[ML_KEM_RANDOM_BYTES] = i;
             input[ML_KEM_RANDOM_BYTES + 1] = j;
             if (!EVP_DigestInit_ex(mdctx, key->shake128_md, NULL)
@@ -0,0 +1,280 @@
+#! /usr/bin/env perl
+# Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# Multi-buffer Keccak-f[1600] for x86_64, in the spirit of
+# sha256-mb-x86_64.pl: four independent states are processed in
+# parallel, one in each 64-bit lane of a %ymm register.
+#
+# The state is kept lane-interleaved in memory, A[25][4], so that the
+# lane (x, y) of all four states is a single 32-byte word at offset
+# 32*(x + 5*y).  A round reads the state from one buffer and writes it
+# to the other, caller-provided, scratch buffer, which makes Rho and Pi
+# simple addressing; the 24 rounds return the result to the original
+# buffer.
+#
+# There are two code paths, selected at run time.  Plain AVX2 works in
+# %ymm0-%ymm5 only, spilling the Theta column values to the scratch
+# buffer, and needs three instructions per rotation.  AVX-512VL keeps
+# the column values in %ymm16-%ymm25 and uses vprolq and vpternlogq.
+# Neither touches registers that are callee-saved on Windows.
+#
+# TSC ticks per squeezed SHAKE128 block and state, Sapphire Rapids:
+#
+# keccak1600-x86_64, one state through EVP	880
+# this module, AVX2				540
+# this module, AVX-512VL			390
+
+# $output is the last argument if it looks like a file (it has an extension)
+# $flavour is the first argument if it doesn't look like a file
+$output = $#ARGV >= 0 && $ARGV[$#ARGV] =~ m|\.\w+$| ? pop : undef;
+$flavour = $#ARGV >= 0 && $ARGV[0] !~ m|\.| ? shift : undef;
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+$avx=0;
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22) + ($1>=2.25);
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.09) + ($1>=2.10) + ($1>=2.12);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:clang|LLVM) version|.*based on LLVM) ([0-9]+\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0) + ($2>=7.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\""
+    or die "can't call $xlate: $!";
+*STDOUT=*OUT;
+
+my @rhotates = ([  0,  1, 62, 28, 27 ],		# [y][x], as in keccak1600.c
+		[ 36, 44,  6, 55, 20 ],
+		[  3, 10, 43, 25, 39 ],
+		[ 41, 45, 15, 21,  8 ],
+		[ 18,  2, 61, 56, 14 ]);
+
+my @iotas = (
+	0x0000000000000001, 0x0000000000008082, 0x800000000000808a,
+	0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
+	0x8000000080008081, 0x8000000000008009, 0x000000000000008a,
+	0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+	0x000000008000808b, 0x800000000000008b, 0x8000000000008089,
+	0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+	0x000000000000800a, 0x800000008000000a, 0x8000000080008081,
+	0x8000000000008080, 0x0000000080000001, 0x8000000080008008);
+
+my ($A,$T,$rc) = ("%rdi","%rsi","%rax");
+my ($B,$C,$D,$t);
+
+# Offset of lane (x, y) in a state buffer, and of the column values C[x]
+# and D[x] in the scratch buffer, past the 25 lanes of the other state.
+sub lane { my ($x, $y) = @_; return 32 * (($x % 5) + 5 * ($y % 5)); }
+sub ccol { return 32 * (25 + ($_[0] % 5)); }
+sub dcol { return 32 * (30 + ($_[0] % 5)); }
+
+# Rotate the qwords of |$x| left by |$n|, using |$t| as scratch.
+sub rol {
+    my ($avx512, $x, $n, $t) = @_;
+
+    return "" if ($n == 0);
+    return "\tvprolq\t\t\$$n,$x,$x\n" if ($avx512);
+    return <<___;
+	vpsllq		\$$n,$x,$t
+	vpsrlq		\$`64-$n`,$x,$x
+	vpor		$t,$x,$x
+___
+}
+
+# One round of Keccak-f[1600] reading the state at |$src| and writing it
+# to |$dst|, followed by Iota with the round constant at (%rax).
+sub round {
+    my ($avx512, $src, $dst) = @_;
+    my ($mov, $xor) = $avx512 ? ("vmovdqu64", "vpxorq") : ("vmovdqu", "vpxor");
+    my $code = "";
+
+    # Theta: C[x] = A[x,0] ^ ... ^ A[x,4], D[x] = C[x-1] ^ rol(C[x+1], 1).
+    # With AVX-512VL C and D stay in %ymm16-%ymm25, otherwise C is also
+    # spilled, each C[x+1] register is rotated in place once, and the D
+    # values go to the scratch buffer.
+    for (my $x = 0; $x < 5; $x++) {
+	$code .= "\t$mov\t" . lane($x, 0) . "($src),$C->[$x]\n";
+	if ($avx512) {
+	    $code .= <<___;
+	vmovdqu64	`lane($x, 1)`($src),$t
+	vpternlogq	\$0x96,`lane($x, 2)`($src),$t,$C->[$x]
+	vmovdqu64	`lane($x, 3)`($src),$t
+	vpternlogq	\$0x96,`lane($x, 4)`($src),$t,$C->[$x]
+___
+	} else {
+	    for (my $y = 1; $y < 5; $y++) {
+		$code .= "\tvpxor\t\t" . lane($x, $y) . "($src),$C->[$x],$C->[$x]\n";
+	    }
+	    $code .= "\tvmovdqu\t\t$C->[$x]," . ccol($x) . "($T)\n";
+	}
+    }
+    for (my $x = 0; $x < 5; $x++) {
+	my ($cp, $cn) = ($C->[($x + 4) % 5], $C->[($x + 1) % 5]);
+
+	if ($avx512) {
+	    $code .= <<___;
+	vprolq		\$1,$cn,$D->[$x]
+	vpxorq		$cp,$D->[$x],$D->[$x]
+___
+	} else {
+	    $code .= <<___;
+	vpsrlq		\$63,$cn,$t
+	vpaddq		$cn,$cn,$cn
+	vpor		$t,$cn,$cn
+	vpxor		`ccol($x + 4)`($T),$cn,$cn
+	vmovdqu		$cn,`dcol($x)`($T)
+___
+	}
+    }
+
+    # Rho and Pi: B[X,Y] = rol(A[x,y] ^ D[x], r[y][x]) with X = y and
+    # Y = 2x + 3y, then Chi and Iota, one output plane at a time.
+    for (my $Y = 0; $Y < 5; $Y++) {
+	for (my $X = 0; $X < 5; $X++) {
+	    my ($x, $y) = ((3 * ($Y - 3 * $X + 25)) % 5, $X);
+
+	    $code .= "\t$mov\t" . lane($x, $y) . "($src),$B->[$X]\n";
+	    $code .= $avx512 ? "\tvpxorq\t\t$D->[$x],$B->[$X],$B->[$X]\n"
+			     : "\tvpxor\t\t" . dcol($x) . "($T),$B->[$X],$B->[$X]\n";
+	    $code .= rol($avx512, $B->[$X], $rhotates[$y][$x], $t);
+	}
+	for (my $X = 0; $X < 5; $X++) {
+	    my ($b0, $b1, $b2) = map { $B->[($X + $_) % 5] } (0..2);
+
+	    if ($avx512) {
+		$code .= <<___;
+	vmovdqa64	$b0,$t
+	vpternlogq	\$0xd2,$b2,$b1,$t
+___
+	    } else {
+		$code .= <<___;
+	vpandn		$b2,$b1,$t
+	vpxor		$b0,$t,$t
+___
+	    }
+	    $code .= "\t$xor\t\t($rc),$t,$t\n" if ($X == 0 && $Y == 0);
+	    $code .= "\t$mov\t$t," . lane($X, $Y) . "($dst)\n";
+	}
+    }
+    return $code;
+}
+
+if ($avx>1) {{{
+
+$code.=<<___;
+.text
+
+.extern	OPENSSL_ia32cap_P
+
+######################################################################
+# void ossl_keccakf1600_x4(uint64_t A[25][4], uint64_t scratch[35][4]);
+#
+# Applies Keccak-f[1600] to each of the four lane-interleaved states.
+# The caller checks that AVX2 is available; AVX-512VL is used if
+# present.
+.globl	ossl_keccakf1600_x4
+.type	ossl_keccakf1600_x4,\@function,2
+.align	32
+ossl_keccakf1600_x4:
+.cfi_startproc
+	lea		.Liotas(%rip),$rc
+___
+$code.=<<___ if ($avx>2);
+	mov		OPENSSL_ia32cap_P+8(%rip),%r8d
+	and		\$`1<<31|1<<16`,%r8d	# AVX512VL + AVX512F
+	cmp		\$`1<<31|1<<16`,%r8d
+	je		.Lkeccak_x4_avx512vl
+___
+($B, $C, $t) = ([ map("%ymm$_",(0..4)) ], [ map("%ymm$_",(0..4)) ], "%ymm5");
+$code.=<<___;
+.align	32
+.Loop_x4_avx2:
+___
+$code.=round(0, $A, $T);
+$code.="\tlea\t\t32($rc),$rc\n";
+$code.=round(0, $T, $A);
+$code.=<<___;
+	lea		32($rc),$rc
+	lea		.Liotas+32*24(%rip),%rcx
+	cmp		%rcx,$rc
+	jne		.Loop_x4_avx2
+
+	vzeroupper
+	ret
+___
+if ($avx>2) {
+($B, $C, $D, $t) = ([ map("%ymm$_",(0..4)) ], [ map("%ymm$_",(16..20)) ],
+		    [ map("%ymm$_",(21..25)) ], "%ymm5");
+$code.=<<___;
+.align	32
+.Lkeccak_x4_avx512vl:
+___
+$code.=round(1, $A, $T);
+$code.="\tlea\t\t32($rc),$rc\n";
+$code.=round(1, $T, $A);
+$code.=<<___;
+	lea		32($rc),$rc
+	lea		.Liotas+32*24(%rip),%rcx
+	cmp		%rcx,$rc
+	jne		.Lkeccak_x4_avx512vl
+
+	vzeroupper
+	ret
+___
+}
+$code.=<<___;
+.cfi_endproc
+.size	ossl_keccakf1600_x4,.-ossl_keccakf1600_x4
+
+.section .rodata align=64
+.align	64
+.Liotas:
+___
+foreach (@iotas) {
+    my $v = sprintf("0x%016x", $_);
+
+    $code.="\t.quad\t" . join(",", ($v) x 4) . "\n";
+}
+$code.=".text\n";
+
+}}} else {{{
+
+$code.=<<___;
+.text
+
+.globl	ossl_keccakf1600_x4
+.type	ossl_keccakf1600_x4,\@abi-omnipotent
+ossl_keccakf1600_x4:
+	.byte	0x0f,0x0b	# ud2
+	ret
+.size	ossl_keccakf1600_x4,.-ossl_keccakf1600_x4
+___
+}}}
+
+$code =~ s/\`([^\`]*)\`/eval $1/gem;
+print $code;
+close STDOUT or die "error closing STDOUT: $!";
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Four-way SHAKE for callers with several independent, equal-length
+ * inputs, such as the entries of the ML-KEM and ML-DSA public matrices.
+ *
+ * The four states are kept lane-interleaved, A[i][j] being lane i of
+ * state j, which is the layout the x86_64 multi-buffer permutation in
+ * asm/keccak1600-mb-x86_64.pl works on.  Elsewhere a portable four-way
+ * permutation is used; it is correct but not faster than running the
+ * single-state code four times, so callers should only take this path
+ * when ossl_keccak1600_x4_capable() says so.
+ */
+
+#include <string.h>
+#include <openssl/byteorder.h>
+#include "internal/cryptlib.h"
+#include "internal/sha3.h"
+
+#if defined(KECCAK1600_X4_ASM)
+void ossl_keccakf1600_x4(uint64_t A[25][4], uint64_t scratch[35][4]);
+#endif
+
+static const unsigned char rhotates[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+static const uint64_t iotas[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static ossl_inline uint64_t rol64(uint64_t v, unsigned int n)
+{
+    return n == 0 ? v : (v << n) | (v >> (64 - n));
+}
+
+/* Reference Keccak-f[1600] on four interleaved states */
+static void keccakf1600_x4_c(uint64_t A[25][4])
+{
+    uint64_t B[25][4], C[5][4], D[4];
+    size_t round, x, y, j;
+
+    for (round = 0; round < 24; round++) {
+        for (x = 0; x < 5; x++)
+            for (j = 0; j < 4; j++)
+                C[x][j] = A[x][j] ^ A[x + 5][j] ^ A[x + 10][j]
+                          ^ A[x + 15][j] ^ A[x + 20][j];
+        for (x = 0; x < 5; x++) {
+            for (j = 0; j < 4; j++)
+                D[j] = C[(x + 4) % 5][j] ^ rol64(C[(x + 1) % 5][j], 1);
+            /* Theta, Rho and Pi: B[y, 2x + 3y] = rol(A[x, y] ^ D[x]) */
+            for (y = 0; y < 5; y++)
+                for (j = 0; j < 4; j++)
+                    B[y + 5 * ((2 * x + 3 * y) % 5)][j] =
+                        rol64(A[x + 5 * y][j] ^ D[j], rhotates[x + 5 * y]);
+        }
+        for (y = 0; y < 25; y += 5)
+            for (x = 0; x < 5; x++)
+                for (j = 0; j < 4; j++)
+                    A[y + x][j] = B[y + x][j]
+                                  ^ (~B[y + (x + 1) % 5][j]
+                                     & B[y + (x + 2) % 5][j]);
+        for (j = 0; j < 4; j++)
+            A[0][j] ^= iotas[round];
+    }
+}
+
+int ossl_keccak1600_x4_capable(void)
+{
+#if defined(KECCAK1600_X4_ASM)
+    return (OPENSSL_ia32cap_P[2] & (1 << 5)) != 0;      /* AVX2 */
+#else
+    return 0;
+#endif
+}
+
+static void keccakf1600_x4(uint64_t A[25][4])
+{
+#if defined(KECCAK1600_X4_ASM)
+    if (OPENSSL_ia32cap_P[2] & (1 << 5)) {
+        uint64_t scratch[35][4];
+
+        ossl_keccakf1600_x4(A, scratch);
+        return;
+    }
+#endif
+    keccakf1600_x4_c(A);
+}
+
+void ossl_shake_x4_init(KECCAK1600_X4_CTX *ctx, size_t bitlen)
+{
+    memset(ctx->A, 0, sizeof(ctx->A));
+    ctx->block_size = SHA3_BLOCKSIZE(bitlen);
+}
+
+/*
+ * Absorb |len| bytes from each of the four inputs and apply the SHAKE
+ * padding, after which the context can only be squeezed.
+ */
+void ossl_shake_x4_absorb(KECCAK1600_X4_CTX *ctx,
+                          const unsigned char *const in[4], size_t len)
+{
+    size_t bsz = ctx->block_size, off = 0, i, j;
+    uint64_t w;
+
+    for (; len - off >= bsz; off += bsz) {
+        for (j = 0; j < 4; j++)
+            for (i = 0; i < bsz / 8; i++) {
+                OPENSSL_load_u64_le(&w, in[j] + off + 8 * i);
+                ctx->A[i][j] ^= w;
+            }
+        keccakf1600_x4(ctx->A);
+    }
+    for (j = 0; j < 4; j++) {
+        for (i = 0; off + i < len; i++)
+            ctx->A[i / 8][j] ^= (uint64_t)in[j][off + i] << (8 * (i % 8));
+        ctx->A[i / 8][j] ^= (uint64_t)0x1f << (8 * (i % 8));
+        ctx->A[(bsz - 1) / 8][j] ^= (uint64_t)0x80 << (8 * ((bsz - 1) % 8));
+    }
+}
+
+/* Squeeze |nblocks| whole blocks into each of the four outputs */
+void ossl_shake_x4_squeeze(KECCAK1600_X4_CTX *ctx,
+                           unsigned char *const out[4], size_t nblocks)
+{
+    size_t bsz = ctx->block_size, off, i, j;
+
+    for (off = 0; nblocks-- > 0; off += bsz) {
+        keccakf1600_x4(ctx->A);
+        for (j = 0; j < 4; j++)
+            for (i = 0; i < bsz / 8; i++)
+                OPENSSL_store_u64_le(out[j] + off + 8 * i, ctx->A[i][j]);
+    }
+}
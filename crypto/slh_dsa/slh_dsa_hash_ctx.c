@@ -7,6 +7,7 @@
  * https://www.openssl.org/source/license.html
  */
 #include <stddef.h>
+#include <string.h>
 #include <openssl/crypto.h>
 #include "slh_dsa_local.h"
 #include "slh_dsa_key.h"
@@ -73,6 +74,12 @@ SLH_DSA_HASH_CTX *ossl_slh_dsa_hash_ctx_dup(const SLH_DSA_HASH_CTX *src)
         return NULL;
 
     ret->hmac_digest_used = src->hmac_digest_used;
+#if defined(SLH_DSA_SHA256_MB_ASM)
+    memcpy(ret->sha256_seed_state, src->sha256_seed_state,
+           sizeof(ret->sha256_seed_state));
+    memcpy(ret->sha256_seed, src->sha256_seed, sizeof(ret->sha256_seed));
+    ret->sha256_seed_set = src->sha256_seed_set;
+#endif
     /* Note that the key is not ref counted, since it does not own the key */
     ret->key = src->key;
 
@@ -51,8 +51,24 @@ struct slh_dsa_hash_ctx_st {
     EVP_MD_CTX *md_big_ctx; /* Either SHA-512 or points to |md_ctx| for SHA-256*/
     EVP_MAC_CTX *hmac_ctx;  /* required by SHA algorithms for PRFmsg() */
     int hmac_digest_used;   /* Used for lazy init of hmac_ctx digest */
+#if defined(SLH_DSA_SHA256_MB_ASM)
+    /* SHA-256 state after the PK.seed block, see slh_f_x_sha2() */
+    uint32_t sha256_seed_state[8];
+    uint8_t sha256_seed[SLH_MAX_N];
+    int sha256_seed_set;
+#endif
 };
 
+/*
+ * A job run by ossl_slh_run_jobs(), |arg| is shared by all of the jobs and
+ * |job| points to the data for this job.
+ */
+typedef int (OSSL_SLH_JOB_FN)(SLH_DSA_HASH_CTX *ctx, const void *arg, void *job);
+
+__owur int ossl_slh_run_jobs(SLH_DSA_HASH_CTX *ctx, OSSL_SLH_JOB_FN *fn,
+                             const void *arg, void *jobs, size_t job_size,
+                             size_t num);
+
 __owur int ossl_slh_wots_pk_gen(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
                                 const uint8_t *pk_seed, uint8_t *adrs,
                                 uint8_t *pk_out, size_t pk_out_len);
@@ -71,7 +87,7 @@ __owur int ossl_slh_xmss_node(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
 __owur int ossl_slh_xmss_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *msg,
                               const uint8_t *sk_seed, uint32_t node_id,
                               const uint8_t *pk_seed, uint8_t *adrs,
-                              WPACKET *sig_wpkt);
+                              const uint8_t *auth_path, WPACKET *sig_wpkt);
 __owur int ossl_slh_xmss_pk_from_sig(SLH_DSA_HASH_CTX *ctx, uint32_t node_id,
                                      PACKET *sig_rpkt, const uint8_t *msg,
                                      const uint8_t *pk_seed, uint8_t *adrs,
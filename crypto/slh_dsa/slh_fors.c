@@ -19,6 +19,12 @@
 
 #define SLH_MAX_K_TIMES_A      (SLH_MAX_A * SLH_MAX_K)
 #define SLH_MAX_ROOTS          (SLH_MAX_K_TIMES_A * SLH_MAX_N)
+/*
+ * Subtrees of up to this height have all their leaves computed together,
+ * using batched hash calls.
+ */
+#define SLH_FORS_LEAF_BATCH_HEIGHT 3
+#define SLH_FORS_LEAF_BATCH        (1 << SLH_FORS_LEAF_BATCH_HEIGHT)
 
 static void slh_base_2b(const uint8_t *in, uint32_t b, uint32_t *out, size_t out_len);
 
@@ -53,6 +59,56 @@ static int slh_fors_sk_gen(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
     return key->hash_func->PRF(ctx, pk_seed, sk_seed, sk_adrs, pk_out, pk_out_len);
 }
 
+/**
+ * @brief Computes consecutive leaf nodes of a FORS tree.
+ * See FIPS 205 Section 8.2 Algorithm 18 steps 2 to 6
+ *
+ * Both the FORS secret values and their hashes are computed with a single
+ * batched hash call each.
+ *
+ * @param ctx Contains SLH_DSA algorithm functions and constants.
+ * @param sk_seed A SLH_DSA private key seed of size |n|
+ * @param pk_seed A SLH_DSA public key seed of size |n|
+ * @param adrs The ADRS object, as for slh_fors_node().
+ * @param node_id The index of the first leaf node
+ * @param num The number of leaf nodes, at most SLH_FORS_LEAF_BATCH
+ * @param nodes The returned leaf nodes, |num| * |n| bytes
+ * @returns 1 on success, or 0 on error.
+ */
+static int slh_fors_leaves(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
+                           const uint8_t *pk_seed, const uint8_t *adrs,
+                           uint32_t node_id, uint32_t num, uint8_t *nodes)
+{
+    const SLH_DSA_KEY *key = ctx->key;
+    uint32_t i, n = key->params->n;
+    uint8_t sk_adrs[SLH_FORS_LEAF_BATCH][SLH_ADRS_SIZE];
+    uint8_t leaf_adrs[SLH_FORS_LEAF_BATCH][SLH_ADRS_SIZE];
+    const uint8_t *sk_adrs_i[SLH_FORS_LEAF_BATCH], *leaf_adrs_i[SLH_FORS_LEAF_BATCH];
+    const uint8_t *seed_i[SLH_FORS_LEAF_BATCH], *sk_i[SLH_FORS_LEAF_BATCH];
+    uint8_t *node_i[SLH_FORS_LEAF_BATCH];
+
+    SLH_ADRS_FUNC_DECLARE(key, adrsf);
+    SLH_HASH_FUNC_DECLARE(key, hashf);
+    SLH_HASH_FN_DECLARE(hashf, F_X);
+
+    for (i = 0; i < num; ++i) {
+        adrsf->copy(sk_adrs[i], adrs);
+        adrsf->set_type_and_clear(sk_adrs[i], SLH_ADRS_TYPE_FORS_PRF);
+        adrsf->copy_keypair_address(sk_adrs[i], adrs);
+        adrsf->set_tree_index(sk_adrs[i], node_id + i);
+        adrsf->copy(leaf_adrs[i], adrs);
+        adrsf->set_tree_height(leaf_adrs[i], 0);
+        adrsf->set_tree_index(leaf_adrs[i], node_id + i);
+        sk_adrs_i[i] = sk_adrs[i];
+        leaf_adrs_i[i] = leaf_adrs[i];
+        seed_i[i] = sk_seed;
+        sk_i[i] = node_i[i] = nodes + i * n;
+    }
+    /* The secret values are replaced in place by the leaf nodes */
+    return F_X(ctx, pk_seed, sk_adrs_i, seed_i, node_i, num)
+        && F_X(ctx, pk_seed, leaf_adrs_i, sk_i, node_i, num);
+}
+
 /**
  * @brief Computes the nodes of a Merkle tree.
  * See FIPS 205 Section 8.2 Algorithm 18
@@ -78,22 +134,35 @@ static int slh_fors_node(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
                          const uint8_t *pk_seed, uint8_t *adrs, uint32_t node_id,
                          uint32_t height, uint8_t *node, size_t node_len)
 {
-    int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
-    uint8_t sk[SLH_MAX_N], lnode[SLH_MAX_N], rnode[SLH_MAX_N];
+    uint8_t lnode[SLH_MAX_N], rnode[SLH_MAX_N];
     uint32_t n = key->params->n;
 
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
 
-    if (height == 0) {
-        /* Gets here for leaf nodes */
-        if (!slh_fors_sk_gen(ctx, sk_seed, pk_seed, adrs, node_id, sk, sizeof(sk)))
+    if (height <= SLH_FORS_LEAF_BATCH_HEIGHT) {
+        /*
+         * Compute all the leaf nodes of this subtree together, and then hash
+         * them together a level at a time, in place.
+         */
+        uint8_t nodes[SLH_FORS_LEAF_BATCH * SLH_MAX_N];
+        uint32_t i, h, num = 1 << height;
+
+        node_id <<= height;
+        if (!slh_fors_leaves(ctx, sk_seed, pk_seed, adrs, node_id, num, nodes))
             return 0;
-        adrsf->set_tree_height(adrs, 0);
-        adrsf->set_tree_index(adrs, node_id);
-        ret = key->hash_func->F(ctx, pk_seed, adrs, sk, n, node, node_len);
-        OPENSSL_cleanse(sk, n);
-        return ret;
+        for (h = 1; h <= height; ++h) {
+            num >>= 1;
+            node_id >>= 1;
+            adrsf->set_tree_height(adrs, h);
+            for (i = 0; i < num; ++i) {
+                adrsf->set_tree_index(adrs, node_id + i);
+                if (!key->hash_func->H(ctx, pk_seed, adrs, nodes + 2 * i * n,
+                                       nodes + (2 * i + 1) * n, nodes + i * n, n))
+                    return 0;
+            }
+        }
+        memcpy(node, nodes, n);
     } else {
         if (!slh_fors_node(ctx, sk_seed, pk_seed, adrs, 2 * node_id, height - 1,
                            lnode, sizeof(rnode))
@@ -108,6 +177,32 @@ static int slh_fors_node(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
     return 1;
 }
 
+/* The data common to all authentication path nodes of a FORS signature */
+typedef struct {
+    const uint8_t *sk_seed;
+    const uint8_t *pk_seed;
+    const uint8_t *adrs;
+} SLH_FORS_AUTH_ARG;
+
+/* An authentication path node of one of the k FORS trees */
+typedef struct {
+    uint32_t node_id;
+    uint32_t height;
+    uint8_t *out;
+} SLH_FORS_AUTH_JOB;
+
+static int slh_fors_auth_job(SLH_DSA_HASH_CTX *ctx, const void *arg, void *job)
+{
+    const SLH_FORS_AUTH_ARG *a = arg;
+    const SLH_FORS_AUTH_JOB *j = job;
+    const SLH_DSA_KEY *key = ctx->key;
+    SLH_ADRS_DECLARE(adrs);
+
+    key->adrs_func->copy(adrs, a->adrs);
+    return slh_fors_node(ctx, a->sk_seed, a->pk_seed, adrs, j->node_id,
+                         j->height, j->out, key->params->n);
+}
+
 /**
  * @brief Generate an FORS signature
  * See FIPS 205 Section 8.3 Algorithm 16
@@ -133,15 +228,15 @@ int ossl_slh_fors_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *md,
                        uint8_t *adrs, WPACKET *sig_wpkt)
 {
     const SLH_DSA_KEY *key = ctx->key;
-    uint32_t tree_id, layer, s, tree_offset;
+    uint32_t tree_id, layer;
     uint32_t ids[SLH_MAX_K];
     const SLH_DSA_PARAMS *params = key->params;
     uint32_t n = params->n;
     uint32_t k = params->k; /* number of trees */
     uint32_t a = params->a;
-    uint32_t two_power_a = (1 << a); /* this is t in FIPS 205 */
-    uint32_t tree_id_times_two_power_a = 0;
-    uint8_t out[SLH_MAX_N];
+    uint8_t *sig, *tree_sig; /* Pointers into the |sig_wpkt| buffer */
+    SLH_FORS_AUTH_JOB jobs[SLH_MAX_K_TIMES_A], *job = jobs;
+    SLH_FORS_AUTH_ARG arg;
 
     /*
      * Split md into k a-bit values e.g with k = 14, a = 12
@@ -149,42 +244,44 @@ int ossl_slh_fors_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *md,
      */
     slh_base_2b(md, a, ids, k);
 
-    for (tree_id = 0; tree_id < k; ++tree_id) {
-        /* Get the tree[i] leaf id */
-        uint32_t node_id = ids[tree_id]; /* |id| = |a| bits */
+    if (!WPACKET_allocate_bytes(sig_wpkt, k * (1 + a) * n, &sig))
+        return 0;
 
-        /*
-         * Give each of the k trees a unique range at each level.
-         * e.g. If we have 4096 leaf nodes (2^a = 2^12) for each tree
-         * tree i will use indexes from 4096 * i + (0..4095) for its bottom level.
-         * For the next level up from the bottom there would be 2048 nodes
-         * (so tree i uses indexes 2048 * i + (0...2047) for this level)
-         */
-        tree_offset = tree_id_times_two_power_a;
+    /*
+     * The authentication paths of the k trees are independent jobs, which
+     * are queued with the biggest subtrees first.
+     *
+     * Give each of the k trees a unique range at each level.
+     * e.g. If we have 4096 leaf nodes (2^a = 2^12) for each tree
+     * tree i will use indexes from 4096 * i + (0..4095) for its bottom level.
+     * For the next level up from the bottom there would be 2048 nodes
+     * (so tree i uses indexes 2048 * i + (0...2047) for this level)
+     *
+     * NOTE: This is a really inefficient way of doing this, since at
+     * layer a - 1 it calculates most of the hashes of the entire tree as
+     * well as all the leaf nodes. So it is calculating nodes multiple times.
+     */
+    for (layer = a; layer-- > 0;) {
+        for (tree_id = 0; tree_id < k; ++tree_id, ++job) {
+            /* XOR gets the index of the other child in a binary tree */
+            job->node_id = ((ids[tree_id] >> layer) ^ 1) + ((tree_id << a) >> layer);
+            job->height = layer;
+            job->out = sig + (tree_id * (1 + a) + 1 + layer) * n;
+        }
+    }
+    arg.sk_seed = sk_seed;
+    arg.pk_seed = pk_seed;
+    arg.adrs = adrs;
+    if (!ossl_slh_run_jobs(ctx, slh_fors_auth_job, &arg, jobs, sizeof(jobs[0]),
+                           k * a))
+        return 0;
 
+    /* Each tree's authentication path follows its revealed private key value */
+    for (tree_id = 0; tree_id < k; ++tree_id) {
+        tree_sig = sig + tree_id * (1 + a) * n;
         if (!slh_fors_sk_gen(ctx, sk_seed, pk_seed, adrs,
-                             node_id + tree_id_times_two_power_a, out, sizeof(out))
-                || !WPACKET_memcpy(sig_wpkt, out, n))
+                             ids[tree_id] + (tree_id << a), tree_sig, n))
             return 0;
-
-        /*
-         * Traverse from the bottom of the tree (layer = 0)
-         * up to the root (layer = a - 1).
-         * NOTE: This is a really inefficient way of doing this, since at
-         * layer a - 1 it calculates most of the hashes of the entire tree as
-         * well as all the leaf nodes. So it is calculating nodes multiple times.
-         */
-        for (layer = 0; layer < a; ++layer) {
-            s = node_id ^ 1; /* XOR gets the index of the other child in a binary tree */
-            if (!slh_fors_node(ctx, sk_seed, pk_seed, adrs,
-                               s + tree_offset, layer, out, sizeof(out)))
-                return 0;
-            node_id >>= 1; /* Get the parent node id */
-            tree_offset >>= 1; /* Each layer up has half as many nodes */
-            if (!WPACKET_memcpy(sig_wpkt, out, n))
-                return 0;
-        }
-        tree_id_times_two_power_a += two_power_a;
     }
     return 1;
 }
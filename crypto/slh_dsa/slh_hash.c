@@ -13,6 +13,7 @@
 #include <openssl/evp.h>
 #include <openssl/core_names.h>
 #include <openssl/rsa.h> /* PKCS1_MGF1() */
+#include <openssl/byteorder.h>
 #include "slh_dsa_local.h"
 #include "slh_dsa_key.h"
 
@@ -22,6 +23,7 @@ static OSSL_SLH_HASHFUNC_H_MSG slh_hmsg_sha2;
 static OSSL_SLH_HASHFUNC_PRF slh_prf_sha2;
 static OSSL_SLH_HASHFUNC_PRF_MSG slh_prf_msg_sha2;
 static OSSL_SLH_HASHFUNC_F slh_f_sha2;
+static OSSL_SLH_HASHFUNC_F_X slh_f_x_sha2;
 static OSSL_SLH_HASHFUNC_H slh_h_sha2;
 static OSSL_SLH_HASHFUNC_T slh_t_sha2;
 
@@ -29,6 +31,7 @@ static OSSL_SLH_HASHFUNC_H_MSG slh_hmsg_shake;
 static OSSL_SLH_HASHFUNC_PRF slh_prf_shake;
 static OSSL_SLH_HASHFUNC_PRF_MSG slh_prf_msg_shake;
 static OSSL_SLH_HASHFUNC_F slh_f_shake;
+static OSSL_SLH_HASHFUNC_F_X slh_f_x_shake;
 static OSSL_SLH_HASHFUNC_H slh_h_shake;
 static OSSL_SLH_HASHFUNC_T slh_t_shake;
 
@@ -110,6 +113,19 @@ slh_f_shake(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed, const uint8_t *adrs,
     return xof_digest_3(ctx->md_ctx, pk_seed, n, adrs, SLH_ADRS_SIZE, m1, m1_len, out, n);
 }
 
+static int
+slh_f_x_shake(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+              const uint8_t *const adrs[], const uint8_t *const m[],
+              uint8_t *const out[], size_t num)
+{
+    size_t i, n = ctx->key->params->n;
+
+    for (i = 0; i < num; i++)
+        if (!slh_f_shake(ctx, pk_seed, adrs[i], m[i], n, out[i], n))
+            return 0;
+    return 1;
+}
+
 static int
 slh_h_shake(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed, const uint8_t *adrs,
             const uint8_t *m1, const uint8_t *m2, uint8_t *out, size_t out_len)
@@ -242,6 +258,148 @@ slh_f_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed, const uint8_t *adrs,
                    OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1, out, out_len);
 }
 
+#if defined(SLH_DSA_SHA256_MB_ASM)
+/* See crypto/sha/asm/sha256-mb-x86_64.pl */
+typedef struct {
+    unsigned int A[8], B[8], C[8], D[8], E[8], F[8], G[8], H[8];
+} SHA256_MB_CTX;
+typedef struct {
+    const unsigned char *ptr;
+    int blocks;
+} HASH_DESC;
+
+void sha256_multi_block(SHA256_MB_CTX *, const HASH_DESC *, int);
+
+# define SHA256_MB_LANES 8
+
+static void sha256_mb_set_lane(SHA256_MB_CTX *mctx, size_t i, const uint32_t *h)
+{
+    mctx->A[i] = h[0];
+    mctx->B[i] = h[1];
+    mctx->C[i] = h[2];
+    mctx->D[i] = h[3];
+    mctx->E[i] = h[4];
+    mctx->F[i] = h[5];
+    mctx->G[i] = h[6];
+    mctx->H[i] = h[7];
+}
+
+static void sha256_mb_get_lane(const SHA256_MB_CTX *mctx, size_t i, uint32_t *h)
+{
+    h[0] = mctx->A[i];
+    h[1] = mctx->B[i];
+    h[2] = mctx->C[i];
+    h[3] = mctx->D[i];
+    h[4] = mctx->E[i];
+    h[5] = mctx->F[i];
+    h[6] = mctx->G[i];
+    h[7] = mctx->H[i];
+}
+
+/*
+ * Every SHA-256 based F() and PRF() call starts with the same 64 byte block,
+ * PK.seed || toByte(0, 64 - n), so the state after it is computed once and
+ * kept in |hctx|. What remains, ADRSc || M plus padding, fits in one more
+ * block for all values of n.
+ */
+static void slh_sha256_seed_state(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed,
+                                  size_t n, SHA256_MB_CTX *mctx)
+{
+    static const uint32_t sha256_iv[8] = {
+        0x6a09e667UL, 0xbb67ae85UL, 0x3c6ef372UL, 0xa54ff53aUL,
+        0x510e527fUL, 0x9b05688cUL, 0x1f83d9abUL, 0x5be0cd19UL
+    };
+    uint8_t block[OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1] = { 0 };
+    HASH_DESC desc[4];
+    size_t i;
+
+    if (hctx->sha256_seed_set && memcmp(hctx->sha256_seed, pk_seed, n) == 0)
+        return;
+
+    memcpy(block, pk_seed, n);
+    for (i = 0; i < 4; i++) {
+        desc[i].ptr = block;
+        desc[i].blocks = i == 0;
+    }
+    sha256_mb_set_lane(mctx, 0, sha256_iv);
+    sha256_multi_block(mctx, desc, 1);
+    sha256_mb_get_lane(mctx, 0, hctx->sha256_seed_state);
+    memcpy(hctx->sha256_seed, pk_seed, n);
+    hctx->sha256_seed_set = 1;
+}
+
+/*
+ * Up to 8 F() calls are made at a time by giving each its own lane of the
+ * multi-buffer SHA-256, which makes one compression per call rather than the
+ * two (plus the EVP overhead) of slh_f_sha2().
+ */
+static int
+slh_f_x_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed,
+             const uint8_t *const adrs[], const uint8_t *const m[],
+             uint8_t *const out[], size_t num)
+{
+    size_t n = hctx->key->params->n;
+    uint64_t bits = 8 * (uint64_t)(OSSL_SLH_DSA_SHA2_NUM_ZEROS_H_AND_T_BOUND1
+                                   + SLH_ADRSC_SIZE + n);
+    uint8_t blocks[SHA256_MB_LANES][64];
+    unsigned char storage[sizeof(SHA256_MB_CTX) + 32];
+    SHA256_MB_CTX *mctx;
+    HASH_DESC desc[SHA256_MB_LANES];
+    uint32_t h[8];
+    size_t i, j, lanes;
+
+    mctx = (SHA256_MB_CTX *)(storage + 32 - ((size_t)storage % 32));
+    slh_sha256_seed_state(hctx, pk_seed, n, mctx);
+
+    for (; num > 0; num -= lanes, adrs += lanes, m += lanes, out += lanes) {
+        lanes = num < SHA256_MB_LANES ? num : SHA256_MB_LANES;
+
+        /*
+         * The kernel processes 4 lanes at a time and stops at the first
+         * group of 4 that has no input, so the used lanes come first.
+         */
+        for (i = 0; i < SHA256_MB_LANES; i++) {
+            uint8_t *b = blocks[i];
+
+            desc[i].ptr = b;
+            desc[i].blocks = i < lanes;
+            if (i >= lanes)
+                continue;
+            memcpy(b, adrs[i], SLH_ADRSC_SIZE);
+            memcpy(b + SLH_ADRSC_SIZE, m[i], n);
+            b[SLH_ADRSC_SIZE + n] = 0x80;
+            memset(b + SLH_ADRSC_SIZE + n + 1, 0, 64 - 8 - SLH_ADRSC_SIZE - n - 1);
+            OPENSSL_store_u64_be(b + 64 - 8, bits);
+            sha256_mb_set_lane(mctx, i, hctx->sha256_seed_state);
+        }
+        sha256_multi_block(mctx, desc, lanes > 4 ? 2 : 1);
+        for (i = 0; i < lanes; i++) {
+            sha256_mb_get_lane(mctx, i, h);
+            /* Truncate the digest to n bytes */
+            for (j = 0; j < n / 4; j++)
+                OPENSSL_store_u32_be(out[i] + 4 * j, h[j]);
+        }
+    }
+    OPENSSL_cleanse(blocks, sizeof(blocks));
+    OPENSSL_cleanse(storage, sizeof(storage));
+    OPENSSL_cleanse(h, sizeof(h));
+    return 1;
+}
+#else
+static int
+slh_f_x_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed,
+             const uint8_t *const adrs[], const uint8_t *const m[],
+             uint8_t *const out[], size_t num)
+{
+    size_t i, n = hctx->key->params->n;
+
+    for (i = 0; i < num; i++)
+        if (!slh_f_sha2(hctx, pk_seed, adrs[i], m[i], n, out[i], n))
+            return 0;
+    return 1;
+}
+#endif
+
 static int
 slh_h_sha2(SLH_DSA_HASH_CTX *hctx, const uint8_t *pk_seed, const uint8_t *adrs,
            const uint8_t *m1, const uint8_t *m2, uint8_t *out, size_t out_len)
@@ -274,6 +432,7 @@ const SLH_HASH_FUNC *ossl_slh_get_hash_fn(int is_shake)
             slh_prf_shake,
             slh_prf_msg_shake,
             slh_f_shake,
+            slh_f_x_shake,
             slh_h_shake,
             slh_t_shake
         },
@@ -282,6 +441,7 @@ const SLH_HASH_FUNC *ossl_slh_get_hash_fn(int is_shake)
             slh_prf_sha2,
             slh_prf_msg_sha2,
             slh_f_sha2,
+            slh_f_x_sha2,
             slh_h_sha2,
             slh_t_sha2
         }
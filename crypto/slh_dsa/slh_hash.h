@@ -42,6 +42,17 @@ typedef int (OSSL_SLH_HASHFUNC_F)(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
                                   const uint8_t *m1, size_t m1_len,
                                   uint8_t *out, size_t out_len);
 
+/*
+ * Computes F() for |num| independent inputs, out[i] = F(pk_seed, adrs[i], m[i])
+ * with |n| byte |m[i]| and |out[i]|, which may be the same buffer.
+ * FIPS 205 defines PRF() the same way as F() for all parameter sets, so this
+ * is also used to generate private key values in bulk, with m[i] = sk_seed.
+ */
+typedef int (OSSL_SLH_HASHFUNC_F_X)(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
+                                    const uint8_t *const adrs[],
+                                    const uint8_t *const m[],
+                                    uint8_t *const out[], size_t num);
+
 typedef int (OSSL_SLH_HASHFUNC_H)(SLH_DSA_HASH_CTX *ctx, const uint8_t *pk_seed,
                                   const uint8_t *adrs,
                                   const uint8_t *m1, const uint8_t *m2,
@@ -57,6 +68,7 @@ typedef struct slh_hash_func_st {
     OSSL_SLH_HASHFUNC_PRF *PRF;
     OSSL_SLH_HASHFUNC_PRF_MSG *PRF_MSG;
     OSSL_SLH_HASHFUNC_F *F;
+    OSSL_SLH_HASHFUNC_F_X *F_X;
     OSSL_SLH_HASHFUNC_H *H;
     OSSL_SLH_HASHFUNC_T *T;
 } SLH_HASH_FUNC;
@@ -11,6 +11,41 @@
 #include "slh_dsa_local.h"
 #include "slh_dsa_key.h"
 
+/* d = 7, 8, 17 or 22 layers of XMSS trees */
+#define SLH_MAX_D 22
+/* h = 63, 64, 66 or 68, the total height of the hypertree */
+#define SLH_MAX_H 68
+
+/* The data common to all authentication path nodes of a signature */
+typedef struct {
+    const uint8_t *sk_seed;
+    const uint8_t *pk_seed;
+} SLH_HT_AUTH_ARG;
+
+/* An authentication path node of the XMSS tree at one layer */
+typedef struct {
+    uint64_t tree_id;
+    uint32_t layer;
+    uint32_t node_id;
+    uint32_t height;
+    uint8_t *out;
+} SLH_HT_AUTH_JOB;
+
+static int slh_ht_auth_job(SLH_DSA_HASH_CTX *ctx, const void *arg, void *job)
+{
+    const SLH_HT_AUTH_ARG *a = arg;
+    const SLH_HT_AUTH_JOB *j = job;
+    const SLH_DSA_KEY *key = ctx->key;
+    SLH_ADRS_FUNC_DECLARE(key, adrsf);
+    SLH_ADRS_DECLARE(adrs);
+
+    adrsf->zero(adrs);
+    adrsf->set_layer_address(adrs, j->layer);
+    adrsf->set_tree_address(adrs, j->tree_id);
+    return ossl_slh_xmss_node(ctx, a->sk_seed, j->node_id, j->height,
+                              a->pk_seed, adrs, j->out, key->params->n);
+}
+
 /**
  * @brief Generate a Hypertree Signature
  * See FIPS 205 Section 7.1 Algorithm 12
@@ -37,16 +72,50 @@ int ossl_slh_ht_sign(SLH_DSA_HASH_CTX *ctx,
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
     SLH_ADRS_DECLARE(adrs);
     uint8_t root[SLH_MAX_N];
-    uint32_t layer, mask;
+    uint32_t layer, h, mask;
     const SLH_DSA_PARAMS *params = key->params;
     uint32_t n = params->n;
     uint32_t d = params->d;
     uint32_t hm = params->hm;
     uint8_t *psig;
     PACKET rpkt, *xmss_sig_rpkt = &rpkt;
+    uint64_t tree_ids[SLH_MAX_D];
+    uint32_t leaf_ids[SLH_MAX_D];
+    uint8_t auth_paths[SLH_MAX_H * SLH_MAX_N];
+    SLH_HT_AUTH_JOB jobs[SLH_MAX_H], *job = jobs;
+    SLH_HT_AUTH_ARG arg;
 
     mask = (1 << hm) - 1; /* A mod 2^h = A & ((2^h - 1))) */
 
+    /*
+     * The XMSS tree and leaf used at each layer are known up front, and the
+     * authentication path nodes do not depend on the message that each tree
+     * signs, so they are all computed first. These are by far the most
+     * expensive part of the signature, and are independent jobs that can be
+     * shared between threads. The biggest subtrees are queued first.
+     */
+    for (layer = 0; layer < d; ++layer) {
+        tree_ids[layer] = tree_id;
+        leaf_ids[layer] = leaf_id;
+        leaf_id = tree_id & mask;
+        tree_id >>= hm;
+    }
+    for (h = hm; h-- > 0;) {
+        for (layer = 0; layer < d; ++layer, ++job) {
+            job->layer = layer;
+            job->tree_id = tree_ids[layer];
+            /* The sibling of the node at height h on the path from the leaf */
+            job->node_id = (leaf_ids[layer] >> h) ^ 1;
+            job->height = h;
+            job->out = auth_paths + (layer * hm + h) * n;
+        }
+    }
+    arg.sk_seed = sk_seed;
+    arg.pk_seed = pk_seed;
+    if (!ossl_slh_run_jobs(ctx, slh_ht_auth_job, &arg, jobs, sizeof(jobs[0]),
+                           d * hm))
+        return 0;
+
     adrsf->zero(adrs);
     /*
      * For each XMSS tree there is a current leaf node that is used for signing.
@@ -66,10 +135,10 @@ int ossl_slh_ht_sign(SLH_DSA_HASH_CTX *ctx,
     for (layer = 0; layer < d; ++layer) {
         /* type = SLH_ADRS_TYPE_WOTS_HASH */
         adrsf->set_layer_address(adrs, layer);
-        adrsf->set_tree_address(adrs, tree_id);
+        adrsf->set_tree_address(adrs, tree_ids[layer]);
         psig = WPACKET_get_curr(sig_wpkt);
-        if (!ossl_slh_xmss_sign(ctx, root, sk_seed, leaf_id, pk_seed, adrs,
-                                sig_wpkt))
+        if (!ossl_slh_xmss_sign(ctx, root, sk_seed, leaf_ids[layer], pk_seed,
+                                adrs, auth_paths + layer * hm * n, sig_wpkt))
             return 0;
         /*
          * On the last loop it skips getting the public key since it is not needed
@@ -80,11 +149,10 @@ int ossl_slh_ht_sign(SLH_DSA_HASH_CTX *ctx,
             if (!PACKET_buf_init(xmss_sig_rpkt, psig,
                                  WPACKET_get_curr(sig_wpkt) - psig))
                 return 0;
-            if (!ossl_slh_xmss_pk_from_sig(ctx, leaf_id, xmss_sig_rpkt, root,
-                                           pk_seed, adrs, root, sizeof(root)))
+            if (!ossl_slh_xmss_pk_from_sig(ctx, leaf_ids[layer], xmss_sig_rpkt,
+                                           root, pk_seed, adrs, root,
+                                           sizeof(root)))
                 return 0;
-            leaf_id = tree_id & mask;
-            tree_id >>= hm;
         }
     }
     return 1;
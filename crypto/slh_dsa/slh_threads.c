@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/crypto.h>
+#include "internal/thread.h"
+#include "slh_dsa_local.h"
+#include "slh_dsa_key.h"
+
+#if defined(OPENSSL_NO_DEFAULT_THREAD_POOL) && defined(OPENSSL_NO_THREAD_POOL)
+# define SLH_DSA_NO_THREADS
+#endif
+
+#if !defined(OPENSSL_THREADS)
+# define SLH_DSA_NO_THREADS
+#endif
+
+#if !defined(SLH_DSA_NO_THREADS)
+
+/* Upper bound on the number of threads used for a single operation */
+# define SLH_MAX_THREADS 64
+
+typedef struct slh_jobs_st {
+    OSSL_SLH_JOB_FN *fn;
+    const void *arg;
+    unsigned char *jobs;
+    size_t job_size;
+    size_t num;
+    int next;               /* The number of jobs handed out so far */
+    CRYPTO_RWLOCK *lock;    /* Only used if atomics are not available */
+} SLH_JOBS;
+
+typedef struct slh_worker_st {
+    SLH_JOBS *jobs;
+    SLH_DSA_HASH_CTX *ctx;  /* Each thread needs its own hash contexts */
+    void *thread;
+    int ret;
+} SLH_WORKER;
+
+/* Run jobs until there are none left */
+static int slh_worker_run(SLH_WORKER *w)
+{
+    SLH_JOBS *jobs = w->jobs;
+    int next;
+
+    while (CRYPTO_atomic_add(&jobs->next, 1, &next, jobs->lock)
+           && (size_t)next <= jobs->num)
+        if (!jobs->fn(w->ctx, jobs->arg,
+                      jobs->jobs + (next - 1) * jobs->job_size))
+            return 0;
+    return 1;
+}
+
+static CRYPTO_THREAD_RETVAL slh_worker_thread(void *arg)
+{
+    SLH_WORKER *w = arg;
+
+    w->ret = slh_worker_run(w);
+    return 0;
+}
+
+static int slh_run_jobs_mt(SLH_DSA_HASH_CTX *ctx, SLH_JOBS *jobs,
+                           uint64_t threads)
+{
+    OSSL_LIB_CTX *libctx = ctx->key->libctx;
+    SLH_WORKER workers[SLH_MAX_THREADS];
+    size_t i, started;
+    int ret;
+
+    if (threads > SLH_MAX_THREADS - 1)
+        threads = SLH_MAX_THREADS - 1;
+    if (threads > jobs->num - 1)
+        threads = jobs->num - 1;
+
+    if ((jobs->lock = CRYPTO_THREAD_lock_new()) == NULL)
+        return 0;
+
+    /*
+     * The calling thread is worker 0. If fewer threads can be started than
+     * were asked for, the remaining workers take on more of the jobs.
+     */
+    workers[0].jobs = jobs;
+    workers[0].ctx = ctx;
+    for (started = 1; started <= threads; started++) {
+        SLH_WORKER *w = &workers[started];
+
+        w->jobs = jobs;
+        w->ret = 0;
+        if ((w->ctx = ossl_slh_dsa_hash_ctx_dup(ctx)) == NULL)
+            break;
+        w->thread = ossl_crypto_thread_start(libctx, &slh_worker_thread, w);
+        if (w->thread == NULL) {
+            ossl_slh_dsa_hash_ctx_free(w->ctx);
+            break;
+        }
+    }
+
+    ret = slh_worker_run(&workers[0]);
+    for (i = 1; i < started; i++) {
+        SLH_WORKER *w = &workers[i];
+
+        if (!ossl_crypto_thread_join(w->thread, NULL)
+                || !ossl_crypto_thread_clean(w->thread))
+            ret = 0;
+        ret &= w->ret;
+        ossl_slh_dsa_hash_ctx_free(w->ctx);
+    }
+    CRYPTO_THREAD_lock_free(jobs->lock);
+    return ret;
+}
+
+#endif /* !defined(SLH_DSA_NO_THREADS) */
+
+/**
+ * @brief Run a set of independent jobs, such as the computation of the
+ * authentication path nodes of the trees that make up a signature.
+ *
+ * If the application has allowed the library context of the key to use
+ * threads (see OSSL_set_max_threads()), the jobs are shared between the
+ * calling thread and as many threads as are available. Jobs are handed out in
+ * order, so the most expensive should come first.
+ *
+ * @param ctx Contains SLH_DSA algorithm functions and constants.
+ * @param fn The function that runs a job.
+ * @param arg The data that is common to all of the jobs.
+ * @param jobs An array of |num| jobs, each of size |job_size|.
+ * @returns 1 if all of the jobs succeeded, or 0 on error.
+ */
+int ossl_slh_run_jobs(SLH_DSA_HASH_CTX *ctx, OSSL_SLH_JOB_FN *fn,
+                      const void *arg, void *jobs, size_t job_size, size_t num)
+{
+    size_t i;
+
+#if !defined(SLH_DSA_NO_THREADS)
+    if (num > 1) {
+        uint64_t threads = ossl_get_avail_threads(ctx->key->libctx);
+
+        if (threads > 0) {
+            SLH_JOBS j;
+
+            j.fn = fn;
+            j.arg = arg;
+            j.jobs = jobs;
+            j.job_size = job_size;
+            j.num = num;
+            j.next = 0;
+            return slh_run_jobs_mt(ctx, &j, threads);
+        }
+    }
+#endif
+    for (i = 0; i < num; i++)
+        if (!fn(ctx, arg, (unsigned char *)jobs + i * job_size))
+            return 0;
+    return 1;
+}
@@ -70,53 +70,98 @@ static ossl_inline void compute_checksum_nibbles(const uint8_t *in, size_t in_le
 }
 
 /**
- * @brief WOTS+ Chaining function
+ * @brief Generate the WOTS+ private key values
+ * See FIPS 205 Section 5.1 Algorithm 6 steps 5 & 6
+ *
+ * All |len| PRF() calls are made as one batched call.
+ *
+ * @param ctx Contains SLH_DSA algorithm functions and constants.
+ * @param sk_seed A private key seed of size |n|
+ * @param pk_seed A public key seed of size |n|
+ * @param adrs An ADRS object containing the layer address, tree address and
+ *             keypair address of the WOTS+ key.
+ * @param len The number of chains.
+ * @param sk_out The returned private key values, |len| * |n| bytes.
+ * @returns 1 on success, or 0 on error.
+ */
+static int slh_wots_sk_gen(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
+                           const uint8_t *pk_seed, const uint8_t *adrs,
+                           size_t len, uint8_t *sk_out)
+{
+    const SLH_DSA_KEY *key = ctx->key;
+    size_t i, n = key->params->n;
+    uint8_t sk_adrs[SLH_WOTS_LEN_MAX][SLH_ADRS_SIZE];
+    const uint8_t *adrs_i[SLH_WOTS_LEN_MAX], *seed_i[SLH_WOTS_LEN_MAX];
+    uint8_t *out_i[SLH_WOTS_LEN_MAX];
+
+    SLH_ADRS_FUNC_DECLARE(key, adrsf);
+
+    for (i = 0; i < len; ++i) {
+        adrsf->copy(sk_adrs[i], adrs);
+        adrsf->set_type_and_clear(sk_adrs[i], SLH_ADRS_TYPE_WOTS_PRF);
+        adrsf->copy_keypair_address(sk_adrs[i], adrs);
+        adrsf->set_chain_address(sk_adrs[i], (uint32_t)i);
+        adrs_i[i] = sk_adrs[i];
+        seed_i[i] = sk_seed;
+        out_i[i] = sk_out + i * n;
+    }
+    return key->hash_func->F_X(ctx, pk_seed, adrs_i, seed_i, out_i, len);
+}
+
+/**
+ * @brief WOTS+ Chaining function, applied to all chains at once
  * See FIPS 205 Section 5 Algorithm 5
  *
- * Iterates using a hash function on the input |steps| times starting at index
- * |start|. (Internally the |adrs| hash address is used to update the chaining
- * index).
+ * Chain i is iterated |steps[i]| times starting at index |start[i]|, in place.
+ * (Internally the chain and hash addresses of a copy of |adrs| are used to
+ * update the chain and chaining indexes.) The chains are advanced together,
+ * so each step is a single batched F() call over the chains that have not
+ * yet finished.
  *
  * @param ctx Contains SLH_DSA algorithm functions and constants.
- * @param in An input string of |n| bytes
- * @param start_index The chaining start index
- * @param steps The number of iterations starting from |start_index|
- *              Note |start_index| + |steps| < w
+ * @param nodes |len| chain values of |n| bytes, which are replaced by the
+ *              chain outputs.
+ * @param start The chaining start index of each chain
+ * @param steps The number of iterations of each chain,
+ *              Note |start[i]| + |steps[i]| < w
  *              (where w = 16 indicates the length of the hash chains)
+ * @param len The number of chains.
  * @param pk_seed A public key seed (which is added to the hash)
  * @param adrs An ADRS object which has a type of WOTS_HASH, and has a layer
- *             address, tree address, key pair address and chain address
- * @params wpkt A WPACKET object to write the hash chain to (n bytes are written)
+ *             address, tree address and key pair address.
  * @returns 1 on success, or 0 on error.
  */
-static int slh_wots_chain(SLH_DSA_HASH_CTX *ctx, const uint8_t *in,
-                          uint8_t start_index, uint8_t steps,
-                          const uint8_t *pk_seed, uint8_t *adrs, WPACKET *wpkt)
+static int slh_wots_chains(SLH_DSA_HASH_CTX *ctx, uint8_t *nodes,
+                           const uint8_t *start, const uint8_t *steps,
+                           size_t len, const uint8_t *pk_seed,
+                           const uint8_t *adrs)
 {
     const SLH_DSA_KEY *key = ctx->key;
     SLH_HASH_FUNC_DECLARE(key, hashf);
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_HASH_FN_DECLARE(hashf, F);
+    SLH_HASH_FN_DECLARE(hashf, F_X);
     SLH_ADRS_FN_DECLARE(adrsf, set_hash_address);
-    size_t j = start_index, end_index;
-    size_t n = key->params->n;
-    uint8_t *tmp; /* Pointer into the |wpkt| buffer */
-    size_t tmp_len = n;
+    size_t i, step, num, n = key->params->n;
+    uint8_t chain_adrs[SLH_WOTS_LEN_MAX][SLH_ADRS_SIZE];
+    const uint8_t *adrs_i[SLH_WOTS_LEN_MAX], *in_i[SLH_WOTS_LEN_MAX];
+    uint8_t *out_i[SLH_WOTS_LEN_MAX];
 
-    if (steps == 0)
-        return WPACKET_memcpy(wpkt, in, n);
-
-    if (!WPACKET_allocate_bytes(wpkt, tmp_len, &tmp))
-        return 0;
-
-    set_hash_address(adrs, (uint32_t)(j++));
-    if (!F(ctx, pk_seed, adrs, in, n, tmp, tmp_len))
-        return 0;
-
-    end_index = start_index + steps;
-    for (; j < end_index; ++j) {
-        set_hash_address(adrs, (uint32_t)j);
-        if (!F(ctx, pk_seed, adrs, tmp, n, tmp, tmp_len))
+    for (i = 0; i < len; ++i) {
+        adrsf->copy(chain_adrs[i], adrs);
+        adrsf->set_chain_address(chain_adrs[i], (uint32_t)i);
+    }
+    for (step = 0; step < NIBBLE_MASK; ++step) {
+        for (i = 0, num = 0; i < len; ++i) {
+            if (step >= steps[i])
+                continue;
+            set_hash_address(chain_adrs[i], (uint32_t)(start[i] + step));
+            adrs_i[num] = chain_adrs[i];
+            in_i[num] = out_i[num] = nodes + i * n;
+            num++;
+        }
+        if (num == 0)
+            break;
+        if (!F_X(ctx, pk_seed, adrs_i, in_i, out_i, num))
             return 0;
     }
     return 1;
@@ -142,45 +187,26 @@ int ossl_slh_wots_pk_gen(SLH_DSA_HASH_CTX *ctx,
     int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
     size_t n = key->params->n;
-    size_t i, len = SLH_WOTS_LEN(n); /* 2 * n + 3 */
-    uint8_t sk[SLH_MAX_N];
+    size_t len = SLH_WOTS_LEN(n); /* 2 * n + 3 */
     uint8_t tmp[SLH_WOTS_LEN_MAX * SLH_MAX_N];
-    WPACKET pkt, *tmp_wpkt = &pkt; /* Points to the |tmp| buffer */
-    size_t tmp_len = 0;
+    uint8_t start[SLH_WOTS_LEN_MAX], steps[SLH_WOTS_LEN_MAX];
 
     SLH_HASH_FUNC_DECLARE(key, hashf);
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_HASH_FN_DECLARE(hashf, PRF);
-    SLH_ADRS_FN_DECLARE(adrsf, set_chain_address);
-    SLH_ADRS_DECLARE(sk_adrs);
     SLH_ADRS_DECLARE(wots_pk_adrs);
 
-    if (!WPACKET_init_static_len(tmp_wpkt, tmp, sizeof(tmp), 0))
-        return 0;
-    adrsf->copy(sk_adrs, adrs);
-    adrsf->set_type_and_clear(sk_adrs, SLH_ADRS_TYPE_WOTS_PRF);
-    adrsf->copy_keypair_address(sk_adrs, adrs);
-
-    for (i = 0; i < len; ++i) { /* len = 2n + 3 */
-        set_chain_address(sk_adrs, (uint32_t)i);
-        if (!PRF(ctx, pk_seed, sk_seed, sk_adrs, sk, sizeof(sk)))
-            goto end;
-
-        set_chain_address(adrs, (uint32_t)i);
-        if (!slh_wots_chain(ctx, sk, 0, NIBBLE_MASK, pk_seed, adrs, tmp_wpkt))
-            goto end;
-    }
-
-    if (!WPACKET_get_total_written(tmp_wpkt, &tmp_len)) /* should be n * (2 * n + 3) */
+    memset(start, 0, len);
+    memset(steps, NIBBLE_MASK, len);
+    if (!slh_wots_sk_gen(ctx, sk_seed, pk_seed, adrs, len, tmp)
+            || !slh_wots_chains(ctx, tmp, start, steps, len, pk_seed, adrs))
         goto end;
+
     adrsf->copy(wots_pk_adrs, adrs);
     adrsf->set_type_and_clear(wots_pk_adrs, SLH_ADRS_TYPE_WOTS_PK);
     adrsf->copy_keypair_address(wots_pk_adrs, adrs);
-    ret = hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, tmp_len, pk_out, pk_out_len);
+    ret = hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, len * n, pk_out, pk_out_len);
 end:
-    WPACKET_finish(tmp_wpkt);
     OPENSSL_cleanse(tmp, sizeof(tmp));
-    OPENSSL_cleanse(sk, n);
     return ret;
 }
 
@@ -204,21 +230,14 @@ int ossl_slh_wots_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *msg,
                        const uint8_t *sk_seed, const uint8_t *pk_seed,
                        uint8_t *adrs, WPACKET *sig_wpkt)
 {
-    int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
     uint8_t msg_and_csum_nibbles[SLH_WOTS_LEN_MAX]; /* size is >= 2 * n + 3 */
-    uint8_t sk[SLH_MAX_N];
-    size_t i;
+    uint8_t start[SLH_WOTS_LEN_MAX];
+    uint8_t *sig; /* Pointer into the |sig_wpkt| buffer */
     size_t n = key->params->n;
     size_t len1 = SLH_WOTS_LEN1(n); /* 2 * n = the msg length in nibbles */
     size_t len = len1 + SLH_WOTS_LEN2;  /* 2 * n + 3 (3 checksum nibbles) */
 
-    SLH_ADRS_DECLARE(sk_adrs);
-    SLH_HASH_FUNC_DECLARE(key, hashf);
-    SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_HASH_FN_DECLARE(hashf, PRF);
-    SLH_ADRS_FN_DECLARE(adrsf, set_chain_address);
-
     /*
      * Convert n message bytes to 2*n base w=16 integers
      * i.e. Convert message to an array of 2*n nibbles.
@@ -227,24 +246,15 @@ int ossl_slh_wots_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *msg,
     /* Compute a 12 bit checksum and add it to the end */
     compute_checksum_nibbles(msg_and_csum_nibbles, len1, msg_and_csum_nibbles + len1);
 
-    adrsf->copy(sk_adrs, adrs);
-    adrsf->set_type_and_clear(sk_adrs, SLH_ADRS_TYPE_WOTS_PRF);
-    adrsf->copy_keypair_address(sk_adrs, adrs);
-
-    for (i = 0; i < len; ++i) {
-        set_chain_address(sk_adrs, (uint32_t)i);
-        /* compute chain i secret */
-        if (!PRF(ctx, pk_seed, sk_seed, sk_adrs, sk, sizeof(sk)))
-            goto err;
-        set_chain_address(adrs, (uint32_t)i);
-        /* compute chain i signature */
-        if (!slh_wots_chain(ctx, sk, 0, msg_and_csum_nibbles[i],
-                            pk_seed, adrs, sig_wpkt))
-            goto err;
-    }
-    ret = 1;
-err:
-    return ret;
+    /*
+     * Compute the chain i secrets directly into the signature, and then
+     * compute each chain i signature in place.
+     */
+    memset(start, 0, len);
+    return WPACKET_allocate_bytes(sig_wpkt, len * n, &sig)
+        && slh_wots_sk_gen(ctx, sk_seed, pk_seed, adrs, len, sig)
+        && slh_wots_chains(ctx, sig, start, msg_and_csum_nibbles, len,
+                           pk_seed, adrs);
 }
 
 /**
@@ -268,48 +278,38 @@ int ossl_slh_wots_pk_from_sig(SLH_DSA_HASH_CTX *ctx,
                               const uint8_t *pk_seed, uint8_t *adrs,
                               uint8_t *pk_out, size_t pk_out_len)
 {
-    int ret = 0;
     const SLH_DSA_KEY *key = ctx->key;
     uint8_t msg_and_csum_nibbles[SLH_WOTS_LEN_MAX];
+    uint8_t steps[SLH_WOTS_LEN_MAX];
     size_t i;
     size_t n = key->params->n;
     size_t len1 = SLH_WOTS_LEN1(n);
     size_t len = len1 + SLH_WOTS_LEN2; /* 2n + 3 */
-    const uint8_t *sig_i;  /* Pointer into |sig_rpkt| buffer */
+    const uint8_t *sig;  /* Pointer into |sig_rpkt| buffer */
     uint8_t tmp[SLH_WOTS_LEN_MAX * SLH_MAX_N];
-    WPACKET pkt, *tmp_pkt = &pkt;
-    size_t tmp_len = 0;
 
     SLH_HASH_FUNC_DECLARE(key, hashf);
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
-    SLH_ADRS_FN_DECLARE(adrsf, set_chain_address);
     SLH_ADRS_DECLARE(wots_pk_adrs);
 
-    if (!WPACKET_init_static_len(tmp_pkt, tmp, sizeof(tmp), 0))
+    if (!PACKET_get_bytes(sig_rpkt, &sig, len * n))
         return 0;
 
     slh_bytes_to_nibbles(msg, n, msg_and_csum_nibbles);
     compute_checksum_nibbles(msg_and_csum_nibbles, len1, msg_and_csum_nibbles + len1);
 
     /* Compute the end nodes for each of the chains */
-    for (i = 0; i < len; ++i) {
-        set_chain_address(adrs, (uint32_t)i);
-        if (!PACKET_get_bytes(sig_rpkt, &sig_i, n)
-                || !slh_wots_chain(ctx, sig_i, msg_and_csum_nibbles[i],
-                                   NIBBLE_MASK - msg_and_csum_nibbles[i],
-                                   pk_seed, adrs, tmp_pkt))
-            goto err;
-    }
+    for (i = 0; i < len; ++i)
+        steps[i] = NIBBLE_MASK - msg_and_csum_nibbles[i];
+    memcpy(tmp, sig, len * n);
+    if (!slh_wots_chains(ctx, tmp, msg_and_csum_nibbles, steps, len,
+                         pk_seed, adrs))
+        return 0;
+
     /* compress the computed public key value */
     adrsf->copy(wots_pk_adrs, adrs);
     adrsf->set_type_and_clear(wots_pk_adrs, SLH_ADRS_TYPE_WOTS_PK);
     adrsf->copy_keypair_address(wots_pk_adrs, adrs);
-    if (!WPACKET_get_total_written(tmp_pkt, &tmp_len))
-        goto err;
-    ret = hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, tmp_len,
-                   pk_out, pk_out_len);
- err:
-    if (!WPACKET_finish(tmp_pkt))
-        ret = 0;
-    return ret;
+    return hashf->T(ctx, pk_seed, wots_pk_adrs, tmp, len * n,
+                    pk_out, pk_out_len);
 }
@@ -79,41 +79,30 @@ int ossl_slh_xmss_node(SLH_DSA_HASH_CTX *ctx, const uint8_t *sk_seed,
  * @param pk_seed A public key seed f size |n|
  * @param adrs An ADRS object containing the layer address and tree address set
  *              to the XMSS key being used to sign the message.
+ * @param auth_path The authentication path of |node_id|, i.e. the (XMSS
+ *                  tree_height) sibling nodes computed by ossl_slh_xmss_node().
+ *                  These do not depend on |msg|, so the caller can compute
+ *                  them beforehand for all of the layers of the hypertree.
  * @param sig_wpkt A WPACKET object to write the generated XMSS signature to.
  * @returns 1 on success, or 0 on error.
  */
 int ossl_slh_xmss_sign(SLH_DSA_HASH_CTX *ctx, const uint8_t *msg,
                        const uint8_t *sk_seed, uint32_t node_id,
-                       const uint8_t *pk_seed, uint8_t *adrs, WPACKET *sig_wpkt)
+                       const uint8_t *pk_seed, uint8_t *adrs,
+                       const uint8_t *auth_path, WPACKET *sig_wpkt)
 {
     const SLH_DSA_KEY *key = ctx->key;
     SLH_ADRS_FUNC_DECLARE(key, adrsf);
     SLH_ADRS_DECLARE(tmp_adrs);
-    size_t n = key->params->n;
-    uint32_t h, hm = key->params->hm;
-    uint32_t id = node_id;
-    uint8_t *auth_path; /* Pointer to a buffer offset inside |sig_wpkt| */
-    size_t auth_path_len = n;
 
-    /*
-     * This code reverses the order of the FIPS 205 code so that it does the
-     * sign first. This simplifies the WPACKET writing.
-     */
     adrsf->copy(tmp_adrs, adrs);
     adrsf->set_type_and_clear(adrs, SLH_ADRS_TYPE_WOTS_HASH);
     adrsf->set_keypair_address(adrs, node_id);
     if (!ossl_slh_wots_sign(ctx, msg, sk_seed, pk_seed, adrs, sig_wpkt))
         return 0;
-
     adrsf->copy(adrs, tmp_adrs);
-    for (h = 0; h < hm; ++h) {
-        if (!WPACKET_allocate_bytes(sig_wpkt, auth_path_len, &auth_path)
-                || !ossl_slh_xmss_node(ctx, sk_seed, id ^ 1, h, pk_seed, adrs,
-                                       auth_path, auth_path_len))
-            return 0;
-        id >>= 1;
-    }
-    return 1;
+
+    return WPACKET_memcpy(sig_wpkt, auth_path, key->params->hm * key->params->n);
 }
 
 /**
@@ -203,6 +203,7 @@ $OpenSSL::safe::opt_s_synopsis = ""
 . "[B<-min_protocol> I<minprot>]\n"
 . "[B<-max_protocol> I<maxprot>]\n"
 . "[B<-record_padding> I<padding>]\n"
+. "[B<-dynamic_record_sizing> I<size>[,I<ramp>[,I<idle>]]]\n"
 . "[B<-debug_broken_protocol>]\n"
 . "[B<-no_middlebox>]";
 $OpenSSL::safe::opt_s_item = ""
@@ -216,7 +217,9 @@ $OpenSSL::safe::opt_s_item = ""
 . "I<algs>, B<-client_sigalgs> I<algs>, B<-groups> I<groups>, B<-curves>\n"
 . "I<curves>, B<-named_curve> I<curve>, B<-cipher> I<ciphers>, B<-ciphersuites>\n"
 . "I<1.3ciphers>, B<-min_protocol> I<minprot>, B<-max_protocol> I<maxprot>,\n"
-. "B<-record_padding> I<padding>, B<-debug_broken_protocol>, B<-no_middlebox>\n"
+. "B<-record_padding> I<padding>,\n"
+. "B<-dynamic_record_sizing> I<size>[,I<ramp>[,I<idle>]],\n"
+. "B<-debug_broken_protocol>, B<-no_middlebox>\n"
 . "\n"
 . "See L<SSL_CONF_cmd(3)/SUPPORTED COMMAND LINE COMMANDS> for details.";
 
@@ -32,6 +32,10 @@ void ossl_ctx_thread_stop(OSSL_LIB_CTX *ctx);
 
 void ossl_trace_cleanup(void);
 void ossl_malloc_setup_failures(void);
+void *ossl_mem_arena_alloc(size_t num);
+int ossl_mem_arena_size(const void *ptr, size_t *num);
+int ossl_mem_arena_free(void *ptr);
+void ossl_mem_arena_cleanup(void);
 
 int ossl_crypto_alloc_ex_data_intern(int class_index, void *obj,
                                      CRYPTO_EX_DATA *ad, int idx);
@@ -63,6 +63,7 @@ int ossl_ec_key_public_check(const EC_KEY *eckey, BN_CTX *ctx);
 int ossl_ec_key_public_check_quick(const EC_KEY *eckey, BN_CTX *ctx);
 int ossl_ec_key_private_check(const EC_KEY *eckey);
 int ossl_ec_key_pairwise_check(const EC_KEY *eckey, BN_CTX *ctx);
+int ossl_ec_key_precompute_public(EC_KEY *eckey);
 OSSL_LIB_CTX *ossl_ec_key_get_libctx(const EC_KEY *eckey);
 const char *ossl_ec_key_get0_propq(const EC_KEY *eckey);
 void ossl_ec_key_set0_libctx(EC_KEY *key, OSSL_LIB_CTX *libctx);
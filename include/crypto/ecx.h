@@ -108,6 +108,14 @@ ossl_ed25519_verify(const uint8_t *tbs, size_t tbs_len,
                     const uint8_t *context, size_t context_len,
                     OSSL_LIB_CTX *libctx, const char *propq);
 int
+ossl_ed25519_verify_batch(const uint8_t *const *tbs, const size_t *tbs_len,
+                          const uint8_t *const *signatures, size_t num,
+                          const uint8_t public_key[32],
+                          const uint8_t dom2flag, const uint8_t phflag,
+                          const uint8_t csflag, const uint8_t *context,
+                          size_t context_len, OSSL_LIB_CTX *libctx,
+                          const char *propq);
+int
 ossl_ed25519_pubkey_verify(const uint8_t *pub, size_t pub_len);
 int
 ossl_ed448_public_from_private(OSSL_LIB_CTX *ctx, uint8_t out_public_key[57],
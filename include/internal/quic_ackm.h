@@ -26,6 +26,13 @@ OSSL_ACKM *ossl_ackm_new(OSSL_TIME (*now)(void *arg),
                          OSSL_CC_DATA *cc_data, int is_server);
 void ossl_ackm_free(OSSL_ACKM *ackm);
 
+/*
+ * Replaces the congestion controller. Only to be used before any packets have
+ * been sent.
+ */
+void ossl_ackm_set_cc(OSSL_ACKM *ackm, const OSSL_CC_METHOD *cc_method,
+                      OSSL_CC_DATA *cc_data);
+
 void ossl_ackm_set_loss_detection_deadline_callback(OSSL_ACKM *ackm,
                                                     void (*fn)(OSSL_TIME deadline,
                                                                void *arg),
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -148,6 +148,14 @@ struct ossl_cc_method_st {
      */
     OSSL_TIME (*get_wakeup_deadline)(OSSL_CC_DATA *ccdata);
 
+    /*
+     * Returns the rate in bytes per second at which data should be paced out
+     * to the network, or 0 if the congestion controller has no estimate yet
+     * and data need not be paced. Like get_tx_allowance, the return value can
+     * vary as time passes.
+     */
+    uint64_t (*get_pacing_rate)(OSSL_CC_DATA *ccdata);
+
     /*
      * The On Data Sent event. num_bytes should be the size of the packet in
      * bytes (or the aggregate size of multiple packets which have just been
@@ -212,6 +220,43 @@ struct ossl_cc_method_st {
 
 extern const OSSL_CC_METHOD ossl_cc_dummy_method;
 extern const OSSL_CC_METHOD ossl_cc_newreno_method;
+extern const OSSL_CC_METHOD ossl_cc_cubic_method;
+extern const OSSL_CC_METHOD ossl_cc_bbr2_method;
+
+/*
+ * Looks up a congestion controller by the name used with
+ * SSL_CTX_set_quic_congestion_control(). Returns NULL if the name is unknown.
+ */
+const OSSL_CC_METHOD *ossl_cc_method_from_name(const char *name);
+
+/* Returns the name of a congestion controller or NULL if it has none. */
+const char *ossl_cc_method_name(const OSSL_CC_METHOD *method);
+
+/*
+ * Folds an RTT sample, taken as the time from tx_time until now, into the
+ * smoothed RTT *srtt, which is zero before the first sample.
+ */
+void ossl_cc_update_srtt(OSSL_TIME *srtt, OSSL_TIME now, OSSL_TIME tx_time);
+
+/*
+ * Returns the pacing rate in bytes per second for a window based congestion
+ * controller with congestion window cwnd, or 0 if there is no RTT sample yet.
+ * The window is spread over a little less than the smoothed RTT, and over
+ * half of it in slow start, so that pacing does not hold back the growth of
+ * the window (RFC 9002 s. 7.7).
+ */
+uint64_t ossl_cc_window_pacing_rate(uint64_t cwnd, OSSL_TIME srtt,
+                                    int slow_start);
+
+/*
+ * Helpers for the bind_diagnostics and unbind_diagnostics methods. Each binds
+ * or unbinds the output location *pp of the parameter named param_name, which
+ * must be an unsigned integer of len bytes.
+ */
+int ossl_cc_bind_diag(OSSL_PARAM *params, const char *param_name, size_t len,
+                      void **pp);
+void ossl_cc_unbind_diag(OSSL_PARAM *params, const char *param_name,
+                         void **pp);
 
 # endif
 
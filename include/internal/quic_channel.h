@@ -457,6 +457,13 @@ uint64_t ossl_quic_channel_get_remote_stream_count_avail(const QUIC_CHANNEL *ch,
  */
 int ossl_quic_channel_have_generated_transport_params(const QUIC_CHANNEL *ch);
 
+/*
+ * Changes the congestion controller. Fails once the channel has been started.
+ */
+int ossl_quic_channel_set_cc_method(QUIC_CHANNEL *ch,
+                                    const OSSL_CC_METHOD *method);
+const OSSL_CC_METHOD *ossl_quic_channel_get_cc_method(const QUIC_CHANNEL *ch);
+
 /* Configures the idle timeout to request from peer (milliseconds, 0=no timeout). */
 void ossl_quic_channel_set_max_idle_timeout_request(QUIC_CHANNEL *ch, uint64_t ms);
 /* Get the configured idle timeout to request from peer. */
@@ -108,6 +108,13 @@ QUIC_LCIDM *ossl_quic_lcidm_new(OSSL_LIB_CTX *libctx, size_t lcid_len);
 /* Frees a LCIDM. */
 void ossl_quic_lcidm_free(QUIC_LCIDM *lcidm);
 
+/*
+ * Makes all LCIDs generated from now on start with the byte prefix, so that
+ * they can be routed to this LCIDM by looking at the first byte. A prefix of
+ * -1 (the default) means all bytes are random.
+ */
+void ossl_quic_lcidm_set_prefix(QUIC_LCIDM *lcidm, int prefix);
+
 /* Gets the local CID length this LCIDM was configured to use. */
 size_t ossl_quic_lcidm_get_lcid_len(const QUIC_LCIDM *lcidm);
 
@@ -67,11 +67,38 @@ typedef struct quic_port_args_st {
      * if 1, this port should do server address validation
      */
     int             do_addr_validation;
+
+    /*
+     * If non-NULL, the port joins this port group as one of its workers. See
+     * ossl_quic_port_group_new().
+     */
+    QUIC_PORT_GROUP *group;
 } QUIC_PORT_ARGS;
 
 /* Only QUIC_ENGINE should use this function. */
 QUIC_PORT *ossl_quic_port_new(const QUIC_PORT_ARGS *args);
 
+/*
+ * QUIC Port Group
+ * ===============
+ *
+ * A port group is a set of server ports which share one UDP address, each
+ * typically using its own SO_REUSEPORT socket and belonging to its own
+ * QUIC_ENGINE, so that each can be driven by a different thread. Each port
+ * in the group is a worker with an index, which is used as the first byte of
+ * every local CID the port issues. The kernel spreads datagrams across the
+ * sockets by address, so when the set of sockets changes a packet can arrive
+ * at a port which does not own its connection. Such a packet is handed over
+ * to the owning worker, which processes it on its next tick.
+ *
+ * The ports of a group also share the key used to encrypt address validation
+ * tokens, so that a token minted by one worker is accepted by the others.
+ */
+# define QUIC_PORT_GROUP_MAX_WORKERS     256
+
+QUIC_PORT_GROUP *ossl_quic_port_group_new(OSSL_LIB_CTX *libctx);
+void ossl_quic_port_group_free(QUIC_PORT_GROUP *grp);
+
 void ossl_quic_port_free(QUIC_PORT *port);
 
 /*
@@ -137,6 +164,12 @@ CRYPTO_MUTEX *ossl_quic_port_get0_mutex(QUIC_PORT *port);
 /* Gets the current time. */
 OSSL_TIME ossl_quic_port_get_time(QUIC_PORT *port);
 
+/*
+ * Returns the index of the port in its port group, or -1 if it is not in a
+ * group.
+ */
+int ossl_quic_port_get_worker_id(const QUIC_PORT *port);
+
 int ossl_quic_port_get_rx_short_dcid_len(const QUIC_PORT *port);
 int ossl_quic_port_get_tx_init_dcid_len(const QUIC_PORT *port);
 
@@ -14,6 +14,7 @@
 
 typedef struct ssl_token_store_st SSL_TOKEN_STORE;
 typedef struct quic_port_st QUIC_PORT;
+typedef struct quic_port_group_st QUIC_PORT_GROUP;
 typedef struct quic_channel_st QUIC_CHANNEL;
 typedef struct quic_txpim_st QUIC_TXPIM;
 typedef struct quic_fifd_st QUIC_FIFD;
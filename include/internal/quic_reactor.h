@@ -114,6 +114,16 @@ struct quic_reactor_st {
      */
     CRYPTO_CONDVAR *notifier_cv;
 
+    /*
+     * Protects woken_notifier, which is set by ossl_quic_reactor_wake() on
+     * threads which do not hold the engine mutex. Valid only if have_notifier
+     * is set, NULL otherwise.
+     */
+    CRYPTO_MUTEX *wake_mutex;
+
+    /* 1 if ossl_quic_reactor_wake() has put the notifier in the signalled state. */
+    int woken_notifier;
+
     /*
      * Count of the current number of blocking waiters. Like everything else,
      * this is protected by the caller's mutex (i.e., the engine mutex).
@@ -188,6 +198,14 @@ int ossl_quic_reactor_tick(QUIC_REACTOR *rtor, uint32_t flags);
 
 RIO_NOTIFIER *ossl_quic_reactor_get0_notifier(QUIC_REACTOR *rtor);
 
+/*
+ * Wakes up the threads blocking on the reactor, so that they tick it. Unlike
+ * the other functions, this may be called without holding the engine mutex,
+ * e.g. by another thread which has just queued input for the reactor. It is
+ * a no-op if inter-thread notification is not being used.
+ */
+void ossl_quic_reactor_wake(QUIC_REACTOR *rtor);
+
 /*
  * Blocking I/O Adaptation Layer
  * =============================
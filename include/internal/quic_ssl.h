@@ -56,6 +56,9 @@ __owur int ossl_quic_accept(SSL *s);
 __owur int ossl_quic_connect(SSL *s);
 __owur int ossl_quic_read(SSL *s, void *buf, size_t len, size_t *readbytes);
 __owur int ossl_quic_peek(SSL *s, void *buf, size_t len, size_t *readbytes);
+__owur int ossl_quic_read_borrow(SSL *s, const unsigned char **data,
+                                 size_t *len);
+__owur int ossl_quic_read_release(SSL *s, size_t len);
 __owur int ossl_quic_write_flags(SSL *s, const void *buf, size_t len,
                                  uint64_t flags, size_t *written);
 __owur int ossl_quic_write(SSL *s, const void *buf, size_t len, size_t *written);
@@ -98,6 +101,8 @@ BIO *ossl_quic_conn_get_net_rbio(const SSL *s);
 BIO *ossl_quic_conn_get_net_wbio(const SSL *s);
 __owur int ossl_quic_conn_set_initial_peer_addr(SSL *s,
                                                 const BIO_ADDR *peer_addr);
+__owur int ossl_quic_set_congestion_control(SSL *s, const char *name);
+const char *ossl_quic_get0_congestion_control(const SSL *s);
 __owur SSL *ossl_quic_conn_stream_new(SSL *s, uint64_t flags);
 __owur SSL *ossl_quic_get0_connection(SSL *s);
 __owur SSL *ossl_quic_get0_listener(SSL *s);
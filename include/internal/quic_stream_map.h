@@ -66,8 +66,9 @@ struct quic_stream_list_node_st {
  * Invariants in each state are noted in comments below. In particular, once all
  * data has been read by the application, we don't need to keep the QUIC_RSTREAM
  * and data buffers around. If the receive part is instead reset before it is
- * finished, we also don't need to keep the QUIC_RSTREAM around. Finally, we
- * don't need a QUIC_RSTREAM on a send-only stream.
+ * finished, we also don't need to keep the QUIC_RSTREAM around, except while
+ * the application still has data borrowed from it with SSL_read_borrow().
+ * Finally, we don't need a QUIC_RSTREAM on a send-only stream.
  */
 #define QUIC_RSTREAM_STATE_NONE         0   /* --- rstream == NULL  */
 #define QUIC_RSTREAM_STATE_RECV         1   /* \                    */
@@ -315,6 +316,12 @@ struct quic_stream_st {
     unsigned int    ready_for_gc            : 1;
     /* Set to 1 if this is currently counted in the shutdown flush stream count. */
     unsigned int    shutdown_flush          : 1;
+    /*
+     * Set to 1 while the application has borrowed the head of the
+     * QUIC_RSTREAM with SSL_read_borrow(). The QUIC_RSTREAM is then only freed
+     * by SSL_read_release() if the receive part is reset meanwhile.
+     */
+    unsigned int    rstream_borrowed        : 1;
 };
 
 #define QUIC_STREAM_INITIATOR_CLIENT        0
@@ -155,6 +155,14 @@ int ossl_quic_tx_packetiser_set_cur_scid(OSSL_QUIC_TX_PACKETISER *txp,
 int ossl_quic_tx_packetiser_set_peer(OSSL_QUIC_TX_PACKETISER *txp,
                                      const BIO_ADDR *peer);
 
+/*
+ * Change the congestion controller in use. Only to be used before any packets
+ * have been generated.
+ */
+void ossl_quic_tx_packetiser_set_cc(OSSL_QUIC_TX_PACKETISER *txp,
+                                    const OSSL_CC_METHOD *cc_method,
+                                    OSSL_CC_DATA *cc_data);
+
 /*
  * Change the QLOG instance retrieval function in use after instantiation.
  */
@@ -59,4 +59,20 @@ int ossl_sha3_squeeze(KECCAK1600_CTX *ctx, unsigned char *out, size_t outlen);
 size_t SHA3_absorb(uint64_t A[5][5], const unsigned char *inp, size_t len,
                    size_t r);
 
+/*
+ * Four independent SHAKE instances computed in parallel.  The states are
+ * lane-interleaved, A[i][j] being lane i of instance j.
+ */
+typedef struct keccak1600_x4_st {
+    uint64_t A[25][4];
+    size_t block_size;
+} KECCAK1600_X4_CTX;
+
+int ossl_keccak1600_x4_capable(void);
+void ossl_shake_x4_init(KECCAK1600_X4_CTX *ctx, size_t bitlen);
+void ossl_shake_x4_absorb(KECCAK1600_X4_CTX *ctx,
+                          const unsigned char *const in[4], size_t len);
+void ossl_shake_x4_squeeze(KECCAK1600_X4_CTX *ctx,
+                           unsigned char *const out[4], size_t nblocks);
+
 #endif /* OSSL_INTERNAL_SHA3_H */
@@ -825,6 +825,7 @@ OSSL_CORE_MAKE_FUNC(const OSSL_PARAM *, keyexch_gettable_ctx_params,
 # define OSSL_FUNC_SIGNATURE_VERIFY_MESSAGE_INIT    30
 # define OSSL_FUNC_SIGNATURE_VERIFY_MESSAGE_UPDATE  31
 # define OSSL_FUNC_SIGNATURE_VERIFY_MESSAGE_FINAL   32
+# define OSSL_FUNC_SIGNATURE_VERIFY_BATCH           33
 
 OSSL_CORE_MAKE_FUNC(void *, signature_newctx, (void *provctx,
                                                const char *propq))
@@ -857,6 +858,10 @@ OSSL_CORE_MAKE_FUNC(int, signature_verify_message_update,
  * is specified via an OSSL_PARAM.
  */
 OSSL_CORE_MAKE_FUNC(int, signature_verify_message_final, (void *ctx))
+OSSL_CORE_MAKE_FUNC(int, signature_verify_batch,
+                    (void *ctx, const unsigned char *const *sigs,
+                     const size_t *siglens, const unsigned char *const *tbs,
+                     const size_t *tbslens, size_t num, int *results))
 OSSL_CORE_MAKE_FUNC(int, signature_verify_recover_init,
                     (void *ctx, void *provkey, const OSSL_PARAM params[]))
 OSSL_CORE_MAKE_FUNC(int, signature_verify_recover,
@@ -2036,6 +2036,11 @@ int EVP_PKEY_verify_init_ex2(EVP_PKEY_CTX *ctx,
 int EVP_PKEY_verify(EVP_PKEY_CTX *ctx,
                     const unsigned char *sig, size_t siglen,
                     const unsigned char *tbs, size_t tbslen);
+int EVP_PKEY_verify_batch(EVP_PKEY_CTX *ctx,
+                          const unsigned char *const *sigs,
+                          const size_t *siglens,
+                          const unsigned char *const *tbs,
+                          const size_t *tbslens, size_t num, int *results);
 int EVP_PKEY_verify_message_init(EVP_PKEY_CTX *ctx,
                                  EVP_SIGNATURE *algo, const OSSL_PARAM params[]);
 int EVP_PKEY_verify_message_update(EVP_PKEY_CTX *ctx,
@@ -756,12 +756,24 @@ static int ecdsa_common_set_ctx_params(void *vctx, const OSSL_PARAM params[])
     if (p != NULL
         && !OSSL_PARAM_get_uint(p, &ctx->nonce_type))
         return 0;
+
+    p = OSSL_PARAM_locate_const(params, OSSL_SIGNATURE_PARAM_KEY_PRECOMPUTE);
+    if (p != NULL) {
+        int precompute;
+
+        if (!OSSL_PARAM_get_int(p, &precompute))
+            return 0;
+        if (precompute != 0 && ctx->ec != NULL
+            && !ossl_ec_key_precompute_public(ctx->ec))
+            return 0;
+    }
     return 1;
 }
 
 #define ECDSA_COMMON_SETTABLE_CTX_PARAMS                                      \
     OSSL_PARAM_uint(OSSL_SIGNATURE_PARAM_KAT, NULL),                          \
     OSSL_PARAM_uint(OSSL_SIGNATURE_PARAM_NONCE_TYPE, NULL),                   \
+    OSSL_PARAM_int(OSSL_SIGNATURE_PARAM_KEY_PRECOMPUTE, NULL),                \
     OSSL_FIPS_IND_SETTABLE_CTX_PARAM(OSSL_SIGNATURE_PARAM_FIPS_KEY_CHECK)     \
     OSSL_FIPS_IND_SETTABLE_CTX_PARAM(OSSL_SIGNATURE_PARAM_FIPS_DIGEST_CHECK)  \
     OSSL_PARAM_END
@@ -0,0 +1,976 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include "internal/quic_cc.h"
+#include "internal/quic_types.h"
+#include "internal/safe_math.h"
+
+OSSL_SAFE_MATH_UNSIGNED(u64, uint64_t)
+
+/*
+ * BBRv2 congestion controller.
+ *
+ * Rather than reacting to loss, BBR builds a model of the path from the
+ * delivery rate and the RTT it measures: the bottleneck bandwidth is the
+ * maximum delivery rate seen over the last few rounds and the propagation delay
+ * is the minimum RTT seen over the last few seconds. Their product, the
+ * bandwidth-delay product (BDP), is what it takes to fill the path without
+ * building a queue, and the congestion window is kept at a small multiple of
+ * it.
+ *
+ * The controller goes through the following states:
+ *
+ *   - Startup: grow the window exponentially until the bandwidth estimate
+ *     stops growing or losses get too frequent.
+ *   - Drain: let the queue built during Startup drain.
+ *   - ProbeBW: cycle through the Down, Cruise, Refill and Up phases, spending
+ *     most of the time at the estimated BDP and occasionally probing for more
+ *     bandwidth.
+ *   - ProbeRTT: briefly shrink the window to refresh the minimum RTT when it
+ *     has not been seen for a while.
+ *
+ * Compared to the original BBR, BBRv2 also takes loss into account: a round in
+ * which more than 2% of the data sent was lost bounds the amount of data in
+ * flight (inflight_hi) to what it was when the losses started, and any loss or
+ * ECN mark lowers a short term bound (inflight_lo) until the next probe.
+ *
+ * Each state has a pacing gain, applied to the bandwidth estimate to give the
+ * rate returned by get_pacing_rate(), and a cwnd gain, applied to the BDP to
+ * give the congestion window which caps the data in flight.
+ *
+ * Delivery rates are sampled by remembering how much data had been delivered
+ * when each packet was sent. The congestion controller interface only tells us
+ * when a packet was sent, so we keep a history of the delivery state at the
+ * send times seen by on_data_sent(), and use the most recent entry not after
+ * the send time of an acknowledged packet. The oldest entries are forgotten
+ * once the history is full.
+ */
+
+#define BBR_STATE_STARTUP           0
+#define BBR_STATE_DRAIN             1
+#define BBR_STATE_PROBE_BW_DOWN     2
+#define BBR_STATE_PROBE_BW_CRUISE   3
+#define BBR_STATE_PROBE_BW_REFILL   4
+#define BBR_STATE_PROBE_BW_UP       5
+#define BBR_STATE_PROBE_RTT         6
+
+/* Number of send times for which we remember the delivery state. */
+#define BBR_SEND_HISTORY_LEN        512
+
+/* Number of rounds over which the maximum bandwidth is taken. */
+#define BBR_BW_FILTER_LEN           10
+
+/* Lifetime of the minimum RTT estimate. */
+#define BBR_MIN_RTT_WINDOW          ossl_seconds2time(10)
+
+/* Interval between ProbeRTT states and the minimum time spent in it. */
+#define BBR_PROBE_RTT_INTERVAL      ossl_seconds2time(5)
+#define BBR_PROBE_RTT_DURATION      ossl_ms2time(200)
+
+/* Maximum time spent cruising before probing for bandwidth again. */
+#define BBR_PROBE_BW_MAX_WAIT       ossl_seconds2time(3)
+#define BBR_PROBE_BW_MAX_ROUNDS     63
+
+/* Gains, in percent. */
+#define BBR_STARTUP_PACING_GAIN     277     /* 2 / ln(2) */
+#define BBR_DRAIN_PACING_GAIN       35
+#define BBR_PROBE_DOWN_PACING_GAIN  90
+#define BBR_PROBE_UP_PACING_GAIN    125
+#define BBR_PACING_GAIN             100
+#define BBR_STARTUP_CWND_GAIN       200
+#define BBR_CWND_GAIN               200
+#define BBR_PROBE_UP_CWND_GAIN      225
+#define BBR_PROBE_RTT_CWND_GAIN     50
+
+/* Startup ends once the bandwidth grew by less than 25% for three rounds. */
+#define BBR_FULL_BW_THRESH          125
+#define BBR_FULL_BW_COUNT           3
+
+/* Tolerated loss rate in percent, and the multiplicative decrease (0.7). */
+#define BBR_LOSS_THRESH             2
+#define BBR_BETA_NUM                7
+#define BBR_BETA_DEN                10
+
+/* Pace slightly below the estimated bandwidth, in percent. */
+#define BBR_PACING_MARGIN           1
+
+/* Headroom left below inflight_hi when not probing, in percent. */
+#define BBR_HEADROOM                15
+
+#define BBR_UNSET                   UINT64_MAX
+
+#define MIN_MAX_INIT_WND_SIZE       14720  /* RFC 9002 s. 7.2 */
+
+typedef struct bbr_send_rec_st {
+    OSSL_TIME   send_time;
+    /* Delivery state when the first packet at send_time was sent. */
+    uint64_t    delivered;
+    OSSL_TIME   delivered_time;
+} BBR_SEND_REC;
+
+typedef struct ossl_cc_bbr2_st {
+    /* Dependencies. */
+    OSSL_TIME       (*now_cb)(void *arg);
+    void            *now_cb_arg;
+
+    /* 'Constants' (which we allow to be configurable). */
+    uint64_t        k_init_wnd, k_min_wnd;
+
+    /* State. */
+    size_t          max_dgram_size;
+    uint64_t        bytes_in_flight, cong_wnd, prior_cwnd;
+    uint64_t        pacing_rate; /* bytes per second */
+    int             state;
+
+    /* Delivery rate estimation. */
+    uint64_t        delivered;
+    OSSL_TIME       delivered_time;
+    BBR_SEND_REC    send_hist[BBR_SEND_HISTORY_LEN];
+    size_t          send_hist_head, send_hist_num;
+
+    /* Round counting. */
+    uint64_t        round_count, next_round_delivered;
+    int             round_start;
+
+    /* Path model. */
+    uint64_t        bw_filter[BBR_BW_FILTER_LEN];
+    uint64_t        max_bw; /* bytes per second */
+    OSSL_TIME       min_rtt, min_rtt_stamp;
+    OSSL_TIME       probe_rtt_min, probe_rtt_min_stamp;
+    uint64_t        inflight_hi, inflight_lo;
+
+    /* Loss and delivery in the current round. */
+    uint64_t        round_lost, round_delivered;
+    int             loss_in_round;
+
+    /* Unflushed state during multiple on-loss calls. */
+    int             processing_loss; /* 1 if not flushed */
+    uint64_t        inflight_at_loss;
+
+    /* Startup. */
+    uint64_t        full_bw;
+    uint32_t        full_bw_count;
+    int             filled_pipe;
+
+    /* ProbeBW and ProbeRTT. */
+    OSSL_TIME       cycle_stamp;
+    uint64_t        cycle_round, refill_round;
+    OSSL_TIME       probe_rtt_done_stamp;
+    int             probe_rtt_round_done;
+
+    /* Diagnostic output locations. */
+    size_t          *p_diag_max_dgram_payload_len;
+    uint64_t        *p_diag_cur_cwnd_size;
+    uint64_t        *p_diag_min_cwnd_size;
+    uint64_t        *p_diag_cur_bytes_in_flight;
+    uint32_t        *p_diag_cur_state;
+} OSSL_CC_BBR2;
+
+static void bbr_set_max_dgram_size(OSSL_CC_BBR2 *bbr, size_t max_dgram_size);
+static void bbr_update_diag(OSSL_CC_BBR2 *bbr);
+
+static void bbr_reset(OSSL_CC_DATA *cc);
+
+static OSSL_CC_DATA *bbr_new(OSSL_TIME (*now_cb)(void *arg),
+                             void *now_cb_arg)
+{
+    OSSL_CC_BBR2 *bbr;
+
+    if ((bbr = OPENSSL_zalloc(sizeof(*bbr))) == NULL)
+        return NULL;
+
+    bbr->now_cb         = now_cb;
+    bbr->now_cb_arg     = now_cb_arg;
+
+    bbr_set_max_dgram_size(bbr, QUIC_MIN_INITIAL_DGRAM_LEN);
+    bbr_reset((OSSL_CC_DATA *)bbr);
+
+    return (OSSL_CC_DATA *)bbr;
+}
+
+static void bbr_free(OSSL_CC_DATA *cc)
+{
+    OPENSSL_free(cc);
+}
+
+static void bbr_set_max_dgram_size(OSSL_CC_BBR2 *bbr, size_t max_dgram_size)
+{
+    size_t max_init_wnd;
+    int is_reduced = (max_dgram_size < bbr->max_dgram_size);
+
+    bbr->max_dgram_size = max_dgram_size;
+
+    max_init_wnd = 2 * max_dgram_size;
+    if (max_init_wnd < MIN_MAX_INIT_WND_SIZE)
+        max_init_wnd = MIN_MAX_INIT_WND_SIZE;
+
+    bbr->k_init_wnd = 10 * max_dgram_size;
+    if (bbr->k_init_wnd > max_init_wnd)
+        bbr->k_init_wnd = max_init_wnd;
+
+    /* BBR needs at least four packets in flight to keep the ACK clock going. */
+    bbr->k_min_wnd = 4 * max_dgram_size;
+
+    if (is_reduced)
+        bbr->cong_wnd = bbr->k_init_wnd;
+
+    bbr_update_diag(bbr);
+}
+
+static void bbr_reset(OSSL_CC_DATA *cc)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+    size_t i;
+
+    bbr->cong_wnd               = bbr->k_init_wnd;
+    bbr->prior_cwnd             = 0;
+    /* The initial window over a nominal RTT of 1ms, as in the BBR draft. */
+    bbr->pacing_rate            = bbr->k_init_wnd * BBR_STARTUP_PACING_GAIN
+                                  * 1000 / 100;
+    bbr->bytes_in_flight        = 0;
+    bbr->state                  = BBR_STATE_STARTUP;
+
+    bbr->delivered              = 0;
+    bbr->delivered_time         = ossl_time_zero();
+    bbr->send_hist_head         = 0;
+    bbr->send_hist_num          = 0;
+
+    bbr->round_count            = 0;
+    bbr->next_round_delivered   = 0;
+    bbr->round_start            = 0;
+
+    for (i = 0; i < BBR_BW_FILTER_LEN; ++i)
+        bbr->bw_filter[i] = 0;
+
+    bbr->max_bw                 = 0;
+    bbr->min_rtt                = ossl_time_infinite();
+    bbr->min_rtt_stamp          = ossl_time_zero();
+    bbr->probe_rtt_min          = ossl_time_infinite();
+    bbr->probe_rtt_min_stamp    = ossl_time_zero();
+    bbr->inflight_hi            = BBR_UNSET;
+    bbr->inflight_lo            = BBR_UNSET;
+
+    bbr->round_lost             = 0;
+    bbr->round_delivered        = 0;
+    bbr->loss_in_round          = 0;
+    bbr->processing_loss        = 0;
+    bbr->inflight_at_loss       = 0;
+
+    bbr->full_bw                = 0;
+    bbr->full_bw_count          = 0;
+    bbr->filled_pipe            = 0;
+
+    bbr->cycle_stamp            = ossl_time_zero();
+    bbr->cycle_round            = 0;
+    bbr->refill_round           = 0;
+    bbr->probe_rtt_done_stamp   = ossl_time_zero();
+    bbr->probe_rtt_round_done   = 0;
+}
+
+static int bbr_set_input_params(OSSL_CC_DATA *cc, const OSSL_PARAM *params)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+    const OSSL_PARAM *p;
+    size_t value;
+
+    p = OSSL_PARAM_locate_const(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN);
+    if (p != NULL) {
+        if (!OSSL_PARAM_get_size_t(p, &value))
+            return 0;
+        if (value < QUIC_MIN_INITIAL_DGRAM_LEN)
+            return 0;
+
+        bbr_set_max_dgram_size(bbr, value);
+    }
+
+    return 1;
+}
+
+static int bbr_bind_diagnostic(OSSL_CC_DATA *cc, OSSL_PARAM *params)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+    size_t *new_p_max_dgram_payload_len;
+    uint64_t *new_p_cur_cwnd_size;
+    uint64_t *new_p_min_cwnd_size;
+    uint64_t *new_p_cur_bytes_in_flight;
+    uint32_t *new_p_cur_state;
+
+    if (!ossl_cc_bind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+                           sizeof(size_t),
+                           (void **)&new_p_max_dgram_payload_len)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+                              sizeof(uint64_t), (void **)&new_p_cur_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+                              sizeof(uint64_t), (void **)&new_p_min_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+                              sizeof(uint64_t),
+                              (void **)&new_p_cur_bytes_in_flight)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+                              sizeof(uint32_t), (void **)&new_p_cur_state))
+        return 0;
+
+    if (new_p_max_dgram_payload_len != NULL)
+        bbr->p_diag_max_dgram_payload_len = new_p_max_dgram_payload_len;
+
+    if (new_p_cur_cwnd_size != NULL)
+        bbr->p_diag_cur_cwnd_size = new_p_cur_cwnd_size;
+
+    if (new_p_min_cwnd_size != NULL)
+        bbr->p_diag_min_cwnd_size = new_p_min_cwnd_size;
+
+    if (new_p_cur_bytes_in_flight != NULL)
+        bbr->p_diag_cur_bytes_in_flight = new_p_cur_bytes_in_flight;
+
+    if (new_p_cur_state != NULL)
+        bbr->p_diag_cur_state = new_p_cur_state;
+
+    bbr_update_diag(bbr);
+    return 1;
+}
+
+static int bbr_unbind_diagnostic(OSSL_CC_DATA *cc, OSSL_PARAM *params)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+                        (void **)&bbr->p_diag_max_dgram_payload_len);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+                        (void **)&bbr->p_diag_cur_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+                        (void **)&bbr->p_diag_min_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+                        (void **)&bbr->p_diag_cur_bytes_in_flight);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+                        (void **)&bbr->p_diag_cur_state);
+    return 1;
+}
+
+static void bbr_update_diag(OSSL_CC_BBR2 *bbr)
+{
+    if (bbr->p_diag_max_dgram_payload_len != NULL)
+        *bbr->p_diag_max_dgram_payload_len = bbr->max_dgram_size;
+
+    if (bbr->p_diag_cur_cwnd_size != NULL)
+        *bbr->p_diag_cur_cwnd_size = bbr->cong_wnd;
+
+    if (bbr->p_diag_min_cwnd_size != NULL)
+        *bbr->p_diag_min_cwnd_size = bbr->k_min_wnd;
+
+    if (bbr->p_diag_cur_bytes_in_flight != NULL)
+        *bbr->p_diag_cur_bytes_in_flight = bbr->bytes_in_flight;
+
+    if (bbr->p_diag_cur_state != NULL) {
+        switch (bbr->state) {
+        case BBR_STATE_STARTUP:
+            *bbr->p_diag_cur_state = 'S';
+            break;
+        case BBR_STATE_DRAIN:
+            *bbr->p_diag_cur_state = 'D';
+            break;
+        case BBR_STATE_PROBE_RTT:
+            *bbr->p_diag_cur_state = 'T';
+            break;
+        default:
+            *bbr->p_diag_cur_state = 'B';
+            break;
+        }
+    }
+}
+
+/*
+ * Returns the bandwidth-delay product scaled by gain percent, or 0 if we do not
+ * have a model of the path yet.
+ */
+static uint64_t bbr_bdp(OSSL_CC_BBR2 *bbr, uint32_t gain)
+{
+    uint64_t bdp;
+    int err = 0;
+
+    if (bbr->max_bw == 0 || ossl_time_is_infinite(bbr->min_rtt))
+        return 0;
+
+    bdp = safe_muldiv_u64(bbr->max_bw, ossl_time2ticks(bbr->min_rtt),
+                          OSSL_TIME_SECOND, &err);
+    if (!err)
+        bdp = safe_muldiv_u64(bdp, gain, 100, &err);
+
+    return err ? UINT64_MAX : bdp;
+}
+
+static void bbr_record_send(OSSL_CC_BBR2 *bbr, OSSL_TIME now)
+{
+    BBR_SEND_REC *rec;
+    size_t idx;
+
+    if (bbr->send_hist_num > 0) {
+        idx = (bbr->send_hist_head + bbr->send_hist_num - 1)
+              % BBR_SEND_HISTORY_LEN;
+        if (ossl_time_compare(bbr->send_hist[idx].send_time, now) >= 0)
+            return;
+    }
+
+    if (bbr->send_hist_num == BBR_SEND_HISTORY_LEN) {
+        /* Forget the oldest entry. */
+        bbr->send_hist_head = (bbr->send_hist_head + 1) % BBR_SEND_HISTORY_LEN;
+        --bbr->send_hist_num;
+    }
+
+    idx = (bbr->send_hist_head + bbr->send_hist_num) % BBR_SEND_HISTORY_LEN;
+    rec = &bbr->send_hist[idx];
+    rec->send_time      = now;
+    rec->delivered      = bbr->delivered;
+    rec->delivered_time = bbr->delivered_time;
+    ++bbr->send_hist_num;
+}
+
+/*
+ * Finds the delivery state for a packet sent at tx_time. Returns NULL if it
+ * has been forgotten already.
+ */
+static const BBR_SEND_REC *bbr_find_send(const OSSL_CC_BBR2 *bbr,
+                                         OSSL_TIME tx_time)
+{
+    size_t lo = 0, hi = bbr->send_hist_num, mid;
+    const BBR_SEND_REC *rec;
+
+    /* Binary search for the last entry not after tx_time. */
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        rec = &bbr->send_hist[(bbr->send_hist_head + mid)
+                              % BBR_SEND_HISTORY_LEN];
+        if (ossl_time_compare(rec->send_time, tx_time) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == 0)
+        return NULL;
+
+    return &bbr->send_hist[(bbr->send_hist_head + lo - 1)
+                           % BBR_SEND_HISTORY_LEN];
+}
+
+static void bbr_update_max_bw(OSSL_CC_BBR2 *bbr, uint64_t bw)
+{
+    size_t i, idx = (size_t)(bbr->round_count % BBR_BW_FILTER_LEN);
+
+    if (bbr->round_start)
+        bbr->bw_filter[idx] = 0;
+
+    if (bw > bbr->bw_filter[idx])
+        bbr->bw_filter[idx] = bw;
+
+    bbr->max_bw = 0;
+    for (i = 0; i < BBR_BW_FILTER_LEN; ++i)
+        if (bbr->bw_filter[i] > bbr->max_bw)
+            bbr->max_bw = bbr->bw_filter[i];
+}
+
+/*
+ * Updates the minimum RTT estimates with an RTT sample. Returns 1 if the
+ * minimum RTT has not been refreshed for BBR_PROBE_RTT_INTERVAL, in which case
+ * it is time to enter ProbeRTT.
+ */
+static int bbr_update_min_rtt(OSSL_CC_BBR2 *bbr, OSSL_TIME now, OSSL_TIME rtt)
+{
+    int probe_rtt_expired;
+
+    probe_rtt_expired
+        = !ossl_time_is_zero(bbr->probe_rtt_min_stamp)
+          && ossl_time_compare(now,
+                               ossl_time_add(bbr->probe_rtt_min_stamp,
+                                             BBR_PROBE_RTT_INTERVAL)) > 0;
+
+    if (ossl_time_compare(rtt, bbr->probe_rtt_min) <= 0 || probe_rtt_expired) {
+        bbr->probe_rtt_min          = rtt;
+        bbr->probe_rtt_min_stamp    = now;
+    }
+
+    if (ossl_time_compare(bbr->probe_rtt_min, bbr->min_rtt) <= 0
+        || ossl_time_compare(now, ossl_time_add(bbr->min_rtt_stamp,
+                                                BBR_MIN_RTT_WINDOW)) > 0) {
+        bbr->min_rtt        = bbr->probe_rtt_min;
+        bbr->min_rtt_stamp  = bbr->probe_rtt_min_stamp;
+    }
+
+    return probe_rtt_expired;
+}
+
+/*
+ * Called at the start of each round: applies the loss seen in the previous
+ * round to the short term bound and starts counting afresh.
+ */
+static void bbr_start_round(OSSL_CC_BBR2 *bbr)
+{
+    uint64_t lo;
+    int err = 0;
+
+    if (bbr->loss_in_round && bbr->filled_pipe) {
+        lo = bbr->inflight_lo == BBR_UNSET ? bbr->cong_wnd : bbr->inflight_lo;
+        lo = safe_muldiv_u64(lo, BBR_BETA_NUM, BBR_BETA_DEN, &err);
+        bbr->inflight_lo = lo < bbr->k_min_wnd ? bbr->k_min_wnd : lo;
+    }
+
+    bbr->round_lost         = 0;
+    bbr->round_delivered    = 0;
+    bbr->loss_in_round      = 0;
+}
+
+static void bbr_enter_probe_bw_down(OSSL_CC_BBR2 *bbr, OSSL_TIME now)
+{
+    bbr->state          = BBR_STATE_PROBE_BW_DOWN;
+    bbr->cycle_stamp    = now;
+    bbr->cycle_round    = bbr->round_count;
+}
+
+static void bbr_enter_probe_bw_cruise(OSSL_CC_BBR2 *bbr)
+{
+    bbr->state = BBR_STATE_PROBE_BW_CRUISE;
+}
+
+static void bbr_enter_probe_bw_refill(OSSL_CC_BBR2 *bbr)
+{
+    /* Forget about earlier losses so that we can probe again. */
+    bbr->inflight_lo    = BBR_UNSET;
+    bbr->state          = BBR_STATE_PROBE_BW_REFILL;
+    bbr->refill_round   = bbr->round_count;
+}
+
+static void bbr_enter_probe_bw_up(OSSL_CC_BBR2 *bbr)
+{
+    bbr->state = BBR_STATE_PROBE_BW_UP;
+}
+
+/* Handles a round in which too much of the data sent was lost. */
+static void bbr_handle_inflight_too_high(OSSL_CC_BBR2 *bbr, OSSL_TIME now)
+{
+    uint64_t hi, bdp = bbr_bdp(bbr, 100);
+    int err = 0;
+
+    switch (bbr->state) {
+    case BBR_STATE_STARTUP:
+        /* The path is full; stay below what we had in flight last round. */
+        bbr->filled_pipe = 1;
+        bbr->inflight_hi = bdp > bbr->round_delivered ? bdp
+                                                      : bbr->round_delivered;
+        break;
+
+    case BBR_STATE_PROBE_BW_UP:
+    case BBR_STATE_PROBE_BW_REFILL:
+        /* We found the limit, remember it and back off. */
+        hi = safe_muldiv_u64(bdp, BBR_BETA_NUM, BBR_BETA_DEN, &err);
+        if (hi < bbr->inflight_at_loss)
+            hi = bbr->inflight_at_loss;
+        bbr->inflight_hi = hi;
+        bbr_enter_probe_bw_down(bbr, now);
+        break;
+
+    default:
+        /* Not probing; the short term bound takes care of this. */
+        break;
+    }
+
+    if (bbr->inflight_hi != BBR_UNSET && bbr->inflight_hi < bbr->k_min_wnd)
+        bbr->inflight_hi = bbr->k_min_wnd;
+}
+
+static void bbr_check_startup_done(OSSL_CC_BBR2 *bbr)
+{
+    int err = 0;
+
+    if (bbr->state != BBR_STATE_STARTUP)
+        return;
+
+    if (!bbr->filled_pipe && bbr->round_start) {
+        if (bbr->max_bw >= safe_muldiv_u64(bbr->full_bw, BBR_FULL_BW_THRESH,
+                                           100, &err)) {
+            bbr->full_bw        = bbr->max_bw;
+            bbr->full_bw_count  = 0;
+        } else if (++bbr->full_bw_count >= BBR_FULL_BW_COUNT) {
+            bbr->filled_pipe    = 1;
+        }
+    }
+
+    if (bbr->filled_pipe)
+        bbr->state = BBR_STATE_DRAIN;
+}
+
+static void bbr_update_probe_bw(OSSL_CC_BBR2 *bbr, OSSL_TIME now)
+{
+    uint64_t bdp = bbr_bdp(bbr, 100);
+
+    switch (bbr->state) {
+    case BBR_STATE_DRAIN:
+        if (bbr->bytes_in_flight <= bdp)
+            bbr_enter_probe_bw_down(bbr, now);
+        break;
+
+    case BBR_STATE_PROBE_BW_DOWN:
+        if (bbr->bytes_in_flight <= bdp)
+            bbr_enter_probe_bw_cruise(bbr);
+        break;
+
+    case BBR_STATE_PROBE_BW_CRUISE:
+        if (ossl_time_compare(now, ossl_time_add(bbr->cycle_stamp,
+                                                 BBR_PROBE_BW_MAX_WAIT)) >= 0
+            || bbr->round_count - bbr->cycle_round >= BBR_PROBE_BW_MAX_ROUNDS)
+            bbr_enter_probe_bw_refill(bbr);
+        break;
+
+    case BBR_STATE_PROBE_BW_REFILL:
+        /* Refill the pipe for one round before probing. */
+        if (bbr->round_start && bbr->round_count > bbr->refill_round)
+            bbr_enter_probe_bw_up(bbr);
+        break;
+
+    case BBR_STATE_PROBE_BW_UP:
+        /* Probe for at least a round, until we have 1.25 BDP in flight. */
+        if (bbr->round_start && bbr->round_count > bbr->refill_round + 1
+            && bbr->bytes_in_flight >= bbr_bdp(bbr, 125))
+            bbr_enter_probe_bw_down(bbr, now);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void bbr_update_probe_rtt(OSSL_CC_BBR2 *bbr, OSSL_TIME now,
+                                 int probe_rtt_expired)
+{
+    uint64_t target;
+
+    if (bbr->state != BBR_STATE_PROBE_RTT) {
+        if (probe_rtt_expired) {
+            bbr->prior_cwnd             = bbr->cong_wnd;
+            bbr->state                  = BBR_STATE_PROBE_RTT;
+            bbr->probe_rtt_done_stamp   = ossl_time_zero();
+            bbr->probe_rtt_round_done   = 0;
+        }
+
+        return;
+    }
+
+    target = bbr_bdp(bbr, BBR_PROBE_RTT_CWND_GAIN);
+    if (target < bbr->k_min_wnd)
+        target = bbr->k_min_wnd;
+
+    if (ossl_time_is_zero(bbr->probe_rtt_done_stamp)) {
+        if (bbr->bytes_in_flight <= target) {
+            bbr->probe_rtt_done_stamp
+                = ossl_time_add(now, BBR_PROBE_RTT_DURATION);
+            bbr->probe_rtt_round_done   = 0;
+            bbr->next_round_delivered   = bbr->delivered;
+        }
+
+        return;
+    }
+
+    if (bbr->round_start)
+        bbr->probe_rtt_round_done = 1;
+
+    if (bbr->probe_rtt_round_done
+        && ossl_time_compare(now, bbr->probe_rtt_done_stamp) >= 0) {
+        /* Done, the minimum RTT is fresh again. */
+        bbr->probe_rtt_min_stamp = now;
+        if (bbr->cong_wnd < bbr->prior_cwnd)
+            bbr->cong_wnd = bbr->prior_cwnd;
+
+        if (bbr->filled_pipe) {
+            bbr_enter_probe_bw_down(bbr, now);
+            bbr_enter_probe_bw_cruise(bbr);
+        } else {
+            bbr->state = BBR_STATE_STARTUP;
+        }
+    }
+}
+
+/* Whether at least half the window was in use before acked bytes arrived. */
+static int bbr_is_cong_limited(OSSL_CC_BBR2 *bbr, uint64_t acked)
+{
+    return (bbr->bytes_in_flight + acked) * 2 >= bbr->cong_wnd;
+}
+
+static void bbr_set_cwnd(OSSL_CC_BBR2 *bbr, uint64_t acked)
+{
+    uint32_t gain;
+    uint64_t target, cap;
+    int err = 0;
+
+    switch (bbr->state) {
+    case BBR_STATE_STARTUP:
+        gain = BBR_STARTUP_CWND_GAIN;
+        break;
+    case BBR_STATE_PROBE_BW_UP:
+        gain = BBR_PROBE_UP_CWND_GAIN;
+        break;
+    default:
+        gain = BBR_CWND_GAIN;
+        break;
+    }
+
+    target = bbr_bdp(bbr, gain);
+    if (target == 0)
+        target = bbr->k_init_wnd;
+    else
+        /* Allow for delayed and aggregated acknowledgements. */
+        target = safe_add_u64(target, 3 * (uint64_t)bbr->max_dgram_size, &err);
+
+    if (bbr->filled_pipe) {
+        bbr->cong_wnd += acked;
+        if (bbr->cong_wnd > target)
+            bbr->cong_wnd = target;
+    } else if ((bbr->cong_wnd < target || bbr->delivered < bbr->k_init_wnd)
+               && bbr_is_cong_limited(bbr, acked)) {
+        /*
+         * RFC 9002 s. 7.8: do not grow the window while the application
+         * is not using at least half of it.
+         */
+        bbr->cong_wnd += acked;
+    }
+
+    if (bbr->state == BBR_STATE_PROBE_RTT) {
+        cap = bbr_bdp(bbr, BBR_PROBE_RTT_CWND_GAIN);
+        if (bbr->cong_wnd > cap)
+            bbr->cong_wnd = cap;
+    }
+
+    /* Respect the loss based bounds, leaving headroom when not probing. */
+    cap = bbr->inflight_hi;
+    if (cap != BBR_UNSET && bbr->state != BBR_STATE_PROBE_BW_UP
+        && bbr->state != BBR_STATE_STARTUP)
+        cap -= cap * BBR_HEADROOM / 100;
+    if (bbr->inflight_lo < cap)
+        cap = bbr->inflight_lo;
+    if (bbr->cong_wnd > cap)
+        bbr->cong_wnd = cap;
+
+    if (bbr->cong_wnd < bbr->k_min_wnd)
+        bbr->cong_wnd = bbr->k_min_wnd;
+}
+
+static void bbr_set_pacing_rate(OSSL_CC_BBR2 *bbr)
+{
+    uint32_t gain;
+    uint64_t rate;
+    int err = 0;
+
+    switch (bbr->state) {
+    case BBR_STATE_STARTUP:
+        gain = BBR_STARTUP_PACING_GAIN;
+        break;
+    case BBR_STATE_DRAIN:
+        gain = BBR_DRAIN_PACING_GAIN;
+        break;
+    case BBR_STATE_PROBE_BW_DOWN:
+        gain = BBR_PROBE_DOWN_PACING_GAIN;
+        break;
+    case BBR_STATE_PROBE_BW_UP:
+        gain = BBR_PROBE_UP_PACING_GAIN;
+        break;
+    default:
+        gain = BBR_PACING_GAIN;
+        break;
+    }
+
+    /* Keep the initial rate until there is a bandwidth sample. */
+    if (bbr->max_bw == 0)
+        return;
+
+    rate = safe_muldiv_u64(bbr->max_bw, gain * (100 - BBR_PACING_MARGIN),
+                           100 * 100, &err);
+    if (err)
+        rate = UINT64_MAX;
+
+    /* Do not slow down in Startup on the strength of early samples. */
+    if (bbr->filled_pipe || rate > bbr->pacing_rate)
+        bbr->pacing_rate = rate;
+}
+
+static uint64_t bbr_get_tx_allowance(OSSL_CC_DATA *cc)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+
+    if (bbr->bytes_in_flight >= bbr->cong_wnd)
+        return 0;
+
+    return bbr->cong_wnd - bbr->bytes_in_flight;
+}
+
+static OSSL_TIME bbr_get_wakeup_deadline(OSSL_CC_DATA *cc)
+{
+    if (bbr_get_tx_allowance(cc) > 0)
+        /* We have TX allowance now so wakeup immediately */
+        return ossl_time_zero();
+
+    /* The window only changes in response to acknowledgements and losses. */
+    return ossl_time_infinite();
+}
+
+static uint64_t bbr_get_pacing_rate(OSSL_CC_DATA *cc)
+{
+    return ((OSSL_CC_BBR2 *)cc)->pacing_rate;
+}
+
+static int bbr_on_data_sent(OSSL_CC_DATA *cc, uint64_t num_bytes)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+    OSSL_TIME now = bbr->now_cb(bbr->now_cb_arg);
+
+    /* Do not count idle periods as delivery time. */
+    if (bbr->bytes_in_flight == 0)
+        bbr->delivered_time = now;
+
+    bbr_record_send(bbr, now);
+    bbr->bytes_in_flight += num_bytes;
+    bbr_update_diag(bbr);
+    return 1;
+}
+
+static int bbr_on_data_acked(OSSL_CC_DATA *cc, const OSSL_CC_ACK_INFO *info)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+    OSSL_TIME now = bbr->now_cb(bbr->now_cb_arg), interval;
+    const BBR_SEND_REC *rec;
+    uint64_t bw = 0;
+    int err = 0, probe_rtt_expired = 0;
+
+    bbr->bytes_in_flight    -= info->tx_size;
+    bbr->delivered          += info->tx_size;
+    bbr->round_start        = 0;
+
+    rec = bbr_find_send(bbr, info->tx_time);
+    if (rec != NULL) {
+        /*
+         * A round trip is over once a packet sent after the start of the
+         * current round has been acknowledged.
+         */
+        if (rec->delivered >= bbr->next_round_delivered) {
+            bbr->next_round_delivered = bbr->delivered;
+            ++bbr->round_count;
+            bbr->round_start = 1;
+            bbr_start_round(bbr);
+        }
+
+        if (ossl_time_compare(now, rec->delivered_time) > 0) {
+            interval = ossl_time_subtract(now, rec->delivered_time);
+            bw = safe_muldiv_u64(bbr->delivered - rec->delivered,
+                                 OSSL_TIME_SECOND, ossl_time2ticks(interval),
+                                 &err);
+            if (err)
+                bw = 0;
+        }
+    }
+
+    bbr->delivered_time     = now;
+    bbr->round_delivered    += info->tx_size;
+
+    if (ossl_time_compare(now, info->tx_time) > 0)
+        probe_rtt_expired
+            = bbr_update_min_rtt(bbr, now,
+                                 ossl_time_subtract(now, info->tx_time));
+
+    bbr_update_max_bw(bbr, bw);
+
+    /* While probing up, raise the upper bound as long as there is no loss. */
+    if (bbr->state == BBR_STATE_PROBE_BW_UP && bbr->inflight_hi != BBR_UNSET
+        && bbr->bytes_in_flight + info->tx_size + bbr->max_dgram_size
+           >= bbr->inflight_hi)
+        bbr->inflight_hi += info->tx_size;
+
+    bbr_check_startup_done(bbr);
+    bbr_update_probe_bw(bbr, now);
+    bbr_update_probe_rtt(bbr, now, probe_rtt_expired);
+    bbr_set_cwnd(bbr, info->tx_size);
+    bbr_set_pacing_rate(bbr);
+    bbr_update_diag(bbr);
+    return 1;
+}
+
+static int bbr_on_data_lost(OSSL_CC_DATA *cc, const OSSL_CC_LOSS_INFO *info)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+
+    if (info->tx_size > bbr->bytes_in_flight)
+        return 0;
+
+    if (!bbr->processing_loss) {
+        bbr->processing_loss    = 1;
+        bbr->inflight_at_loss   = bbr->bytes_in_flight;
+    }
+
+    bbr->bytes_in_flight    -= info->tx_size;
+    bbr->round_lost         += info->tx_size;
+    bbr->loss_in_round      = 1;
+    bbr_update_diag(bbr);
+    return 1;
+}
+
+static int bbr_on_data_lost_finished(OSSL_CC_DATA *cc, uint32_t flags)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+    OSSL_TIME now = bbr->now_cb(bbr->now_cb_arg);
+    uint64_t total;
+
+    if (!bbr->processing_loss)
+        return 1;
+
+    bbr->processing_loss = 0;
+
+    total = bbr->round_lost + bbr->round_delivered;
+    if (bbr->round_lost * 100 > total * BBR_LOSS_THRESH)
+        bbr_handle_inflight_too_high(bbr, now);
+
+    if ((flags & OSSL_CC_LOST_FLAG_PERSISTENT_CONGESTION) != 0) {
+        bbr->prior_cwnd = bbr->cong_wnd;
+        bbr->cong_wnd   = bbr->k_min_wnd;
+    }
+
+    bbr_set_cwnd(bbr, 0);
+    bbr_set_pacing_rate(bbr);
+    bbr_update_diag(bbr);
+    return 1;
+}
+
+static int bbr_on_data_invalidated(OSSL_CC_DATA *cc, uint64_t num_bytes)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+
+    bbr->bytes_in_flight -= num_bytes;
+    bbr_update_diag(bbr);
+    return 1;
+}
+
+static int bbr_on_ecn(OSSL_CC_DATA *cc, const OSSL_CC_ECN_INFO *info)
+{
+    OSSL_CC_BBR2 *bbr = (OSSL_CC_BBR2 *)cc;
+
+    /* Treat a CE mark like a loss for the short term bound. */
+    bbr->loss_in_round = 1;
+    return 1;
+}
+
+const OSSL_CC_METHOD ossl_cc_bbr2_method = {
+    bbr_new,
+    bbr_free,
+    bbr_reset,
+    bbr_set_input_params,
+    bbr_bind_diagnostic,
+    bbr_unbind_diagnostic,
+    bbr_get_tx_allowance,
+    bbr_get_wakeup_deadline,
+    bbr_get_pacing_rate,
+    bbr_on_data_sent,
+    bbr_on_data_acked,
+    bbr_on_data_lost,
+    bbr_on_data_lost_finished,
+    bbr_on_data_invalidated,
+    bbr_on_ecn,
+};
@@ -0,0 +1,614 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include "internal/quic_cc.h"
+#include "internal/quic_types.h"
+#include "internal/safe_math.h"
+
+OSSL_SAFE_MATH_UNSIGNED(u64, uint64_t)
+
+/*
+ * CUBIC congestion controller (RFC 9438).
+ *
+ * Slow start and congestion recovery work as in the NewReno congestion
+ * controller. In the congestion avoidance state the window follows the cubic
+ * function
+ *
+ *   W_cubic(t) = C * (t - K)^3 + W_max
+ *
+ * where t is the time since the end of the last congestion recovery period and
+ * W_max is the window at which the last congestion event occurred. The window
+ * grows quickly while it is far below W_max, levels off around it and then
+ * starts probing for more bandwidth again, so its growth does not depend on the
+ * RTT the way NewReno's linear growth does. The window never grows slower than
+ * that of an AIMD controller using the same multiplicative decrease (the
+ * Reno-friendly region).
+ */
+typedef struct ossl_cc_cubic_st {
+    /* Dependencies. */
+    OSSL_TIME   (*now_cb)(void *arg);
+    void        *now_cb_arg;
+
+    /* 'Constants' (which we allow to be configurable). */
+    uint64_t    k_init_wnd, k_min_wnd;
+
+    /* State. */
+    size_t      max_dgram_size;
+    uint64_t    bytes_in_flight, cong_wnd, slow_start_thresh;
+    OSSL_TIME   cong_recovery_start_time;
+
+    /* Window before the last congestion event and the cubic origin. */
+    uint64_t    w_max, cwnd_prior;
+    /* Reno-friendly window estimate. */
+    uint64_t    w_est;
+    /* Remainders of the fractional window increases. */
+    uint64_t    cwnd_inc_rem, w_est_inc_rem;
+    /* Start of the current congestion avoidance epoch or zero. */
+    OSSL_TIME   epoch_start;
+    /* Time after the start of the epoch at which W_cubic(t) reaches W_max. */
+    OSSL_TIME   k;
+    /* Smoothed RTT of the acknowledged packets. */
+    OSSL_TIME   srtt;
+
+    /* Unflushed state during multiple on-loss calls. */
+    int         processing_loss; /* 1 if not flushed */
+    OSSL_TIME   tx_time_of_last_loss;
+
+    /* Diagnostic state. */
+    int         in_congestion_recovery;
+
+    /* Diagnostic output locations. */
+    size_t      *p_diag_max_dgram_payload_len;
+    uint64_t    *p_diag_cur_cwnd_size;
+    uint64_t    *p_diag_min_cwnd_size;
+    uint64_t    *p_diag_cur_bytes_in_flight;
+    uint32_t    *p_diag_cur_state;
+} OSSL_CC_CUBIC;
+
+#define MIN_MAX_INIT_WND_SIZE    14720  /* RFC 9002 s. 7.2 */
+
+/* Multiplicative decrease factor beta_cubic = 0.7 */
+#define CUBIC_BETA_NUM          7
+#define CUBIC_BETA_DEN          10
+
+/* Scaling constant C = 0.4 */
+#define CUBIC_C_NUM             4
+#define CUBIC_C_DEN             10
+
+/* alpha_cubic = 3 * (1 - beta_cubic) / (1 + beta_cubic) = 9 / 17 */
+#define CUBIC_ALPHA_NUM         9
+#define CUBIC_ALPHA_DEN         17
+
+/* Cubes of milliseconds per cube of seconds. */
+#define MS3_PER_S3              UINT64_C(1000000000)
+
+/* Keeps |t - K| in milliseconds small enough for its cube to fit 64 bits. */
+#define CUBIC_MAX_OFFSET_MS     ((UINT64_C(1) << 21) - 1)
+
+static void cubic_set_max_dgram_size(OSSL_CC_CUBIC *cc,
+                                     size_t max_dgram_size);
+static void cubic_update_diag(OSSL_CC_CUBIC *cc);
+
+static void cubic_reset(OSSL_CC_DATA *cc);
+
+static OSSL_CC_DATA *cubic_new(OSSL_TIME (*now_cb)(void *arg),
+                               void *now_cb_arg)
+{
+    OSSL_CC_CUBIC *cc;
+
+    if ((cc = OPENSSL_zalloc(sizeof(*cc))) == NULL)
+        return NULL;
+
+    cc->now_cb          = now_cb;
+    cc->now_cb_arg      = now_cb_arg;
+
+    cubic_set_max_dgram_size(cc, QUIC_MIN_INITIAL_DGRAM_LEN);
+    cubic_reset((OSSL_CC_DATA *)cc);
+
+    return (OSSL_CC_DATA *)cc;
+}
+
+static void cubic_free(OSSL_CC_DATA *cc)
+{
+    OPENSSL_free(cc);
+}
+
+static void cubic_set_max_dgram_size(OSSL_CC_CUBIC *cc,
+                                     size_t max_dgram_size)
+{
+    size_t max_init_wnd;
+    int is_reduced = (max_dgram_size < cc->max_dgram_size);
+
+    cc->max_dgram_size = max_dgram_size;
+
+    max_init_wnd = 2 * max_dgram_size;
+    if (max_init_wnd < MIN_MAX_INIT_WND_SIZE)
+        max_init_wnd = MIN_MAX_INIT_WND_SIZE;
+
+    cc->k_init_wnd = 10 * max_dgram_size;
+    if (cc->k_init_wnd > max_init_wnd)
+        cc->k_init_wnd = max_init_wnd;
+
+    cc->k_min_wnd = 2 * max_dgram_size;
+
+    if (is_reduced)
+        cc->cong_wnd = cc->k_init_wnd;
+
+    cubic_update_diag(cc);
+}
+
+static void cubic_reset(OSSL_CC_DATA *ccdata)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->cong_wnd                    = cc->k_init_wnd;
+    cc->bytes_in_flight             = 0;
+    cc->slow_start_thresh           = UINT64_MAX;
+    cc->cong_recovery_start_time    = ossl_time_zero();
+
+    cc->w_max           = 0;
+    cc->cwnd_prior      = 0;
+    cc->w_est           = 0;
+    cc->cwnd_inc_rem    = 0;
+    cc->w_est_inc_rem   = 0;
+    cc->epoch_start     = ossl_time_zero();
+    cc->k               = ossl_time_zero();
+    cc->srtt            = ossl_time_zero();
+
+    cc->processing_loss         = 0;
+    cc->tx_time_of_last_loss    = ossl_time_zero();
+    cc->in_congestion_recovery  = 0;
+}
+
+static int cubic_set_input_params(OSSL_CC_DATA *ccdata,
+                                  const OSSL_PARAM *params)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+    const OSSL_PARAM *p;
+    size_t value;
+
+    p = OSSL_PARAM_locate_const(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN);
+    if (p != NULL) {
+        if (!OSSL_PARAM_get_size_t(p, &value))
+            return 0;
+        if (value < QUIC_MIN_INITIAL_DGRAM_LEN)
+            return 0;
+
+        cubic_set_max_dgram_size(cc, value);
+    }
+
+    return 1;
+}
+
+static int cubic_bind_diagnostic(OSSL_CC_DATA *ccdata, OSSL_PARAM *params)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+    size_t *new_p_max_dgram_payload_len;
+    uint64_t *new_p_cur_cwnd_size;
+    uint64_t *new_p_min_cwnd_size;
+    uint64_t *new_p_cur_bytes_in_flight;
+    uint32_t *new_p_cur_state;
+
+    if (!ossl_cc_bind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+                           sizeof(size_t),
+                           (void **)&new_p_max_dgram_payload_len)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+                              sizeof(uint64_t), (void **)&new_p_cur_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+                              sizeof(uint64_t), (void **)&new_p_min_cwnd_size)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+                              sizeof(uint64_t),
+                              (void **)&new_p_cur_bytes_in_flight)
+        || !ossl_cc_bind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+                              sizeof(uint32_t), (void **)&new_p_cur_state))
+        return 0;
+
+    if (new_p_max_dgram_payload_len != NULL)
+        cc->p_diag_max_dgram_payload_len = new_p_max_dgram_payload_len;
+
+    if (new_p_cur_cwnd_size != NULL)
+        cc->p_diag_cur_cwnd_size = new_p_cur_cwnd_size;
+
+    if (new_p_min_cwnd_size != NULL)
+        cc->p_diag_min_cwnd_size = new_p_min_cwnd_size;
+
+    if (new_p_cur_bytes_in_flight != NULL)
+        cc->p_diag_cur_bytes_in_flight = new_p_cur_bytes_in_flight;
+
+    if (new_p_cur_state != NULL)
+        cc->p_diag_cur_state = new_p_cur_state;
+
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_unbind_diagnostic(OSSL_CC_DATA *ccdata, OSSL_PARAM *params)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MAX_DGRAM_PAYLOAD_LEN,
+                        (void **)&cc->p_diag_max_dgram_payload_len);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_CWND_SIZE,
+                        (void **)&cc->p_diag_cur_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_MIN_CWND_SIZE,
+                        (void **)&cc->p_diag_min_cwnd_size);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_BYTES_IN_FLIGHT,
+                        (void **)&cc->p_diag_cur_bytes_in_flight);
+    ossl_cc_unbind_diag(params, OSSL_CC_OPTION_CUR_STATE,
+                        (void **)&cc->p_diag_cur_state);
+    return 1;
+}
+
+static void cubic_update_diag(OSSL_CC_CUBIC *cc)
+{
+    if (cc->p_diag_max_dgram_payload_len != NULL)
+        *cc->p_diag_max_dgram_payload_len = cc->max_dgram_size;
+
+    if (cc->p_diag_cur_cwnd_size != NULL)
+        *cc->p_diag_cur_cwnd_size = cc->cong_wnd;
+
+    if (cc->p_diag_min_cwnd_size != NULL)
+        *cc->p_diag_min_cwnd_size = cc->k_min_wnd;
+
+    if (cc->p_diag_cur_bytes_in_flight != NULL)
+        *cc->p_diag_cur_bytes_in_flight = cc->bytes_in_flight;
+
+    if (cc->p_diag_cur_state != NULL) {
+        if (cc->in_congestion_recovery)
+            *cc->p_diag_cur_state = 'R';
+        else if (cc->cong_wnd < cc->slow_start_thresh)
+            *cc->p_diag_cur_state = 'S';
+        else
+            *cc->p_diag_cur_state = 'A';
+    }
+}
+
+/* Integer cube root, rounded down. */
+static uint64_t icbrt(uint64_t x)
+{
+    uint64_t y = 0, b;
+    int s;
+
+    for (s = 63; s >= 0; s -= 3) {
+        y <<= 1;
+        b = 3 * y * (y + 1) + 1;
+        if ((x >> s) >= b) {
+            x -= b << s;
+            ++y;
+        }
+    }
+
+    return y;
+}
+
+/* Returns W_cubic(t) in bytes. */
+static uint64_t cubic_w_cubic(OSSL_CC_CUBIC *cc, OSSL_TIME t)
+{
+    uint64_t off, delta;
+    int neg, err = 0;
+
+    neg = ossl_time_compare(t, cc->k) < 0;
+    off = ossl_time2ms(ossl_time_abs_difference(t, cc->k));
+    if (off > CUBIC_MAX_OFFSET_MS)
+        off = CUBIC_MAX_OFFSET_MS;
+
+    /* C * (t - K)^3 segments, with t - K in seconds. */
+    delta = safe_muldiv_u64(off * off * off,
+                            CUBIC_C_NUM * (uint64_t)cc->max_dgram_size,
+                            CUBIC_C_DEN * MS3_PER_S3, &err);
+    if (err)
+        delta = UINT64_MAX;
+
+    if (neg)
+        return delta >= cc->w_max ? 0 : cc->w_max - delta;
+
+    delta = safe_add_u64(cc->w_max, delta, &err);
+    return err ? UINT64_MAX : delta;
+}
+
+static void cubic_start_epoch(OSSL_CC_CUBIC *cc, OSSL_TIME now)
+{
+    uint64_t k3;
+    int err = 0;
+
+    cc->epoch_start     = now;
+    cc->cwnd_inc_rem    = 0;
+    cc->w_est_inc_rem   = 0;
+    cc->w_est           = cc->cong_wnd;
+
+    if (cc->cong_wnd < cc->w_max) {
+        /* K = cbrt((W_max - cwnd) / C), with windows in segments. */
+        k3 = safe_muldiv_u64(cc->w_max - cc->cong_wnd,
+                             CUBIC_C_DEN * MS3_PER_S3,
+                             CUBIC_C_NUM * (uint64_t)cc->max_dgram_size, &err);
+        if (err)
+            k3 = UINT64_MAX;
+
+        cc->k = ossl_ms2time(icbrt(k3));
+    } else {
+        /* We are already past W_max, so probe from here. */
+        cc->k       = ossl_time_zero();
+        cc->w_max   = cc->cong_wnd;
+    }
+}
+
+static int cubic_in_cong_recovery(OSSL_CC_CUBIC *cc, OSSL_TIME tx_time)
+{
+    return ossl_time_compare(tx_time, cc->cong_recovery_start_time) <= 0;
+}
+
+static void cubic_cong(OSSL_CC_CUBIC *cc, OSSL_TIME tx_time)
+{
+    int err = 0;
+
+    /* No reaction if already in a recovery period. */
+    if (cubic_in_cong_recovery(cc, tx_time))
+        return;
+
+    /* Start a new recovery period. */
+    cc->in_congestion_recovery = 1;
+    cc->cong_recovery_start_time = cc->now_cb(cc->now_cb_arg);
+
+    /*
+     * Fast convergence: if the window did not get back to W_max since the last
+     * congestion event, the available bandwidth has shrunk, so release some of
+     * it to other flows early.
+     */
+    if (cc->cong_wnd < cc->w_max)
+        cc->w_max = safe_muldiv_u64(cc->cong_wnd,
+                                    CUBIC_BETA_DEN + CUBIC_BETA_NUM,
+                                    2 * CUBIC_BETA_DEN, &err);
+    else
+        cc->w_max = cc->cong_wnd;
+
+    cc->cwnd_prior = cc->cong_wnd;
+
+    /* slow_start_thresh = cong_wnd * beta_cubic */
+    cc->slow_start_thresh = safe_muldiv_u64(cc->cong_wnd, CUBIC_BETA_NUM,
+                                            CUBIC_BETA_DEN, &err);
+    if (err) {
+        cc->w_max               = cc->cong_wnd;
+        cc->slow_start_thresh   = UINT64_MAX;
+    }
+
+    if (cc->slow_start_thresh < cc->k_min_wnd)
+        cc->slow_start_thresh = cc->k_min_wnd;
+
+    cc->cong_wnd = cc->slow_start_thresh;
+
+    /* The next epoch starts with the first acknowledgement after recovery. */
+    cc->epoch_start = ossl_time_zero();
+}
+
+static void cubic_flush(OSSL_CC_CUBIC *cc, uint32_t flags)
+{
+    if (!cc->processing_loss)
+        return;
+
+    cubic_cong(cc, cc->tx_time_of_last_loss);
+
+    if ((flags & OSSL_CC_LOST_FLAG_PERSISTENT_CONGESTION) != 0) {
+        cc->cong_wnd                    = cc->k_min_wnd;
+        cc->cong_recovery_start_time    = ossl_time_zero();
+        cc->epoch_start                 = ossl_time_zero();
+    }
+
+    cc->processing_loss = 0;
+    cubic_update_diag(cc);
+}
+
+static uint64_t cubic_get_tx_allowance(OSSL_CC_DATA *ccdata)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    if (cc->bytes_in_flight >= cc->cong_wnd)
+        return 0;
+
+    return cc->cong_wnd - cc->bytes_in_flight;
+}
+
+static OSSL_TIME cubic_get_wakeup_deadline(OSSL_CC_DATA *ccdata)
+{
+    if (cubic_get_tx_allowance(ccdata) > 0)
+        /* We have TX allowance now so wakeup immediately */
+        return ossl_time_zero();
+
+    /* The window only changes in response to acknowledgements and losses. */
+    return ossl_time_infinite();
+}
+
+static uint64_t cubic_get_pacing_rate(OSSL_CC_DATA *ccdata)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    return ossl_cc_window_pacing_rate(cc->cong_wnd, cc->srtt,
+                                      cc->cong_wnd < cc->slow_start_thresh);
+}
+
+static int cubic_on_data_sent(OSSL_CC_DATA *ccdata, uint64_t num_bytes)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->bytes_in_flight += num_bytes;
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_is_cong_limited(OSSL_CC_CUBIC *cc)
+{
+    uint64_t wnd_rem;
+
+    /* We are congestion-limited if we are already at the congestion window. */
+    if (cc->bytes_in_flight >= cc->cong_wnd)
+        return 1;
+
+    wnd_rem = cc->cong_wnd - cc->bytes_in_flight;
+
+    /* Same criteria as for NewReno. */
+    return (cc->cong_wnd < cc->slow_start_thresh && wnd_rem <= cc->cong_wnd / 2)
+           || wnd_rem <= 3 * cc->max_dgram_size;
+}
+
+static void cubic_avoid_cong(OSSL_CC_CUBIC *cc, OSSL_TIME now,
+                             uint64_t acked)
+{
+    OSSL_TIME t;
+    uint64_t target, w_cubic, num, den;
+
+    if (ossl_time_is_zero(cc->epoch_start))
+        cubic_start_epoch(cc, now);
+
+    /*
+     * Grow the Reno-friendly estimate by alpha_cubic segments per window
+     * acknowledged, or by one segment once it has passed the window at the
+     * last congestion event.
+     */
+    if (cc->w_est < cc->cwnd_prior) {
+        num = CUBIC_ALPHA_NUM;
+        den = CUBIC_ALPHA_DEN;
+    } else {
+        num = den = 1;
+    }
+
+    cc->w_est_inc_rem += acked * cc->max_dgram_size * num;
+    cc->w_est += cc->w_est_inc_rem / (cc->cong_wnd * den);
+    cc->w_est_inc_rem %= cc->cong_wnd * den;
+
+    t = ossl_time_subtract(now, cc->epoch_start);
+    w_cubic = cubic_w_cubic(cc, t);
+
+    if (w_cubic < cc->w_est) {
+        /* Reno-friendly region. */
+        if (cc->cong_wnd < cc->w_est)
+            cc->cong_wnd = cc->w_est;
+        return;
+    }
+
+    /* Aim for the window W_cubic gives one RTT from now, but at most 1.5x. */
+    target = cubic_w_cubic(cc, ossl_time_add(t, cc->srtt));
+    if (target > cc->cong_wnd + cc->cong_wnd / 2)
+        target = cc->cong_wnd + cc->cong_wnd / 2;
+    if (target <= cc->cong_wnd)
+        return;
+
+    /* Increase by (target - cwnd) / cwnd per byte acknowledged. */
+    cc->cwnd_inc_rem += (target - cc->cong_wnd) * acked;
+    den = cc->cong_wnd;
+    cc->cong_wnd += cc->cwnd_inc_rem / den;
+    cc->cwnd_inc_rem %= den;
+}
+
+static int cubic_on_data_acked(OSSL_CC_DATA *ccdata,
+                               const OSSL_CC_ACK_INFO *info)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+    OSSL_TIME now = cc->now_cb(cc->now_cb_arg);
+
+    cc->bytes_in_flight -= info->tx_size;
+    ossl_cc_update_srtt(&cc->srtt, now, info->tx_time);
+
+    /*
+     * As with NewReno, an acknowledgement is only a sign of spare capacity if
+     * we are making use of the window we already have.
+     */
+    if (!cubic_is_cong_limited(cc))
+        goto out;
+
+    if (cubic_in_cong_recovery(cc, info->tx_time)) {
+        /* Congestion recovery, do nothing. */
+    } else if (cc->cong_wnd < cc->slow_start_thresh) {
+        /* Slow start. */
+        cc->cong_wnd += info->tx_size;
+        cc->in_congestion_recovery = 0;
+    } else {
+        /* Congestion avoidance. */
+        cubic_avoid_cong(cc, now, info->tx_size);
+        cc->in_congestion_recovery = 0;
+    }
+
+out:
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_on_data_lost(OSSL_CC_DATA *ccdata,
+                              const OSSL_CC_LOSS_INFO *info)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    if (info->tx_size > cc->bytes_in_flight)
+        return 0;
+
+    cc->bytes_in_flight -= info->tx_size;
+
+    if (!cc->processing_loss) {
+        /*
+         * Do not react again to the loss of a packet sent before a loss which
+         * has already been signalled.
+         */
+        if (ossl_time_compare(info->tx_time, cc->tx_time_of_last_loss) <= 0)
+            goto out;
+
+        cc->processing_loss = 1;
+    }
+
+    cc->tx_time_of_last_loss
+        = ossl_time_max(cc->tx_time_of_last_loss, info->tx_time);
+
+out:
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_on_data_lost_finished(OSSL_CC_DATA *ccdata, uint32_t flags)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cubic_flush(cc, flags);
+    return 1;
+}
+
+static int cubic_on_data_invalidated(OSSL_CC_DATA *ccdata,
+                                     uint64_t num_bytes)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->bytes_in_flight -= num_bytes;
+    cubic_update_diag(cc);
+    return 1;
+}
+
+static int cubic_on_ecn(OSSL_CC_DATA *ccdata,
+                        const OSSL_CC_ECN_INFO *info)
+{
+    OSSL_CC_CUBIC *cc = (OSSL_CC_CUBIC *)ccdata;
+
+    cc->processing_loss         = 1;
+    cc->tx_time_of_last_loss    = info->largest_acked_time;
+    cubic_flush(cc, 0);
+    return 1;
+}
+
+const OSSL_CC_METHOD ossl_cc_cubic_method = {
+    cubic_new,
+    cubic_free,
+    cubic_reset,
+    cubic_set_input_params,
+    cubic_bind_diagnostic,
+    cubic_unbind_diagnostic,
+    cubic_get_tx_allowance,
+    cubic_get_wakeup_deadline,
+    cubic_get_pacing_rate,
+    cubic_on_data_sent,
+    cubic_on_data_acked,
+    cubic_on_data_lost,
+    cubic_on_data_lost_finished,
+    cubic_on_data_invalidated,
+    cubic_on_ecn,
+};
@@ -1094,6 +1094,13 @@ void ossl_ackm_free(OSSL_ACKM *ackm)
     OPENSSL_free(ackm);
 }
 
+void ossl_ackm_set_cc(OSSL_ACKM *ackm, const OSSL_CC_METHOD *cc_method,
+                      OSSL_CC_DATA *cc_data)
+{
+    ackm->cc_method = cc_method;
+    ackm->cc_data   = cc_data;
+}
+
 int ossl_ackm_on_tx_packet(OSSL_ACKM *ackm, OSSL_ACKM_TX_PKT *pkt)
 {
     struct tx_pkt_history_st *h = get_tx_history(ackm, pkt->pkt_space);
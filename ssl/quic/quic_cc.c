@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/crypto.h>
+#include "internal/nelem.h"
+#include "internal/quic_cc.h"
+#include "internal/safe_math.h"
+
+OSSL_SAFE_MATH_UNSIGNED(u64, uint64_t)
+
+/* Pacing gains of window based congestion controllers, in percent. */
+#define CC_PACING_GAIN_SLOW_START   200
+#define CC_PACING_GAIN              125
+
+static const struct {
+    const char              *name;
+    const OSSL_CC_METHOD    *method;
+} cc_methods[] = {
+    { "newreno",    &ossl_cc_newreno_method },
+    { "cubic",      &ossl_cc_cubic_method },
+    { "bbr2",       &ossl_cc_bbr2_method },
+};
+
+const OSSL_CC_METHOD *ossl_cc_method_from_name(const char *name)
+{
+    size_t i;
+
+    if (name == NULL)
+        return NULL;
+
+    for (i = 0; i < OSSL_NELEM(cc_methods); ++i)
+        if (OPENSSL_strcasecmp(name, cc_methods[i].name) == 0)
+            return cc_methods[i].method;
+
+    return NULL;
+}
+
+const char *ossl_cc_method_name(const OSSL_CC_METHOD *method)
+{
+    size_t i;
+
+    for (i = 0; i < OSSL_NELEM(cc_methods); ++i)
+        if (cc_methods[i].method == method)
+            return cc_methods[i].name;
+
+    return NULL;
+}
+
+void ossl_cc_update_srtt(OSSL_TIME *srtt, OSSL_TIME now, OSSL_TIME tx_time)
+{
+    OSSL_TIME sample;
+
+    if (ossl_time_compare(now, tx_time) <= 0)
+        return;
+
+    sample = ossl_time_subtract(now, tx_time);
+    if (ossl_time_is_zero(*srtt))
+        *srtt = sample;
+    else
+        /* srtt = 7/8 * srtt + 1/8 * sample */
+        *srtt = ossl_time_divide(ossl_time_add(ossl_time_multiply(*srtt, 7),
+                                               sample), 8);
+}
+
+uint64_t ossl_cc_window_pacing_rate(uint64_t cwnd, OSSL_TIME srtt,
+                                    int slow_start)
+{
+    uint64_t gain = slow_start ? CC_PACING_GAIN_SLOW_START : CC_PACING_GAIN;
+    uint64_t rate;
+    int err = 0;
+
+    if (ossl_time_is_zero(srtt))
+        return 0;
+
+    rate = safe_muldiv_u64(safe_mul_u64(cwnd, gain, &err), OSSL_TIME_SECOND,
+                           safe_mul_u64(ossl_time2ticks(srtt), 100, &err),
+                           &err);
+    return err ? UINT64_MAX : rate;
+}
+
+int ossl_cc_bind_diag(OSSL_PARAM *params, const char *param_name, size_t len,
+                      void **pp)
+{
+    const OSSL_PARAM *p = OSSL_PARAM_locate_const(params, param_name);
+
+    *pp = NULL;
+
+    if (p == NULL)
+        return 1;
+
+    if (p->data_type != OSSL_PARAM_UNSIGNED_INTEGER
+        || p->data_size != len)
+        return 0;
+
+    *pp = p->data;
+    return 1;
+}
+
+void ossl_cc_unbind_diag(OSSL_PARAM *params, const char *param_name,
+                         void **pp)
+{
+    const OSSL_PARAM *p = OSSL_PARAM_locate_const(params, param_name);
+
+    if (p != NULL)
+        *pp = NULL;
+}
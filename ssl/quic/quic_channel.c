@@ -237,7 +237,8 @@ static int ch_init(QUIC_CHANNEL *ch)
         goto err;
 
     ch->have_statm = 1;
-    ch->cc_method = &ossl_cc_newreno_method;
+    ch->cc_method = ch->tls->ctx->quic_cc_method != NULL
+                    ? ch->tls->ctx->quic_cc_method : &ossl_cc_newreno_method;
     if ((ch->cc_data = ch->cc_method->new(get_time, ch)) == NULL)
         goto err;
 
@@ -4097,6 +4098,33 @@ int ossl_quic_channel_have_generated_transport_params(const QUIC_CHANNEL *ch)
     return ch->got_local_transport_params;
 }
 
+int ossl_quic_channel_set_cc_method(QUIC_CHANNEL *ch,
+                                    const OSSL_CC_METHOD *method)
+{
+    OSSL_CC_DATA *cc_data;
+
+    if (ch->state != QUIC_CHANNEL_STATE_IDLE)
+        return 0;
+
+    if (method == ch->cc_method)
+        return 1;
+
+    if ((cc_data = method->new(get_time, ch)) == NULL)
+        return 0;
+
+    ossl_ackm_set_cc(ch->ackm, method, cc_data);
+    ossl_quic_tx_packetiser_set_cc(ch->txp, method, cc_data);
+    ch->cc_method->free(ch->cc_data);
+    ch->cc_method   = method;
+    ch->cc_data     = cc_data;
+    return 1;
+}
+
+const OSSL_CC_METHOD *ossl_quic_channel_get_cc_method(const QUIC_CHANNEL *ch)
+{
+    return ch->cc_method;
+}
+
 void ossl_quic_channel_set_max_idle_timeout_request(QUIC_CHANNEL *ch, uint64_t ms)
 {
     ch->max_idle_timeout_local_req = ms;
@@ -132,6 +132,12 @@ void ossl_quic_demux_set_bio(QUIC_DEMUX *demux, BIO *net_bio)
         mtu = BIO_dgram_get_mtu(net_bio);
         if (mtu >= QUIC_MIN_INITIAL_DGRAM_LEN)
             ossl_quic_demux_set_mtu(demux, mtu); /* best effort */
+
+        /*
+         * UDP GRO is not enabled here: the BIO belongs to the application,
+         * which may also read its socket by other means.  It can enable GRO
+         * itself with BIO_dgram_set_segmentation().
+         */
     }
 }
 
@@ -373,36 +379,56 @@ static int demux_process_pending_urxl(QUIC_DEMUX *demux)
     return 1;
 }
 
+/*
+ * Whether the network BIO still holds datagrams it has taken off the socket,
+ * as BIO_s_datagram() does with GRO super-datagrams. The socket then need not
+ * be readable, so they must be read before anyone polls it.
+ */
+static int demux_net_bio_pending(QUIC_DEMUX *demux)
+{
+    return demux->net_bio != NULL
+        && (BIO_dgram_get_segmentation(demux->net_bio)
+            & BIO_DGRAM_SEGMENTATION_RX) != 0
+        && BIO_pending(demux->net_bio) > 0;
+}
+
 /*
  * Drain the pending URXE list, processing any pending URXEs by making their
- * callbacks. If no URXEs are pending, a network read is attempted first.
+ * callbacks. If no URXEs are pending, a network read is attempted first, and
+ * repeated while the network BIO holds datagrams taken off the socket.
  */
 int ossl_quic_demux_pump(QUIC_DEMUX *demux)
 {
     int ret;
 
-    if (ossl_list_urxe_head(&demux->urx_pending) == NULL) {
-        ret = demux_ensure_free_urxe(demux, DEMUX_MAX_MSGS_PER_CALL);
-        if (ret != 1)
-            return QUIC_DEMUX_PUMP_RES_PERMANENT_FAIL;
+    do {
+        if (ossl_list_urxe_head(&demux->urx_pending) == NULL) {
+            ret = demux_ensure_free_urxe(demux, DEMUX_MAX_MSGS_PER_CALL);
+            if (ret != 1)
+                return QUIC_DEMUX_PUMP_RES_PERMANENT_FAIL;
 
-        ret = demux_recv(demux);
-        if (ret != QUIC_DEMUX_PUMP_RES_OK)
-            return ret;
+            ret = demux_recv(demux);
+            if (ret != QUIC_DEMUX_PUMP_RES_OK)
+                return ret;
 
-        /*
-         * If demux_recv returned successfully, we should always have something.
-         */
-        assert(ossl_list_urxe_head(&demux->urx_pending) != NULL);
-    }
+            /*
+             * If demux_recv returned successfully, we should always have
+             * something.
+             */
+            assert(ossl_list_urxe_head(&demux->urx_pending) != NULL);
+        }
 
-    if ((ret = demux_process_pending_urxl(demux)) <= 0)
-        return QUIC_DEMUX_PUMP_RES_PERMANENT_FAIL;
+        if ((ret = demux_process_pending_urxl(demux)) <= 0)
+            return QUIC_DEMUX_PUMP_RES_PERMANENT_FAIL;
+    } while (demux_net_bio_pending(demux));
 
     return QUIC_DEMUX_PUMP_RES_OK;
 }
 
-/* Artificially inject a packet into the demuxer for testing purposes. */
+/*
+ * Artificially inject a packet into the demuxer, for testing purposes or to
+ * hand over a datagram received by another port.
+ */
 int ossl_quic_demux_inject(QUIC_DEMUX *demux,
                            const unsigned char *buf,
                            size_t buf_len,
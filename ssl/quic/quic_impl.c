@@ -1299,6 +1299,60 @@ int ossl_quic_conn_set_initial_peer_addr(SSL *s,
     return BIO_ADDR_copy(&ctx.qc->init_peer_addr, peer_addr);
 }
 
+/*
+ * SSL_set_quic_congestion_control
+ * -------------------------------
+ */
+int ossl_quic_set_congestion_control(SSL *s, const char *name)
+{
+    QCTX ctx;
+    const OSSL_CC_METHOD *method;
+    int ret = 0;
+
+    if (!expect_quic_cs(s, &ctx))
+        return 0;
+
+    if ((method = ossl_cc_method_from_name(name)) == NULL)
+        return QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_PASSED_INVALID_ARGUMENT,
+                                           "unknown congestion controller");
+
+    qctx_lock(&ctx);
+
+    if (ctx.qc->started) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED,
+                                    NULL);
+        goto out;
+    }
+
+    if (!ossl_quic_channel_set_cc_method(ctx.qc->ch, method)) {
+        QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_INTERNAL_ERROR, NULL);
+        goto out;
+    }
+
+    ret = 1;
+out:
+    qctx_unlock(&ctx);
+    return ret;
+}
+
+/*
+ * SSL_get0_quic_congestion_control
+ * --------------------------------
+ */
+const char *ossl_quic_get0_congestion_control(const SSL *s)
+{
+    QCTX ctx;
+    const char *name;
+
+    if (!expect_quic_cs(s, &ctx))
+        return NULL;
+
+    qctx_lock(&ctx);
+    name = ossl_cc_method_name(ossl_quic_channel_get_cc_method(ctx.qc->ch));
+    qctx_unlock(&ctx);
+    return name;
+}
+
 /*
  * QUIC Front-End I/O API: Asynchronous I/O Management
  * ===================================================
@@ -2940,6 +2994,11 @@ static int quic_read_actual(QCTX *ctx,
     int is_fin = 0, err, eos;
     QUIC_CONNECTION *qc = ctx->qc;
 
+    /* The head of the stream is locked until SSL_read_release() */
+    if (stream != NULL && stream->rstream_borrowed)
+        return QUIC_RAISE_NON_NORMAL_ERROR(ctx, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED,
+                                           NULL);
+
     if (!quic_validate_for_read(ctx->xso, &err, &eos)) {
         if (eos) {
             ctx->xso->retired_fin = 1;
@@ -3128,6 +3187,129 @@ int ossl_quic_peek(SSL *s, void *buf, size_t len, size_t *bytes_read)
     return quic_read(s, buf, len, bytes_read, 1);
 }
 
+/*
+ * SSL_read_borrow
+ * ---------------
+ */
+QUIC_TAKES_LOCK
+int ossl_quic_read_borrow(SSL *s, const unsigned char **data, size_t *len)
+{
+    QCTX ctx;
+    QUIC_STREAM *qs;
+    unsigned char c;
+    size_t readbytes;
+    int ret = 0, fin = 0;
+
+    /* Wait for stream data, handle the FIN and errors as SSL_peek_ex() does */
+    if (!quic_read(s, &c, 1, &readbytes, 1))
+        return 0;
+
+    if (!expect_quic_cs(s, &ctx))
+        return 0;
+
+    qctx_lock_for_io(&ctx);
+
+    if (ctx.xso == NULL)
+        ctx.xso = ctx.qc->default_xso;
+
+    if (ctx.xso == NULL || ctx.xso->stream == NULL
+            || !ossl_quic_stream_has_recv_buffer(ctx.xso->stream)) {
+        ret = QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_INTERNAL_ERROR, NULL);
+        goto out;
+    }
+
+    qs = ctx.xso->stream;
+    if (!ossl_quic_rstream_get_record(qs->rstream, data, len, &fin)) {
+        ret = QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_INTERNAL_ERROR, NULL);
+        goto out;
+    }
+
+    if (*data == NULL || *len == 0) {
+        /* Another thread read the data since it was peeked */
+        if (*data != NULL)
+            ossl_quic_rstream_release_record(qs->rstream, 0);
+        ret = QUIC_RAISE_NORMAL_ERROR(&ctx, SSL_ERROR_WANT_READ);
+        goto out;
+    }
+
+    qs->rstream_borrowed = 1;
+    ret = 1;
+
+out:
+    qctx_unlock(&ctx);
+    return ret;
+}
+
+QUIC_TAKES_LOCK
+int ossl_quic_read_release(SSL *s, size_t len)
+{
+    QCTX ctx;
+    QUIC_STREAM *qs;
+    QUIC_STREAM_MAP *qsm;
+    OSSL_RTT_INFO rtt_info;
+    size_t avail = 0;
+    int ret = 0, fin = 0;
+
+    if (!expect_quic_cs(s, &ctx))
+        return 0;
+
+    qctx_lock_for_io(&ctx);
+
+    if (ctx.xso == NULL)
+        ctx.xso = ctx.qc->default_xso;
+
+    if (ctx.xso == NULL || ctx.xso->stream == NULL
+            || !ctx.xso->stream->rstream_borrowed) {
+        ret = QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED,
+                                          NULL);
+        goto out;
+    }
+
+    qs = ctx.xso->stream;
+    qsm = ossl_quic_channel_get_qsm(ctx.qc->ch);
+
+    if (!ossl_quic_stream_has_recv_buffer(qs)) {
+        /* The stream was reset while borrowed, the data is of no use now */
+        qs->rstream_borrowed = 0;
+        ossl_quic_rstream_free(qs->rstream);
+        qs->rstream = NULL;
+        ret = 1;
+        goto out;
+    }
+
+    if (!ossl_quic_rstream_release_record(qs->rstream, len)) {
+        ret = QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_PASSED_INVALID_ARGUMENT,
+                                          NULL);
+        goto out;
+    }
+    qs->rstream_borrowed = 0;
+
+    if (len > 0) {
+        /* As for SSL_read(), retire the bytes from stream-level RXFC */
+        ossl_statm_get_rtt_info(ossl_quic_channel_get_statm(ctx.qc->ch),
+                                &rtt_info);
+        if (!ossl_quic_rxfc_on_retire(&qs->rxfc, len, rtt_info.smoothed_rtt)) {
+            ret = QUIC_RAISE_NON_NORMAL_ERROR(&ctx, ERR_R_INTERNAL_ERROR, NULL);
+            goto out;
+        }
+    }
+
+    if (ossl_quic_rstream_available(qs->rstream, &avail, &fin)
+            && avail == 0 && fin)
+        ossl_quic_stream_map_notify_totally_read(qsm, qs);
+
+    if (len > 0) {
+        ossl_quic_stream_map_update_state(qsm, qs);
+        if (quic_mutation_allowed(ctx.qc, /*req_active=*/0))
+            qctx_maybe_autotick(&ctx);
+    }
+    ret = 1;
+
+out:
+    qctx_unlock(&ctx);
+    return ret;
+}
+
 /*
  * SSL_pending
  * -----------
@@ -4285,6 +4467,25 @@ static SSL *alloc_port_user_ssl(QUIC_CHANNEL *ch, void *arg)
  * =================================
  */
 
+/*
+ * Get the port group shared by the worker listeners created from ctx, creating
+ * it if necessary.
+ */
+static QUIC_PORT_GROUP *ctx_get_port_group(SSL_CTX *ctx)
+{
+    QUIC_PORT_GROUP *grp;
+
+    if (!CRYPTO_THREAD_write_lock(ctx->lock))
+        return NULL;
+
+    if (ctx->quic_port_group == NULL)
+        ctx->quic_port_group = ossl_quic_port_group_new(ctx->libctx);
+    grp = ctx->quic_port_group;
+
+    CRYPTO_THREAD_unlock(ctx->lock);
+    return grp;
+}
+
 /*
  * SSL_new_listener
  * ----------------
@@ -4313,7 +4514,9 @@ SSL *ossl_quic_new_listener(SSL_CTX *ctx, uint64_t flags)
     engine_args.mutex   = ql->mutex;
 #endif
 
-    if (need_notifier_for_domain_flags(ctx->domain_flags))
+    /* Workers are woken up by the others when they hand over a packet */
+    if (need_notifier_for_domain_flags(ctx->domain_flags)
+        || (flags & SSL_LISTENER_FLAG_WORKER) != 0)
         engine_args.reactor_flags |= QUIC_REACTOR_FLAG_USE_NOTIFIER;
 
     if ((ql->engine = ossl_quic_engine_new(&engine_args)) == NULL) {
@@ -4327,6 +4530,11 @@ SSL *ossl_quic_new_listener(SSL_CTX *ctx, uint64_t flags)
     port_args.user_ssl_arg = ql;
     if ((flags & SSL_LISTENER_FLAG_NO_VALIDATE) == 0)
         port_args.do_addr_validation = 1;
+    if ((flags & SSL_LISTENER_FLAG_WORKER) != 0
+        && (port_args.group = ctx_get_port_group(ctx)) == NULL) {
+        QUIC_RAISE_NON_NORMAL_ERROR(NULL, ERR_R_INTERNAL_ERROR, NULL);
+        goto err;
+    }
     ql->port = ossl_quic_engine_create_port(ql->engine, &port_args);
     if (ql->port == NULL) {
         QUIC_RAISE_NON_NORMAL_ERROR(NULL, ERR_R_INTERNAL_ERROR, NULL);
@@ -4384,6 +4592,11 @@ SSL *ossl_quic_new_listener_from(SSL *ssl, uint64_t flags)
     port_args.user_ssl_arg = ql;
     if ((flags & SSL_LISTENER_FLAG_NO_VALIDATE) == 0)
         port_args.do_addr_validation = 1;
+    if ((flags & SSL_LISTENER_FLAG_WORKER) != 0
+        && (port_args.group = ctx_get_port_group(ssl->ctx)) == NULL) {
+        QUIC_RAISE_NON_NORMAL_ERROR(NULL, ERR_R_INTERNAL_ERROR, NULL);
+        goto err;
+    }
     ql->port = ossl_quic_engine_create_port(ctx.qd->engine, &port_args);
     if (ql->port == NULL) {
         QUIC_RAISE_NON_NORMAL_ERROR(NULL, ERR_R_INTERNAL_ERROR, NULL);
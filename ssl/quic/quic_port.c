@@ -13,6 +13,7 @@
 #include "internal/quic_srtm.h"
 #include "internal/quic_txp.h"
 #include "internal/ssl_unwrap.h"
+#include "internal/thread_arch.h"
 #include "quic_port_local.h"
 #include "quic_channel_local.h"
 #include "quic_engine_local.h"
@@ -96,6 +97,189 @@ typedef struct validation_token {
 DEFINE_LIST_OF_IMPL(ch, QUIC_CHANNEL);
 DEFINE_LIST_OF_IMPL(incoming_ch, QUIC_CHANNEL);
 DEFINE_LIST_OF_IMPL(port, QUIC_PORT);
+DEFINE_LIST_OF_IMPL(port_fwd, QUIC_PORT_FWD_DGRAM);
+
+/*
+ * Maximum number of datagrams handed over to a worker which have yet to be
+ * processed by it. Any more are dropped.
+ */
+#define PORT_FWD_MAX_DGRAMS     1024
+
+/* Length of the AES-256-GCM key used for validation tokens. */
+#define PORT_TOKEN_KEY_LEN      32
+
+struct quic_port_group_st {
+    /* Protects ports. */
+    CRYPTO_MUTEX    *mutex;
+
+    /* The workers, indexed by the first byte of their LCIDs. */
+    QUIC_PORT       *ports[QUIC_PORT_GROUP_MAX_WORKERS];
+
+    /* Key shared by all workers for validation token encryption. */
+    unsigned char   token_key[PORT_TOKEN_KEY_LEN];
+};
+
+QUIC_PORT_GROUP *ossl_quic_port_group_new(OSSL_LIB_CTX *libctx)
+{
+    QUIC_PORT_GROUP *grp;
+
+    if ((grp = OPENSSL_zalloc(sizeof(*grp))) == NULL)
+        return NULL;
+
+#if defined(OPENSSL_THREADS)
+    if ((grp->mutex = ossl_crypto_mutex_new()) == NULL) {
+        OPENSSL_free(grp);
+        return NULL;
+    }
+#endif
+
+    if (!RAND_priv_bytes_ex(libctx, grp->token_key, sizeof(grp->token_key),
+                            0)) {
+        ossl_quic_port_group_free(grp);
+        return NULL;
+    }
+
+    return grp;
+}
+
+void ossl_quic_port_group_free(QUIC_PORT_GROUP *grp)
+{
+    if (grp == NULL)
+        return;
+
+    ossl_crypto_mutex_free(&grp->mutex);
+    OPENSSL_cleanse(grp->token_key, sizeof(grp->token_key));
+    OPENSSL_free(grp);
+}
+
+static int port_group_join(QUIC_PORT *port)
+{
+    QUIC_PORT_GROUP *grp = port->group;
+    int i;
+
+#if defined(OPENSSL_THREADS)
+    if ((port->fwd_mutex = ossl_crypto_mutex_new()) == NULL)
+        return 0;
+#endif
+    ossl_list_port_fwd_init(&port->fwd_list);
+
+    ossl_crypto_mutex_lock(grp->mutex);
+    for (i = 0; i < QUIC_PORT_GROUP_MAX_WORKERS; i++)
+        if (grp->ports[i] == NULL)
+            break;
+    if (i < QUIC_PORT_GROUP_MAX_WORKERS) {
+        grp->ports[i] = port;
+        port->worker_id = i;
+    }
+    ossl_crypto_mutex_unlock(grp->mutex);
+
+    if (port->worker_id < 0)
+        return 0;
+
+    ossl_quic_lcidm_set_prefix(port->lcidm, port->worker_id);
+    return 1;
+}
+
+static void port_group_leave(QUIC_PORT *port)
+{
+    QUIC_PORT_FWD_DGRAM *dgram, *dnext;
+
+    if (port->worker_id >= 0) {
+        /* After this no other worker can add to our list. */
+        ossl_crypto_mutex_lock(port->group->mutex);
+        port->group->ports[port->worker_id] = NULL;
+        ossl_crypto_mutex_unlock(port->group->mutex);
+        port->worker_id = -1;
+    }
+
+    OSSL_LIST_FOREACH_DELSAFE(dgram, dnext, port_fwd, &port->fwd_list) {
+        ossl_list_port_fwd_remove(&port->fwd_list, dgram);
+        OPENSSL_free(dgram);
+    }
+    ossl_crypto_mutex_free(&port->fwd_mutex);
+}
+
+/*
+ * If a datagram which matches no local connection is addressed to an LCID of
+ * another worker of the port group, hand it over to that worker. Returns 1 if
+ * the datagram was taken care of, in which case the caller releases e.
+ */
+static int port_forward_to_worker(QUIC_PORT *port, QUIC_URXE *e,
+                                  const QUIC_CONN_ID *dcid)
+{
+    const unsigned char *data = ossl_quic_urxe_data(e);
+    QUIC_PORT_FWD_DGRAM *dgram;
+    QUIC_PORT *target;
+
+    if (port->worker_id < 0
+            || dcid->id_len == 0
+            || dcid->id_len != port->rx_short_dcid_len
+            || dcid->id[0] == port->worker_id)
+        return 0;
+
+    /*
+     * Initial and 0-RTT packets may be addressed to a DCID chosen by the
+     * client, which carries no routing information. Only 1-RTT and Handshake
+     * packets are certain to use one of our LCIDs.
+     */
+    if ((data[0] & 0x80) != 0 && ((data[0] >> 4) & 0x3) != 2)
+        return 0;
+
+    if ((dgram = OPENSSL_malloc(sizeof(*dgram) + e->data_len)) == NULL)
+        return 0;
+
+    ossl_list_port_fwd_init_elem(dgram);
+    dgram->peer     = e->peer;
+    dgram->local    = e->local;
+    dgram->data_len = e->data_len;
+    memcpy(dgram + 1, data, e->data_len);
+
+    ossl_crypto_mutex_lock(port->group->mutex);
+    target = port->group->ports[dcid->id[0]];
+    if (target != NULL) {
+        ossl_crypto_mutex_lock(target->fwd_mutex);
+        if (ossl_list_port_fwd_num(&target->fwd_list) < PORT_FWD_MAX_DGRAMS) {
+            ossl_list_port_fwd_insert_tail(&target->fwd_list, dgram);
+            dgram = NULL;
+        }
+        ossl_crypto_mutex_unlock(target->fwd_mutex);
+
+        /* Don't leave the datagram waiting for the target's next event */
+        if (dgram == NULL)
+            ossl_quic_reactor_wake(ossl_quic_port_get0_reactor(target));
+    }
+    ossl_crypto_mutex_unlock(port->group->mutex);
+
+    if (target == NULL) {
+        /* No such worker, handle it as an unknown packet */
+        OPENSSL_free(dgram);
+        return 0;
+    }
+
+    /* If the target's queue was full, the datagram is dropped */
+    OPENSSL_free(dgram);
+    return 1;
+}
+
+/* Feed the datagrams handed over by other workers into our demuxer. */
+static void port_rx_forwarded(QUIC_PORT *port)
+{
+    OSSL_LIST(port_fwd) list;
+    QUIC_PORT_FWD_DGRAM *dgram, *dnext;
+
+    ossl_crypto_mutex_lock(port->fwd_mutex);
+    list = port->fwd_list;
+    ossl_list_port_fwd_init(&port->fwd_list);
+    ossl_crypto_mutex_unlock(port->fwd_mutex);
+
+    OSSL_LIST_FOREACH_DELSAFE(dgram, dnext, port_fwd, &list) {
+        ossl_list_port_fwd_remove(&list, dgram);
+        ossl_quic_demux_inject(port->demux,
+                               (const unsigned char *)(dgram + 1),
+                               dgram->data_len, &dgram->peer, &dgram->local);
+        OPENSSL_free(dgram);
+    }
+}
 
 QUIC_PORT *ossl_quic_port_new(const QUIC_PORT_ARGS *args)
 {
@@ -110,6 +294,8 @@ QUIC_PORT *ossl_quic_port_new(const QUIC_PORT_ARGS *args)
     port->validate_addr = args->do_addr_validation;
     port->get_conn_user_ssl = args->get_conn_user_ssl;
     port->user_ssl_arg = args->user_ssl_arg;
+    port->group         = args->group;
+    port->worker_id     = -1;
 
     if (!port_init(port)) {
         OPENSSL_free(port);
@@ -159,6 +345,11 @@ static int port_init(QUIC_PORT *port)
                                            rx_short_dcid_len)) == NULL)
         goto err;
 
+    /* Workers identify themselves by the first byte of their LCIDs. */
+    if (port->group != NULL
+        && (rx_short_dcid_len == 0 || !port_group_join(port)))
+        goto err;
+
     port->rx_short_dcid_len = (unsigned char)rx_short_dcid_len;
     port->tx_init_dcid_len  = INIT_DCID_LEN;
     port->state             = QUIC_PORT_STATE_RUNNING;
@@ -167,15 +358,26 @@ static int port_init(QUIC_PORT *port)
     port->on_engine_list    = 1;
     port->bio_changed       = 1;
 
-    /* Generate random key for token encryption */
+    /*
+     * Generate random key for token encryption, or use the one shared by
+     * the port group
+     */
     if ((port->token_ctx = EVP_CIPHER_CTX_new()) == NULL
         || (cipher = EVP_CIPHER_fetch(port->engine->libctx,
                                       "AES-256-GCM", NULL)) == NULL
         || !EVP_EncryptInit_ex(port->token_ctx, cipher, NULL, NULL, NULL)
         || (key_len = EVP_CIPHER_CTX_get_key_length(port->token_ctx)) <= 0
-        || (token_key = OPENSSL_malloc(key_len)) == NULL
-        || !RAND_priv_bytes_ex(port->engine->libctx, token_key, key_len, 0)
-        || !EVP_EncryptInit_ex(port->token_ctx, NULL, NULL, token_key, NULL))
+        || (token_key = OPENSSL_malloc(key_len)) == NULL)
+        goto err;
+    if (port->group != NULL) {
+        if (key_len != PORT_TOKEN_KEY_LEN)
+            goto err;
+        memcpy(token_key, port->group->token_key, key_len);
+    } else if (!RAND_priv_bytes_ex(port->engine->libctx, token_key, key_len,
+                                   0)) {
+        goto err;
+    }
+    if (!EVP_EncryptInit_ex(port->token_ctx, NULL, NULL, token_key, NULL))
         goto err;
 
     ret = 1;
@@ -200,6 +402,9 @@ static void port_cleanup(QUIC_PORT *port)
     ossl_quic_srtm_free(port->srtm);
     port->srtm = NULL;
 
+    if (port->group != NULL)
+        port_group_leave(port);
+
     ossl_quic_lcidm_free(port->lcidm);
     port->lcidm = NULL;
 
@@ -258,6 +463,11 @@ static OSSL_TIME get_time(void *port)
     return ossl_quic_port_get_time((QUIC_PORT *)port);
 }
 
+int ossl_quic_port_get_worker_id(const QUIC_PORT *port)
+{
+    return port->worker_id;
+}
+
 int ossl_quic_port_get_rx_short_dcid_len(const QUIC_PORT *port)
 {
     return port->rx_short_dcid_len;
@@ -711,6 +921,11 @@ static void port_rx_pre(QUIC_PORT *port)
      * to the appropriate QRX instances.
      */
     ret = ossl_quic_demux_pump(port->demux);
+
+    /* Process datagrams handed over by other workers after our own. */
+    if (ret != QUIC_DEMUX_PUMP_RES_PERMANENT_FAIL && port->worker_id >= 0)
+        port_rx_forwarded(port);
+
     if (ret == QUIC_DEMUX_PUMP_RES_PERMANENT_FAIL)
         /*
          * We don't care about transient failure, but permanent failure means we
@@ -1506,6 +1721,9 @@ static void port_default_packet_handler(QUIC_URXE *e, void *arg,
         return;
     }
 
+    if (dcid != NULL && port_forward_to_worker(port, e, dcid))
+        goto undesirable;
+
     /*
      * If we have an incoming packet which doesn't match any existing connection
      * we assume this is an attempt to make a new connection.
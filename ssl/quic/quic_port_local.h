@@ -28,6 +28,17 @@
 DECLARE_LIST_OF(ch, QUIC_CHANNEL);
 DECLARE_LIST_OF(incoming_ch, QUIC_CHANNEL);
 
+/* A datagram handed over to this port by another worker of its port group. */
+typedef struct quic_port_fwd_dgram_st QUIC_PORT_FWD_DGRAM;
+struct quic_port_fwd_dgram_st {
+    OSSL_LIST_MEMBER(port_fwd, QUIC_PORT_FWD_DGRAM);
+    BIO_ADDR    peer, local;
+    size_t      data_len;
+    /* followed by data_len bytes of datagram data */
+};
+
+DECLARE_LIST_OF(port_fwd, QUIC_PORT_FWD_DGRAM);
+
 /* A port is always in one of the following states: */
 enum {
     /* Initial and steady state. */
@@ -116,6 +127,18 @@ struct quic_port_st {
 
     /* AES-256 GCM context for token encryption */
     EVP_CIPHER_CTX *token_ctx;
+
+    /* Port group this port is a worker of, and its index in it. */
+    QUIC_PORT_GROUP                 *group;
+    int                             worker_id;
+
+    /*
+     * Datagrams handed over by other workers of the port group, which are
+     * processed on the next tick. Protected by fwd_mutex, as they are added
+     * by threads which do not hold the engine mutex of this port.
+     */
+    CRYPTO_MUTEX                    *fwd_mutex;
+    OSSL_LIST(port_fwd)             fwd_list;
 };
 
 # endif
@@ -48,9 +48,17 @@ int ossl_quic_reactor_init(QUIC_REACTOR *rtor,
             return 0;
         }
 
+        if ((rtor->wake_mutex = ossl_crypto_mutex_new()) == NULL) {
+            ossl_crypto_condvar_free(&rtor->notifier_cv);
+            ossl_rio_notifier_cleanup(&rtor->notifier);
+            return 0;
+        }
+        rtor->woken_notifier = 0;
+
         rtor->have_notifier = 1;
     } else {
         rtor->have_notifier = 0;
+        rtor->wake_mutex = NULL;
     }
 
     return 1;
@@ -66,6 +74,7 @@ void ossl_quic_reactor_cleanup(QUIC_REACTOR *rtor)
         rtor->have_notifier = 0;
 
         ossl_crypto_condvar_free(&rtor->notifier_cv);
+        ossl_crypto_mutex_free(&rtor->wake_mutex);
     }
 }
 
@@ -571,9 +580,31 @@ void ossl_quic_reactor_leave_blocking_section(QUIC_REACTOR *rtor)
     assert(rtor->cur_blocking_waiters > 0);
     --rtor->cur_blocking_waiters;
 
-    if (rtor->have_notifier && rtor->signalled_notifier) {
+    if (!rtor->have_notifier)
+        return;
+
+    /*
+     * A wakeup by ossl_quic_reactor_wake() is handled like one by
+     * rtor_notify_other_threads() from here on.
+     */
+    ossl_crypto_mutex_lock(rtor->wake_mutex);
+    if (rtor->woken_notifier) {
+        rtor->woken_notifier = 0;
+        rtor->signalled_notifier = 1;
+    }
+    ossl_crypto_mutex_unlock(rtor->wake_mutex);
+
+    if (rtor->signalled_notifier) {
         if (rtor->cur_blocking_waiters == 0) {
+            /*
+             * This also takes back any wakeup by ossl_quic_reactor_wake()
+             * since the above. The caller ticks next, which processes what
+             * was queued before it.
+             */
+            ossl_crypto_mutex_lock(rtor->wake_mutex);
             ossl_rio_notifier_unsignal(&rtor->notifier);
+            rtor->woken_notifier = 0;
+            ossl_crypto_mutex_unlock(rtor->wake_mutex);
             rtor->signalled_notifier = 0;
 
             /*
@@ -588,3 +619,17 @@ void ossl_quic_reactor_leave_blocking_section(QUIC_REACTOR *rtor)
         }
     }
 }
+
+void ossl_quic_reactor_wake(QUIC_REACTOR *rtor)
+{
+    /* have_notifier may only be read under the engine mutex */
+    if (rtor->wake_mutex == NULL)
+        return;
+
+    ossl_crypto_mutex_lock(rtor->wake_mutex);
+    if (!rtor->woken_notifier) {
+        ossl_rio_notifier_signal(&rtor->notifier);
+        rtor->woken_notifier = 1;
+    }
+    ossl_crypto_mutex_unlock(rtor->wake_mutex);
+}
@@ -931,7 +931,8 @@ static void txe_to_msg(TXE *txe, BIO_MSG *msg)
         = BIO_ADDR_family(&txe->local) != AF_UNSPEC ? &txe->local : NULL;
 }
 
-#define MAX_MSGS_PER_SEND   32
+/* One full GSO train, see BIO_dgram_set_segmentation() */
+#define MAX_MSGS_PER_SEND   64
 
 int ossl_qtx_flush_net(OSSL_QTX *qtx)
 {
@@ -615,9 +615,11 @@ int ossl_quic_stream_map_notify_reset_recv_part(QUIC_STREAM_MAP *qsm,
         /* RFC 9000 s. 3.3: No point sending STOP_SENDING if already reset. */
         qs->want_stop_sending       = 0;
 
-        /* QUIC_RSTREAM is no longer needed */
-        ossl_quic_rstream_free(qs->rstream);
-        qs->rstream = NULL;
+        /* QUIC_RSTREAM is no longer needed, unless its data is borrowed */
+        if (!qs->rstream_borrowed) {
+            ossl_quic_rstream_free(qs->rstream);
+            qs->rstream = NULL;
+        }
 
         ossl_quic_stream_map_update_state(qsm, qs);
         return 1;
@@ -68,6 +68,7 @@ struct ossl_quic_tx_packetiser_st {
     OSSL_TIME       last_tx_time;               /* Last time a packet was generated, or 0. */
 
     size_t          unvalidated_credit;         /* Limit of data we can send until validated */
+    OSSL_TIME       pacing_next;                /* Earliest time to send the next in-flight packet. */
 
     /* Internal state - frame (re)generation flags. */
     unsigned int    want_handshake_done     : 1;
@@ -452,6 +453,9 @@ static int txp_pkt_commit(OSSL_QUIC_TX_PACKETISER *txp, struct txp_pkt *pkt,
                           uint32_t archetype, int *txpim_pkt_reffed);
 static uint32_t txp_determine_archetype(OSSL_QUIC_TX_PACKETISER *txp,
                                         uint64_t cc_limit);
+static int txp_is_paced(OSSL_QUIC_TX_PACKETISER *txp, OSSL_TIME now);
+static void txp_pacing_on_sent(OSSL_QUIC_TX_PACKETISER *txp,
+                               uint64_t num_bytes);
 
 /**
  * Sets the validated state of a QUIC TX packetiser.
@@ -560,6 +564,7 @@ OSSL_QUIC_TX_PACKETISER *ossl_quic_tx_packetiser_new(const OSSL_QUIC_TX_PACKETIS
 
     txp->args           = *args;
     txp->last_tx_time   = ossl_time_zero();
+    txp->pacing_next    = ossl_time_zero();
 
     if (!ossl_quic_fifd_init(&txp->fifd,
                              txp->args.cfq, txp->args.ackm, txp->args.txpim,
@@ -718,6 +723,14 @@ void ossl_quic_tx_packetiser_set_ack_tx_cb(OSSL_QUIC_TX_PACKETISER *txp,
     txp->ack_tx_cb_arg  = cb_arg;
 }
 
+void ossl_quic_tx_packetiser_set_cc(OSSL_QUIC_TX_PACKETISER *txp,
+                                    const OSSL_CC_METHOD *cc_method,
+                                    OSSL_CC_DATA *cc_data)
+{
+    txp->args.cc_method = cc_method;
+    txp->args.cc_data   = cc_data;
+}
+
 void ossl_quic_tx_packetiser_set_qlog_cb(OSSL_QUIC_TX_PACKETISER *txp,
                                          QLOG *(*get_qlog_cb)(void *arg),
                                          void *get_qlog_cb_arg)
@@ -865,6 +878,13 @@ int ossl_quic_tx_packetiser_generate(OSSL_QUIC_TX_PACKETISER *txp,
 
     memset(status, 0, sizeof(*status));
 
+    /*
+     * Until the pacer lets the next in-flight packet go we can only send the
+     * packets which bypass CC, just as if we were out of CC budget.
+     */
+    if (cc_limit > 0 && txp_is_paced(txp, txp->args.now(txp->args.now_arg)))
+        cc_limit = 0;
+
     for (enc_level = QUIC_ENC_LEVEL_INITIAL;
          enc_level < QUIC_ENC_LEVEL_NUM;
          ++enc_level)
@@ -3099,6 +3119,9 @@ static int txp_pkt_commit(OSSL_QUIC_TX_PACKETISER *txp,
     }
 
     /* We have now sent the packet, so update state accordingly. */
+    if (tpkt->ackm_pkt.is_inflight)
+        txp_pacing_on_sent(txp, tpkt->ackm_pkt.num_bytes);
+
     if (tpkt->ackm_pkt.is_ack_eliciting)
         txp->force_ack_eliciting &= ~(1UL << pn_space);
 
@@ -3222,6 +3245,58 @@ QUIC_PN ossl_quic_tx_packetiser_get_next_pn(OSSL_QUIC_TX_PACKETISER *txp,
     return txp->next_pn[pn_space];
 }
 
+/*
+ * Pacing
+ * ======
+ *
+ * Rather than sending in-flight packets as soon as the congestion window
+ * allows, which sends a whole window in one burst, we space them out at the
+ * pacing rate given by the congestion controller. pacing_next is the earliest
+ * time at which the next in-flight packet may be sent, and every in-flight
+ * packet sent moves it on by the time the packet takes to send at the pacing
+ * rate. It is also reported as the TXP deadline, so that the channel is ticked
+ * again when the next packet may go.
+ *
+ * Sending time left unused while there is nothing to send is saved up, but
+ * only enough of it to send TXP_PACING_BURST datagrams back to back, or
+ * TXP_PACING_BURST_TIME worth of data if that is more. This is the burst of
+ * up to an initial window that RFC 9002 s. 7.7 allows, and at high rates it
+ * avoids having to wake up for every single packet.
+ */
+#define TXP_PACING_BURST        10
+#define TXP_PACING_BURST_TIME   ossl_ms2time(1)
+
+/* Returns the time it takes to send num_bytes at rate bytes per second. */
+static OSSL_TIME txp_pacing_time(uint64_t num_bytes, uint64_t rate)
+{
+    return ossl_time_muldiv(ossl_seconds2time(1), num_bytes, rate);
+}
+
+static int txp_is_paced(OSSL_QUIC_TX_PACKETISER *txp, OSSL_TIME now)
+{
+    return txp->args.cc_method->get_pacing_rate(txp->args.cc_data) > 0
+        && ossl_time_compare(now, txp->pacing_next) < 0;
+}
+
+static void txp_pacing_on_sent(OSSL_QUIC_TX_PACKETISER *txp,
+                               uint64_t num_bytes)
+{
+    uint64_t rate = txp->args.cc_method->get_pacing_rate(txp->args.cc_data);
+    OSSL_TIME now, burst;
+
+    if (rate == 0)
+        return;
+
+    now     = txp->args.now(txp->args.now_arg);
+    burst   = txp_pacing_time((TXP_PACING_BURST - 1) * txp_get_mdpl(txp), rate);
+    burst   = ossl_time_max(burst, TXP_PACING_BURST_TIME);
+
+    txp->pacing_next = ossl_time_max(txp->pacing_next,
+                                     ossl_time_subtract(now, burst));
+    txp->pacing_next = ossl_time_add(txp->pacing_next,
+                                     txp_pacing_time(num_bytes, rate));
+}
+
 OSSL_TIME ossl_quic_tx_packetiser_get_deadline(OSSL_QUIC_TX_PACKETISER *txp)
 {
     /*
@@ -3251,6 +3326,9 @@ OSSL_TIME ossl_quic_tx_packetiser_get_deadline(OSSL_QUIC_TX_PACKETISER *txp)
     if (txp->args.cc_method->get_tx_allowance(txp->args.cc_data) == 0)
         deadline = ossl_time_min(deadline,
                                  txp->args.cc_method->get_wakeup_deadline(txp->args.cc_data));
+    else if (txp_is_paced(txp, txp->args.now(txp->args.now_arg)))
+        /* When will the pacer let the next packet go? */
+        deadline = ossl_time_min(deadline, txp->pacing_next);
 
     return deadline;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright 2018-2024 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2018-2025 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -297,42 +297,56 @@ static int ktls_set_crypto_state(OSSL_RECORD_LAYER *rl, int level,
                                  COMP_METHOD *comp)
 {
     ktls_crypto_info_t crypto_info;
+    /*
+     * After a TLSv1.3 KeyUpdate the socket is already offloaded and only gets
+     * new keys, which Linux supports from 6.14. The kernel has taken over the
+     * record sequence by then so there is no going back to user space crypto,
+     * and a failure is fatal rather than a reason to try another method.
+     */
+    int rekey = rl->direction == OSSL_RECORD_DIRECTION_WRITE
+                ? BIO_get_ktls_send(rl->bio) : BIO_get_ktls_recv(rl->bio);
 
     /*
      * Check if we are suitable for KTLS. If not suitable we return
      * OSSL_RECORD_RETURN_NON_FATAL_ERR so that other record layers can be tried
-     * instead
+     * instead, unless this is a rekey.
      */
 
     if (comp != NULL)
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        goto unsuitable;
 
     /* ktls supports only the maximum fragment size */
     if (rl->max_frag_len != SSL3_RT_MAX_PLAIN_LENGTH)
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        goto unsuitable;
 
     /* check that cipher is supported */
     if (!ktls_int_check_supported_cipher(rl, ciph, md, taglen))
-        return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        goto unsuitable;
 
     /* All future data will get encrypted by ktls. Flush the BIO or skip ktls */
     if (rl->direction == OSSL_RECORD_DIRECTION_WRITE) {
         if (BIO_flush(rl->bio) <= 0)
-            return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+            goto unsuitable;
 
         /* KTLS does not support record padding */
         if (rl->padding != NULL || rl->block_padding > 0)
-            return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+            goto unsuitable;
     }
 
     if (!ktls_configure_crypto(rl->libctx, rl->version, ciph, md, rl->sequence,
                                &crypto_info,
                                rl->direction == OSSL_RECORD_DIRECTION_WRITE,
                                iv, ivlen, key, keylen, mackey, mackeylen))
-       return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+        goto unsuitable;
 
-    if (!BIO_set_ktls(rl->bio, &crypto_info, rl->direction))
+    if (!BIO_set_ktls(rl->bio, &crypto_info, rl->direction)) {
+        if (rekey) {
+            ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(),
+                           "kTLS rekey failed");
+            return OSSL_RECORD_RETURN_FATAL;
+        }
         return OSSL_RECORD_RETURN_NON_FATAL_ERR;
+    }
 
     if (rl->direction == OSSL_RECORD_DIRECTION_WRITE &&
         (rl->options & SSL_OP_ENABLE_KTLS_TX_ZEROCOPY_SENDFILE) != 0)
@@ -343,6 +357,14 @@ static int ktls_set_crypto_state(OSSL_RECORD_LAYER *rl, int level,
         BIO_set_ktls_tx_zerocopy_sendfile(rl->bio);
 
     return OSSL_RECORD_RETURN_SUCCESS;
+
+ unsuitable:
+    if (rekey) {
+        ERR_raise_data(ERR_LIB_SSL, ERR_R_INTERNAL_ERROR,
+                       "kTLS rekey not possible with the new keys");
+        return OSSL_RECORD_RETURN_FATAL;
+    }
+    return OSSL_RECORD_RETURN_NON_FATAL_ERR;
 }
 
 static int ktls_read_n(OSSL_RECORD_LAYER *rl, size_t n, size_t max, int extend,
@@ -324,6 +324,17 @@ struct ossl_record_layer_st {
     size_t block_padding;
     size_t hs_padding;
 
+    /*
+     * Dynamic record sizing: the size of application data records until
+     * dyn_record_ramp bytes have been sent since the connection was last idle
+     * for dyn_record_idle, or 0 if disabled
+     */
+    size_t dyn_record_size;
+    size_t dyn_record_ramp;
+    OSSL_TIME dyn_record_idle;
+    size_t dyn_record_sent;
+    OSSL_TIME dyn_record_last;
+
     /* Only used by SSLv3 */
     unsigned char mac_secret[EVP_MAX_MD_SIZE];
 
@@ -478,6 +489,7 @@ int tls_write_records_multiblock(OSSL_RECORD_LAYER *rl,
                                  OSSL_RECORD_TEMPLATE *templates,
                                  size_t numtempl);
 
+int tls_dyn_record_limit(OSSL_RECORD_LAYER *rl, uint8_t type, size_t *preffrag);
 size_t tls_get_max_records_default(OSSL_RECORD_LAYER *rl, uint8_t type,
                                    size_t len,
                                    size_t maxfrag, size_t *preffrag);
@@ -1227,6 +1227,29 @@ int tls_set_options(OSSL_RECORD_LAYER *rl, const OSSL_PARAM *options)
             ERR_raise(ERR_LIB_SSL, SSL_R_FAILED_TO_GET_PARAMETER);
             return 0;
         }
+        p = OSSL_PARAM_locate_const(options,
+                                    OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_SIZE);
+        if (p != NULL && !OSSL_PARAM_get_size_t(p, &rl->dyn_record_size)) {
+            ERR_raise(ERR_LIB_SSL, SSL_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        p = OSSL_PARAM_locate_const(options,
+                                    OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_RAMP);
+        if (p != NULL && !OSSL_PARAM_get_size_t(p, &rl->dyn_record_ramp)) {
+            ERR_raise(ERR_LIB_SSL, SSL_R_FAILED_TO_GET_PARAMETER);
+            return 0;
+        }
+        p = OSSL_PARAM_locate_const(options,
+                                    OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_IDLE);
+        if (p != NULL) {
+            uint32_t idle_ms;
+
+            if (!OSSL_PARAM_get_uint32(p, &idle_ms)) {
+                ERR_raise(ERR_LIB_SSL, SSL_R_FAILED_TO_GET_PARAMETER);
+                return 0;
+            }
+            rl->dyn_record_idle = ossl_ms2time(idle_ms);
+        }
     }
 
     if (rl->level == OSSL_RECORD_PROTECTION_LEVEL_APPLICATION) {
@@ -1513,10 +1536,40 @@ size_t tls_app_data_pending(OSSL_RECORD_LAYER *rl)
     return num;
 }
 
+/*
+ * Dynamic record sizing. After the connection has been idle, application data
+ * is sent in small records, sized to fit in a single TCP segment, so that the
+ * peer can decrypt the first bytes as soon as they arrive rather than having
+ * to wait for a full 16KB record to get through slow start. Once
+ * |dyn_record_ramp| bytes have been sent full sized records are used again
+ * for throughput. Returns 1 if |*preffrag| was lowered.
+ */
+int tls_dyn_record_limit(OSSL_RECORD_LAYER *rl, uint8_t type, size_t *preffrag)
+{
+    if (rl->dyn_record_size == 0 || type != SSL3_RT_APPLICATION_DATA)
+        return 0;
+
+    if (rl->dyn_record_sent > 0
+            && !ossl_time_is_zero(rl->dyn_record_idle)
+            && ossl_time_compare(ossl_time_subtract(ossl_time_now(),
+                                                    rl->dyn_record_last),
+                                 rl->dyn_record_idle) > 0)
+        rl->dyn_record_sent = 0;
+
+    if (rl->dyn_record_sent >= rl->dyn_record_ramp
+            || *preffrag <= rl->dyn_record_size)
+        return 0;
+
+    *preffrag = rl->dyn_record_size;
+    return 1;
+}
+
 size_t tls_get_max_records_default(OSSL_RECORD_LAYER *rl, uint8_t type,
                                    size_t len,
                                    size_t maxfrag, size_t *preffrag)
 {
+    tls_dyn_record_limit(rl, type, preffrag);
+
     /*
      * If we have a pipeline capable cipher, and we have been configured to use
      * it, then return the preferred number of pipelines.
@@ -1898,6 +1951,15 @@ int tls_write_records(OSSL_RECORD_LAYER *rl, OSSL_RECORD_TEMPLATE *templates,
         return OSSL_RECORD_RETURN_FATAL;
     }
 
+    if (rl->dyn_record_size > 0) {
+        size_t i;
+
+        for (i = 0; i < numtempl; i++)
+            if (templates[i].type == SSL3_RT_APPLICATION_DATA)
+                rl->dyn_record_sent += templates[i].buflen;
+        rl->dyn_record_last = ossl_time_now();
+    }
+
     rl->nextwbuf = 0;
     /* we now just need to write the buffers */
     return tls_retry_write_records(rl);
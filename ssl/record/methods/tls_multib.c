@@ -42,6 +42,10 @@ size_t tls_get_max_records_multiblock(OSSL_RECORD_LAYER *rl, uint8_t type,
                                       size_t len, size_t maxfrag,
                                       size_t *preffrag)
 {
+    /* Small records are better sent one at a time */
+    if (tls_dyn_record_limit(rl, type, preffrag))
+        return tls_get_max_records_default(rl, type, len, maxfrag, preffrag);
+
     if (tls_is_multiblock_capable(rl, type, len, *preffrag)) {
         /* minimize address aliasing conflicts */
         if ((*preffrag & 0xfff) == 0)
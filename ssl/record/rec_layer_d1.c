@@ -216,6 +216,12 @@ int dtls1_read_bytes(SSL *s, uint8_t type, uint8_t *recvd_type,
         return -1;
     }
 
+    /* The current record must not change until SSL_read_release() */
+    if (sc->rlayer.borrowed) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED);
+        return -1;
+    }
+
     if (!ossl_statem_get_in_handshake(sc) && SSL_in_init(s)) {
         /* type == SSL3_RT_APPLICATION_DATA */
         i = sc->handshake_func(s);
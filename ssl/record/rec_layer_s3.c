@@ -49,6 +49,8 @@ int RECORD_LAYER_clear(RECORD_LAYER *rl)
     rl->alert_count = 0;
     rl->num_recs = 0;
     rl->curr_rec = 0;
+    rl->borrowed = 0;
+    memset(rl->ktls_stats, 0, sizeof(rl->ktls_stats));
 
     BIO_free(rl->rrlnext);
     rl->rrlnext = NULL;
@@ -70,6 +72,25 @@ int RECORD_LAYER_clear(RECORD_LAYER *rl)
     return ret;
 }
 
+/*
+ * Accounts for |numrecs| records holding |bytes| bytes that were sent or
+ * received through the kernel, see SSL_get_ktls_stats()
+ */
+void ossl_ktls_add_stats(SSL_CONNECTION *s, int direction, size_t numrecs,
+                         size_t bytes)
+{
+#ifndef OPENSSL_NO_KTLS
+    const OSSL_RECORD_METHOD *meth = direction == OSSL_RECORD_DIRECTION_READ
+                                     ? s->rlayer.rrlmethod
+                                     : s->rlayer.wrlmethod;
+
+    if (meth != &ossl_ktls_record_method)
+        return;
+    s->rlayer.ktls_stats[direction].records += numrecs;
+    s->rlayer.ktls_stats[direction].bytes += bytes;
+#endif
+}
+
 int RECORD_LAYER_reset(RECORD_LAYER *rl)
 {
     int ret;
@@ -409,7 +430,10 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
         /*
         * Ask the record layer how it would like to split the amount of data
         * that we have, and how many of those records it would like in one go.
+        * The answer may change from one round to the next, e.g. with dynamic
+        * record sizing.
         */
+        split_send_fragment = ssl_get_split_send_fragment(s);
         maxpipes = s->rlayer.wrlmethod->get_max_records(s->rlayer.wrl, type, n,
                                                         max_send_fragment,
                                                         &split_send_fragment);
@@ -468,6 +492,10 @@ int ssl3_write_bytes(SSL *ssl, uint8_t type, const void *buf_, size_t len,
 
         i = HANDLE_RLAYER_WRITE_RETURN(s,
             s->rlayer.wrlmethod->write_records(s->rlayer.wrl, tmpls, maxpipes));
+        /* On a retry the records are sent later, they are counted now */
+        if (i > 0 || s->rwstate == SSL_WRITING)
+            ossl_ktls_add_stats(s, OSSL_RECORD_DIRECTION_WRITE, maxpipes,
+                                s->rlayer.wpend_tot);
         if (i <= 0) {
             /* SSLfatal() already called if appropriate */
             s->rlayer.wnum = tot;
@@ -638,6 +666,12 @@ int ssl3_read_bytes(SSL *ssl, uint8_t type, uint8_t *recvd_type,
         return -1;
     }
 
+    /* The current record must not change until SSL_read_release() */
+    if (s->rlayer.borrowed) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED);
+        return -1;
+    }
+
     if ((type == SSL3_RT_HANDSHAKE) && (s->rlayer.handshake_fragment_len > 0))
         /* (partially) satisfy request from storage */
     {
@@ -703,6 +737,7 @@ int ssl3_read_bytes(SSL *ssl, uint8_t type, uint8_t *recvd_type,
                 /* SSLfatal() already called if appropriate */
                 return ret;
             }
+            ossl_ktls_add_stats(s, OSSL_RECORD_DIRECTION_READ, 1, rr->length);
             rr->off = 0;
             s->rlayer.num_recs++;
         } while (s->rlayer.rrlmethod->processed_read_pending(s->rlayer.rrl)
@@ -1248,7 +1283,7 @@ int ssl_set_new_record_layer(SSL_CONNECTION *s, int version,
                              int mactype, const EVP_MD *md,
                              const SSL_COMP *comp, const EVP_MD *kdfdigest)
 {
-    OSSL_PARAM options[5], *opts = options;
+    OSSL_PARAM options[8], *opts = options;
     OSSL_PARAM settings[6], *set =  settings;
     const OSSL_RECORD_METHOD **thismethod;
     OSSL_RECORD_LAYER **thisrl, *newrl = NULL;
@@ -1298,6 +1333,12 @@ int ssl_set_new_record_layer(SSL_CONNECTION *s, int version,
                                               &s->rlayer.block_padding);
         *opts++ = OSSL_PARAM_construct_size_t(OSSL_LIBSSL_RECORD_LAYER_PARAM_HS_PADDING,
                                               &s->rlayer.hs_padding);
+        *opts++ = OSSL_PARAM_construct_size_t(OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_SIZE,
+                                              &s->rlayer.dyn_record_size);
+        *opts++ = OSSL_PARAM_construct_size_t(OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_RAMP,
+                                              &s->rlayer.dyn_record_ramp);
+        *opts++ = OSSL_PARAM_construct_uint32(OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_IDLE,
+                                              &s->rlayer.dyn_record_idle);
     }
     *opts = OSSL_PARAM_construct_end();
 
@@ -1470,6 +1511,12 @@ int ssl_set_new_record_layer(SSL_CONNECTION *s, int version,
         }
     }
 
+#ifndef OPENSSL_NO_KTLS
+    /* A TLSv1.3 KeyUpdate that kept the kernel offload */
+    if (meth == &ossl_ktls_record_method && *thismethod == meth)
+        s->rlayer.ktls_stats[direction].rekeys++;
+#endif
+
     *thisrl = newrl;
     *thismethod = meth;
 
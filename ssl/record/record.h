@@ -115,10 +115,24 @@ typedef struct record_layer_st {
     size_t block_padding;
     size_t hs_padding;
 
+    /* Dynamic record sizing, see SSL_set_dynamic_record_sizing() */
+    size_t dyn_record_size;
+    size_t dyn_record_ramp;
+    uint32_t dyn_record_idle;
+
+    /* kTLS statistics, indexed by OSSL_RECORD_DIRECTION_* */
+    struct {
+        uint64_t records;
+        uint64_t bytes;
+        uint64_t rekeys;
+    } ktls_stats[2];
+
     /* How many records we have read from the record layer */
     size_t num_recs;
     /* The next record from the record layer that we need to process */
     size_t curr_rec;
+    /* Set while tlsrecs[curr_rec] is lent out by SSL_read_borrow() */
+    int borrowed;
     /* Record layer data to be processed */
     TLS_RECORD tlsrecs[SSL_MAX_PIPELINES];
 
@@ -140,6 +154,8 @@ int RECORD_LAYER_reset(RECORD_LAYER *rl);
 int RECORD_LAYER_read_pending(const RECORD_LAYER *rl);
 int RECORD_LAYER_processed_read_pending(const RECORD_LAYER *rl);
 int RECORD_LAYER_write_pending(const RECORD_LAYER *rl);
+void ossl_ktls_add_stats(SSL_CONNECTION *s, int direction, size_t numrecs,
+                         size_t bytes);
 int RECORD_LAYER_is_sslv2_record(RECORD_LAYER *rl);
 __owur size_t ssl3_pending(const SSL *s);
 __owur int ssl3_write_bytes(SSL *s, uint8_t type, const void *buf, size_t len,
@@ -128,6 +128,8 @@ int ssl3_dispatch_alert(SSL *s)
 
     i = HANDLE_RLAYER_WRITE_RETURN(sc,
             sc->rlayer.wrlmethod->write_records(sc->rlayer.wrl, &templ, 1));
+    if (i > 0 || sc->rwstate == SSL_WRITING)
+        ossl_ktls_add_stats(sc, OSSL_RECORD_DIRECTION_WRITE, 1, templ.buflen);
 
     if (i <= 0) {
         sc->s3.alert_dispatch = SSL_ALERT_DISPATCH_RETRY;
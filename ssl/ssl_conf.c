@@ -705,6 +705,58 @@ out:
     return rv;
 }
 
+/*
+ * |value| input is "<number[,number[,number]]>"
+ * where the first number is the size of the records sent after an idle
+ * period, the optional second the number of bytes after which full sized
+ * records are used, and the optional third the idle timeout in milliseconds
+ */
+static int cmd_DynamicRecordSizing(SSL_CONF_CTX *cctx, const char *value)
+{
+    int rv = 0;
+    unsigned long vals[3] = { 0, 1024 * 1024, 1000 };
+    char *copy = NULL, *p, *commap;
+    char *endptr = NULL;
+    size_t i;
+
+    copy = OPENSSL_strdup(value);
+    if (copy == NULL)
+        goto out;
+    for (i = 0, p = copy; i < OSSL_NELEM(vals); i++, p = commap + 1) {
+        commap = strchr(p, ',');
+        if (commap != NULL)
+            *commap = '\0';
+        if (!OPENSSL_strtoul(p, &endptr, 0, &vals[i]) || *endptr != '\0')
+            goto out;
+        if (commap == NULL)
+            break;
+    }
+    if (commap != NULL || vals[2] > UINT32_MAX)
+        goto out;
+
+    if (cctx->ctx)
+        rv = SSL_CTX_set_dynamic_record_sizing(cctx->ctx, (size_t)vals[0],
+                                               (size_t)vals[1],
+                                               (uint32_t)vals[2]);
+    if (cctx->ssl)
+        rv = SSL_set_dynamic_record_sizing(cctx->ssl, (size_t)vals[0],
+                                           (size_t)vals[1], (uint32_t)vals[2]);
+out:
+    OPENSSL_free(copy);
+    return rv;
+}
+
+static int cmd_QUICCongestionControl(SSL_CONF_CTX *cctx, const char *value)
+{
+    int rv = 1;
+
+    /* Ignored by TLS and DTLS so that one configuration can serve both */
+    if (cctx->ctx != NULL && IS_QUIC_CTX(cctx->ctx))
+        rv = SSL_CTX_set_quic_congestion_control(cctx->ctx, value);
+    if (cctx->ssl != NULL && IS_QUIC(cctx->ssl))
+        rv = SSL_set_quic_congestion_control(cctx->ssl, value);
+    return rv;
+}
 
 static int cmd_NumTickets(SSL_CONF_CTX *cctx, const char *value)
 {
@@ -823,6 +875,8 @@ static const ssl_conf_cmd_tbl ssl_conf_cmds[] = {
                  SSL_CONF_FLAG_SERVER | SSL_CONF_FLAG_CERTIFICATE,
                  SSL_CONF_TYPE_FILE),
     SSL_CONF_CMD_STRING(RecordPadding, "record_padding", 0),
+    SSL_CONF_CMD_STRING(DynamicRecordSizing, "dynamic_record_sizing", 0),
+    SSL_CONF_CMD_STRING(QUICCongestionControl, NULL, 0),
     SSL_CONF_CMD_STRING(NumTickets, "num_tickets", SSL_CONF_FLAG_SERVER),
 };
 
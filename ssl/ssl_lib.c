@@ -37,6 +37,12 @@
 # include <sys/stat.h>
 # include <fcntl.h>
 #endif
+#ifdef OPENSSL_SYS_UNIX
+# include <sys/types.h>
+# include <unistd.h>
+#endif
+
+static void ssl_sendfile_release(SSL_CONNECTION *sc);
 
 static int ssl_undefined_function_3(SSL_CONNECTION *sc, unsigned char *r,
                                     unsigned char *s, size_t t, size_t *u)
@@ -579,6 +585,7 @@ int SSL_clear(SSL *s)
         return 0;
     }
 
+    s->writev_done = 0;
     return s->method->ssl_reset(s);
 }
 
@@ -619,6 +626,7 @@ int ossl_ssl_connection_reset(SSL *s)
     BUF_MEM_free(sc->init_buf);
     sc->init_buf = NULL;
     sc->first_packet = 0;
+    ssl_sendfile_release(sc);
 
     sc->key_update = SSL_KEY_UPDATE_NONE;
     memset(sc->ext.compress_certificate_from_peer, 0,
@@ -801,6 +809,9 @@ SSL *ossl_ssl_connection_new_int(SSL_CTX *ctx, SSL *user_ssl,
     s->rlayer.record_padding_arg = ctx->record_padding_arg;
     s->rlayer.block_padding = ctx->block_padding;
     s->rlayer.hs_padding = ctx->hs_padding;
+    s->rlayer.dyn_record_size = ctx->dyn_record_size;
+    s->rlayer.dyn_record_ramp = ctx->dyn_record_ramp;
+    s->rlayer.dyn_record_idle = ctx->dyn_record_idle;
     s->sid_ctx_length = ctx->sid_ctx_length;
     if (!ossl_assert(s->sid_ctx_length <= sizeof(s->sid_ctx)))
         goto err;
@@ -1097,6 +1108,7 @@ int SSL_has_matching_session_id(const SSL *ssl, const unsigned char *id,
      * by this SSL.
      */
     SSL_SESSION r, *p;
+    SSL_SESS_CACHE_SHARD *shard;
     const SSL_CONNECTION *sc = SSL_CONNECTION_FROM_CONST_SSL(ssl);
 
     if (sc == NULL || id_len > sizeof(r.session_id))
@@ -1106,10 +1118,11 @@ int SSL_has_matching_session_id(const SSL *ssl, const unsigned char *id,
     r.session_id_length = id_len;
     memcpy(r.session_id, id, id_len);
 
-    if (!CRYPTO_THREAD_read_lock(sc->session_ctx->lock))
+    shard = ssl_sess_cache_get_shard(sc->session_ctx, &r);
+    if (!CRYPTO_THREAD_read_lock(shard->lock))
         return 0;
-    p = lh_SSL_SESSION_retrieve(sc->session_ctx->sessions, &r);
-    CRYPTO_THREAD_unlock(sc->session_ctx->lock);
+    p = lh_SSL_SESSION_retrieve(shard->sessions, &r);
+    CRYPTO_THREAD_unlock(shard->lock);
     return (p != NULL);
 }
 
@@ -1446,6 +1459,7 @@ void SSL_free(SSL *s)
     SSL_CTX_free(s->ctx);
     CRYPTO_THREAD_lock_free(s->lock);
     CRYPTO_FREE_REF(&s->references);
+    OPENSSL_free(s->writev_buf);
 
     OPENSSL_free(s);
 }
@@ -1470,6 +1484,7 @@ void ossl_ssl_connection_free(SSL *ssl)
     dane_final(&s->dane);
 
     BUF_MEM_free(s->init_buf);
+    ssl_sendfile_release(s);
 
     /* add extra stuff */
     sk_SSL_CIPHER_free(s->cipher_list);
@@ -2555,6 +2570,72 @@ int SSL_peek_ex(SSL *s, void *buf, size_t num, size_t *readbytes)
     return ret;
 }
 
+int SSL_read_borrow(SSL *s, const unsigned char **data, size_t *len)
+{
+    SSL_CONNECTION *sc;
+    TLS_RECORD *rr;
+    unsigned char c;
+    size_t readbytes;
+
+#ifndef OPENSSL_NO_QUIC
+    if (IS_QUIC(s))
+        return ossl_quic_read_borrow(s, data, len);
+#endif
+
+    if ((sc = SSL_CONNECTION_FROM_SSL_ONLY(s)) == NULL)
+        return 0;
+
+    /*
+     * Peeking a byte processes records until the current one holds
+     * application data, which is then lent out in place.
+     */
+    if (!SSL_peek_ex(s, &c, 1, &readbytes))
+        return 0;
+
+    rr = &sc->rlayer.tlsrecs[sc->rlayer.curr_rec];
+    if (!ossl_assert(sc->rlayer.curr_rec < sc->rlayer.num_recs
+                     && rr->type == SSL3_RT_APPLICATION_DATA
+                     && rr->length > 0)) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+
+    sc->rlayer.borrowed = 1;
+    *data = rr->data + rr->off;
+    *len = rr->length;
+    return 1;
+}
+
+int SSL_read_release(SSL *s, size_t len)
+{
+    SSL_CONNECTION *sc;
+    TLS_RECORD *rr;
+
+#ifndef OPENSSL_NO_QUIC
+    if (IS_QUIC(s))
+        return ossl_quic_read_release(s, len);
+#endif
+
+    if ((sc = SSL_CONNECTION_FROM_SSL_ONLY(s)) == NULL)
+        return 0;
+
+    if (!sc->rlayer.borrowed) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED);
+        return 0;
+    }
+
+    rr = &sc->rlayer.tlsrecs[sc->rlayer.curr_rec];
+    if (len > rr->length) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+
+    sc->rlayer.borrowed = 0;
+    if (len == 0)
+        return 1;
+    return ssl_release_record(sc, rr, len);
+}
+
 int ssl_write_internal(SSL *s, const void *buf, size_t num,
                        uint64_t flags, size_t *written)
 {
@@ -2612,6 +2693,105 @@ int ssl_write_internal(SSL *s, const void *buf, size_t num,
     }
 }
 
+static void ssl_sendfile_release(SSL_CONNECTION *sc)
+{
+    OPENSSL_free(sc->sendfile.buf);
+    memset(&sc->sendfile, 0, sizeof(sc->sendfile));
+}
+
+#ifdef OPENSSL_SYS_UNIX
+/* The most SSL_sendfile() writes in one call when kTLS is not in use */
+# define SSL_SENDFILE_MAX_CHUNK  (1024 * 1024)
+
+/* Forget the data of a finished write, but keep the buffer for the next one */
+static void ssl_sendfile_done(SSL_CONNECTION *sc)
+{
+    sc->sendfile.data = NULL;
+    sc->sendfile.len = 0;
+}
+
+/*
+ * Read the file range into the buffer of the connection, which is only
+ * reallocated to grow.  The file is not mapped into memory, as a concurrent
+ * truncation would then fault.  A short read is sent as it is, the next call
+ * then reads 0 bytes if it was caused by the end of the file.
+ * Returns 1 on success, 0 at the end of the file or -1 on error.
+ */
+static int ssl_sendfile_load(SSL_CONNECTION *sc, int fd, off_t offset,
+                             size_t size)
+{
+    ossl_ssize_t n;
+
+    if (sc->sendfile.buflen < size) {
+        OPENSSL_free(sc->sendfile.buf);
+        sc->sendfile.buflen = 0;
+        if ((sc->sendfile.buf = OPENSSL_malloc(size)) == NULL)
+            return -1;
+        sc->sendfile.buflen = size;
+    }
+    do {
+        n = pread(fd, sc->sendfile.buf, size, offset);
+    } while (n < 0 && get_last_sys_error() == EINTR);
+    if (n <= 0) {
+        if (n < 0)
+            ERR_raise_data(ERR_LIB_SYS, get_last_sys_error(),
+                           "pread failure");
+        return (int)n;
+    }
+    sc->sendfile.data = sc->sendfile.buf;
+    sc->sendfile.len = (size_t)n;
+    return 1;
+}
+
+/*
+ * SSL_sendfile() without kTLS: the file data is read and written through the
+ * record layer like any other application data.
+ */
+static ossl_ssize_t ssl_sendfile_fallback(SSL *s, SSL_CONNECTION *sc, int fd,
+                                          off_t offset, size_t size)
+{
+    size_t maxsize = SSL_SENDFILE_MAX_CHUNK;
+    size_t written;
+    int ret;
+
+    if (size == 0)
+        return 0;
+
+    if (SSL_CONNECTION_IS_DTLS(sc))
+        maxsize = ssl_get_max_send_fragment(sc);
+    if (size > maxsize)
+        size = maxsize;
+
+    /*
+     * A retry after SSL_ERROR_WANT_WRITE must pass the same buffer, so the
+     * data of an unfinished write is reused if the caller asks for it again.
+     */
+    if (sc->sendfile.data == NULL || sc->sendfile.fd != fd
+            || sc->sendfile.offset != offset) {
+        ssl_sendfile_done(sc);
+        ret = ssl_sendfile_load(sc, fd, offset, size);
+        if (ret <= 0)
+            return ret;
+        sc->sendfile.fd = fd;
+        sc->sendfile.offset = offset;
+    }
+
+    if (ssl_write_internal(s, sc->sendfile.data, sc->sendfile.len, 0,
+                           &written) <= 0)
+        return -1;
+
+    if (written < sc->sendfile.len) {
+        /* A partial write with SSL_MODE_ENABLE_PARTIAL_WRITE */
+        sc->sendfile.data += written;
+        sc->sendfile.len -= written;
+        sc->sendfile.offset += written;
+    } else {
+        ssl_sendfile_done(sc);
+    }
+    return (ossl_ssize_t)written;
+}
+#endif
+
 ossl_ssize_t SSL_sendfile(SSL *s, int fd, off_t offset, size_t size, int flags)
 {
     ossl_ssize_t ret;
@@ -2632,8 +2812,12 @@ ossl_ssize_t SSL_sendfile(SSL *s, int fd, off_t offset, size_t size, int flags)
     }
 
     if (!BIO_get_ktls_send(sc->wbio)) {
+#ifdef OPENSSL_SYS_UNIX
+        return ssl_sendfile_fallback(s, sc, fd, offset, size);
+#else
         ERR_raise(ERR_LIB_SSL, SSL_R_UNINITIALIZED);
         return -1;
+#endif
     }
 
     /* If we have an alert to send, lets send it */
@@ -2676,6 +2860,10 @@ ossl_ssize_t SSL_sendfile(SSL *s, int fd, off_t offset, size_t size, int flags)
                            "ktls_sendfile failure");
         return ret;
     }
+    /* The kernel fills the records up to the maximum size */
+    ossl_ktls_add_stats(sc, OSSL_RECORD_DIRECTION_WRITE,
+                        (ret + SSL3_RT_MAX_PLAIN_LENGTH - 1)
+                        / SSL3_RT_MAX_PLAIN_LENGTH, ret);
     sc->rwstate = SSL_NOTHING;
     return ret;
 #endif
@@ -2718,6 +2906,107 @@ int SSL_write_ex2(SSL *s, const void *buf, size_t num, uint64_t flags,
     return ret;
 }
 
+int SSL_writev_ex(SSL *s, const SSL_IOVEC *iov, size_t iovcnt,
+                  size_t *written)
+{
+    SSL_CONNECTION *sc = NULL;
+    const unsigned char *p;
+    size_t i, j, off, joff, total = 0, start, done, rem, frag, n, c, w;
+    int partial;
+
+    for (i = 0; i < iovcnt; i++) {
+        if (iov[i].len > SIZE_MAX - total) {
+            ERR_raise(ERR_LIB_SSL, SSL_R_BAD_LENGTH);
+            return 0;
+        }
+        total += iov[i].len;
+    }
+
+    if (total == 0)
+        return SSL_write_ex(s, "", 0, written);
+
+    if (!IS_QUIC(s) && (sc = SSL_CONNECTION_FROM_SSL_ONLY(s)) == NULL)
+        return 0;
+    partial = sc != NULL && (sc->mode & SSL_MODE_ENABLE_PARTIAL_WRITE) != 0;
+
+    /*
+     * Skip what was written before a retry, as SSL_write_ex() does.  A call
+     * for another amount of data is a new write rather than a retry.
+     */
+    if (total != s->writev_total)
+        s->writev_done = 0;
+    start = done = s->writev_done;
+    s->writev_done = 0;
+    for (i = 0, off = done; off >= iov[i].len; i++)
+        off -= iov[i].len;
+
+    while (done < total) {
+        if (off == iov[i].len) {
+            i++;
+            off = 0;
+            continue;
+        }
+        rem = iov[i].len - off;
+        p = (const unsigned char *)iov[i].base + off;
+
+        /*
+         * QUIC streams have no records, elements are handed over whole.  For
+         * TLS and DTLS as many full records as possible are written straight
+         * from the element, and a record that would span the end of the
+         * element is gathered from the following ones so that records are
+         * never shorter than they need to be.
+         */
+        frag = sc == NULL ? rem : ssl_get_max_send_fragment(sc);
+        if (rem >= frag) {
+            n = rem - rem % frag;
+        } else {
+            if (s->writev_buf == NULL
+                    && (s->writev_buf =
+                        OPENSSL_malloc(SSL3_RT_MAX_PLAIN_LENGTH)) == NULL)
+                return 0;
+            if (frag > SSL3_RT_MAX_PLAIN_LENGTH)
+                frag = SSL3_RT_MAX_PLAIN_LENGTH;
+            for (n = 0, j = i, joff = off; n < frag && j < iovcnt;) {
+                c = iov[j].len - joff;
+                if (c > frag - n)
+                    c = frag - n;
+                if (c > 0)
+                    memcpy(s->writev_buf + n,
+                           (const unsigned char *)iov[j].base + joff, c);
+                n += c;
+                joff += c;
+                if (joff == iov[j].len) {
+                    j++;
+                    joff = 0;
+                }
+            }
+            p = s->writev_buf;
+        }
+
+        if (ssl_write_internal(s, p, n, 0, &w) <= 0) {
+            /* With partial writes what was written so far is reported */
+            if (partial && done > start)
+                break;
+            /* Only a write that can be retried resumes where this one stops */
+            if (SSL_want(s) != SSL_NOTHING) {
+                s->writev_done = done;
+                s->writev_total = total;
+            }
+            return 0;
+        }
+
+        done += w;
+        for (c = w; c > 0 && c >= iov[i].len - off; i++, off = 0)
+            c -= iov[i].len - off;
+        off += c;
+        if (partial && w < n)
+            break;
+    }
+
+    *written = done;
+    return 1;
+}
+
 int SSL_write_early_data(SSL *s, const void *buf, size_t num, size_t *written)
 {
     int ret, early_data_state;
@@ -3111,7 +3400,10 @@ long SSL_callback_ctrl(SSL *s, int cmd, void (*fp) (void))
 
 LHASH_OF(SSL_SESSION) *SSL_CTX_sessions(SSL_CTX *ctx)
 {
-    return ctx->sessions;
+    /* A sharded cache has no single hash table to return */
+    if (ctx->num_sess_shards != 1)
+        return NULL;
+    return ctx->sess_shards[0].sessions;
 }
 
 static int ssl_tsan_load(SSL_CTX *ctx, TSAN_QUALIFIER int *stat)
@@ -3173,13 +3465,18 @@ long SSL_CTX_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
         return (long)ctx->session_cache_size;
     case SSL_CTRL_SET_SESS_CACHE_MODE:
         l = ctx->session_cache_mode;
-        ctx->session_cache_mode = larg;
+        if (((l ^ larg) & SSL_SESS_CACHE_SHARDED) != 0
+            && !ssl_sess_cache_set_sharded(ctx,
+                                           (larg & SSL_SESS_CACHE_SHARDED) != 0))
+            larg = (larg & ~SSL_SESS_CACHE_SHARDED)
+                   | (l & SSL_SESS_CACHE_SHARDED);
+        ctx->session_cache_mode = (uint32_t)larg;
         return l;
     case SSL_CTRL_GET_SESS_CACHE_MODE:
         return ctx->session_cache_mode;
 
     case SSL_CTRL_SESS_NUMBER:
-        return lh_SSL_SESSION_num_items(ctx->sessions);
+        return (long)ssl_sess_cache_num_items(ctx);
     case SSL_CTRL_SESS_CONNECT:
         return ssl_tsan_load(ctx, &ctx->stats.sess_connect);
     case SSL_CTRL_SESS_CONNECT_GOOD:
@@ -3883,7 +4180,7 @@ int SSL_export_keying_material_early(SSL *s, unsigned char *out, size_t olen,
                                               context, contextlen);
 }
 
-static unsigned long ssl_session_hash(const SSL_SESSION *a)
+unsigned long ssl_session_hash(const SSL_SESSION *a)
 {
     const unsigned char *session_id = a->session_id;
     unsigned long l;
@@ -3910,7 +4207,7 @@ static unsigned long ssl_session_hash(const SSL_SESSION *a)
  * being able to construct an SSL_SESSION that will collide with any existing
  * session with a matching session ID.
  */
-static int ssl_session_cmp(const SSL_SESSION *a, const SSL_SESSION *b)
+int ssl_session_cmp(const SSL_SESSION *a, const SSL_SESSION *b)
 {
     if (a->ssl_version != b->ssl_version)
         return 1;
@@ -4089,8 +4386,7 @@ SSL_CTX *SSL_CTX_new_ex(OSSL_LIB_CTX *libctx, const char *propq,
     ret->max_cert_list = SSL_MAX_CERT_LIST_DEFAULT;
     ret->verify_mode = SSL_VERIFY_NONE;
 
-    ret->sessions = lh_SSL_SESSION_new(ssl_session_hash, ssl_session_cmp);
-    if (ret->sessions == NULL) {
+    if (!ssl_sess_cache_set_sharded(ret, 0)) {
         ERR_raise(ERR_LIB_SSL, ERR_R_CRYPTO_LIB);
         goto err;
     }
@@ -4177,9 +4473,6 @@ SSL_CTX *SSL_CTX_new_ex(OSSL_LIB_CTX *libctx, const char *propq,
         goto err;
     }
 
-    if ((ret->ext.secure = OPENSSL_secure_zalloc(sizeof(*ret->ext.secure))) == NULL)
-        goto err;
-
     /* No compression for DTLS */
     if (!(meth->ssl3_enc->enc_flags & SSL_ENC_FLAG_DTLS))
         ret->comp_methods = SSL_COMP_get_compression_methods();
@@ -4188,13 +4481,8 @@ SSL_CTX *SSL_CTX_new_ex(OSSL_LIB_CTX *libctx, const char *propq,
     ret->split_send_fragment = SSL3_RT_MAX_PLAIN_LENGTH;
 
     /* Setup RFC5077 ticket keys */
-    if ((RAND_bytes_ex(libctx, ret->ext.tick_key_name,
-                       sizeof(ret->ext.tick_key_name), 0) <= 0)
-        || (RAND_priv_bytes_ex(libctx, ret->ext.secure->tick_hmac_key,
-                               sizeof(ret->ext.secure->tick_hmac_key), 0) <= 0)
-        || (RAND_priv_bytes_ex(libctx, ret->ext.secure->tick_aes_key,
-                               sizeof(ret->ext.secure->tick_aes_key), 0) <= 0))
-        ret->options |= SSL_OP_NO_TICKET;
+    if (!ssl_ticket_keys_init(ret))
+        goto err;
 
     if (RAND_priv_bytes_ex(libctx, ret->ext.cookie_hmac_key,
                            sizeof(ret->ext.cookie_hmac_key), 0) <= 0) {
@@ -4414,11 +4702,12 @@ void SSL_CTX_free(SSL_CTX *a)
      * free ex_data, then finally free the cache.
      * (See ticket [openssl.org #212].)
      */
-    if (a->sessions != NULL)
+    if (a->sess_shards != NULL)
         SSL_CTX_flush_sessions_ex(a, 0);
 
     CRYPTO_free_ex_data(CRYPTO_EX_INDEX_SSL_CTX, a, &a->ex_data);
-    lh_SSL_SESSION_free(a->sessions);
+    ssl_sess_cache_free(a);
+    ssl_shm_sess_cache_free(a->shm_sess_cache);
     X509_STORE_free(a->cert_store);
 #ifndef OPENSSL_NO_CT
     CTLOG_STORE_free(a->ctlog_store);
@@ -4446,7 +4735,7 @@ void SSL_CTX_free(SSL_CTX *a)
     OPENSSL_free(a->ext.keyshares);
     OPENSSL_free(a->ext.tuples);
     OPENSSL_free(a->ext.alpn);
-    OPENSSL_secure_free(a->ext.secure);
+    ssl_ticket_keys_free(a);
 
     ssl_evp_md_free(a->md5);
     ssl_evp_md_free(a->sha1);
@@ -4494,6 +4783,7 @@ void SSL_CTX_free(SSL_CTX *a)
 
 #ifndef OPENSSL_NO_QUIC
     ossl_quic_free_token_store(a->tokencache);
+    ossl_quic_port_group_free(a->quic_port_group);
 #endif
 
     OPENSSL_free(a);
@@ -6068,6 +6358,84 @@ int SSL_set_block_padding(SSL *ssl, size_t block_size)
     return SSL_set_block_padding_ex(ssl, block_size, block_size);
 }
 
+int SSL_get_ktls_state(const SSL *s)
+{
+    int state = 0;
+#ifndef OPENSSL_NO_KTLS
+    const SSL_CONNECTION *sc = SSL_CONNECTION_FROM_CONST_SSL_ONLY(s);
+
+    if (sc == NULL)
+        return 0;
+    if (sc->rlayer.wrlmethod == &ossl_ktls_record_method)
+        state |= SSL_KTLS_TX;
+    if (sc->rlayer.rrlmethod == &ossl_ktls_record_method)
+        state |= SSL_KTLS_RX;
+#endif
+    return state;
+}
+
+int SSL_get_ktls_stats(const SSL *s, int direction, uint64_t *records,
+                       uint64_t *bytes, uint64_t *rekeys)
+{
+    const SSL_CONNECTION *sc = SSL_CONNECTION_FROM_CONST_SSL_ONLY(s);
+    int dir;
+
+    if (sc == NULL)
+        return 0;
+    if (direction == SSL_KTLS_TX)
+        dir = OSSL_RECORD_DIRECTION_WRITE;
+    else if (direction == SSL_KTLS_RX)
+        dir = OSSL_RECORD_DIRECTION_READ;
+    else
+        return 0;
+
+    if (records != NULL)
+        *records = sc->rlayer.ktls_stats[dir].records;
+    if (bytes != NULL)
+        *bytes = sc->rlayer.ktls_stats[dir].bytes;
+    if (rekeys != NULL)
+        *rekeys = sc->rlayer.ktls_stats[dir].rekeys;
+    return 1;
+}
+
+int SSL_CTX_set_dynamic_record_sizing(SSL_CTX *ctx, size_t initial_size,
+                                      size_t ramp_bytes, uint32_t idle_ms)
+{
+    if (IS_QUIC_CTX(ctx) || initial_size > SSL3_RT_MAX_PLAIN_LENGTH)
+        return 0;
+
+    ctx->dyn_record_size = initial_size;
+    ctx->dyn_record_ramp = ramp_bytes;
+    ctx->dyn_record_idle = idle_ms;
+    return 1;
+}
+
+int SSL_set_dynamic_record_sizing(SSL *ssl, size_t initial_size,
+                                  size_t ramp_bytes, uint32_t idle_ms)
+{
+    SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL_ONLY(ssl);
+    OSSL_PARAM options[4], *opts = options;
+
+    if (sc == NULL || initial_size > SSL3_RT_MAX_PLAIN_LENGTH)
+        return 0;
+
+    sc->rlayer.dyn_record_size = initial_size;
+    sc->rlayer.dyn_record_ramp = ramp_bytes;
+    sc->rlayer.dyn_record_idle = idle_ms;
+
+    *opts++ = OSSL_PARAM_construct_size_t(OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_SIZE,
+                                          &sc->rlayer.dyn_record_size);
+    *opts++ = OSSL_PARAM_construct_size_t(OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_RAMP,
+                                          &sc->rlayer.dyn_record_ramp);
+    *opts++ = OSSL_PARAM_construct_uint32(OSSL_LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_IDLE,
+                                          &sc->rlayer.dyn_record_idle);
+    *opts = OSSL_PARAM_construct_end();
+
+    /* Also applies to a connection that is already established */
+    return sc->rlayer.wrlmethod == NULL
+           || sc->rlayer.wrlmethod->set_options(sc->rlayer.wrl, options);
+}
+
 int SSL_set_num_tickets(SSL *s, size_t num_tickets)
 {
     SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL(s);
@@ -8187,6 +8555,50 @@ int SSL_CTX_set_domain_flags(SSL_CTX *ctx, uint64_t domain_flags)
     return 0;
 }
 
+int SSL_CTX_set_quic_congestion_control(SSL_CTX *ctx, const char *name)
+{
+#ifndef OPENSSL_NO_QUIC
+    const OSSL_CC_METHOD *method;
+
+    if (IS_QUIC_CTX(ctx)) {
+        if ((method = ossl_cc_method_from_name(name)) == NULL) {
+            ERR_raise_data(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT,
+                           "unknown congestion controller");
+            return 0;
+        }
+
+        ctx->quic_cc_method = method;
+        return 1;
+    }
+#endif
+
+    ERR_raise_data(ERR_LIB_SSL, ERR_R_UNSUPPORTED,
+                   "congestion control unsupported on this kind of SSL_CTX");
+    return 0;
+}
+
+int SSL_set_quic_congestion_control(SSL *s, const char *name)
+{
+#ifndef OPENSSL_NO_QUIC
+    if (IS_QUIC(s))
+        return ossl_quic_set_congestion_control(s, name);
+#endif
+
+    ERR_raise_data(ERR_LIB_SSL, ERR_R_UNSUPPORTED,
+                   "congestion control unsupported on this kind of SSL");
+    return 0;
+}
+
+const char *SSL_get0_quic_congestion_control(const SSL *s)
+{
+#ifndef OPENSSL_NO_QUIC
+    if (IS_QUIC(s))
+        return ossl_quic_get0_congestion_control(s);
+#endif
+
+    return NULL;
+}
+
 int SSL_CTX_get_domain_flags(const SSL_CTX *ctx, uint64_t *domain_flags)
 {
 #ifndef OPENSSL_NO_QUIC
@@ -554,11 +554,13 @@ struct ssl_session_st {
     unsigned char *ticket_appdata;
     size_t ticket_appdata_len;
     uint32_t flags;
-    SSL_CTX *owner;
+    /* The session cache shard this session is cached in, if any */
+    struct ssl_sess_cache_shard_st *owner;
 
     /*
      * These are used to make removal of session-ids more efficient and to
-     * implement a maximum cache size. Access requires protection of ctx->lock.
+     * implement a maximum cache size. Access requires protection of the
+     * owner's lock.
      */
     struct ssl_session_st *prev, *next;
     CRYPTO_REF_COUNT references;
@@ -701,10 +703,22 @@ DEFINE_LHASH_OF_EX(X509_NAME);
 # define TLSEXT_KEYNAME_LENGTH  16
 # define TLSEXT_TICK_KEY_LENGTH 32
 
-typedef struct ssl_ctx_ext_secure_st {
-    unsigned char tick_hmac_key[TLSEXT_TICK_KEY_LENGTH];
-    unsigned char tick_aes_key[TLSEXT_TICK_KEY_LENGTH];
-} SSL_CTX_EXT_SECURE;
+typedef struct ssl_ticket_key_st {
+    unsigned char name[TLSEXT_KEYNAME_LENGTH];
+    unsigned char hmac_key[TLSEXT_TICK_KEY_LENGTH];
+    unsigned char aes_key[TLSEXT_TICK_KEY_LENGTH];
+    /* Keyed once and copied for each ticket, NULL if unavailable */
+    EVP_CIPHER_CTX *enc_tmpl;
+    EVP_CIPHER_CTX *dec_tmpl;
+    EVP_MAC_CTX *mac_tmpl;
+} SSL_TICKET_KEY;
+
+/* Immutable once published, see ssl_ticket_keys.c */
+typedef struct ssl_ticket_keyring_st {
+    size_t num;
+    /* In secure memory, keys[0] encrypts new tickets */
+    SSL_TICKET_KEY *keys;
+} SSL_TICKET_KEYRING;
 
 /*
  * Helper function for HMAC
@@ -721,6 +735,7 @@ typedef struct ssl_hmac_st {
 } SSL_HMAC;
 
 SSL_HMAC *ssl_hmac_new(const SSL_CTX *ctx);
+SSL_HMAC *ssl_hmac_dup_EVP_MAC_CTX(const EVP_MAC_CTX *src);
 void ssl_hmac_free(SSL_HMAC *ctx);
 # ifndef OPENSSL_NO_DEPRECATED_3_0
 HMAC_CTX *ssl_hmac_get0_HMAC_CTX(SSL_HMAC *ctx);
@@ -792,6 +807,27 @@ typedef struct {
 #  define OPENSSL_CLIENT_MAX_KEY_SHARES 4
 # endif
 
+/*
+ * One partition of the internal session cache: a hash of the cached sessions
+ * and a list of them sorted by timeout.  Without SSL_SESS_CACHE_SHARDED there
+ * is a single shard protected by the SSL_CTX lock.  With it there are
+ * SSL_SESS_CACHE_NUM_SHARDS shards, each with its own lock, and a session
+ * lives in the shard selected by the hash of its session ID, so that lookups
+ * and insertions for different sessions rarely contend.
+ */
+# define SSL_SESS_CACHE_NUM_SHARDS  64
+
+/* Cross-process cache set up by SSL_CTX_set_shared_session_cache() */
+typedef struct ssl_shm_sess_cache_st SSL_SHM_SESS_CACHE;
+
+typedef struct ssl_sess_cache_shard_st {
+    CRYPTO_RWLOCK *lock;
+    int own_lock;
+    LHASH_OF(SSL_SESSION) *sessions;
+    struct ssl_session_st *head;
+    struct ssl_session_st *tail;
+} SSL_SESS_CACHE_SHARD;
+
 struct ssl_ctx_st {
     OSSL_LIB_CTX *libctx;
 
@@ -802,14 +838,14 @@ struct ssl_ctx_st {
     /* TLSv1.3 specific ciphersuites */
     STACK_OF(SSL_CIPHER) *tls13_ciphersuites;
     struct x509_store_st /* X509_STORE */ *cert_store;
-    LHASH_OF(SSL_SESSION) *sessions;
+    /* The internal session cache, see SSL_SESS_CACHE_SHARD */
+    SSL_SESS_CACHE_SHARD *sess_shards;
+    size_t num_sess_shards;
     /*
      * Most session-ids that will be cached, default is
      * SSL_SESSION_CACHE_MAX_SIZE_DEFAULT. 0 is unlimited.
      */
     size_t session_cache_size;
-    struct ssl_session_st *session_cache_head;
-    struct ssl_session_st *session_cache_tail;
     /*
      * This can have one of 2 values, ored together, SSL_SESS_CACHE_CLIENT,
      * SSL_SESS_CACHE_SERVER, Default is SSL_SESSION_CACHE_SERVER, which
@@ -836,6 +872,8 @@ struct ssl_ctx_st {
     SSL_SESSION *(*get_session_cb) (struct ssl_st *ssl,
                                     const unsigned char *data, int len,
                                     int *copy);
+    /* Shared memory cache behind the callbacks above, if in use */
+    SSL_SHM_SESS_CACHE *shm_sess_cache;
     struct {
         TSAN_QUALIFIER int sess_connect;       /* SSL new conn - started */
         TSAN_QUALIFIER int sess_connect_renegotiate; /* SSL reneg - requested */
@@ -995,9 +1033,15 @@ struct ssl_ctx_st {
         /* TLS extensions servername callback */
         int (*servername_cb) (SSL *, int *, void *);
         void *servername_arg;
-        /* RFC 4507 session ticket keys */
-        unsigned char tick_key_name[TLSEXT_KEYNAME_LENGTH];
-        SSL_CTX_EXT_SECURE *secure;
+        /*
+         * RFC 4507 session ticket keys.  The current keyring is the one in
+         * slot (tick_keyring_gen & 1), tick_keyring_readers count the
+         * threads using each slot and tick_keyring_lock serialises updates.
+         */
+        SSL_TICKET_KEYRING *tick_keyring[2];
+        uint64_t tick_keyring_gen;
+        int tick_keyring_readers[2];
+        CRYPTO_RWLOCK *tick_keyring_lock;
 # ifndef OPENSSL_NO_DEPRECATED_3_0
         /* Callback to support customisation of ticket key setting */
         int (*ticket_key_cb) (SSL *ssl,
@@ -1137,6 +1181,11 @@ struct ssl_ctx_st {
     size_t block_padding;
     size_t hs_padding;
 
+    /* Dynamic record sizing, see SSL_CTX_set_dynamic_record_sizing() */
+    size_t dyn_record_size;
+    size_t dyn_record_ramp;
+    uint32_t dyn_record_idle;
+
     /* Session ticket appdata */
     SSL_CTX_generate_session_ticket_fn generate_ticket_cb;
     SSL_CTX_decrypt_session_ticket_fn decrypt_ticket_cb;
@@ -1198,6 +1247,10 @@ struct ssl_ctx_st {
 # ifndef OPENSSL_NO_QUIC
     uint64_t domain_flags;
     SSL_TOKEN_STORE *tokencache;
+    /* Shared by the worker listeners created from this SSL_CTX */
+    QUIC_PORT_GROUP *quic_port_group;
+    /* Congestion controller for new QUIC connections, NULL for the default */
+    const OSSL_CC_METHOD *quic_cc_method;
 # endif
 
 # ifndef OPENSSL_NO_QLOG
@@ -1239,6 +1292,12 @@ struct ssl_st {
     CRYPTO_RWLOCK *lock;
     /* extra application data */
     CRYPTO_EX_DATA ex_data;
+    /* Bytes written by an SSL_writev_ex() call that is to be retried */
+    size_t writev_done;
+    /* Total length of the SSL_writev_ex() call that is to be retried */
+    size_t writev_total;
+    /* Gathers the records of SSL_writev_ex() that span several elements */
+    unsigned char *writev_buf;
 };
 
 struct ssl_connection_st {
@@ -1803,6 +1862,21 @@ struct ssl_connection_st {
     /* Record layer data */
     RECORD_LAYER rlayer;
 
+    /*
+     * File data that SSL_sendfile() is writing when kTLS is not in use. It
+     * is kept until the write completes so that a retry passes the same
+     * buffer to the record layer. The buffer itself is reused by later calls
+     * and only freed with the connection.
+     */
+    struct {
+        unsigned char *buf;
+        size_t buflen;
+        int fd;
+        off_t offset;
+        const unsigned char *data;
+        size_t len;
+    } sendfile;
+
     /* Default password callback. */
     pem_password_cb *default_passwd_callback;
     /* Default password callback user data. */
@@ -2548,6 +2622,30 @@ __owur int ssl_get_new_session(SSL_CONNECTION *s, int session);
 __owur SSL_SESSION *lookup_sess_in_cache(SSL_CONNECTION *s,
                                          const unsigned char *sess_id,
                                          size_t sess_id_len);
+unsigned long ssl_session_hash(const SSL_SESSION *a);
+int ssl_session_cmp(const SSL_SESSION *a, const SSL_SESSION *b);
+__owur int ssl_sess_cache_set_sharded(SSL_CTX *ctx, int sharded);
+void ssl_sess_cache_free(SSL_CTX *ctx);
+void ssl_shm_sess_cache_remove(SSL_CTX *ctx, SSL_SESSION *sess);
+void ssl_shm_sess_cache_free(SSL_SHM_SESS_CACHE *cache);
+
+__owur int ssl_ticket_keys_init(SSL_CTX *ctx);
+void ssl_ticket_keys_free(SSL_CTX *ctx);
+__owur int ssl_ticket_keys_set(SSL_CTX *ctx, const unsigned char *keys,
+                               size_t len);
+long ssl_ticket_keys_get(SSL_CTX *ctx, unsigned char *keys, size_t len);
+__owur int ssl_ticket_key_encrypt_init(SSL_CTX *tctx, EVP_CIPHER_CTX *ctx,
+                                       SSL_HMAC **hctx,
+                                       unsigned char *key_name,
+                                       unsigned char *iv);
+__owur int ssl_ticket_key_decrypt_init(SSL_CTX *tctx,
+                                       const unsigned char *key_name,
+                                       const unsigned char *iv,
+                                       EVP_CIPHER_CTX *ctx, SSL_HMAC **hctx,
+                                       int *renew);
+size_t ssl_sess_cache_num_items(const SSL_CTX *ctx);
+SSL_SESS_CACHE_SHARD *ssl_sess_cache_get_shard(const SSL_CTX *ctx,
+                                               const SSL_SESSION *s);
 __owur int ssl_get_prev_session(SSL_CONNECTION *s, CLIENTHELLO_MSG *hello);
 __owur SSL_SESSION *ssl_session_dup(const SSL_SESSION *src, int ticket);
 __owur int ssl_cipher_id_cmp(const SSL_CIPHER *a, const SSL_CIPHER *b);
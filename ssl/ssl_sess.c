@@ -21,8 +21,9 @@
 #include "ssl_local.h"
 #include "statem/statem_local.h"
 
-static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s);
-static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s);
+static void SSL_SESSION_list_remove(SSL_SESS_CACHE_SHARD *shard,
+                                    SSL_SESSION *s);
+static void SSL_SESSION_list_add(SSL_SESS_CACHE_SHARD *shard, SSL_SESSION *s);
 static int remove_session_lock(SSL_CTX *ctx, SSL_SESSION *c, int lck);
 
 DEFINE_STACK_OF(SSL_SESSION)
@@ -500,6 +501,7 @@ SSL_SESSION *lookup_sess_in_cache(SSL_CONNECTION *s,
     if ((s->session_ctx->session_cache_mode
          & SSL_SESS_CACHE_NO_INTERNAL_LOOKUP) == 0) {
         SSL_SESSION data;
+        SSL_SESS_CACHE_SHARD *shard;
 
         data.ssl_version = s->version;
         if (!ossl_assert(sess_id_len <= SSL_MAX_SSL_SESSION_ID_LENGTH))
@@ -508,17 +510,18 @@ SSL_SESSION *lookup_sess_in_cache(SSL_CONNECTION *s,
         memcpy(data.session_id, sess_id, sess_id_len);
         data.session_id_length = sess_id_len;
 
-        if (!CRYPTO_THREAD_read_lock(s->session_ctx->lock))
+        shard = ssl_sess_cache_get_shard(s->session_ctx, &data);
+        if (!CRYPTO_THREAD_read_lock(shard->lock))
             return NULL;
-        ret = lh_SSL_SESSION_retrieve(s->session_ctx->sessions, &data);
+        ret = lh_SSL_SESSION_retrieve(shard->sessions, &data);
         if (ret != NULL) {
             /* don't allow other threads to steal it: */
             if (!SSL_SESSION_up_ref(ret)) {
-                CRYPTO_THREAD_unlock(s->session_ctx->lock);
+                CRYPTO_THREAD_unlock(shard->lock);
                 return NULL;
             }
         }
-        CRYPTO_THREAD_unlock(s->session_ctx->lock);
+        CRYPTO_THREAD_unlock(shard->lock);
         if (ret == NULL)
             ssl_tsan_counter(s->session_ctx, &s->session_ctx->stats.sess_miss);
     }
@@ -727,6 +730,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
 {
     int ret = 0;
     SSL_SESSION *s;
+    SSL_SESS_CACHE_SHARD *shard = ssl_sess_cache_get_shard(ctx, c);
 
     /*
      * add just 1 reference count for the SSL_CTX's session cache even though
@@ -739,20 +743,20 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
      * if session c is in already in cache, we take back the increment later
      */
 
-    if (!CRYPTO_THREAD_write_lock(ctx->lock)) {
+    if (!CRYPTO_THREAD_write_lock(shard->lock)) {
         SSL_SESSION_free(c);
         return 0;
     }
-    s = lh_SSL_SESSION_insert(ctx->sessions, c);
+    s = lh_SSL_SESSION_insert(shard->sessions, c);
 
     /*
      * s != NULL iff we already had a session with the given PID. In this
      * case, s == c should hold (then we did not really modify
-     * ctx->sessions), or we're in trouble.
+     * shard->sessions), or we're in trouble.
      */
     if (s != NULL && s != c) {
         /* We *are* in trouble ... */
-        SSL_SESSION_list_remove(ctx, s);
+        SSL_SESSION_list_remove(shard, s);
         SSL_SESSION_free(s);
         /*
          * ... so pretend the other session did not exist in cache (we cannot
@@ -762,7 +766,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
          */
         s = NULL;
     } else if (s == NULL &&
-               lh_SSL_SESSION_retrieve(ctx->sessions, c) == NULL) {
+               lh_SSL_SESSION_retrieve(shard->sessions, c) == NULL) {
         /* s == NULL can also mean OOM error in lh_SSL_SESSION_insert ... */
 
         /*
@@ -787,8 +791,12 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
         ret = 1;
 
         if (SSL_CTX_sess_get_cache_size(ctx) > 0) {
-            while (SSL_CTX_sess_number(ctx) >= SSL_CTX_sess_get_cache_size(ctx)) {
-                if (!remove_session_lock(ctx, ctx->session_cache_tail, 0))
+            /* A sharded cache enforces an equal part of the limit per shard */
+            size_t limit = (SSL_CTX_sess_get_cache_size(ctx)
+                            + ctx->num_sess_shards - 1) / ctx->num_sess_shards;
+
+            while (lh_SSL_SESSION_num_items(shard->sessions) >= limit) {
+                if (!remove_session_lock(ctx, shard->tail, 0))
                     break;
                 else
                     ssl_tsan_counter(ctx, &ctx->stats.sess_cache_full);
@@ -796,7 +804,7 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
         }
     }
 
-    SSL_SESSION_list_add(ctx, c);
+    SSL_SESSION_list_add(shard, c);
 
     if (s != NULL) {
         /*
@@ -807,34 +815,38 @@ int SSL_CTX_add_session(SSL_CTX *ctx, SSL_SESSION *c)
         SSL_SESSION_free(s);    /* s == c */
         ret = 0;
     }
-    CRYPTO_THREAD_unlock(ctx->lock);
+    CRYPTO_THREAD_unlock(shard->lock);
     return ret;
 }
 
 int SSL_CTX_remove_session(SSL_CTX *ctx, SSL_SESSION *c)
 {
+    if (c != NULL)
+        ssl_shm_sess_cache_remove(ctx, c);
     return remove_session_lock(ctx, c, 1);
 }
 
 static int remove_session_lock(SSL_CTX *ctx, SSL_SESSION *c, int lck)
 {
     SSL_SESSION *r;
+    SSL_SESS_CACHE_SHARD *shard;
     int ret = 0;
 
     if ((c != NULL) && (c->session_id_length != 0)) {
+        shard = ssl_sess_cache_get_shard(ctx, c);
         if (lck) {
-            if (!CRYPTO_THREAD_write_lock(ctx->lock))
+            if (!CRYPTO_THREAD_write_lock(shard->lock))
                 return 0;
         }
-        if ((r = lh_SSL_SESSION_retrieve(ctx->sessions, c)) != NULL) {
+        if ((r = lh_SSL_SESSION_retrieve(shard->sessions, c)) != NULL) {
             ret = 1;
-            r = lh_SSL_SESSION_delete(ctx->sessions, r);
-            SSL_SESSION_list_remove(ctx, r);
+            r = lh_SSL_SESSION_delete(shard->sessions, r);
+            SSL_SESSION_list_remove(shard, r);
         }
         c->not_resumable = 1;
 
         if (lck)
-            CRYPTO_THREAD_unlock(ctx->lock);
+            CRYPTO_THREAD_unlock(shard->lock);
 
         if (ctx->remove_session_cb != NULL)
             ctx->remove_session_cb(ctx, c);
@@ -1216,47 +1228,53 @@ void SSL_CTX_flush_sessions_ex(SSL_CTX *s, time_t t)
 {
     STACK_OF(SSL_SESSION) *sk;
     SSL_SESSION *current;
+    SSL_SESS_CACHE_SHARD *shard;
     unsigned long i;
+    size_t n;
     const OSSL_TIME timeout = ossl_time_from_time_t(t);
 
-    if (!CRYPTO_THREAD_write_lock(s->lock))
-        return;
-
     sk = sk_SSL_SESSION_new_null();
-    i = lh_SSL_SESSION_get_down_load(s->sessions);
-    lh_SSL_SESSION_set_down_load(s->sessions, 0);
 
-    /*
-     * Iterate over the list from the back (oldest), and stop
-     * when a session can no longer be removed.
-     * Add the session to a temporary list to be freed outside
-     * the SSL_CTX lock.
-     * But still do the remove_session_cb() within the lock.
-     */
-    while (s->session_cache_tail != NULL) {
-        current = s->session_cache_tail;
-        if (t == 0 || sess_timedout(timeout, current)) {
-            lh_SSL_SESSION_delete(s->sessions, current);
-            SSL_SESSION_list_remove(s, current);
-            current->not_resumable = 1;
-            if (s->remove_session_cb != NULL)
-                s->remove_session_cb(s, current);
-            /*
-             * Throw the session on a stack, it's entirely plausible
-             * that while freeing outside the critical section, the
-             * session could be re-added, so avoid using the next/prev
-             * pointers. If the stack failed to create, or the session
-             * couldn't be put on the stack, just free it here
-             */
-            if (sk == NULL || !sk_SSL_SESSION_push(sk, current))
-                SSL_SESSION_free(current);
-        } else {
-            break;
+    for (n = 0; n < s->num_sess_shards; n++) {
+        shard = &s->sess_shards[n];
+        if (!CRYPTO_THREAD_write_lock(shard->lock))
+            continue;
+
+        i = lh_SSL_SESSION_get_down_load(shard->sessions);
+        lh_SSL_SESSION_set_down_load(shard->sessions, 0);
+
+        /*
+         * Iterate over the list from the back (oldest), and stop
+         * when a session can no longer be removed.
+         * Add the session to a temporary list to be freed outside
+         * the shard lock.
+         * But still do the remove_session_cb() within the lock.
+         */
+        while (shard->tail != NULL) {
+            current = shard->tail;
+            if (t == 0 || sess_timedout(timeout, current)) {
+                lh_SSL_SESSION_delete(shard->sessions, current);
+                SSL_SESSION_list_remove(shard, current);
+                current->not_resumable = 1;
+                if (s->remove_session_cb != NULL)
+                    s->remove_session_cb(s, current);
+                /*
+                 * Throw the session on a stack, it's entirely plausible
+                 * that while freeing outside the critical section, the
+                 * session could be re-added, so avoid using the next/prev
+                 * pointers. If the stack failed to create, or the session
+                 * couldn't be put on the stack, just free it here
+                 */
+                if (sk == NULL || !sk_SSL_SESSION_push(sk, current))
+                    SSL_SESSION_free(current);
+            } else {
+                break;
+            }
         }
-    }
 
-    lh_SSL_SESSION_set_down_load(s->sessions, i);
-    CRYPTO_THREAD_unlock(s->lock);
+        lh_SSL_SESSION_set_down_load(shard->sessions, i);
+        CRYPTO_THREAD_unlock(shard->lock);
+    }
 
     sk_SSL_SESSION_pop_free(sk, SSL_SESSION_free);
 }
@@ -1273,27 +1291,28 @@ int ssl_clear_bad_session(SSL_CONNECTION *s)
         return 0;
 }
 
-/* locked by SSL_CTX in the calling function */
-static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s)
+/* locked by the shard lock in the calling function */
+static void SSL_SESSION_list_remove(SSL_SESS_CACHE_SHARD *shard,
+                                    SSL_SESSION *s)
 {
     if ((s->next == NULL) || (s->prev == NULL))
         return;
 
-    if (s->next == (SSL_SESSION *)&(ctx->session_cache_tail)) {
+    if (s->next == (SSL_SESSION *)&(shard->tail)) {
         /* last element in list */
-        if (s->prev == (SSL_SESSION *)&(ctx->session_cache_head)) {
+        if (s->prev == (SSL_SESSION *)&(shard->head)) {
             /* only one element in list */
-            ctx->session_cache_head = NULL;
-            ctx->session_cache_tail = NULL;
+            shard->head = NULL;
+            shard->tail = NULL;
         } else {
-            ctx->session_cache_tail = s->prev;
-            s->prev->next = (SSL_SESSION *)&(ctx->session_cache_tail);
+            shard->tail = s->prev;
+            s->prev->next = (SSL_SESSION *)&(shard->tail);
         }
     } else {
-        if (s->prev == (SSL_SESSION *)&(ctx->session_cache_head)) {
+        if (s->prev == (SSL_SESSION *)&(shard->head)) {
             /* first element in list */
-            ctx->session_cache_head = s->next;
-            s->next->prev = (SSL_SESSION *)&(ctx->session_cache_head);
+            shard->head = s->next;
+            s->next->prev = (SSL_SESSION *)&(shard->head);
         } else {
             /* middle of list */
             s->next->prev = s->prev;
@@ -1304,41 +1323,41 @@ static void SSL_SESSION_list_remove(SSL_CTX *ctx, SSL_SESSION *s)
     s->owner = NULL;
 }
 
-static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s)
+static void SSL_SESSION_list_add(SSL_SESS_CACHE_SHARD *shard, SSL_SESSION *s)
 {
     SSL_SESSION *next;
 
     if ((s->next != NULL) && (s->prev != NULL))
-        SSL_SESSION_list_remove(ctx, s);
+        SSL_SESSION_list_remove(shard, s);
 
-    if (ctx->session_cache_head == NULL) {
-        ctx->session_cache_head = s;
-        ctx->session_cache_tail = s;
-        s->prev = (SSL_SESSION *)&(ctx->session_cache_head);
-        s->next = (SSL_SESSION *)&(ctx->session_cache_tail);
+    if (shard->head == NULL) {
+        shard->head = s;
+        shard->tail = s;
+        s->prev = (SSL_SESSION *)&(shard->head);
+        s->next = (SSL_SESSION *)&(shard->tail);
     } else {
-        if (timeoutcmp(s, ctx->session_cache_head) >= 0) {
+        if (timeoutcmp(s, shard->head) >= 0) {
             /*
              * if we timeout after (or the same time as) the first
              * session, put us first - usual case
              */
-            s->next = ctx->session_cache_head;
+            s->next = shard->head;
             s->next->prev = s;
-            s->prev = (SSL_SESSION *)&(ctx->session_cache_head);
-            ctx->session_cache_head = s;
-        } else if (timeoutcmp(s, ctx->session_cache_tail) < 0) {
+            s->prev = (SSL_SESSION *)&(shard->head);
+            shard->head = s;
+        } else if (timeoutcmp(s, shard->tail) < 0) {
             /* if we timeout before the last session, put us last */
-            s->prev = ctx->session_cache_tail;
+            s->prev = shard->tail;
             s->prev->next = s;
-            s->next = (SSL_SESSION *)&(ctx->session_cache_tail);
-            ctx->session_cache_tail = s;
+            s->next = (SSL_SESSION *)&(shard->tail);
+            shard->tail = s;
         } else {
             /*
              * we timeout somewhere in-between - if there is only
              * one session in the cache it will be caught above
              */
-            next = ctx->session_cache_head->next;
-            while (next != (SSL_SESSION*)&(ctx->session_cache_tail)) {
+            next = shard->head->next;
+            while (next != (SSL_SESSION*)&(shard->tail)) {
                 if (timeoutcmp(s, next) >= 0) {
                     s->next = next;
                     s->prev = next->prev;
@@ -1350,7 +1369,99 @@ static void SSL_SESSION_list_add(SSL_CTX *ctx, SSL_SESSION *s)
             }
         }
     }
-    s->owner = ctx;
+    s->owner = shard;
+}
+
+static SSL_SESS_CACHE_SHARD *sess_cache_shard(SSL_SESS_CACHE_SHARD *shards,
+                                              size_t num,
+                                              const SSL_SESSION *s)
+{
+    if (num == 1)
+        return shards;
+    /*
+     * Each shard's hash table picks a bucket from the low bits of the session
+     * hash, so choose the shard from the top bits to keep the buckets evenly
+     * used.
+     */
+    return &shards[((ssl_session_hash(s) >> 24) & 0xff) % num];
+}
+
+SSL_SESS_CACHE_SHARD *ssl_sess_cache_get_shard(const SSL_CTX *ctx,
+                                               const SSL_SESSION *s)
+{
+    return sess_cache_shard(ctx->sess_shards, ctx->num_sess_shards, s);
+}
+
+size_t ssl_sess_cache_num_items(const SSL_CTX *ctx)
+{
+    size_t i, n = 0;
+
+    for (i = 0; i < ctx->num_sess_shards; i++)
+        n += lh_SSL_SESSION_num_items(ctx->sess_shards[i].sessions);
+    return n;
+}
+
+static void sess_cache_free_shards(SSL_SESS_CACHE_SHARD *shards, size_t num)
+{
+    size_t i;
+
+    if (shards == NULL)
+        return;
+    for (i = 0; i < num; i++) {
+        lh_SSL_SESSION_free(shards[i].sessions);
+        if (shards[i].own_lock)
+            CRYPTO_THREAD_lock_free(shards[i].lock);
+    }
+    OPENSSL_free(shards);
+}
+
+void ssl_sess_cache_free(SSL_CTX *ctx)
+{
+    sess_cache_free_shards(ctx->sess_shards, ctx->num_sess_shards);
+    ctx->sess_shards = NULL;
+    ctx->num_sess_shards = 0;
+}
+
+/*
+ * Switch the internal session cache between a single shard using the SSL_CTX
+ * lock and SSL_SESS_CACHE_NUM_SHARDS shards with their own locks.  The shard
+ * array is read without a lock, so it is only replaced while the cache is
+ * empty and no SSL object refers to |ctx|.  Otherwise 0 is returned and the
+ * cache is left as it is.
+ */
+int ssl_sess_cache_set_sharded(SSL_CTX *ctx, int sharded)
+{
+    size_t num = sharded ? SSL_SESS_CACHE_NUM_SHARDS : 1;
+    SSL_SESS_CACHE_SHARD *shards;
+    size_t i;
+    int refs;
+
+    if (ctx->sess_shards != NULL
+        && (ssl_sess_cache_num_items(ctx) != 0
+            || !CRYPTO_GET_REF(&ctx->references, &refs) || refs > 1))
+        return 0;
+
+    if ((shards = OPENSSL_zalloc(num * sizeof(*shards))) == NULL)
+        return 0;
+    for (i = 0; i < num; i++) {
+        shards[i].sessions = lh_SSL_SESSION_new(ssl_session_hash,
+                                                ssl_session_cmp);
+        if (num == 1) {
+            shards[i].lock = ctx->lock;
+        } else {
+            shards[i].lock = CRYPTO_THREAD_lock_new();
+            shards[i].own_lock = shards[i].lock != NULL;
+        }
+        if (shards[i].sessions == NULL || shards[i].lock == NULL) {
+            sess_cache_free_shards(shards, num);
+            return 0;
+        }
+    }
+
+    ssl_sess_cache_free(ctx);
+    ctx->sess_shards = shards;
+    ctx->num_sess_shards = num;
+    return 1;
 }
 
 void SSL_CTX_sess_set_new_cb(SSL_CTX *ctx,
@@ -0,0 +1,522 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * A session cache kept in a shared memory mapping of a file, so that several
+ * server processes (typically forked workers) can resume each other's
+ * sessions.  It plugs into the external session cache callbacks of an
+ * SSL_CTX.
+ *
+ * The mapping starts with a small header followed by sets of
+ * SHM_SESS_WAYS fixed size slots.  A session is stored in the set selected
+ * by a hash of its session id, replacing an empty or expired slot or else
+ * the least recently used one.
+ *
+ * Every slot carries a sequence number that is odd while the slot is being
+ * written.  Readers never lock: they copy the slot and check that the
+ * sequence number did not change meanwhile.  Writers are serialised with a
+ * lock local to the process and an fcntl() record lock on the set for other
+ * processes.
+ */
+
+#include "internal/e_os.h"
+#include <string.h>
+#include <openssl/crypto.h>
+#include "internal/ssl_unwrap.h"
+#include "ssl_local.h"
+
+#if defined(OPENSSL_SYS_UNIX)
+# include <errno.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# define SHM_SESS_CACHE_SUPPORTED
+#endif
+
+#ifdef SHM_SESS_CACHE_SUPPORTED
+
+# define SHM_SESS_MAGIC         0x314d48534c53534fULL    /* "OSSLSHM1" */
+# define SHM_SESS_WAYS          8
+# define SHM_SESS_SLOT_SIZE     2048
+
+typedef struct {
+    uint64_t magic;
+    uint64_t nsets;
+    uint64_t ways;
+    uint64_t slot_size;
+    uint64_t reserved[4];
+} SHM_SESS_HDR;
+
+typedef struct {
+    uint64_t seq;               /* odd while the slot is being written */
+    uint64_t last_used;         /* seconds */
+    uint64_t expires;           /* seconds */
+    uint32_t id_len;            /* 0 if the slot is empty */
+    uint32_t der_len;
+    unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+    unsigned char der[SHM_SESS_SLOT_SIZE - 3 * sizeof(uint64_t)
+                      - 2 * sizeof(uint32_t) - SSL_MAX_SSL_SESSION_ID_LENGTH];
+} SHM_SESS_SLOT;
+
+struct ssl_shm_sess_cache_st {
+    int fd;
+    unsigned char *map;
+    size_t map_size;
+    uint64_t nsets;
+    SHM_SESS_SLOT *slots;
+    /* Serialises writers within this process, fcntl() locks do not */
+    CRYPTO_RWLOCK *lock;
+    /* Callbacks the application had set, called after our own */
+    int (*app_new_cb)(SSL *ssl, SSL_SESSION *sess);
+    SSL_SESSION *(*app_get_cb)(SSL *ssl, const unsigned char *id, int id_len,
+                               int *copy);
+};
+
+static uint64_t shm_sess_now(void)
+{
+    return ossl_time2seconds(ossl_time_now());
+}
+
+/* FNV-1a, session ids do not have to be random if set by the application */
+static uint64_t shm_sess_set(const SSL_SHM_SESS_CACHE *cache,
+                             const unsigned char *id, size_t id_len)
+{
+    uint32_t h = 0x811c9dc5;
+    size_t i;
+
+    for (i = 0; i < id_len; i++) {
+        h ^= id[i];
+        h *= 0x01000193;
+    }
+    return h % cache->nsets;
+}
+
+static int shm_sess_lock_set(const SSL_SHM_SESS_CACHE *cache, uint64_t set,
+                             short type)
+{
+    struct flock fl;
+
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = type;
+    fl.l_whence = SEEK_SET;
+    fl.l_start = (off_t)(sizeof(SHM_SESS_HDR)
+                         + set * SHM_SESS_WAYS * sizeof(SHM_SESS_SLOT));
+    fl.l_len = (off_t)(SHM_SESS_WAYS * sizeof(SHM_SESS_SLOT));
+    while (fcntl(cache->fd, F_SETLKW, &fl) == -1)
+        if (errno != EINTR)
+            return 0;
+    return 1;
+}
+
+/*
+ * Take the write side of a set.  The process lock is taken first so that
+ * only one thread per process ever waits on the fcntl() lock.
+ */
+static int shm_sess_write_lock(SSL_SHM_SESS_CACHE *cache, uint64_t set)
+{
+    if (!CRYPTO_THREAD_write_lock(cache->lock))
+        return 0;
+    if (!shm_sess_lock_set(cache, set, F_WRLCK)) {
+        CRYPTO_THREAD_unlock(cache->lock);
+        return 0;
+    }
+    return 1;
+}
+
+static void shm_sess_write_unlock(SSL_SHM_SESS_CACHE *cache, uint64_t set)
+{
+    shm_sess_lock_set(cache, set, F_UNLCK);
+    CRYPTO_THREAD_unlock(cache->lock);
+}
+
+/*
+ * Mark a slot as being written.  A slot may still be odd if a process died
+ * while writing it; we hold the set lock, so simply take it over.
+ */
+static int shm_sess_slot_begin(SHM_SESS_SLOT *slot)
+{
+    uint64_t seq;
+
+    if (!CRYPTO_atomic_load(&slot->seq, &seq, NULL))
+        return 0;
+    if ((seq & 1) == 0 && !CRYPTO_atomic_add64(&slot->seq, 1, &seq, NULL))
+        return 0;
+    return 1;
+}
+
+static void shm_sess_slot_end(SHM_SESS_SLOT *slot)
+{
+    uint64_t seq;
+
+    CRYPTO_atomic_add64(&slot->seq, 1, &seq, NULL);
+}
+
+/*
+ * Find the slot holding |id| in |set|.  Only used with the set locked for
+ * writing, so the slot contents are stable.
+ */
+static SHM_SESS_SLOT *shm_sess_find_locked(SSL_SHM_SESS_CACHE *cache,
+                                           uint64_t set,
+                                           const unsigned char *id,
+                                           size_t id_len)
+{
+    SHM_SESS_SLOT *slot = &cache->slots[set * SHM_SESS_WAYS];
+    size_t i;
+
+    for (i = 0; i < SHM_SESS_WAYS; i++, slot++)
+        if (slot->id_len == id_len && memcmp(slot->id, id, id_len) == 0)
+            return slot;
+    return NULL;
+}
+
+/*
+ * Copy the encoding of the session |id| out of |set| without locking.
+ * Returns the length of the encoding or 0 if not found.
+ */
+static size_t shm_sess_lookup(SSL_SHM_SESS_CACHE *cache,
+                              const unsigned char *id, size_t id_len,
+                              unsigned char *der, size_t der_size)
+{
+    uint64_t set = shm_sess_set(cache, id, id_len);
+    SHM_SESS_SLOT *slot = &cache->slots[set * SHM_SESS_WAYS];
+    uint64_t now = shm_sess_now();
+    uint64_t seq, seq2, expires, last_used;
+    size_t i, len;
+
+    for (i = 0; i < SHM_SESS_WAYS; i++, slot++) {
+        if (!CRYPTO_atomic_load(&slot->seq, &seq, NULL)
+                || (seq & 1) != 0
+                || slot->id_len != id_len
+                || memcmp(slot->id, id, id_len) != 0)
+            continue;
+
+        len = slot->der_len;
+        expires = slot->expires;
+        if (len == 0 || len > der_size || expires <= now)
+            continue;
+        memcpy(der, slot->der, len);
+
+        /*
+         * An atomic read-modify-write orders the copy above before the
+         * check, which a plain acquire load would not.
+         */
+        if (!CRYPTO_atomic_add64(&slot->seq, 0, &seq2, NULL) || seq != seq2)
+            continue;
+
+        if (CRYPTO_atomic_load(&slot->last_used, &last_used, NULL)
+                && last_used != now)
+            CRYPTO_atomic_store(&slot->last_used, now, NULL);
+        return len;
+    }
+    return 0;
+}
+
+static int shm_sess_store(SSL_SHM_SESS_CACHE *cache, SSL_SESSION *sess)
+{
+    unsigned char der[sizeof(((SHM_SESS_SLOT *)NULL)->der)];
+    unsigned char *p = der;
+    SHM_SESS_SLOT *slot, *victim = NULL;
+    uint64_t set, now = shm_sess_now();
+    int len;
+    size_t i;
+
+    if (sess->session_id_length == 0)
+        return 0;
+
+    /* Sessions too big for a slot, e.g. with long peer chains, are skipped */
+    len = i2d_SSL_SESSION(sess, NULL);
+    if (len <= 0 || (size_t)len > sizeof(der))
+        return 0;
+    if (i2d_SSL_SESSION(sess, &p) != len)
+        return 0;
+
+    set = shm_sess_set(cache, sess->session_id, sess->session_id_length);
+    if (!shm_sess_write_lock(cache, set))
+        return 0;
+
+    victim = shm_sess_find_locked(cache, set, sess->session_id,
+                                  sess->session_id_length);
+    if (victim == NULL) {
+        slot = &cache->slots[set * SHM_SESS_WAYS];
+        for (i = 0; i < SHM_SESS_WAYS; i++, slot++) {
+            if (slot->id_len == 0 || slot->expires <= now) {
+                victim = slot;
+                break;
+            }
+            if (victim == NULL || slot->last_used < victim->last_used)
+                victim = slot;
+        }
+    }
+
+    if (shm_sess_slot_begin(victim)) {
+        victim->id_len = (uint32_t)sess->session_id_length;
+        memcpy(victim->id, sess->session_id, sess->session_id_length);
+        victim->der_len = (uint32_t)len;
+        memcpy(victim->der, der, len);
+        victim->expires = ossl_time2seconds(sess->calc_timeout);
+        victim->last_used = now;
+        shm_sess_slot_end(victim);
+    }
+
+    shm_sess_write_unlock(cache, set);
+    return 1;
+}
+
+static void shm_sess_remove(SSL_SHM_SESS_CACHE *cache,
+                            const unsigned char *id, size_t id_len)
+{
+    uint64_t set = shm_sess_set(cache, id, id_len);
+    SHM_SESS_SLOT *slot;
+
+    if (!shm_sess_write_lock(cache, set))
+        return;
+    slot = shm_sess_find_locked(cache, set, id, id_len);
+    if (slot != NULL && shm_sess_slot_begin(slot)) {
+        slot->id_len = 0;
+        slot->der_len = 0;
+        slot->expires = 0;
+        shm_sess_slot_end(slot);
+    }
+    shm_sess_write_unlock(cache, set);
+}
+
+static int shm_sess_new_cb(SSL *s, SSL_SESSION *sess)
+{
+    SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL(s);
+    SSL_SHM_SESS_CACHE *cache;
+
+    if (sc == NULL || (cache = sc->session_ctx->shm_sess_cache) == NULL)
+        return 0;
+
+    /*
+     * TLSv1.3 sessions are resumed from stateless tickets unless
+     * SSL_OP_NO_TICKET is set, so there is no point in sharing them.
+     */
+    if (!SSL_CONNECTION_IS_TLS13(sc) || (sc->options & SSL_OP_NO_TICKET) != 0)
+        shm_sess_store(cache, sess);
+
+    /* We keep no reference to |sess|, the application's callback may */
+    return cache->app_new_cb != NULL ? cache->app_new_cb(s, sess) : 0;
+}
+
+static SSL_SESSION *shm_sess_get_cb(SSL *s, const unsigned char *id,
+                                    int id_len, int *copy)
+{
+    SSL_CONNECTION *sc = SSL_CONNECTION_FROM_SSL(s);
+    unsigned char der[sizeof(((SHM_SESS_SLOT *)NULL)->der)];
+    const unsigned char *p = der;
+    SSL_CTX *ctx;
+    size_t len;
+
+    *copy = 0;
+    if (sc == NULL || id_len <= 0
+            || id_len > SSL_MAX_SSL_SESSION_ID_LENGTH)
+        return NULL;
+    ctx = sc->session_ctx;
+    if (ctx->shm_sess_cache == NULL)
+        return NULL;
+
+    len = shm_sess_lookup(ctx->shm_sess_cache, id, id_len, der, sizeof(der));
+    if (len == 0)
+        return ctx->shm_sess_cache->app_get_cb != NULL
+               ? ctx->shm_sess_cache->app_get_cb(s, id, id_len, copy) : NULL;
+    return d2i_SSL_SESSION_ex(NULL, &p, (long)len, ctx->libctx, ctx->propq);
+}
+
+/*
+ * Called from SSL_CTX_remove_session() rather than as remove_session_cb,
+ * which also fires when a session merely drops out of one process's internal
+ * cache or when the SSL_CTX is freed.  Neither should affect other processes.
+ */
+void ssl_shm_sess_cache_remove(SSL_CTX *ctx, SSL_SESSION *sess)
+{
+    if (ctx->shm_sess_cache != NULL && sess->session_id_length > 0)
+        shm_sess_remove(ctx->shm_sess_cache, sess->session_id,
+                        sess->session_id_length);
+}
+
+void ssl_shm_sess_cache_free(SSL_SHM_SESS_CACHE *cache)
+{
+    if (cache == NULL)
+        return;
+    if (cache->map != NULL)
+        munmap(cache->map, cache->map_size);
+    if (cache->fd >= 0)
+        close(cache->fd);
+    CRYPTO_THREAD_lock_free(cache->lock);
+    OPENSSL_free(cache);
+}
+
+/*
+ * Map |path|, creating and initialising it if needed.  All the processes
+ * sharing the file must use the same |size|, otherwise this fails.
+ */
+static SSL_SHM_SESS_CACHE *shm_sess_cache_new(const char *path, size_t size)
+{
+    SSL_SHM_SESS_CACHE *cache;
+    SHM_SESS_HDR *hdr;
+    struct flock fl;
+    struct stat st;
+    uint64_t nsets, magic;
+    int flags = O_RDWR | O_CREAT, init = 0, locked = 0;
+
+    if (size < sizeof(SHM_SESS_HDR) + SHM_SESS_WAYS * sizeof(SHM_SESS_SLOT)) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return NULL;
+    }
+    nsets = (size - sizeof(SHM_SESS_HDR))
+            / (SHM_SESS_WAYS * sizeof(SHM_SESS_SLOT));
+
+    if ((cache = OPENSSL_zalloc(sizeof(*cache))) == NULL)
+        return NULL;
+    cache->fd = -1;
+    cache->nsets = nsets;
+    cache->map_size = sizeof(SHM_SESS_HDR)
+                      + nsets * SHM_SESS_WAYS * sizeof(SHM_SESS_SLOT);
+    if ((cache->lock = CRYPTO_THREAD_lock_new()) == NULL) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_CRYPTO_LIB);
+        goto err;
+    }
+
+# ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+# endif
+    if ((cache->fd = open(path, flags, 0600)) < 0) {
+        ERR_raise_data(ERR_LIB_SYS, errno, "calling open(%s)", path);
+        goto err;
+    }
+
+    /*
+     * Lock the header while checking and, if needed, initialising the file.
+     * Only a file that nobody has initialised yet is sized and initialised
+     * here.  Other processes may have a live mapping of any other file, so
+     * a file of another size or layout is rejected rather than reset.
+     */
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+    fl.l_len = (off_t)sizeof(SHM_SESS_HDR);
+    while (fcntl(cache->fd, F_SETLKW, &fl) == -1) {
+        if (errno != EINTR) {
+            ERR_raise_data(ERR_LIB_SYS, errno, "calling fcntl()");
+            goto err;
+        }
+    }
+    locked = 1;
+
+    if (fstat(cache->fd, &st) != 0) {
+        ERR_raise_data(ERR_LIB_SYS, errno, "calling fstat()");
+        goto err;
+    }
+    if (st.st_size == 0) {
+        if (ftruncate(cache->fd, (off_t)cache->map_size) != 0) {
+            ERR_raise_data(ERR_LIB_SYS, errno, "calling ftruncate()");
+            goto err;
+        }
+        init = 1;
+    } else if ((uint64_t)st.st_size != cache->map_size) {
+        ERR_raise_data(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT,
+                       "%s is in use with a different cache size", path);
+        goto err;
+    }
+
+    cache->map = mmap(NULL, cache->map_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, cache->fd, 0);
+    if (cache->map == MAP_FAILED) {
+        cache->map = NULL;
+        ERR_raise_data(ERR_LIB_SYS, errno, "calling mmap()");
+        goto err;
+    }
+    hdr = (SHM_SESS_HDR *)cache->map;
+    cache->slots = (SHM_SESS_SLOT *)(cache->map + sizeof(SHM_SESS_HDR));
+
+    /* The cache relies on native atomics working across processes */
+    if (!CRYPTO_atomic_load(&hdr->magic, &magic, NULL)) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_UNSUPPORTED);
+        goto err;
+    }
+    /*
+     * A zero magic means that whoever sized the file failed before
+     * initialising it, so nobody can be using it yet.
+     */
+    if (!init && magic != 0
+            && (magic != SHM_SESS_MAGIC || hdr->nsets != nsets
+                || hdr->ways != SHM_SESS_WAYS
+                || hdr->slot_size != sizeof(SHM_SESS_SLOT))) {
+        ERR_raise_data(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT,
+                       "%s is in use with a different cache layout", path);
+        goto err;
+    }
+    if (init || magic == 0) {
+        memset(cache->map, 0, cache->map_size);
+        hdr->nsets = nsets;
+        hdr->ways = SHM_SESS_WAYS;
+        hdr->slot_size = sizeof(SHM_SESS_SLOT);
+        CRYPTO_atomic_store(&hdr->magic, SHM_SESS_MAGIC, NULL);
+    }
+
+    fl.l_type = F_UNLCK;
+    fcntl(cache->fd, F_SETLK, &fl);
+    return cache;
+
+ err:
+    if (locked) {
+        fl.l_type = F_UNLCK;
+        fcntl(cache->fd, F_SETLK, &fl);
+    }
+    ssl_shm_sess_cache_free(cache);
+    return NULL;
+}
+
+#else
+
+void ssl_shm_sess_cache_remove(SSL_CTX *ctx, SSL_SESSION *sess)
+{
+}
+
+void ssl_shm_sess_cache_free(SSL_SHM_SESS_CACHE *cache)
+{
+}
+
+#endif /* SHM_SESS_CACHE_SUPPORTED */
+
+int SSL_CTX_set_shared_session_cache(SSL_CTX *ctx, const char *path,
+                                     size_t size)
+{
+#ifdef SHM_SESS_CACHE_SUPPORTED
+    SSL_SHM_SESS_CACHE *cache = NULL;
+
+    if (path != NULL && (cache = shm_sess_cache_new(path, size)) == NULL)
+        return 0;
+
+    /* Keep any callbacks of the application and call them from ours */
+    if (ctx->shm_sess_cache != NULL) {
+        if (ctx->new_session_cb == shm_sess_new_cb)
+            ctx->new_session_cb = ctx->shm_sess_cache->app_new_cb;
+        if (ctx->get_session_cb == shm_sess_get_cb)
+            ctx->get_session_cb = ctx->shm_sess_cache->app_get_cb;
+    }
+    ssl_shm_sess_cache_free(ctx->shm_sess_cache);
+    ctx->shm_sess_cache = cache;
+    if (cache != NULL) {
+        cache->app_new_cb = ctx->new_session_cb;
+        cache->app_get_cb = ctx->get_session_cb;
+        ctx->new_session_cb = shm_sess_new_cb;
+        ctx->get_session_cb = shm_sess_get_cb;
+    }
+    return 1;
+#else
+    if (path == NULL)
+        return 1;
+    ERR_raise(ERR_LIB_SSL, ERR_R_UNSUPPORTED);
+    return 0;
+#endif
+}
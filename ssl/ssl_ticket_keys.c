@@ -0,0 +1,450 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Session ticket keyring.
+ *
+ * The keys protecting stateless session tickets are held in an immutable
+ * SSL_TICKET_KEYRING.  The first key encrypts new tickets and any key in the
+ * ring decrypts them.  Each key carries cipher and HMAC contexts keyed when
+ * the ring is built, so that a ticket only costs copying them.
+ *
+ * Replacing the keyring must not hold up ticket processing.  The SSL_CTX
+ * therefore has two keyring slots and a generation counter whose low bit
+ * selects the current one.  Readers pin the current slot with a per slot
+ * counter and check that the generation did not move meanwhile.  A writer
+ * waits until the other slot has no readers left, installs the new ring
+ * there and bumps the generation.  This is a reduced form of the RCU in
+ * crypto/threads_*.c, which libssl cannot use as it is internal to
+ * libcrypto.
+ */
+
+#include <string.h>
+#include <openssl/rand.h>
+#include <openssl/core_names.h>
+#include "ssl_local.h"
+
+#define TICKET_KEY_LENGTH \
+    (TLSEXT_KEYNAME_LENGTH + 2 * TLSEXT_TICK_KEY_LENGTH)
+
+static void ticket_keyring_free(SSL_TICKET_KEYRING *ring)
+{
+    size_t i;
+
+    if (ring == NULL)
+        return;
+    for (i = 0; i < ring->num; i++) {
+        EVP_CIPHER_CTX_free(ring->keys[i].enc_tmpl);
+        EVP_CIPHER_CTX_free(ring->keys[i].dec_tmpl);
+        EVP_MAC_CTX_free(ring->keys[i].mac_tmpl);
+    }
+    OPENSSL_secure_clear_free(ring->keys, ring->num * sizeof(*ring->keys));
+    OPENSSL_free(ring);
+}
+
+/*
+ * Key the template contexts of |key|.  They are left NULL if the algorithms
+ * are not available, in which case tickets are handled the slow way.
+ */
+static void ticket_key_prepare(SSL_TICKET_KEY *key, EVP_CIPHER *cipher,
+                               EVP_MAC *mac)
+{
+    OSSL_PARAM params[2];
+
+    if (cipher != NULL) {
+        key->enc_tmpl = EVP_CIPHER_CTX_new();
+        key->dec_tmpl = EVP_CIPHER_CTX_new();
+        if (key->enc_tmpl == NULL || key->dec_tmpl == NULL
+                || !EVP_EncryptInit_ex(key->enc_tmpl, cipher, NULL,
+                                       key->aes_key, NULL)
+                || !EVP_DecryptInit_ex(key->dec_tmpl, cipher, NULL,
+                                       key->aes_key, NULL)) {
+            EVP_CIPHER_CTX_free(key->enc_tmpl);
+            EVP_CIPHER_CTX_free(key->dec_tmpl);
+            key->enc_tmpl = key->dec_tmpl = NULL;
+        }
+    }
+    if (mac != NULL) {
+        params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+                                                     "SHA256", 0);
+        params[1] = OSSL_PARAM_construct_end();
+        key->mac_tmpl = EVP_MAC_CTX_new(mac);
+        if (key->mac_tmpl == NULL
+                || !EVP_MAC_init(key->mac_tmpl, key->hmac_key,
+                                 sizeof(key->hmac_key), params)) {
+            EVP_MAC_CTX_free(key->mac_tmpl);
+            key->mac_tmpl = NULL;
+        }
+    }
+}
+
+/*
+ * Build a keyring from |num| keys, each laid out as for
+ * SSL_CTX_set_tlsext_ticket_keys(): name, HMAC key, AES key.
+ */
+static SSL_TICKET_KEYRING *ticket_keyring_new(SSL_CTX *ctx,
+                                              const unsigned char *keys,
+                                              size_t num)
+{
+    SSL_TICKET_KEYRING *ring;
+    SSL_TICKET_KEY *key;
+    EVP_CIPHER *cipher;
+    EVP_MAC *mac;
+    size_t i;
+
+    if ((ring = OPENSSL_zalloc(sizeof(*ring))) == NULL)
+        return NULL;
+    if ((ring->keys = OPENSSL_secure_zalloc(num * sizeof(*ring->keys)))
+            == NULL) {
+        OPENSSL_free(ring);
+        return NULL;
+    }
+    ring->num = num;
+
+    ERR_set_mark();
+    cipher = EVP_CIPHER_fetch(ctx->libctx, "AES-256-CBC", ctx->propq);
+    mac = EVP_MAC_fetch(ctx->libctx, "HMAC", ctx->propq);
+    for (i = 0; i < num; i++, keys += TICKET_KEY_LENGTH) {
+        key = &ring->keys[i];
+        memcpy(key->name, keys, sizeof(key->name));
+        memcpy(key->hmac_key, keys + sizeof(key->name),
+               sizeof(key->hmac_key));
+        memcpy(key->aes_key, keys + sizeof(key->name) + sizeof(key->hmac_key),
+               sizeof(key->aes_key));
+        ticket_key_prepare(key, cipher, mac);
+    }
+    ERR_pop_to_mark();
+    EVP_CIPHER_free(cipher);
+    EVP_MAC_free(mac);
+    return ring;
+}
+
+/* The current keyring, only to be called by writers */
+static SSL_TICKET_KEYRING *ticket_keyring_current(SSL_CTX *ctx)
+{
+    uint64_t gen;
+
+    if (!CRYPTO_atomic_load(&ctx->ext.tick_keyring_gen, &gen, ctx->lock))
+        return NULL;
+    return ctx->ext.tick_keyring[gen & 1];
+}
+
+/*
+ * Make |ring| the current keyring.  Must be called with tick_keyring_lock
+ * held, which serialises writers.
+ */
+static int ticket_keyring_publish(SSL_CTX *ctx, SSL_TICKET_KEYRING *ring)
+{
+    uint64_t gen;
+    int slot, readers;
+
+    if (!CRYPTO_atomic_load(&ctx->ext.tick_keyring_gen, &gen, ctx->lock))
+        return 0;
+    slot = (int)((gen + 1) & 1);
+
+    /*
+     * Wait for the readers still using the keyring that was replaced last
+     * time.  New readers only pin the current slot, so this terminates
+     * quickly: those readers are just copying a template.  A
+     * read-modify-write is used to read the counter so that it is ordered
+     * after the generation update of the previous writer.
+     */
+    for (;;) {
+        if (!CRYPTO_atomic_add(&ctx->ext.tick_keyring_readers[slot], 0,
+                               &readers, ctx->lock))
+            return 0;
+        if (readers == 0)
+            break;
+        OSSL_sleep(0);
+    }
+
+    ticket_keyring_free(ctx->ext.tick_keyring[slot]);
+    ctx->ext.tick_keyring[slot] = ring;
+    return CRYPTO_atomic_add64(&ctx->ext.tick_keyring_gen, 1, &gen,
+                               ctx->lock);
+}
+
+static void ticket_keyring_release(SSL_CTX *ctx, int slot)
+{
+    int readers;
+
+    CRYPTO_atomic_add(&ctx->ext.tick_keyring_readers[slot], -1, &readers,
+                      ctx->lock);
+}
+
+/*
+ * Pin the current keyring.  It stays valid until released with
+ * ticket_keyring_release(ctx, *slot).
+ */
+static const SSL_TICKET_KEYRING *ticket_keyring_acquire(SSL_CTX *ctx,
+                                                        int *slot)
+{
+    uint64_t gen, gen2;
+    int readers;
+
+    for (;;) {
+        if (!CRYPTO_atomic_load(&ctx->ext.tick_keyring_gen, &gen, ctx->lock))
+            return NULL;
+        *slot = (int)(gen & 1);
+        if (!CRYPTO_atomic_add(&ctx->ext.tick_keyring_readers[*slot], 1,
+                               &readers, ctx->lock))
+            return NULL;
+        if (!CRYPTO_atomic_load(&ctx->ext.tick_keyring_gen, &gen2,
+                                ctx->lock)) {
+            ticket_keyring_release(ctx, *slot);
+            return NULL;
+        }
+        if (gen2 == gen)
+            return ctx->ext.tick_keyring[*slot];
+        /* A writer got in between, retry with the new keyring */
+        ticket_keyring_release(ctx, *slot);
+    }
+}
+
+/*
+ * Set up |ctx| and |*hctx| for the ticket key |key|.  When encrypting a
+ * fresh IV is written to |iv|, otherwise |iv| is the one from the ticket.
+ */
+static int ticket_key_ctx_init(SSL_CTX *tctx, const SSL_TICKET_KEY *key,
+                               EVP_CIPHER_CTX *ctx, SSL_HMAC **hctx,
+                               unsigned char *iv, int enc)
+{
+    const EVP_CIPHER_CTX *tmpl = enc ? key->enc_tmpl : key->dec_tmpl;
+    EVP_CIPHER *cipher = NULL;
+    int iv_len, ok = 0;
+
+    if (tmpl != NULL && key->mac_tmpl != NULL) {
+        if (!EVP_CIPHER_CTX_copy(ctx, tmpl))
+            return 0;
+        *hctx = ssl_hmac_dup_EVP_MAC_CTX(key->mac_tmpl);
+    } else {
+        /* The algorithms were not available when the keyring was built */
+        cipher = EVP_CIPHER_fetch(tctx->libctx, "AES-256-CBC", tctx->propq);
+        if (cipher == NULL
+                || !EVP_CipherInit_ex(ctx, cipher, NULL, key->aes_key, NULL,
+                                      enc))
+            goto end;
+        *hctx = ssl_hmac_new(tctx);
+        if (*hctx != NULL
+                && !ssl_hmac_init(*hctx, (void *)key->hmac_key,
+                                  sizeof(key->hmac_key), "SHA256")) {
+            ssl_hmac_free(*hctx);
+            *hctx = NULL;
+        }
+    }
+    if (*hctx == NULL)
+        goto end;
+
+    iv_len = EVP_CIPHER_CTX_get_iv_length(ctx);
+    if (iv_len < 0
+            || (enc && RAND_bytes_ex(tctx->libctx, iv, iv_len, 0) <= 0)
+            || !EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, enc))
+        goto end;
+    ok = 1;
+ end:
+    EVP_CIPHER_free(cipher);
+    return ok;
+}
+
+/*
+ * Set up the contexts to encrypt a new ticket with the current key of
+ * |tctx|, writing the key name and a fresh IV.
+ */
+int ssl_ticket_key_encrypt_init(SSL_CTX *tctx, EVP_CIPHER_CTX *ctx,
+                                SSL_HMAC **hctx, unsigned char *key_name,
+                                unsigned char *iv)
+{
+    const SSL_TICKET_KEYRING *ring;
+    int slot, ok = 0;
+
+    if ((ring = ticket_keyring_acquire(tctx, &slot)) == NULL)
+        return 0;
+    if (ring->num > 0
+            && ticket_key_ctx_init(tctx, &ring->keys[0], ctx, hctx, iv, 1)) {
+        memcpy(key_name, ring->keys[0].name, TLSEXT_KEYNAME_LENGTH);
+        ok = 1;
+    }
+    ticket_keyring_release(tctx, slot);
+    return ok;
+}
+
+/*
+ * Set up the contexts to decrypt a ticket starting with |key_name| and |iv|.
+ * Returns 1 on success, 0 if no key of |tctx| matches the name and -1 on
+ * error.  |*renew| is set if the ticket was made with a key that no longer
+ * encrypts new tickets.
+ */
+int ssl_ticket_key_decrypt_init(SSL_CTX *tctx, const unsigned char *key_name,
+                                const unsigned char *iv, EVP_CIPHER_CTX *ctx,
+                                SSL_HMAC **hctx, int *renew)
+{
+    const SSL_TICKET_KEYRING *ring;
+    size_t i;
+    int slot, ret = 0;
+
+    if ((ring = ticket_keyring_acquire(tctx, &slot)) == NULL)
+        return -1;
+    for (i = 0; i < ring->num; i++) {
+        if (memcmp(key_name, ring->keys[i].name, TLSEXT_KEYNAME_LENGTH) != 0)
+            continue;
+        ret = ticket_key_ctx_init(tctx, &ring->keys[i], ctx, hctx,
+                                  (unsigned char *)iv, 0) ? 1 : -1;
+        *renew = i > 0;
+        break;
+    }
+    ticket_keyring_release(tctx, slot);
+    return ret;
+}
+
+/*
+ * Replace the keys of |ctx| with the |len| bytes at |keys|, a multiple of
+ * TICKET_KEY_LENGTH.
+ */
+int ssl_ticket_keys_set(SSL_CTX *ctx, const unsigned char *keys, size_t len)
+{
+    SSL_TICKET_KEYRING *ring;
+    int ok;
+
+    if (len == 0 || len % TICKET_KEY_LENGTH != 0) {
+        ERR_raise(ERR_LIB_SSL, SSL_R_INVALID_TICKET_KEYS_LENGTH);
+        return 0;
+    }
+    if ((ring = ticket_keyring_new(ctx, keys, len / TICKET_KEY_LENGTH))
+            == NULL)
+        return 0;
+    if (!CRYPTO_THREAD_write_lock(ctx->ext.tick_keyring_lock)) {
+        ticket_keyring_free(ring);
+        return 0;
+    }
+    ok = ticket_keyring_publish(ctx, ring);
+    CRYPTO_THREAD_unlock(ctx->ext.tick_keyring_lock);
+    if (!ok)
+        ticket_keyring_free(ring);
+    return ok;
+}
+
+/*
+ * Copy the keys of |ctx| to |keys|.  If |keys| is NULL just return the
+ * length needed.
+ */
+long ssl_ticket_keys_get(SSL_CTX *ctx, unsigned char *keys, size_t len)
+{
+    const SSL_TICKET_KEYRING *ring;
+    const SSL_TICKET_KEY *key;
+    long ret = 0;
+    size_t i;
+
+    if (!CRYPTO_THREAD_read_lock(ctx->ext.tick_keyring_lock))
+        return 0;
+    if ((ring = ticket_keyring_current(ctx)) == NULL)
+        goto end;
+    if (keys == NULL) {
+        ret = (long)(ring->num * TICKET_KEY_LENGTH);
+        goto end;
+    }
+    if (len != ring->num * TICKET_KEY_LENGTH) {
+        ERR_raise(ERR_LIB_SSL, SSL_R_INVALID_TICKET_KEYS_LENGTH);
+        goto end;
+    }
+    for (i = 0; i < ring->num; i++, keys += TICKET_KEY_LENGTH) {
+        key = &ring->keys[i];
+        memcpy(keys, key->name, sizeof(key->name));
+        memcpy(keys + sizeof(key->name), key->hmac_key,
+               sizeof(key->hmac_key));
+        memcpy(keys + sizeof(key->name) + sizeof(key->hmac_key),
+               key->aes_key, sizeof(key->aes_key));
+    }
+    ret = 1;
+ end:
+    CRYPTO_THREAD_unlock(ctx->ext.tick_keyring_lock);
+    return ret;
+}
+
+static int ticket_key_generate(SSL_CTX *ctx, unsigned char *key)
+{
+    return RAND_bytes_ex(ctx->libctx, key, TLSEXT_KEYNAME_LENGTH, 0) > 0
+        && RAND_priv_bytes_ex(ctx->libctx, key + TLSEXT_KEYNAME_LENGTH,
+                              2 * TLSEXT_TICK_KEY_LENGTH, 0) > 0;
+}
+
+int SSL_CTX_rotate_ticket_keys(SSL_CTX *ctx, size_t max_keys)
+{
+    SSL_TICKET_KEYRING *ring, *cur;
+    unsigned char *keys = NULL;
+    size_t num = 0, i;
+    int ok = 0;
+
+    if (max_keys == 0) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_PASSED_INVALID_ARGUMENT);
+        return 0;
+    }
+    if (!CRYPTO_THREAD_write_lock(ctx->ext.tick_keyring_lock))
+        return 0;
+    if ((cur = ticket_keyring_current(ctx)) == NULL)
+        goto end;
+
+    num = cur->num + 1 < max_keys ? cur->num + 1 : max_keys;
+    if ((keys = OPENSSL_secure_malloc(num * TICKET_KEY_LENGTH)) == NULL)
+        goto end;
+    if (!ticket_key_generate(ctx, keys)) {
+        ERR_raise(ERR_LIB_SSL, ERR_R_RAND_LIB);
+        goto end;
+    }
+    for (i = 1; i < num; i++) {
+        unsigned char *p = keys + i * TICKET_KEY_LENGTH;
+        const SSL_TICKET_KEY *key = &cur->keys[i - 1];
+
+        memcpy(p, key->name, sizeof(key->name));
+        memcpy(p + sizeof(key->name), key->hmac_key, sizeof(key->hmac_key));
+        memcpy(p + sizeof(key->name) + sizeof(key->hmac_key), key->aes_key,
+               sizeof(key->aes_key));
+    }
+
+    if ((ring = ticket_keyring_new(ctx, keys, num)) == NULL)
+        goto end;
+    if (!ticket_keyring_publish(ctx, ring)) {
+        ticket_keyring_free(ring);
+        goto end;
+    }
+    ok = 1;
+ end:
+    CRYPTO_THREAD_unlock(ctx->ext.tick_keyring_lock);
+    OPENSSL_secure_clear_free(keys, num * TICKET_KEY_LENGTH);
+    return ok;
+}
+
+/*
+ * Give |ctx| a single random ticket key.  If no random key can be generated
+ * tickets are disabled.
+ */
+int ssl_ticket_keys_init(SSL_CTX *ctx)
+{
+    unsigned char *key;
+    int ok = 0;
+
+    if ((ctx->ext.tick_keyring_lock = CRYPTO_THREAD_lock_new()) == NULL)
+        return 0;
+    if ((key = OPENSSL_secure_zalloc(TICKET_KEY_LENGTH)) == NULL)
+        return 0;
+    if (!ticket_key_generate(ctx, key))
+        ctx->options |= SSL_OP_NO_TICKET;
+    ctx->ext.tick_keyring[0] = ticket_keyring_new(ctx, key, 1);
+    ok = ctx->ext.tick_keyring[0] != NULL;
+    OPENSSL_secure_clear_free(key, TICKET_KEY_LENGTH);
+    return ok;
+}
+
+void ssl_ticket_keys_free(SSL_CTX *ctx)
+{
+    ticket_keyring_free(ctx->ext.tick_keyring[0]);
+    ticket_keyring_free(ctx->ext.tick_keyring[1]);
+    ctx->ext.tick_keyring[0] = ctx->ext.tick_keyring[1] = NULL;
+    CRYPTO_THREAD_lock_free(ctx->ext.tick_keyring_lock);
+    ctx->ext.tick_keyring_lock = NULL;
+}
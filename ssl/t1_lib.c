@@ -3099,11 +3099,6 @@ SSL_TICKET_STATUS tls_decrypt_ticket(SSL_CONNECTION *s,
     }
 
     /* Initialize session ticket encryption and HMAC contexts */
-    hctx = ssl_hmac_new(tctx);
-    if (hctx == NULL) {
-        ret = SSL_TICKET_FATAL_ERR_MALLOC;
-        goto end;
-    }
     ctx = EVP_CIPHER_CTX_new();
     if (ctx == NULL) {
         ret = SSL_TICKET_FATAL_ERR_MALLOC;
@@ -3118,6 +3113,12 @@ SSL_TICKET_STATUS tls_decrypt_ticket(SSL_CONNECTION *s,
         unsigned char *nctick = (unsigned char *)etick;
         int rv = 0;
 
+        hctx = ssl_hmac_new(tctx);
+        if (hctx == NULL) {
+            ret = SSL_TICKET_FATAL_ERR_MALLOC;
+            goto end;
+        }
+
         if (tctx->ext.ticket_key_evp_cb != NULL)
             rv = tctx->ext.ticket_key_evp_cb(SSL_CONNECTION_GET_USER_SSL(s),
                                              nctick,
@@ -3143,29 +3144,19 @@ SSL_TICKET_STATUS tls_decrypt_ticket(SSL_CONNECTION *s,
         if (rv == 2)
             renew_ticket = 1;
     } else {
-        EVP_CIPHER *aes256cbc = NULL;
+        /* Find the key by name, tickets from older keys are renewed */
+        int rv = ssl_ticket_key_decrypt_init(tctx, etick,
+                                             etick + TLSEXT_KEYNAME_LENGTH,
+                                             ctx, &hctx, &renew_ticket);
 
-        /* Check key name matches */
-        if (memcmp(etick, tctx->ext.tick_key_name,
-                   TLSEXT_KEYNAME_LENGTH) != 0) {
-            ret = SSL_TICKET_NO_DECRYPT;
+        if (rv < 0) {
+            ret = SSL_TICKET_FATAL_ERR_OTHER;
             goto end;
         }
-
-        aes256cbc = EVP_CIPHER_fetch(sctx->libctx, "AES-256-CBC",
-                                     sctx->propq);
-        if (aes256cbc == NULL
-            || ssl_hmac_init(hctx, tctx->ext.secure->tick_hmac_key,
-                             sizeof(tctx->ext.secure->tick_hmac_key),
-                             "SHA256") <= 0
-            || EVP_DecryptInit_ex(ctx, aes256cbc, NULL,
-                                  tctx->ext.secure->tick_aes_key,
-                                  etick + TLSEXT_KEYNAME_LENGTH) <= 0) {
-            EVP_CIPHER_free(aes256cbc);
-            ret = SSL_TICKET_FATAL_ERR_OTHER;
+        if (rv == 0) {
+            ret = SSL_TICKET_NO_DECRYPT;
             goto end;
         }
-        EVP_CIPHER_free(aes256cbc);
         if (SSL_CONNECTION_IS_TLS13(s))
             renew_ticket = 1;
     }
@@ -4844,6 +4835,20 @@ SSL_HMAC *ssl_hmac_new(const SSL_CTX *ctx)
     return NULL;
 }
 
+/* Start from a copy of |src|, which has already been keyed */
+SSL_HMAC *ssl_hmac_dup_EVP_MAC_CTX(const EVP_MAC_CTX *src)
+{
+    SSL_HMAC *ret = OPENSSL_zalloc(sizeof(*ret));
+
+    if (ret == NULL)
+        return NULL;
+    if ((ret->ctx = EVP_MAC_CTX_dup(src)) == NULL) {
+        OPENSSL_free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
 void ssl_hmac_free(SSL_HMAC *ctx)
 {
     if (ctx != NULL) {
@@ -452,6 +452,147 @@ static int test_bio_dgram(int idx)
                                bio_dgram_cases[idx].local);
 }
 
+#define SEG_NUM     8
+#define SEG_LEN     1200
+#define SEG_LAST    700
+
+static int test_bio_dgram_segmentation(void)
+{
+    int testresult = 0;
+    BIO *b1 = NULL, *b2 = NULL, *bmem = NULL;
+    int fd1 = -1, fd2 = -1;
+    BIO_ADDR *addr1 = NULL, *addr2 = NULL, *peer = NULL;
+    union BIO_sock_info_u info1 = {0}, info2 = {0};
+    struct in_addr ina;
+    static unsigned char tx_buf[SEG_NUM][SEG_LEN], rx_buf[SEG_NUM][1500];
+    static unsigned char super_buf[65536];
+    BIO_MSG tx_msg[SEG_NUM], rx_msg[SEG_NUM];
+    const uint32_t both = BIO_DGRAM_SEGMENTATION_TX | BIO_DGRAM_SEGMENTATION_RX;
+    size_t i, num_processed = 0, total = 0;
+    int ret;
+
+    /* Only datagram sockets can offload segmentation */
+    if (!TEST_ptr(bmem = BIO_new(BIO_s_mem()))
+        || !TEST_uint_eq(BIO_dgram_get_segmentation_cap(bmem), 0)
+        || !TEST_false(BIO_dgram_set_segmentation(bmem,
+                                                  BIO_DGRAM_SEGMENTATION_TX)))
+        goto err;
+
+    ina.s_addr = htonl(0x7f000001UL);
+    if (!TEST_ptr(addr1 = BIO_ADDR_new())
+        || !TEST_ptr(addr2 = BIO_ADDR_new())
+        || !TEST_ptr(peer = BIO_ADDR_new())
+        || !TEST_true(BIO_ADDR_rawmake(addr1, AF_INET, &ina, sizeof(ina), 0))
+        || !TEST_true(BIO_ADDR_rawmake(addr2, AF_INET, &ina, sizeof(ina), 0)))
+        goto err;
+
+    fd1 = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0);
+    fd2 = BIO_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, 0);
+    if (!TEST_int_ge(fd1, 0)
+        || !TEST_int_ge(fd2, 0)
+        || !TEST_true(BIO_bind(fd1, addr1, 0))
+        || !TEST_true(BIO_bind(fd2, addr2, 0)))
+        goto err;
+
+    info1.addr = addr1;
+    info2.addr = addr2;
+    if (!TEST_int_gt(BIO_sock_info(fd1, BIO_SOCK_INFO_ADDRESS, &info1), 0)
+        || !TEST_int_gt(BIO_sock_info(fd2, BIO_SOCK_INFO_ADDRESS, &info2), 0)
+        || !TEST_ptr(b1 = BIO_new_dgram(fd1, 0))
+        || !TEST_ptr(b2 = BIO_new_dgram(fd2, 0)))
+        goto err;
+
+    if (BIO_dgram_get_segmentation_cap(b1) != both) {
+        testresult = TEST_skip("UDP segmentation offload is not available");
+        goto err;
+    }
+
+    if (!TEST_true(BIO_dgram_set_segmentation(b1, BIO_DGRAM_SEGMENTATION_TX))
+        || !TEST_uint_eq(BIO_dgram_get_segmentation(b1),
+                         BIO_DGRAM_SEGMENTATION_TX)
+        || !TEST_true(BIO_dgram_set_segmentation(b2, BIO_DGRAM_SEGMENTATION_RX))
+        || !TEST_uint_eq(BIO_dgram_get_segmentation(b2),
+                         BIO_DGRAM_SEGMENTATION_RX))
+        goto err;
+
+    memset(tx_msg, 0, sizeof(tx_msg));
+    for (i = 0; i < SEG_NUM; ++i) {
+        memset(tx_buf[i], (int)i + 1, SEG_LEN);
+        tx_msg[i].data      = tx_buf[i];
+        tx_msg[i].data_len  = i < SEG_NUM - 1 ? SEG_LEN : SEG_LAST;
+        tx_msg[i].peer      = addr2;
+        total += tx_msg[i].data_len;
+    }
+
+    /*
+     * Send the datagrams twice. The kernel keeps a GSO train together on
+     * loopback, so a receiver with GRO enabled gets it with a single recv().
+     */
+    for (i = 0; i < 2; ++i)
+        if (!TEST_true(do_sendmmsg(b1, tx_msg, SEG_NUM, 0, &num_processed))
+            || !TEST_size_t_eq(num_processed, SEG_NUM))
+            goto err;
+
+    ret = recv(fd2, (void *)super_buf, sizeof(super_buf), 0);
+    if (!TEST_int_eq(ret, (int)total))
+        goto err;
+
+    /*
+     * The BIO splits the second train up again, also when the caller does not
+     * take all datagrams at once.
+     */
+    memset(rx_msg, 0, sizeof(rx_msg));
+    for (i = 0; i < SEG_NUM; ++i) {
+        rx_msg[i].data      = rx_buf[i];
+        rx_msg[i].data_len  = sizeof(rx_buf[i]);
+        rx_msg[i].peer      = peer;
+    }
+
+    if (!TEST_true(BIO_recvmmsg(b2, rx_msg, sizeof(BIO_MSG), 3, 0,
+                                &num_processed))
+        || !TEST_size_t_eq(num_processed, 3)
+        || !TEST_true(do_recvmmsg(b2, rx_msg + 3, SEG_NUM - 3, 0,
+                                  &num_processed))
+        || !TEST_size_t_eq(num_processed, SEG_NUM - 3)
+        || !TEST_int_eq(compare_addr(peer, addr1), 1))
+        goto err;
+
+    for (i = 0; i < SEG_NUM; ++i)
+        if (!TEST_mem_eq(rx_msg[i].data, rx_msg[i].data_len,
+                         tx_msg[i].data, tx_msg[i].data_len))
+            goto err;
+
+    /* BIO_read() also returns one datagram at a time */
+    if (!TEST_true(do_sendmmsg(b1, tx_msg, SEG_NUM, 0, &num_processed))
+        || !TEST_size_t_eq(num_processed, SEG_NUM))
+        goto err;
+    for (i = 0; i < SEG_NUM; ++i) {
+        ret = BIO_read(b2, rx_buf[i], sizeof(rx_buf[i]));
+        if (!TEST_int_gt(ret, 0)
+            || !TEST_mem_eq(rx_buf[i], ret, tx_msg[i].data,
+                            tx_msg[i].data_len))
+            goto err;
+    }
+
+    if (!TEST_true(BIO_dgram_set_segmentation(b2, 0))
+        || !TEST_uint_eq(BIO_dgram_get_segmentation(b2), 0))
+        goto err;
+
+    testresult = 1;
+err:
+    BIO_free(bmem);
+    BIO_free(b1);
+    BIO_free(b2);
+    if (fd1 >= 0)
+        BIO_closesocket(fd1);
+    if (fd2 >= 0)
+        BIO_closesocket(fd2);
+    BIO_ADDR_free(addr1);
+    BIO_ADDR_free(addr2);
+    BIO_ADDR_free(peer);
+    return testresult;
+}
+
 # if !defined(OPENSSL_NO_CHACHA)
 static int random_data(const uint32_t *key, uint8_t *data, size_t data_len, size_t offset)
 {
@@ -785,6 +926,7 @@ int setup_tests(void)
 
 #if !defined(OPENSSL_NO_DGRAM) && !defined(OPENSSL_NO_SOCK)
     ADD_ALL_TESTS(test_bio_dgram, OSSL_NELEM(bio_dgram_cases));
+    ADD_TEST(test_bio_dgram_segmentation);
 # if !defined(OPENSSL_NO_CHACHA)
     ADD_ALL_TESTS(test_bio_dgram_pair, 3);
 # endif
@@ -22,6 +22,7 @@
 # include <openssl/bn.h>
 # include <openssl/ec.h>
 # include <openssl/rand.h>
+# include <openssl/core_names.h>
 # include "internal/nelem.h"
 # include "ecdsatest.h"
 
@@ -386,6 +387,79 @@ static int test_ecdsa_sig_NULL(void)
     return ret;
 }
 
+/*
+ * Verify enough times with one key that a table of multiples of its public
+ * key is made, and check that it gives the same answers, also once the key
+ * has been replaced and when the table is requested through a parameter.
+ */
+static int test_builtin_pub_precomp(int n)
+{
+    EC_KEY *eckey = NULL, *eckey2 = NULL;
+    ECDSA_SIG *sig[2] = { NULL, NULL }, *sig2 = NULL;
+    EVP_PKEY *pkey = NULL;
+    EVP_PKEY_CTX *pctx = NULL;
+    OSSL_PARAM params[2];
+    unsigned char dgst[2][32], *der = NULL;
+    int derlen, precompute = 1, nid = curves[n].nid, i, ret = 0;
+
+    /* skip built-in curves where ord(G) is not prime, and SM2 */
+    if (nid == NID_ipsec4 || nid == NID_ipsec3 || nid == NID_sm2)
+        return 1;
+
+    if (!TEST_int_gt(RAND_bytes(dgst[0], sizeof(dgst)), 0)
+        || !TEST_ptr(eckey = EC_KEY_new_by_curve_name(nid))
+        || !TEST_true(EC_KEY_generate_key(eckey))
+        || !TEST_ptr(eckey2 = EC_KEY_new_by_curve_name(nid))
+        || !TEST_true(EC_KEY_generate_key(eckey2))
+        || !TEST_ptr(sig[0] = ECDSA_do_sign(dgst[0], sizeof(dgst[0]), eckey))
+        || !TEST_ptr(sig[1] = ECDSA_do_sign(dgst[1], sizeof(dgst[1]), eckey))
+        || !TEST_ptr(sig2 = ECDSA_do_sign(dgst[0], sizeof(dgst[0]), eckey2)))
+        goto err;
+
+    for (i = 0; i < 80; i++)
+        if (!TEST_int_eq(ECDSA_do_verify(dgst[i & 1], sizeof(dgst[0]),
+                                         sig[(i >> 1) & 1], eckey),
+                         (i & 1) == ((i >> 1) & 1)))
+            goto err;
+
+    /* a new public key must not be checked against the old table */
+    if (!TEST_true(EC_KEY_set_public_key(eckey,
+                                         EC_KEY_get0_public_key(eckey2))))
+        goto err;
+    for (i = 0; i < 80; i++)
+        if (!TEST_int_eq(ECDSA_do_verify(dgst[0], sizeof(dgst[0]),
+                                         (i & 1) ? sig2 : sig[0], eckey),
+                         i & 1))
+            goto err;
+
+    /* request the table up front through the signature parameter */
+    params[0] = OSSL_PARAM_construct_int(OSSL_SIGNATURE_PARAM_KEY_PRECOMPUTE,
+                                         &precompute);
+    params[1] = OSSL_PARAM_construct_end();
+    if (!TEST_int_gt(derlen = i2d_ECDSA_SIG(sig2, &der), 0)
+        || !TEST_ptr(pkey = EVP_PKEY_new())
+        || !TEST_true(EVP_PKEY_set1_EC_KEY(pkey, eckey2))
+        || !TEST_ptr(pctx = EVP_PKEY_CTX_new(pkey, NULL))
+        || !TEST_int_eq(EVP_PKEY_verify_init_ex(pctx, params), 1)
+        || !TEST_int_eq(EVP_PKEY_verify(pctx, der, derlen, dgst[0],
+                                        sizeof(dgst[0])), 1)
+        || !TEST_int_eq(EVP_PKEY_verify(pctx, der, derlen, dgst[1],
+                                        sizeof(dgst[1])), 0))
+        goto err;
+
+    ret = 1;
+ err:
+    EVP_PKEY_CTX_free(pctx);
+    EVP_PKEY_free(pkey);
+    OPENSSL_free(der);
+    ECDSA_SIG_free(sig[0]);
+    ECDSA_SIG_free(sig[1]);
+    ECDSA_SIG_free(sig2);
+    EC_KEY_free(eckey);
+    EC_KEY_free(eckey2);
+    return ret;
+}
+
 #endif /* OPENSSL_NO_EC */
 
 int setup_tests(void)
@@ -405,6 +479,7 @@ int setup_tests(void)
         return 0;
     }
     ADD_ALL_TESTS(test_builtin_as_ec, (int)crv_len);
+    ADD_ALL_TESTS(test_builtin_pub_precomp, (int)crv_len);
     ADD_TEST(test_ecdsa_sig_NULL);
 # ifndef OPENSSL_NO_SM2
     ADD_ALL_TESTS(test_builtin_as_sm2, (int)crv_len);
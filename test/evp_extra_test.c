@@ -1663,6 +1663,161 @@ static int test_EVP_PKEY_sign(int tst)
     return ret;
 }
 
+/*
+ * Test EVP_PKEY_verify_batch() with all signatures valid, and with one of
+ * them made invalid by altering the message.
+ * Test 0: ED25519 (verified as a batch)
+ * Test 1: EC (verified one by one)
+ */
+#define BATCH_SIZE 16
+static int test_EVP_PKEY_verify_batch(int tst)
+{
+    int ret = 0;
+    EVP_PKEY *pkey = NULL;
+    EVP_PKEY_CTX *ctx = NULL;
+    EVP_SIGNATURE *alg = NULL;
+    unsigned char msgs[BATCH_SIZE][40];
+    unsigned char *sigs[BATCH_SIZE] = { NULL };
+    const unsigned char *csigs[BATCH_SIZE], *tbs[BATCH_SIZE];
+    size_t siglens[BATCH_SIZE], tbslens[BATCH_SIZE];
+    int results[BATCH_SIZE];
+    size_t i, bad = 5;
+
+    if (tst == 0) {
+#ifndef OPENSSL_NO_ECX
+        if (!TEST_ptr(pkey = load_example_ed25519_key())
+                || !TEST_ptr(alg = EVP_SIGNATURE_fetch(testctx, "ED25519",
+                                                       NULL)))
+            goto out;
+#else
+        ret = 1;
+        goto out;
+#endif
+    } else {
+#ifndef OPENSSL_NO_EC
+        if (!TEST_ptr(pkey = load_example_ec_key()))
+            goto out;
+#else
+        ret = 1;
+        goto out;
+#endif
+    }
+
+    if (!TEST_ptr(ctx = EVP_PKEY_CTX_new_from_pkey(testctx, pkey, NULL)))
+        goto out;
+    for (i = 0; i < BATCH_SIZE; i++) {
+        memset(msgs[i], (int)i, sizeof(msgs[i]));
+        tbs[i] = msgs[i];
+        /* EC signs a digest, keep it at SHA-1 size */
+        tbslens[i] = tst == 0 ? 8 + 2 * i : 20;
+        if ((alg != NULL
+             ? !TEST_int_gt(EVP_PKEY_sign_message_init(ctx, alg, NULL), 0)
+             : !TEST_int_gt(EVP_PKEY_sign_init(ctx), 0))
+                || !TEST_int_gt(EVP_PKEY_sign(ctx, NULL, &siglens[i], tbs[i],
+                                       tbslens[i]), 0)
+                || !TEST_ptr(sigs[i] = OPENSSL_malloc(siglens[i]))
+                || !TEST_int_gt(EVP_PKEY_sign(ctx, sigs[i], &siglens[i],
+                                              tbs[i], tbslens[i]), 0))
+            goto out;
+        csigs[i] = sigs[i];
+    }
+
+    if ((alg != NULL
+         ? !TEST_int_gt(EVP_PKEY_verify_message_init(ctx, alg, NULL), 0)
+         : !TEST_int_gt(EVP_PKEY_verify_init(ctx), 0))
+            || !TEST_int_eq(EVP_PKEY_verify_batch(ctx, csigs, siglens, tbs,
+                                                  tbslens, BATCH_SIZE,
+                                                  results), 1))
+        goto out;
+    for (i = 0; i < BATCH_SIZE; i++)
+        if (!TEST_int_eq(results[i], 1))
+            goto out;
+
+    msgs[bad][0] ^= 1;
+    if (!TEST_int_eq(EVP_PKEY_verify_batch(ctx, csigs, siglens, tbs, tbslens,
+                                           BATCH_SIZE, results), 0))
+        goto out;
+    for (i = 0; i < BATCH_SIZE; i++)
+        if (!TEST_int_eq(results[i], i != bad))
+            goto out;
+
+    ret = 1;
+ out:
+    EVP_PKEY_CTX_free(ctx);
+    EVP_SIGNATURE_free(alg);
+    for (i = 0; i < BATCH_SIZE; i++)
+        OPENSSL_free(sigs[i]);
+    EVP_PKEY_free(pkey);
+    return ret;
+}
+
+#ifndef OPENSSL_NO_ECX
+/*
+ * Ed25519 batch verification must give the same results as single
+ * verification for points of small order.  With the neutral element as
+ * public key, R = neutral element and S = 0 is a valid signature for any
+ * message.  So is R = (0, -1), which has order 2, with the cofactored
+ * equation.  S = 1 is not valid with either of them.
+ */
+static int test_EVP_PKEY_verify_batch_small_order(void)
+{
+    static const unsigned char neutral[32] = { 0x01 };
+    static const unsigned char order2[32] = {
+        0xec, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f
+    };
+    static const unsigned char msg[] = "small order";
+    int ret = 0;
+    EVP_PKEY *pkey = NULL;
+    EVP_PKEY_CTX *ctx = NULL;
+    EVP_SIGNATURE *alg = NULL;
+    unsigned char sigs[4][64] = { { 0 } };
+    const unsigned char *csigs[4], *tbs[4];
+    size_t siglens[4], tbslens[4];
+    int results[4];
+    size_t i;
+
+    for (i = 0; i < OSSL_NELEM(sigs); i++) {
+        memcpy(sigs[i], i == 1 || i == 2 ? order2 : neutral, 32);
+        csigs[i] = sigs[i];
+        siglens[i] = sizeof(sigs[i]);
+        tbs[i] = msg;
+        tbslens[i] = sizeof(msg) - 1 - i;
+    }
+    sigs[3][32] = 1;
+
+    if (!TEST_ptr(pkey = EVP_PKEY_new_raw_public_key_ex(testctx, "ED25519",
+                                                        NULL, neutral,
+                                                        sizeof(neutral)))
+            || !TEST_ptr(alg = EVP_SIGNATURE_fetch(testctx, "ED25519", NULL))
+            || !TEST_ptr(ctx = EVP_PKEY_CTX_new_from_pkey(testctx, pkey,
+                                                          NULL))
+            || !TEST_int_gt(EVP_PKEY_verify_message_init(ctx, alg, NULL), 0)
+            || !TEST_int_eq(EVP_PKEY_verify_batch(ctx, csigs, siglens, tbs,
+                                                  tbslens, OSSL_NELEM(sigs),
+                                                  results), 0))
+        goto out;
+
+    for (i = 0; i < OSSL_NELEM(sigs); i++)
+        if (!TEST_int_eq(results[i], i != 3)
+                || !TEST_int_gt(EVP_PKEY_verify_message_init(ctx, alg, NULL),
+                                0)
+                || !TEST_int_eq(EVP_PKEY_verify(ctx, sigs[i], siglens[i],
+                                                tbs[i], tbslens[i]) == 1,
+                                results[i]))
+            goto out;
+
+    ret = 1;
+ out:
+    EVP_PKEY_CTX_free(ctx);
+    EVP_SIGNATURE_free(alg);
+    EVP_PKEY_free(pkey);
+    return ret;
+}
+#endif
+
 #ifndef OPENSSL_NO_DEPRECATED_3_0
 static int test_EVP_PKEY_sign_with_app_method(int tst)
 {
@@ -6782,6 +6937,10 @@ int setup_tests(void)
     ADD_TEST(test_EVP_Digest);
     ADD_TEST(test_EVP_md_null);
     ADD_ALL_TESTS(test_EVP_PKEY_sign, 3);
+    ADD_ALL_TESTS(test_EVP_PKEY_verify_batch, 2);
+#ifndef OPENSSL_NO_ECX
+    ADD_TEST(test_EVP_PKEY_verify_batch_small_order);
+#endif
 #ifndef OPENSSL_NO_DEPRECATED_3_0
     ADD_ALL_TESTS(test_EVP_PKEY_sign_with_app_method, 2);
 #endif
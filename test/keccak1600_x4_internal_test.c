@@ -0,0 +1,81 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Internal tests for the four-way SHAKE used by the PQC samplers, against
+ * the one-state SHAKE128 and SHAKE256 digests.  Input lengths cover the
+ * empty input, partial blocks and several whole blocks.
+ */
+
+#include <string.h>
+#include <openssl/evp.h>
+#include "testutil.h"
+#include "internal/cryptlib.h"
+#include "internal/sha3.h"
+
+#define MAX_IN  (3 * 168 + 40)
+#define NBLOCKS 3
+
+static const size_t lengths[] = {
+    0, 1, 7, 8, 33, 34, 135, 136, 137, 167, 168, 169, 272, 336, 400, MAX_IN
+};
+
+static int test_shake_x4(int idx)
+{
+    static const int bits[] = { 128, 256 };
+    size_t len = lengths[idx / 2];
+    int bitlen = bits[idx % 2];
+    size_t outlen = NBLOCKS * SHA3_BLOCKSIZE(bitlen);
+    unsigned char in[4][MAX_IN], out[4][NBLOCKS * 168], ref[NBLOCKS * 168];
+    const unsigned char *const inp[4] = { in[0], in[1], in[2], in[3] };
+    unsigned char *const outp[4] = { out[0], out[1], out[2], out[3] };
+    KECCAK1600_X4_CTX ctx;
+    EVP_MD_CTX *mdctx = NULL;
+    EVP_MD *md = NULL;
+    size_t i, j;
+    int ret = 0;
+
+    for (j = 0; j < 4; j++)
+        for (i = 0; i < len; i++)
+            in[j][i] = (unsigned char)(i * 31 + j * 97 + (i >> 3));
+
+    ossl_shake_x4_init(&ctx, bitlen);
+    ossl_shake_x4_absorb(&ctx, inp, len);
+    ossl_shake_x4_squeeze(&ctx, outp, NBLOCKS);
+
+    if (!TEST_ptr(md = EVP_MD_fetch(NULL, bitlen == 128 ? "SHAKE128"
+                                                        : "SHAKE256", NULL))
+        || !TEST_ptr(mdctx = EVP_MD_CTX_new()))
+        goto err;
+    for (j = 0; j < 4; j++) {
+        if (!TEST_true(EVP_DigestInit_ex2(mdctx, md, NULL))
+            || !TEST_true(EVP_DigestUpdate(mdctx, in[j], len))
+            || !TEST_true(EVP_DigestFinalXOF(mdctx, ref, outlen))
+            || !TEST_mem_eq(out[j], outlen, ref, outlen)) {
+            TEST_info("SHAKE%d, input length %zu, instance %zu",
+                      bitlen, len, j);
+            goto err;
+        }
+    }
+    ret = 1;
+ err:
+    EVP_MD_CTX_free(mdctx);
+    EVP_MD_free(md);
+    return ret;
+}
+
+int setup_tests(void)
+{
+#ifdef OPENSSL_CPUID_OBJ
+    OPENSSL_cpuid_setup();
+#endif
+
+    ADD_ALL_TESTS(test_shake_x4, 2 * OSSL_NELEM(lengths));
+    return 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License 2.0 (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <openssl/crypto.h>
+#include <openssl/bn.h>
+
+#include "testutil.h"
+#include "threadstest.h"
+
+#define SLAB_MASK (~(uintptr_t)(64 * 1024 - 1))
+
+static int same_slab(const void *a, const void *b)
+{
+    return ((uintptr_t)a & SLAB_MASK) == ((uintptr_t)b & SLAB_MASK);
+}
+
+static int test_arena_alloc(void)
+{
+    unsigned char *p = NULL, *q = NULL, *big = NULL, *r;
+    int testresult = 0;
+
+    if (!TEST_true(CRYPTO_arena_begin()))
+        return 0;
+
+    /* Small allocations are carved out of the same slab */
+    if (!TEST_ptr(p = OPENSSL_malloc(100))
+            || !TEST_ptr(q = OPENSSL_zalloc(200))
+            || !TEST_true(same_slab(p, q))
+            || !TEST_ptr(big = OPENSSL_malloc(1 << 20)))
+        goto end;
+    memset(p, 'a', 100);
+
+    /* Growing an allocation keeps its contents */
+    if (!TEST_ptr(r = OPENSSL_realloc(p, 1000)))
+        goto end;
+    p = r;
+    if (!TEST_char_eq(p[0], 'a') || !TEST_char_eq(p[99], 'a'))
+        goto end;
+
+    testresult = 1;
+ end:
+    CRYPTO_arena_end();
+    /* Allocations that outlive the scope remain usable */
+    if (p != NULL)
+        memset(p, 'b', 1000);
+    if (q != NULL)
+        memset(q, 'b', 200);
+    OPENSSL_free(p);
+    OPENSSL_free(q);
+    OPENSSL_free(big);
+    return testresult;
+}
+
+static int test_arena_nested(void)
+{
+    void *p = NULL, *q = NULL, *r = NULL;
+    int testresult = 0;
+
+    if (!TEST_true(CRYPTO_arena_begin()))
+        return 0;
+    if (!TEST_true(CRYPTO_arena_begin())) {
+        CRYPTO_arena_end();
+        return 0;
+    }
+    p = OPENSSL_malloc(16);
+    CRYPTO_arena_end();
+    /* Still in the outer scope */
+    q = OPENSSL_malloc(16);
+    CRYPTO_arena_end();
+    r = OPENSSL_malloc(16);
+
+    if (TEST_ptr(p) && TEST_ptr(q) && TEST_ptr(r)
+            && TEST_true(same_slab(p, q)))
+        testresult = 1;
+    OPENSSL_free(p);
+    OPENSSL_free(q);
+    OPENSSL_free(r);
+    return testresult;
+}
+
+static int test_arena_bignum(void)
+{
+    BIGNUM *a = NULL, *b = NULL;
+    BN_CTX *ctx = NULL;
+    int testresult = 0;
+
+    if (!TEST_true(CRYPTO_arena_begin()))
+        return 0;
+    if (!TEST_ptr(ctx = BN_CTX_new())
+            || !TEST_ptr(a = BN_new())
+            || !TEST_ptr(b = BN_new())
+            || !TEST_true(BN_set_word(a, 3))
+            || !TEST_true(BN_lshift(a, a, 4000))
+            || !TEST_true(BN_sqr(b, a, ctx))
+            || !TEST_int_eq(BN_num_bits(b), 2 * BN_num_bits(a)))
+        goto end;
+    testresult = 1;
+ end:
+    BN_CTX_free(ctx);
+    BN_free(a);
+    CRYPTO_arena_end();
+    BN_free(b);
+    return testresult;
+}
+
+static void *thread_ptr;
+
+static void free_in_thread(void)
+{
+    OPENSSL_free(thread_ptr);
+    thread_ptr = NULL;
+}
+
+/* An allocation can be freed by another thread */
+static int test_arena_threads(void)
+{
+    thread_t t;
+    int testresult = 0;
+
+    if (!TEST_true(CRYPTO_arena_begin()))
+        return 0;
+    thread_ptr = OPENSSL_malloc(64);
+    if (TEST_ptr(thread_ptr)
+            && TEST_true(run_thread(&t, free_in_thread))
+            && TEST_true(wait_for_thread(t))
+            && TEST_ptr_null(thread_ptr))
+        testresult = 1;
+    CRYPTO_arena_end();
+    return testresult;
+}
+
+static void alloc_in_thread(void)
+{
+    if (CRYPTO_arena_begin())
+        thread_ptr = OPENSSL_malloc(64);
+}
+
+/*
+ * A thread exiting without leaving its scope gives its slab back once the
+ * allocations made from it are freed, so the next slab handed out is that one.
+ */
+static int test_arena_thread_exit(void)
+{
+    thread_t t;
+    void *p, *q = NULL;
+    int testresult = 0;
+
+    thread_ptr = NULL;
+    if (!TEST_true(run_thread(&t, alloc_in_thread))
+            || !TEST_true(wait_for_thread(t))
+            || !TEST_ptr(p = thread_ptr))
+        return 0;
+    OPENSSL_free(p);
+    thread_ptr = NULL;
+
+    if (!TEST_true(CRYPTO_arena_begin()))
+        return 0;
+    if (TEST_ptr(q = OPENSSL_malloc(64))
+            && TEST_true(same_slab(p, q)))
+        testresult = 1;
+    OPENSSL_free(q);
+    CRYPTO_arena_end();
+    return testresult;
+}
+
+int setup_tests(void)
+{
+    ADD_TEST(test_arena_alloc);
+    ADD_TEST(test_arena_nested);
+    ADD_TEST(test_arena_bignum);
+    ADD_TEST(test_arena_threads);
+    ADD_TEST(test_arena_thread_exit);
+    return 1;
+}
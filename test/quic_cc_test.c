@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2022-2025 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the Apache License 2.0 (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -14,6 +14,13 @@
 #include <openssl/ssl.h>
 #include "internal/quic_cc.h"
 #include "internal/priority_queue.h"
+#include "internal/nelem.h"
+
+static const OSSL_CC_METHOD *const cc_methods[] = {
+    &ossl_cc_newreno_method,
+    &ossl_cc_cubic_method,
+    &ossl_cc_bbr2_method,
+};
 
 /*
  * Time Simulation
@@ -325,12 +332,12 @@ static int dump_state(const OSSL_CC_METHOD *ccm, OSSL_CC_DATA *cc,
  * capacity. The average estimated channel capacity should not be too far from
  * the actual channel capacity.
  */
-static int test_simulate(void)
+static int test_simulate(int idx)
 {
     int testresult = 0;
     int rc;
     int have_sim = 0;
-    const OSSL_CC_METHOD *ccm = &ossl_cc_newreno_method;
+    const OSSL_CC_METHOD *ccm = cc_methods[idx];
     OSSL_CC_DATA *cc = NULL;
     size_t mdpl = 1472;
     uint64_t total_sent = 0, total_to_send, allowance;
@@ -480,11 +487,11 @@ err:
  *
  * Basic test of the congestion control APIs.
  */
-static int test_sanity(void)
+static int test_sanity(int idx)
 {
     int testresult = 0;
     OSSL_CC_DATA *cc = NULL;
-    const OSSL_CC_METHOD *ccm = &ossl_cc_newreno_method;
+    const OSSL_CC_METHOD *ccm = cc_methods[idx];
     OSSL_CC_LOSS_INFO loss_info = {0};
     OSSL_CC_ACK_INFO ack_info = {0};
     uint64_t allowance, allowance2;
@@ -548,6 +555,10 @@ static int test_sanity(void)
     if (!TEST_uint64_t_ge(allowance2 = ccm->get_tx_allowance(cc), allowance))
         goto err;
 
+    /* Having seen an RTT sample, we should now pace. */
+    if (!TEST_uint64_t_gt(ccm->get_pacing_rate(cc), 0))
+        goto err;
+
     /* Test invalidation. */
     if (!TEST_true(ccm->on_data_sent(cc, 1200)))
         goto err;
@@ -623,7 +634,7 @@ int setup_tests(void)
         "\"State\"\n");
 #endif
 
-    ADD_TEST(test_simulate);
-    ADD_TEST(test_sanity);
+    ADD_ALL_TESTS(test_simulate, OSSL_NELEM(cc_methods));
+    ADD_ALL_TESTS(test_sanity, OSSL_NELEM(cc_methods));
     return 1;
 }
@@ -1264,6 +1264,71 @@ static const struct script_op script_18[] = {
     OP_END
 };
 
+/* 19. 1-RTT, STREAM, Pacing */
+static const unsigned char stream_19[32768];
+
+static uint64_t paced_get_pacing_rate(OSSL_CC_DATA *cc)
+{
+    /* Slow enough that no further datagram becomes due during the test. */
+    return 1000;
+}
+
+static OSSL_CC_METHOD paced_cc_method;
+
+static int enable_pacing(struct helper *h)
+{
+    paced_cc_method                 = *h->cc_method;
+    paced_cc_method.get_pacing_rate = paced_get_pacing_rate;
+
+    ossl_quic_tx_packetiser_set_cc(h->txp, &paced_cc_method, h->cc_data);
+    return 1;
+}
+
+static int check_paced(struct helper *h)
+{
+    QUIC_TXP_STATUS status;
+    OSSL_TIME deadline;
+    size_t i;
+
+    /*
+     * After an idle period the pacer lets a burst of up to ten datagrams go
+     * back to back, then holds back the remaining stream data.
+     */
+    for (i = 0;; ++i) {
+        if (!TEST_true(ossl_quic_tx_packetiser_generate(h->txp, &status)))
+            return 0;
+
+        if (status.sent_pkt == 0)
+            break;
+
+        if (!TEST_size_t_lt(i, 9))
+            return 0;
+    }
+
+    /* The TXP should want to be woken up when the next datagram is due. */
+    deadline = ossl_quic_tx_packetiser_get_deadline(h->txp);
+    if (!TEST_false(ossl_time_is_infinite(deadline))
+        || !TEST_true(ossl_time_compare(deadline, fake_now(NULL)) > 0))
+        return 0;
+
+    return 1;
+}
+
+static const struct script_op script_19[] = {
+    OP_PROVIDE_SECRET(QUIC_ENC_LEVEL_1RTT, QRL_SUITE_AES128GCM, secret_1)
+    OP_HANDSHAKE_COMPLETE()
+    OP_CHECK(enable_pacing)
+    OP_STREAM_NEW(42)
+    OP_CONN_TXFC_BUMP(sizeof(stream_19))
+    OP_STREAM_TXFC_BUMP(42, sizeof(stream_19))
+    OP_STREAM_SEND(42, stream_19)
+    OP_TXP_GENERATE()
+    OP_RX_PKT()
+    OP_EXPECT_DGRAM_LEN(1000, 1500)
+    OP_CHECK(check_paced)
+    OP_END
+};
+
 static const struct script_op *const scripts[] = {
     script_1,
     script_2,
@@ -1282,7 +1347,8 @@ static const struct script_op *const scripts[] = {
     script_15,
     script_16,
     script_17,
-    script_18
+    script_18,
+    script_19
 };
 
 static void skip_padding(struct helper *h)
@@ -20,6 +20,8 @@
 #include "testutil/output.h"
 #include "../ssl/ssl_local.h"
 #include "internal/quic_error.h"
+#include "internal/quic_channel.h"
+#include "internal/quic_cc.h"
 
 static OSSL_LIB_CTX *libctx = NULL;
 static OSSL_PROVIDER *defctxnull = NULL;
@@ -1567,6 +1569,72 @@ static int test_get_shutdown(void)
     return testresult;
 }
 
+/* Test SSL_read_borrow() and SSL_read_release() on a QUIC stream */
+static int test_read_borrow(void)
+{
+    SSL_CTX *cctx = SSL_CTX_new_ex(libctx, NULL, OSSL_QUIC_client_method());
+    SSL *clientquic = NULL;
+    QUIC_TSERVER *qtserv = NULL;
+    const char *msg = "Hello World";
+    const unsigned char *data = NULL;
+    unsigned char buf[32];
+    size_t numbytes, len = 0;
+    uint64_t sid;
+    int i, testresult = 0;
+
+    if (!TEST_ptr(cctx)
+            || !TEST_true(qtest_create_quic_objects(libctx, cctx, NULL, cert,
+                                                    privkey,
+                                                    QTEST_FLAG_FAKE_TIME,
+                                                    &qtserv, &clientquic,
+                                                    NULL, NULL))
+            || !TEST_true(qtest_create_quic_connection(qtserv, clientquic)))
+        goto err;
+
+    if (!TEST_true(ossl_quic_tserver_stream_new(qtserv, 0, &sid))
+            || !TEST_true(ossl_quic_tserver_write(qtserv, sid,
+                                                  (unsigned char *)msg,
+                                                  strlen(msg), &numbytes))
+            || !TEST_size_t_eq(strlen(msg), numbytes)
+            || !TEST_true(ossl_quic_tserver_conclude(qtserv, sid)))
+        goto err;
+
+    for (i = 0; !SSL_read_borrow(clientquic, &data, &len); i++) {
+        if (!TEST_int_eq(SSL_get_error(clientquic, 0), SSL_ERROR_WANT_READ)
+                || !TEST_int_lt(i, 100))
+            goto err;
+        ossl_quic_tserver_tick(qtserv);
+        qtest_add_time(1);
+    }
+
+    /* The stream can not be read while its data is borrowed */
+    if (!TEST_mem_eq(data, len, msg, strlen(msg))
+            || !TEST_false(SSL_read_ex(clientquic, buf, sizeof(buf), &numbytes))
+            || !TEST_false(SSL_read_release(clientquic, len + 1))
+            || !TEST_true(SSL_read_release(clientquic, 6)))
+        goto err;
+
+    if (!TEST_true(SSL_read_borrow(clientquic, &data, &len))
+            || !TEST_mem_eq(data, len, msg + 6, strlen(msg) - 6)
+            || !TEST_true(SSL_read_release(clientquic, len))
+            || !TEST_false(SSL_read_release(clientquic, 0)))
+        goto err;
+
+    /* All the data and the FIN have been consumed */
+    ERR_clear_error();
+    if (!TEST_false(SSL_read_borrow(clientquic, &data, &len))
+            || !TEST_int_eq(SSL_get_error(clientquic, 0), SSL_ERROR_ZERO_RETURN))
+        goto err;
+
+    testresult = 1;
+ err:
+    ossl_quic_tserver_free(qtserv);
+    SSL_free(clientquic);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 #define MAX_LOOPS   2000
 
 /*
@@ -1630,7 +1698,11 @@ static int unreliable_server_read(QUIC_TSERVER *qtserv, uint64_t sid,
  * Test 1: As with test 0 but also split datagrams containing multiple packets
  *         into individual datagrams so that individual packets can be affected
  *         by noise - not just a whole datagram.
+ * Tests 2-5: As with tests 0 and 1 but using the CUBIC and BBRv2 congestion
+ *            controllers on both endpoints.
  */
+static const char *noisy_cc_names[] = { "newreno", "cubic", "bbr2" };
+
 static int test_noisy_dgram(int idx)
 {
     SSL_CTX *cctx = SSL_CTX_new_ex(libctx, NULL, OSSL_QUIC_client_method());
@@ -1643,8 +1715,9 @@ static int test_noisy_dgram(int idx)
     unsigned char buf[80];
     int flags = QTEST_FLAG_NOISE | QTEST_FLAG_FAKE_TIME;
     QTEST_FAULT *fault = NULL;
+    const char *ccname = noisy_cc_names[idx / 2];
 
-    if (idx == 1)
+    if (idx % 2 == 1)
         flags |= QTEST_FLAG_PACKET_SPLIT;
 
     if (!TEST_ptr(cctx)
@@ -1654,9 +1727,22 @@ static int test_noisy_dgram(int idx)
                                                     &clientquic, &fault, NULL)))
         goto err;
 
+    if (!TEST_false(SSL_set_quic_congestion_control(clientquic, "nosuchcc"))
+            || !TEST_true(SSL_set_quic_congestion_control(clientquic, ccname))
+            || !TEST_str_eq(SSL_get0_quic_congestion_control(clientquic),
+                            ccname)
+            || !TEST_true(ossl_quic_channel_set_cc_method(
+                              ossl_quic_tserver_get_channel(qtserv),
+                              ossl_cc_method_from_name(ccname))))
+        goto err;
+
     if (!TEST_true(qtest_create_quic_connection(qtserv, clientquic)))
             goto err;
 
+    /* The controller cannot be changed once the connection is started */
+    if (!TEST_false(SSL_set_quic_congestion_control(clientquic, "newreno")))
+        goto err;
+
     if (!TEST_true(SSL_set_incoming_stream_policy(clientquic,
                                                   SSL_INCOMING_STREAM_POLICY_ACCEPT,
                                                   0))
@@ -2809,6 +2895,122 @@ static int test_ssl_accept_connection(void)
     return testresult;
 }
 
+/*
+ * Test that a worker listener hands packets of connections belonging to
+ * another worker over to that worker.
+ */
+static int test_worker_listener(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL, *sstream = NULL;
+    SSL *qa = NULL, *qb = NULL;
+    BIO *cbio = NULL, *sbio = NULL, *bbio = NULL, *bpeer = NULL;
+    BIO_ADDR *addr = NULL;
+    struct in_addr ina;
+    unsigned char msg[] = "Hello, worker!", buf[sizeof(msg)];
+    size_t nread, nwritten;
+    int testresult = 0, ret, i;
+
+    ina.s_addr = htonl(0x1f000001);
+    if (!TEST_ptr(sctx = create_server_ctx())
+        || !TEST_ptr(cctx = create_client_ctx())
+        || !TEST_true(BIO_new_bio_dgram_pair(&cbio, 0, &sbio, 0))
+        || !TEST_true(BIO_new_bio_dgram_pair(&bbio, 0, &bpeer, 0)))
+        goto err;
+
+    /* Both workers use the same address */
+    if (!TEST_ptr(addr = create_addr(&ina, 8040))
+        || !TEST_true(bio_addr_bind(sbio, addr)))
+        goto err;
+    if (!TEST_ptr(addr = create_addr(&ina, 8040))
+        || !TEST_true(bio_addr_bind(bbio, addr)))
+        goto err;
+    if (!TEST_ptr(addr = create_addr(&ina, 4080))
+        || !TEST_true(bio_addr_bind(cbio, addr)))
+        goto err;
+    addr = NULL;
+
+    if (!TEST_ptr(qa = SSL_new_listener(sctx, SSL_LISTENER_FLAG_WORKER))
+        || !TEST_ptr(qb = SSL_new_listener(sctx, SSL_LISTENER_FLAG_WORKER)))
+        goto err;
+    SSL_set_bio(qa, sbio, sbio);
+    sbio = NULL;
+    SSL_set_bio(qb, bbio, bbio);
+    bbio = NULL;
+    if (!TEST_true(SSL_listen(qa))
+        || !TEST_true(SSL_listen(qb)))
+        goto err;
+
+    if (!TEST_ptr(clientssl = SSL_new(cctx))
+        || !TEST_ptr(addr = create_addr(&ina, 8040))
+        || !TEST_true(qc_init(clientssl, addr)))
+        goto err;
+    SSL_set_bio(clientssl, cbio, cbio);
+    cbio = NULL;
+
+    /* Send ClientHello and server retry */
+    for (i = 0; i < 2; i++) {
+        ret = SSL_connect(clientssl);
+        if (!TEST_int_le(ret, 0)
+            || !TEST_int_eq(SSL_get_error(clientssl, ret), SSL_ERROR_WANT_READ))
+            goto err;
+        SSL_handle_events(qa);
+    }
+
+    if (!TEST_ptr(serverssl = SSL_accept_connection(qa, 0))
+        || !TEST_true(create_bare_ssl_connection(serverssl, clientssl,
+                                                 SSL_ERROR_NONE, 0, 0))
+        || !TEST_true(SSL_set_incoming_stream_policy(serverssl,
+                                                     SSL_INCOMING_STREAM_POLICY_ACCEPT,
+                                                     0)))
+        goto err;
+
+    /*
+     * From now on the datagrams sent by the client are received by the
+     * second worker, as if the operating system had started to direct them to
+     * its socket.
+     */
+    if (!TEST_true(BIO_up_ref(SSL_get_rbio(qa))))
+        goto err;
+    SSL_set0_rbio(qb, SSL_get_rbio(qa));
+    SSL_set0_rbio(qa, bpeer);
+    bpeer = NULL;
+
+    if (!TEST_true(SSL_write_ex(clientssl, msg, sizeof(msg), &nwritten))
+        || !TEST_size_t_eq(nwritten, sizeof(msg)))
+        goto err;
+
+    for (i = 0; i < 10 && sstream == NULL; i++) {
+        SSL_handle_events(clientssl);
+        SSL_handle_events(qb);
+        SSL_handle_events(qa);
+        sstream = SSL_accept_stream(serverssl, SSL_ACCEPT_STREAM_NO_BLOCK);
+    }
+
+    if (!TEST_ptr(sstream)
+        || !TEST_true(SSL_read_ex(sstream, buf, sizeof(buf), &nread))
+        || !TEST_mem_eq(buf, nread, msg, sizeof(msg)))
+        goto err;
+
+    testresult = 1;
+
+ err:
+    SSL_free(sstream);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_free(qa);
+    SSL_free(qb);
+    BIO_free(cbio);
+    BIO_free(sbio);
+    BIO_free(bbio);
+    BIO_free(bpeer);
+    BIO_ADDR_free(addr);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 static SSL *quic_verify_ssl = NULL;
 
 static int quic_verify_cb(int ok, X509_STORE_CTX *ctx)
@@ -3105,9 +3307,10 @@ int setup_tests(void)
     ADD_TEST(test_quic_psk);
     ADD_ALL_TESTS(test_client_auth, 3);
     ADD_ALL_TESTS(test_alpn, 2);
-    ADD_ALL_TESTS(test_noisy_dgram, 2);
+    ADD_ALL_TESTS(test_noisy_dgram, 2 * OSSL_NELEM(noisy_cc_names));
     ADD_TEST(test_bw_limit);
     ADD_TEST(test_get_shutdown);
+    ADD_TEST(test_read_borrow);
     ADD_ALL_TESTS(test_tparam, OSSL_NELEM(tparam_tests));
     ADD_TEST(test_session_cb);
     ADD_TEST(test_domain_flags);
@@ -3118,6 +3321,7 @@ int setup_tests(void)
 #endif
     ADD_TEST(test_server_method_with_ssl_new);
     ADD_TEST(test_ssl_accept_connection);
+    ADD_TEST(test_worker_listener);
     ADD_TEST(test_ssl_set_verify);
     ADD_TEST(test_accept_stream);
     return 1;
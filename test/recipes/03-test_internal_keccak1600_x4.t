@@ -0,0 +1,31 @@
+#! /usr/bin/env perl
+# Copyright 2025 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the Apache License 2.0 (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+use strict;
+use OpenSSL::Test;
+
+setup("test_internal_keccak1600_x4");
+
+plan tests => 3;
+
+ok(run(test(["keccak1600_x4_internal_test"])));
+
+# On x86_64 repeat with AVX-512VL and then AVX2 masked out, to cover the
+# other code paths of the multi-buffer permutation and the portable one.
+{
+    local $ENV{OPENSSL_ia32cap} = ":~0x80000000";
+
+    ok(run(test(["keccak1600_x4_internal_test"])),
+       "keccak1600_x4_internal_test without AVX-512VL");
+}
+{
+    local $ENV{OPENSSL_ia32cap} = ":~0x20";
+
+    ok(run(test(["keccak1600_x4_internal_test"])),
+       "keccak1600_x4_internal_test without AVX2");
+}
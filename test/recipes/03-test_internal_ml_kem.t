@@ -13,6 +13,16 @@ use OpenSSL::Test qw/:DEFAULT srctop_file/;
 setup("ml_kem_internal_test");
 plan skip_all => 'EC is not supported in this build'
     if disabled('ml-kem');
-plan tests => 1;
+plan tests => 2;
 
 ok(run(test(["ml_kem_internal_test"])));
+
+# Repeat the known-answer tests with AVX2 masked out, so that on x86_64
+# both the vector kernels and the portable C code are checked against the
+# same expected values.  Elsewhere this is simply a second run.
+{
+    local $ENV{OPENSSL_ia32cap} = ":~0x20";
+
+    ok(run(test(["ml_kem_internal_test"])),
+       "ml_kem_internal_test without AVX2");
+}
@@ -24,7 +24,7 @@ use lib srctop_dir('Configurations');
 use lib bldtop_dir('.');
 
 plan skip_all => 'ML-DSA is not supported in this build' if disabled('ml-dsa');
-plan tests => 12;
+plan tests => 13;
 
 require_ok(srctop_file('test','recipes','tconversion.pl'));
 
@@ -82,6 +82,14 @@ subtest "ml-dsa-87 conversions using 'openssl pkey' -- pub key" => sub {
 
 ok(run(test(["ml_dsa_test"])), "running ml_dsa_test");
 
+# Repeat with AVX2 masked out, so that on x86_64 both the vector kernels
+# and the portable C code are checked against the known answers.
+{
+    local $ENV{OPENSSL_ia32cap} = ":~0x20";
+
+    ok(run(test(["ml_dsa_test"])), "running ml_dsa_test without AVX2");
+}
+
 SKIP: {
     skip "Skipping FIPS tests", 1
         if $no_fips;
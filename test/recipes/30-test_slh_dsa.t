@@ -23,10 +23,27 @@ use lib srctop_dir('Configurations');
 use lib bldtop_dir('.');
 
 plan skip_all => 'SLH-DSA is not supported in this build' if disabled('slh-dsa');
-plan tests => 2;
+plan tests => 4;
 
 ok(run(test(["slh_dsa_test"])), "running slh_dsa_test");
 
+# Repeat with the SHA extensions masked out, so that on x86_64 the SHA2
+# parameter sets also go through the SIMD multi-buffer SHA-256 code.
+{
+    local $ENV{OPENSSL_ia32cap} = ":~0x20000000";
+
+    ok(run(test(["slh_dsa_test"])),
+       "running slh_dsa_test without SHA extensions");
+}
+
+SKIP: {
+    skip "Skipping threaded signing test, no thread pool", 1
+        if disabled('default-thread-pool');
+
+    ok(run(test(["slh_dsa_test", "-threads", "4"])),
+       "running slh_dsa_test with threads");
+}
+
 SKIP: {
     skip "Skipping FIPS tests", 1
         if $no_fips;
@@ -12,6 +12,7 @@
 #include <openssl/param_build.h>
 #include <openssl/rand.h>
 #include <openssl/pem.h>
+#include <openssl/thread.h>
 #include "crypto/slh_dsa.h"
 #include "internal/nelem.h"
 #include "testutil.h"
@@ -21,6 +22,7 @@ typedef enum OPTION_choice {
     OPT_ERR = -1,
     OPT_EOF = 0,
     OPT_CONFIG_FILE,
+    OPT_THREADS,
     OPT_TEST_ENUM
 } OPTION_CHOICE;
 
@@ -621,6 +623,8 @@ const OPTIONS *test_get_options(void)
         OPT_TEST_OPTIONS_DEFAULT_USAGE,
         { "config", OPT_CONFIG_FILE, '<',
           "The configuration file to use for the libctx" },
+        { "threads", OPT_THREADS, 'p',
+          "The number of threads that signing may use" },
         { NULL }
     };
     return options;
@@ -630,12 +634,16 @@ int setup_tests(void)
 {
     OPTION_CHOICE o;
     char *config_file = NULL;
+    int threads = 0;
 
     while ((o = opt_next()) != OPT_EOF) {
         switch (o) {
         case OPT_CONFIG_FILE:
             config_file = opt_arg();
             break;
+        case OPT_THREADS:
+            threads = opt_int_arg();
+            break;
         case OPT_TEST_CASES:
             break;
         default:
@@ -645,6 +653,8 @@ int setup_tests(void)
     }
     if (!test_get_libctx(&lib_ctx, &null_prov, config_file, &lib_prov, NULL))
         return 0;
+    if (threads > 0 && !TEST_true(OSSL_set_max_threads(lib_ctx, threads)))
+        return 0;
 
     ADD_TEST(slh_dsa_bad_pub_len_test);
     ADD_TEST(slh_dsa_key_validate_test);
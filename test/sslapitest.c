@@ -45,6 +45,11 @@
 #include "../ssl/ssl_local.h"
 #include "../ssl/record/methods/recmethod_local.h"
 #include "filterprov.h"
+#include "threadstest.h"
+
+#if defined(OPENSSL_SYS_LINUX) && !defined(OPENSSL_NO_KTLS)
+# include <sys/utsname.h>
+#endif
 
 #undef OSSL_NO_USABLE_TLS1_3
 #if defined(OPENSSL_NO_TLS1_3) \
@@ -1036,6 +1041,21 @@ static int ktls_chk_platform(int sock)
     return 1;
 }
 
+/* Whether the kernel accepts new keys after a TLSv1.3 KeyUpdate */
+static int ktls_chk_rekey(void)
+{
+# if defined(OPENSSL_SYS_LINUX)
+    struct utsname u;
+    int major, minor;
+
+    if (uname(&u) != 0 || sscanf(u.release, "%d.%d", &major, &minor) != 2)
+        return 0;
+    return major > 6 || (major == 6 && minor >= 14);
+# else
+    return 0;
+# endif
+}
+
 static int ping_pong_query(SSL *clientssl, SSL *serverssl)
 {
     static char count = 1;
@@ -1149,8 +1169,9 @@ static int execute_test_ktls(int cis_ktls, int sis_ktls,
     SSL_CONNECTION *clientsc, *serversc;
     unsigned char *buf = NULL;
     const size_t bufsz = SSL3_RT_MAX_PLAIN_LENGTH + 16;
-    int ret;
+    int ret, cstate, sstate;
     size_t offset = 0, i;
+    uint64_t records, bytes, rekeys;
 
     if (!TEST_true(create_test_sockets(&cfd, &sfd, SOCK_STREAM, NULL)))
         goto end;
@@ -1286,6 +1307,36 @@ static int execute_test_ktls(int cis_ktls, int sis_ktls,
         if (!TEST_true(buf[i] == 0))
             goto end;
 
+    cstate = SSL_get_ktls_state(clientssl);
+    sstate = SSL_get_ktls_state(serverssl);
+    if ((sstate & SSL_KTLS_RX) != 0
+            && (!TEST_true(SSL_get_ktls_stats(serverssl, SSL_KTLS_RX, &records,
+                                              &bytes, NULL))
+                || !TEST_uint64_t_gt(records, 0)
+                || !TEST_uint64_t_ge(bytes, bufsz)))
+        goto end;
+
+    /* The offload stays in place across a KeyUpdate in each direction */
+    if (tls_version == TLS1_3_VERSION && ktls_chk_rekey()) {
+        if (!TEST_true(SSL_key_update(clientssl, SSL_KEY_UPDATE_REQUESTED))
+                || !TEST_true(ping_pong_query(clientssl, serverssl))
+                || !TEST_int_eq(SSL_get_ktls_state(clientssl), cstate)
+                || !TEST_int_eq(SSL_get_ktls_state(serverssl), sstate))
+            goto end;
+        for (i = 0; i < 2; i++) {
+            int dir = i == 0 ? SSL_KTLS_TX : SSL_KTLS_RX;
+
+            if (!TEST_true(SSL_get_ktls_stats(clientssl, dir, NULL, NULL,
+                                              &rekeys))
+                    || !TEST_uint64_t_eq(rekeys, (cstate & dir) != 0 ? 1 : 0)
+                    || !TEST_true(SSL_get_ktls_stats(serverssl, dir, NULL,
+                                                     NULL, &rekeys))
+                    || !TEST_uint64_t_eq(rekeys,
+                                         (sstate & dir) != 0 ? 1 : 0))
+                goto end;
+        }
+    }
+
     testresult = 1;
 end:
     OPENSSL_free(buf);
@@ -8536,6 +8587,399 @@ static int test_ssl_pending(int tst)
     return testresult;
 }
 
+/*
+ * Test SSL_read_borrow() and SSL_read_release()
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3
+ */
+static int test_read_borrow(int tst)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    int testresult = 0;
+    const char msg1[] = "A test message", msg2[] = "Another one";
+    const unsigned char *data;
+    char buf[sizeof(msg2)];
+    size_t written, readbytes, len;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (tst == 0)
+        return TEST_skip("TLSv1.2 is disabled");
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+    if (tst == 1)
+        return TEST_skip("No usable TLSv1.3");
+#endif
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(), TLS1_VERSION,
+                                       tst == 0 ? TLS1_2_VERSION
+                                                : TLS1_3_VERSION,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                                             &clientssl, NULL, NULL))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE)))
+        goto end;
+
+    /* Nothing has been borrowed yet */
+    if (!TEST_false(SSL_read_release(clientssl, 0))
+            || !TEST_true(SSL_write_ex(serverssl, msg1, sizeof(msg1), &written))
+            || !TEST_true(SSL_write_ex(serverssl, msg2, sizeof(msg2), &written)))
+        goto end;
+
+    /* Records are lent out one at a time */
+    if (!TEST_true(SSL_read_borrow(clientssl, &data, &len))
+            || !TEST_mem_eq(data, len, msg1, sizeof(msg1))
+            || !TEST_false(SSL_read_ex(clientssl, buf, sizeof(buf), &readbytes))
+            || !TEST_false(SSL_read_release(clientssl, len + 1))
+            || !TEST_true(SSL_read_release(clientssl, 5)))
+        goto end;
+
+    /* The rest of a partially released record is lent out again */
+    if (!TEST_true(SSL_read_borrow(clientssl, &data, &len))
+            || !TEST_mem_eq(data, len, msg1 + 5, sizeof(msg1) - 5)
+            || !TEST_true(SSL_read_release(clientssl, len))
+            || !TEST_true(SSL_read_borrow(clientssl, &data, &len))
+            || !TEST_mem_eq(data, len, msg2, sizeof(msg2))
+            || !TEST_true(SSL_read_release(clientssl, 0)))
+        goto end;
+
+    /* Data that was not released is still there for SSL_read_ex() */
+    ERR_clear_error();
+    if (!TEST_true(SSL_read_ex(clientssl, buf, sizeof(buf), &readbytes))
+            || !TEST_mem_eq(buf, readbytes, msg2, sizeof(msg2))
+            || !TEST_false(SSL_read_borrow(clientssl, &data, &len))
+            || !TEST_int_eq(SSL_get_error(clientssl, 0), SSL_ERROR_WANT_READ))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+static int records_written;
+
+static void count_records_cb(int write_p, int version, int content_type,
+                             const void *buf, size_t msglen, SSL *ssl,
+                             void *arg)
+{
+    if (write_p && content_type == SSL3_RT_HEADER)
+        records_written++;
+}
+
+static int writev_drain(BIO *from, BIO *to)
+{
+    char tmp[4096];
+    int n;
+
+    while ((n = BIO_read(from, tmp, sizeof(tmp))) > 0)
+        if (!TEST_int_eq(BIO_write(to, tmp, n), n))
+            return 0;
+    return 1;
+}
+
+/*
+ * Test that SSL_writev_ex() writes full records whatever the layout of the
+ * data in the buffers, and resumes where it stopped when retried
+ */
+static int test_writev(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    BIO *sbio = NULL, *pair_in = NULL, *pair_out = NULL;
+    int testresult = 0, pass;
+    static const char hdr[] = "HTTP/1.1 200 OK\r\n\r\n";
+    unsigned char *body = NULL, *buf = NULL;
+    size_t bodylen = SSL3_RT_MAX_PLAIN_LENGTH + 1000, total, written;
+    size_t readbytes, i;
+    SSL_IOVEC iov[4];
+
+    if (!TEST_ptr(body = OPENSSL_malloc(bodylen))
+            || !TEST_ptr(buf = OPENSSL_malloc(2 * bodylen)))
+        goto end;
+    for (i = 0; i < bodylen; i++)
+        body[i] = (unsigned char)i;
+    iov[0].base = hdr;
+    iov[0].len = strlen(hdr);
+    iov[1].base = NULL;
+    iov[1].len = 0;
+    iov[2].base = body;
+    iov[2].len = bodylen;
+    iov[3].base = hdr;
+    iov[3].len = strlen(hdr);
+    total = bodylen + 2 * strlen(hdr);
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(), TLS1_VERSION, 0,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                                             &clientssl, NULL, NULL)))
+        goto end;
+
+    SSL_set_msg_callback(serverssl, count_records_cb);
+    if (!TEST_true(create_ssl_connection(serverssl, clientssl,
+                                         SSL_ERROR_NONE)))
+        goto end;
+
+    for (pass = 0; pass < 2; pass++) {
+        /* A full record and one for the rest, rather than four records */
+        records_written = 0;
+        if (pass == 1) {
+            /*
+             * Only leave room for the first record, so that the write has to
+             * be retried for the second one.
+             */
+            if (!TEST_ptr(sbio = SSL_get_wbio(serverssl))
+                    || !TEST_true(BIO_up_ref(sbio))
+                    || !TEST_true(BIO_new_bio_pair(&pair_in, 17000,
+                                                   &pair_out, 17000))) {
+                BIO_free(sbio);
+                sbio = NULL;
+                goto end;
+            }
+            SSL_set0_wbio(serverssl, pair_in);
+            if (!TEST_false(SSL_writev_ex(serverssl, iov, OSSL_NELEM(iov),
+                                          &written))
+                    || !TEST_int_eq(SSL_get_error(serverssl, 0),
+                                    SSL_ERROR_WANT_WRITE)
+                    || !writev_drain(pair_out, sbio))
+                goto end;
+        }
+
+        if (!TEST_true(SSL_writev_ex(serverssl, iov, OSSL_NELEM(iov),
+                                     &written))
+                || !TEST_size_t_eq(written, total)
+                || !TEST_int_eq(records_written, 2))
+            goto end;
+
+        if (pass == 1) {
+            if (!writev_drain(pair_out, sbio))
+                goto end;
+            SSL_set0_wbio(serverssl, sbio);
+            sbio = NULL;
+        }
+
+        for (i = 0; i < total; i += readbytes)
+            if (!TEST_true(SSL_read_ex(clientssl, buf + i, total - i,
+                                       &readbytes)))
+                goto end;
+
+        if (!TEST_mem_eq(buf, strlen(hdr), hdr, strlen(hdr))
+                || !TEST_mem_eq(buf + strlen(hdr), bodylen, body, bodylen)
+                || !TEST_mem_eq(buf + strlen(hdr) + bodylen, strlen(hdr),
+                                hdr, strlen(hdr)))
+            goto end;
+    }
+
+    testresult = 1;
+
+ end:
+    BIO_free(sbio);
+    BIO_free(pair_out);
+    OPENSSL_free(body);
+    OPENSSL_free(buf);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+/*
+ * Test that dynamic record sizing sends small records until the ramp is
+ * reached, and again after the connection has been idle.
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3
+ */
+static int test_dynamic_record_sizing(int idx)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    int testresult = 0;
+    unsigned char *buf = NULL, *rbuf = NULL;
+    size_t buflen = 10000, written, readbytes, i;
+    int prot = idx == 0 ? TLS1_2_VERSION : TLS1_3_VERSION;
+
+#ifdef OPENSSL_NO_TLS1_2
+    if (idx == 0)
+        return TEST_skip("TLSv1.2 is disabled in this build");
+#endif
+#ifdef OSSL_NO_USABLE_TLS1_3
+    if (idx == 1)
+        return TEST_skip("No usable TLSv1.3 in this build");
+#endif
+
+    if (!TEST_ptr(buf = OPENSSL_malloc(buflen))
+            || !TEST_ptr(rbuf = OPENSSL_malloc(buflen)))
+        goto end;
+    for (i = 0; i < buflen; i++)
+        buf[i] = (unsigned char)i;
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(), prot, prot,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_false(SSL_CTX_set_dynamic_record_sizing(sctx,
+                               SSL3_RT_MAX_PLAIN_LENGTH + 1, 0, 0))
+            || !TEST_true(SSL_CTX_set_dynamic_record_sizing(sctx, 1000, 3000,
+                                                            0))
+            || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                                             &clientssl, NULL, NULL)))
+        goto end;
+
+    SSL_set_msg_callback(serverssl, count_records_cb);
+    if (!TEST_true(create_ssl_connection(serverssl, clientssl,
+                                         SSL_ERROR_NONE)))
+        goto end;
+
+    /* Three small records up to the ramp, then one for the rest */
+    records_written = 0;
+    if (!TEST_true(SSL_write_ex(serverssl, buf, buflen, &written))
+            || !TEST_size_t_eq(written, buflen)
+            || !TEST_int_eq(records_written, 4))
+        goto end;
+    for (i = 0; i < buflen; i += readbytes)
+        if (!TEST_true(SSL_read_ex(clientssl, rbuf + i, buflen - i,
+                                   &readbytes)))
+            goto end;
+    if (!TEST_mem_eq(buf, buflen, rbuf, buflen))
+        goto end;
+
+    /* Past the ramp full sized records are used */
+    records_written = 0;
+    if (!TEST_true(SSL_write_ex(serverssl, buf, buflen, &written))
+            || !TEST_int_eq(records_written, 1)
+            || !TEST_true(SSL_read_ex(clientssl, rbuf, buflen, &readbytes))
+            || !TEST_size_t_eq(readbytes, buflen))
+        goto end;
+
+    /* After an idle period small records are used again */
+    if (!TEST_true(SSL_set_dynamic_record_sizing(serverssl, 1000, 3000, 1)))
+        goto end;
+    OSSL_sleep(20);
+    records_written = 0;
+    if (!TEST_true(SSL_write_ex(serverssl, buf, 2000, &written))
+            || !TEST_int_eq(records_written, 2))
+        goto end;
+    for (i = 0; i < 2000; i += readbytes)
+        if (!TEST_true(SSL_read_ex(clientssl, rbuf + i, 2000 - i,
+                                   &readbytes)))
+            goto end;
+
+    testresult = 1;
+
+ end:
+    OPENSSL_free(buf);
+    OPENSSL_free(rbuf);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
+#ifdef OPENSSL_SYS_UNIX
+/*
+ * Test SSL_sendfile() without kTLS, for a regular file, including one
+ * truncated while it is open, and for a character device.
+ */
+static int test_sendfile_fallback(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    int testresult = 0;
+    unsigned char *buf = NULL, *rbuf = NULL;
+    size_t buflen = 100000, readbytes, i;
+    ossl_ssize_t ret;
+    BIO *out = NULL, *in = NULL;
+    FILE *zero = NULL;
+    FILE *ffdp;
+
+    if (!TEST_ptr(buf = OPENSSL_malloc(buflen))
+            || !TEST_ptr(rbuf = OPENSSL_zalloc(buflen))
+            || !TEST_int_gt(RAND_bytes_ex(libctx, buf, buflen, 0), 0)
+            || !TEST_ptr(out = BIO_new_file(tmpfilename, "wb"))
+            || !TEST_int_eq(BIO_write(out, buf, (int)buflen), (int)buflen))
+        goto end;
+    BIO_free(out);
+    out = NULL;
+    if (!TEST_ptr(in = BIO_new_file(tmpfilename, "rb"))
+            || !TEST_long_gt(BIO_get_fp(in, &ffdp), 0))
+        goto end;
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(), TLS1_VERSION, 0,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(create_ssl_objects(sctx, cctx, &serverssl,
+                                             &clientssl, NULL, NULL))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE)))
+        goto end;
+
+    /* An unaligned offset, and a size running past the end of the file */
+    ret = SSL_sendfile(serverssl, fileno(ffdp), 1, buflen, 0);
+    if (!TEST_int_eq((int)ret, (int)(buflen - 1)))
+        goto end;
+    for (i = 0; i < buflen - 1; i += readbytes)
+        if (!TEST_true(SSL_read_ex(clientssl, rbuf + i, buflen - 1 - i,
+                                   &readbytes)))
+            goto end;
+    if (!TEST_mem_eq(rbuf, buflen - 1, buf + 1, buflen - 1))
+        goto end;
+
+    /* Nothing is left to send at the end of the file */
+    if (!TEST_int_eq((int)SSL_sendfile(serverssl, fileno(ffdp), buflen, 10,
+                                       0), 0))
+        goto end;
+
+    /* Nor once the file has been truncated under us */
+    if (!TEST_ptr(out = BIO_new_file(tmpfilename, "wb")))
+        goto end;
+    BIO_free(out);
+    out = NULL;
+    if (!TEST_int_eq((int)SSL_sendfile(serverssl, fileno(ffdp), 0, 10, 0), 0))
+        goto end;
+
+    /* Other file descriptors are read in the same way */
+    if ((zero = fopen("/dev/zero", "rb")) == NULL) {
+        testresult = TEST_skip("Cannot open /dev/zero");
+        goto end;
+    }
+    if (!TEST_int_eq((int)SSL_sendfile(serverssl, fileno(zero), 0, 5000, 0),
+                     5000)
+            || !TEST_true(SSL_read_ex(clientssl, rbuf, buflen, &readbytes))
+            || !TEST_size_t_eq(readbytes, 5000))
+        goto end;
+    for (i = 0; i < readbytes; i++)
+        if (!TEST_uchar_eq(rbuf[i], 0))
+            goto end;
+
+    testresult = 1;
+
+ end:
+    if (zero != NULL)
+        fclose(zero);
+    BIO_free(in);
+    BIO_free(out);
+    OPENSSL_free(buf);
+    OPENSSL_free(rbuf);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
 static struct {
     unsigned int maxprot;
     const char *clntciphers;
@@ -10071,6 +10515,459 @@ static int test_session_cache_overflow(int idx)
 }
 #endif /* !defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2) */
 
+/*
+ * Test the sharded internal session cache: sessions are found again after
+ * being spread over the shards, the overall cache size limit is honoured and
+ * sharding can't be switched on or off once the SSL_CTX is in use.
+ * Test 0: Sharded cache
+ * Test 1: Unsharded cache
+ */
+#define SHARD_TEST_SESSIONS 200
+
+static int test_session_cache_sharded(int idx)
+{
+    SSL_CTX *ctx = NULL;
+    SSL *s = NULL;
+    SSL_SESSION *sess[SHARD_TEST_SESSIONS] = { NULL };
+    unsigned char id[SSL_MAX_SSL_SESSION_ID_LENGTH];
+    long mode = SSL_SESS_CACHE_SERVER;
+    int i, testresult = 0;
+
+    if (!TEST_ptr(ctx = SSL_CTX_new_ex(libctx, NULL, TLS_server_method())))
+        goto end;
+
+    if (idx == 0)
+        mode |= SSL_SESS_CACHE_SHARDED;
+    SSL_CTX_set_session_cache_mode(ctx, mode);
+    if (!TEST_long_eq(SSL_CTX_get_session_cache_mode(ctx), mode))
+        goto end;
+    if (idx == 0 && !TEST_ptr_null(SSL_CTX_sessions(ctx)))
+        goto end;
+
+    /* Once an SSL object uses the SSL_CTX, the flag can't be changed */
+    if (!TEST_ptr(s = SSL_new(ctx)))
+        goto end;
+    SSL_CTX_set_session_cache_mode(ctx, mode ^ SSL_SESS_CACHE_SHARDED);
+    if (!TEST_long_eq(SSL_CTX_get_session_cache_mode(ctx), mode))
+        goto end;
+
+    memset(id, 0, sizeof(id));
+    for (i = 0; i < SHARD_TEST_SESSIONS; i++) {
+        id[0] = (unsigned char)i;
+        id[1] = (unsigned char)(i >> 8);
+        if (!TEST_ptr(sess[i] = SSL_SESSION_new())
+                || !TEST_true(SSL_SESSION_set_protocol_version(sess[i],
+                                                               SSL_version(s)))
+                || !TEST_true(SSL_SESSION_set1_id(sess[i], id, sizeof(id)))
+                || !TEST_true(SSL_CTX_add_session(ctx, sess[i])))
+            goto end;
+    }
+    if (!TEST_long_eq(SSL_CTX_sess_number(ctx), SHARD_TEST_SESSIONS))
+        goto end;
+
+    for (i = 0; i < SHARD_TEST_SESSIONS; i++) {
+        id[0] = (unsigned char)i;
+        id[1] = (unsigned char)(i >> 8);
+        if (!TEST_true(SSL_has_matching_session_id(s, id, sizeof(id))))
+            goto end;
+    }
+
+    /* Removing a session only removes it from its own shard */
+    if (!TEST_true(SSL_CTX_remove_session(ctx, sess[0]))
+            || !TEST_long_eq(SSL_CTX_sess_number(ctx),
+                             SHARD_TEST_SESSIONS - 1))
+        goto end;
+    id[0] = id[1] = 0;
+    if (!TEST_false(SSL_has_matching_session_id(s, id, sizeof(id))))
+        goto end;
+
+    /* Adding sessions beyond the cache size evicts old ones */
+    SSL_CTX_sess_set_cache_size(ctx, SHARD_TEST_SESSIONS / 2);
+    if (!TEST_true(SSL_CTX_add_session(ctx, sess[0]))
+            || !TEST_long_le(SSL_CTX_sess_number(ctx), SHARD_TEST_SESSIONS))
+        goto end;
+    for (i = 1; i < SHARD_TEST_SESSIONS; i++) {
+        SSL_CTX_remove_session(ctx, sess[i]);
+        if (!TEST_true(SSL_CTX_add_session(ctx, sess[i])))
+            goto end;
+    }
+    if (!TEST_long_le(SSL_CTX_sess_number(ctx), SHARD_TEST_SESSIONS / 2)
+            || !TEST_long_gt(SSL_CTX_sess_number(ctx), 0))
+        goto end;
+
+    /* Nor while there are sessions in the cache */
+    SSL_free(s);
+    s = NULL;
+    i = (int)SSL_CTX_sess_number(ctx);
+    SSL_CTX_set_session_cache_mode(ctx, mode ^ SSL_SESS_CACHE_SHARDED);
+    if (!TEST_long_eq(SSL_CTX_get_session_cache_mode(ctx), mode)
+            || !TEST_long_eq(SSL_CTX_sess_number(ctx), i))
+        goto end;
+
+    /* But it can once the cache has been emptied */
+    for (i = 0; i < SHARD_TEST_SESSIONS; i++)
+        SSL_CTX_remove_session(ctx, sess[i]);
+    mode ^= SSL_SESS_CACHE_SHARDED;
+    SSL_CTX_set_session_cache_mode(ctx, mode);
+    if (!TEST_long_eq(SSL_CTX_sess_number(ctx), 0)
+            || !TEST_long_eq(SSL_CTX_get_session_cache_mode(ctx), mode))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    SSL_free(s);
+    for (i = 0; i < SHARD_TEST_SESSIONS; i++)
+        SSL_SESSION_free(sess[i]);
+    SSL_CTX_free(ctx);
+
+    return testresult;
+}
+
+#ifndef OPENSSL_NO_TLS1_2
+/*
+ * Resume TLSv1.2 sessions from the server's internal session cache on several
+ * threads at once and report the rate, with and without sharding.
+ */
+# define SHARD_MT_THREADS       4
+# define SHARD_MT_RESUMPTIONS   250
+
+static SSL_CTX *shard_mt_sctx = NULL, *shard_mt_cctx = NULL;
+static CRYPTO_RWLOCK *shard_mt_lock = NULL;
+static int shard_mt_failures = 0;
+
+static void shard_mt_worker(void)
+{
+    SSL *serverssl = NULL, *clientssl = NULL;
+    SSL_SESSION *sess = NULL;
+    int i, tmp, ok = 0;
+
+    if (!TEST_true(create_ssl_objects(shard_mt_sctx, shard_mt_cctx, &serverssl,
+                                      &clientssl, NULL, NULL))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE))
+            || !TEST_ptr(sess = SSL_get1_session(clientssl)))
+        goto end;
+    shutdown_ssl_connection(serverssl, clientssl);
+    serverssl = clientssl = NULL;
+
+    for (i = 0; i < SHARD_MT_RESUMPTIONS; i++) {
+        if (!TEST_true(create_ssl_objects(shard_mt_sctx, shard_mt_cctx,
+                                          &serverssl, &clientssl, NULL, NULL))
+                || !TEST_true(SSL_set_session(clientssl, sess))
+                || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                    SSL_ERROR_NONE))
+                || !TEST_true(SSL_session_reused(serverssl)))
+            goto end;
+        shutdown_ssl_connection(serverssl, clientssl);
+        serverssl = clientssl = NULL;
+    }
+    ok = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_SESSION_free(sess);
+    if (!ok)
+        CRYPTO_atomic_add(&shard_mt_failures, 1, &tmp, shard_mt_lock);
+}
+
+/*
+ * Test 0: Unsharded cache
+ * Test 1: Sharded cache
+ */
+static int test_session_cache_sharded_mt(int idx)
+{
+    thread_t threads[SHARD_MT_THREADS];
+    size_t started = 0, i;
+    OSSL_TIME start;
+    uint64_t us;
+    int failures, testresult = 0;
+
+    shard_mt_failures = 0;
+    if (!TEST_ptr(shard_mt_lock = CRYPTO_THREAD_lock_new())
+            || !TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                              TLS_client_method(),
+                                              TLS1_2_VERSION, TLS1_2_VERSION,
+                                              &shard_mt_sctx, &shard_mt_cctx,
+                                              cert, privkey)))
+        goto end;
+    SSL_CTX_set_options(shard_mt_sctx, SSL_OP_NO_TICKET);
+    SSL_CTX_set_session_cache_mode(shard_mt_sctx,
+                                   SSL_SESS_CACHE_SERVER
+                                   | (idx == 1 ? SSL_SESS_CACHE_SHARDED : 0));
+
+    start = ossl_time_now();
+    for (i = 0; i < SHARD_MT_THREADS - 1; i++, started++)
+        if (!TEST_true(run_thread(&threads[i], shard_mt_worker)))
+            break;
+    if (started == SHARD_MT_THREADS - 1)
+        shard_mt_worker();
+    for (i = 0; i < started; i++)
+        wait_for_thread(threads[i]);
+    us = ossl_time2us(ossl_time_subtract(ossl_time_now(), start));
+
+    if (!TEST_size_t_eq(started, SHARD_MT_THREADS - 1)
+            || !TEST_true(CRYPTO_atomic_load_int(&shard_mt_failures, &failures,
+                                                 shard_mt_lock))
+            || !TEST_int_eq(failures, 0))
+        goto end;
+    TEST_info("%s cache: %d resumptions on %d threads, %.0f per second",
+              idx == 1 ? "Sharded" : "Unsharded",
+              SHARD_MT_THREADS * SHARD_MT_RESUMPTIONS, SHARD_MT_THREADS,
+              us == 0 ? 0.0
+                      : SHARD_MT_THREADS * SHARD_MT_RESUMPTIONS * 1e6 / us);
+    testresult = 1;
+
+ end:
+    SSL_CTX_free(shard_mt_sctx);
+    SSL_CTX_free(shard_mt_cctx);
+    shard_mt_sctx = shard_mt_cctx = NULL;
+    CRYPTO_THREAD_lock_free(shard_mt_lock);
+    shard_mt_lock = NULL;
+    return testresult;
+}
+#endif
+
+#if defined(OPENSSL_SYS_UNIX) \
+    && (!defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2))
+/*
+ * Test that a session created through one SSL_CTX can be resumed through
+ * another one attached to the same shared session cache, as two server
+ * processes would.  The internal caches are disabled so that every lookup
+ * goes through the shared cache.
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3 with stateful tickets
+ */
+static int shm_app_new_cb_calls = 0;
+
+static int shm_app_new_cb(SSL *s, SSL_SESSION *sess)
+{
+    shm_app_new_cb_calls++;
+    return 0;
+}
+
+static int test_session_cache_shared(int idx)
+{
+    SSL_CTX *sctx = NULL, *sctx2 = NULL, *cctx = NULL;
+    SSL *serverssl = NULL, *clientssl = NULL;
+    SSL_SESSION *sess = NULL;
+    BIO *bio = NULL;
+    int testresult = 0;
+    int prot = idx == 0 ? TLS1_2_VERSION : TLS1_3_VERSION;
+
+# ifdef OPENSSL_NO_TLS1_2
+    if (idx == 0)
+        return TEST_skip("No TLSv1.2 available");
+# endif
+# ifdef OSSL_NO_USABLE_TLS1_3
+    if (idx == 1)
+        return TEST_skip("No TLSv1.3 available");
+# endif
+
+    /* Other tests write to the same file, start from an empty one */
+    if (!TEST_ptr(bio = BIO_new_file(tmpfilename, "wb")))
+        goto end;
+    BIO_free(bio);
+
+    shm_app_new_cb_calls = 0;
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(), prot, prot,
+                                       &sctx, &cctx, cert, privkey))
+            || !TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                              NULL, prot, prot,
+                                              &sctx2, NULL, cert, privkey)))
+        goto end;
+    SSL_CTX_sess_set_new_cb(sctx, shm_app_new_cb);
+    if (!TEST_true(SSL_CTX_set_shared_session_cache(sctx, tmpfilename,
+                                                    64 * 1024))
+            /* A cache in use is not resized under the other processes */
+            || !TEST_false(SSL_CTX_set_shared_session_cache(sctx2, tmpfilename,
+                                                            128 * 1024))
+            || !TEST_true(SSL_CTX_set_shared_session_cache(sctx2, tmpfilename,
+                                                           64 * 1024)))
+        goto end;
+    ERR_clear_error();
+
+    SSL_CTX_set_session_cache_mode(sctx, SSL_SESS_CACHE_SERVER
+                                         | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_set_session_cache_mode(sctx2, SSL_SESS_CACHE_SERVER
+                                          | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_set_options(sctx, SSL_OP_NO_TICKET);
+    SSL_CTX_set_options(sctx2, SSL_OP_NO_TICKET);
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                      NULL, NULL))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE))
+            || !TEST_ptr(sess = SSL_get1_session(clientssl))
+            /* The application's own callback is still called */
+            || !TEST_int_gt(shm_app_new_cb_calls, 0))
+        goto end;
+    shutdown_ssl_connection(serverssl, clientssl);
+    serverssl = clientssl = NULL;
+
+    /* Resume through the other SSL_CTX */
+    if (!TEST_true(create_ssl_objects(sctx2, cctx, &serverssl, &clientssl,
+                                      NULL, NULL))
+            || !TEST_true(SSL_set_session(clientssl, sess))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE))
+            || !TEST_true(SSL_session_reused(clientssl)))
+        goto end;
+    shutdown_ssl_connection(serverssl, clientssl);
+    serverssl = clientssl = NULL;
+
+    if (idx == 0) {
+        /* A removed session can no longer be resumed by anyone */
+        SSL_CTX_remove_session(sctx2, sess);
+        if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                          NULL, NULL))
+                || !TEST_true(SSL_set_session(clientssl, sess))
+                || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                    SSL_ERROR_NONE))
+                || !TEST_false(SSL_session_reused(clientssl)))
+            goto end;
+    }
+
+    /* Detaching the cache restores the callbacks it replaced */
+    if (!TEST_true(SSL_CTX_set_shared_session_cache(sctx2, NULL, 0))
+            || !TEST_true(SSL_CTX_sess_get_new_cb(sctx2) == NULL)
+            || !TEST_true(SSL_CTX_sess_get_get_cb(sctx2) == NULL)
+            || !TEST_true(SSL_CTX_set_shared_session_cache(sctx, NULL, 0))
+            || !TEST_true(SSL_CTX_sess_get_new_cb(sctx) == shm_app_new_cb))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_SESSION_free(sess);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(sctx2);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
+#if !defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2)
+/*
+ * Test session ticket key rotation: tickets made with an older key in the
+ * keyring are still accepted and renewed with the current key, and tickets
+ * made with a key that has been rotated out are not.
+ * Test 0: TLSv1.2
+ * Test 1: TLSv1.3
+ */
+static int test_ticket_key_rotation(int idx)
+{
+    SSL_CTX *sctx = NULL, *cctx = NULL;
+    SSL *serverssl = NULL, *clientssl = NULL;
+    SSL_SESSION *sess = NULL, *sess2 = NULL;
+    unsigned char keys[3 * 80], keys2[3 * 80];
+    const unsigned char *tick;
+    size_t ticklen;
+    int testresult = 0;
+    int prot = idx == 0 ? TLS1_2_VERSION : TLS1_3_VERSION;
+
+# ifdef OPENSSL_NO_TLS1_2
+    if (idx == 0)
+        return TEST_skip("No TLSv1.2 available");
+# endif
+# ifdef OSSL_NO_USABLE_TLS1_3
+    if (idx == 1)
+        return TEST_skip("No TLSv1.3 available");
+# endif
+
+    if (!TEST_true(create_ssl_ctx_pair(libctx, TLS_server_method(),
+                                       TLS_client_method(), prot, prot,
+                                       &sctx, &cctx, cert, privkey)))
+        goto end;
+    SSL_CTX_set_session_cache_mode(sctx, SSL_SESS_CACHE_OFF);
+
+    /* A single key, of the size reported for one key */
+    if (!TEST_long_eq(SSL_CTX_get_tlsext_ticket_keys(sctx, NULL, 0), 80)
+            || !TEST_long_eq(SSL_CTX_set_tlsext_ticket_keys(sctx, NULL, 0),
+                             80))
+        goto end;
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                      NULL, NULL))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE))
+            || !TEST_ptr(sess = SSL_get1_session(clientssl)))
+        goto end;
+    shutdown_ssl_connection(serverssl, clientssl);
+    serverssl = clientssl = NULL;
+
+    /* The old key stays usable after a rotation */
+    if (!TEST_true(SSL_CTX_rotate_ticket_keys(sctx, 2))
+            || !TEST_long_eq(SSL_CTX_get_tlsext_ticket_keys(sctx, NULL, 0),
+                             160)
+            || !TEST_true(SSL_CTX_get_tlsext_ticket_keys(sctx, keys, 160)))
+        goto end;
+
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                      NULL, NULL))
+            || !TEST_true(SSL_set_session(clientssl, sess))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE))
+            || !TEST_true(SSL_session_reused(clientssl))
+            || !TEST_ptr(sess2 = SSL_get1_session(clientssl)))
+        goto end;
+    shutdown_ssl_connection(serverssl, clientssl);
+    serverssl = clientssl = NULL;
+
+    /* The ticket was renewed with the new key */
+    SSL_SESSION_get0_ticket(sess2, &tick, &ticklen);
+    if (!TEST_size_t_gt(ticklen, 16)
+            || !TEST_mem_eq(tick, 16, keys, 16))
+        goto end;
+
+    /* The first key is gone after another rotation */
+    if (!TEST_true(SSL_CTX_rotate_ticket_keys(sctx, 2))
+            || !TEST_long_eq(SSL_CTX_get_tlsext_ticket_keys(sctx, NULL, 0),
+                             160))
+        goto end;
+    if (!TEST_true(create_ssl_objects(sctx, cctx, &serverssl, &clientssl,
+                                      NULL, NULL))
+            || !TEST_true(SSL_set_session(clientssl, sess))
+            || !TEST_true(create_ssl_connection(serverssl, clientssl,
+                                                SSL_ERROR_NONE))
+            || !TEST_false(SSL_session_reused(clientssl)))
+        goto end;
+    shutdown_ssl_connection(serverssl, clientssl);
+    serverssl = clientssl = NULL;
+
+    /* Several keys can be set at once and read back */
+    memset(keys, 0, sizeof(keys));
+    keys[0] = 1;
+    keys[80] = 2;
+    keys[160] = 3;
+    if (!TEST_false(SSL_CTX_set_tlsext_ticket_keys(sctx, keys, 81))
+            || !TEST_true(SSL_CTX_set_tlsext_ticket_keys(sctx, keys,
+                                                         sizeof(keys)))
+            || !TEST_false(SSL_CTX_get_tlsext_ticket_keys(sctx, keys2, 80))
+            || !TEST_true(SSL_CTX_get_tlsext_ticket_keys(sctx, keys2,
+                                                         sizeof(keys2)))
+            || !TEST_mem_eq(keys, sizeof(keys), keys2, sizeof(keys2)))
+        goto end;
+
+    testresult = 1;
+
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_SESSION_free(sess);
+    SSL_SESSION_free(sess2);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+#endif
+
 /*
  * Test 0: Client sets servername and server acknowledges it (TLSv1.2)
  * Test 1: Client sets servername and server does not acknowledge it (TLSv1.2)
@@ -13992,6 +14889,12 @@ int setup_tests(void)
     ADD_ALL_TESTS(test_info_callback, 6);
 #endif
     ADD_ALL_TESTS(test_ssl_pending, 2);
+    ADD_ALL_TESTS(test_read_borrow, 2);
+    ADD_TEST(test_writev);
+    ADD_ALL_TESTS(test_dynamic_record_sizing, 2);
+#ifdef OPENSSL_SYS_UNIX
+    ADD_TEST(test_sendfile_fallback);
+#endif
     ADD_ALL_TESTS(test_ssl_get_shared_ciphers, OSSL_NELEM(shared_ciphers_data));
     ADD_ALL_TESTS(test_ticket_callbacks, 20);
     ADD_ALL_TESTS(test_shutdown, 7);
@@ -14038,6 +14941,17 @@ int setup_tests(void)
     ADD_ALL_TESTS(test_session_timeout, 1);
 #if !defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2)
     ADD_ALL_TESTS(test_session_cache_overflow, 4);
+#endif
+    ADD_ALL_TESTS(test_session_cache_sharded, 2);
+#ifndef OPENSSL_NO_TLS1_2
+    ADD_ALL_TESTS(test_session_cache_sharded_mt, 2);
+#endif
+#if defined(OPENSSL_SYS_UNIX) \
+    && (!defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2))
+    ADD_ALL_TESTS(test_session_cache_shared, 2);
+#endif
+#if !defined(OSSL_NO_USABLE_TLS1_3) || !defined(OPENSSL_NO_TLS1_2)
+    ADD_ALL_TESTS(test_ticket_key_rotation, 2);
 #endif
     ADD_TEST(test_load_dhfile);
 #ifndef OSSL_NO_USABLE_TLS1_3
@@ -27,6 +27,7 @@
 #include <openssl/rand.h>
 #include <openssl/pem.h>
 #include <openssl/evp.h>
+#include <openssl/core_names.h>
 #include "internal/tsan_assist.h"
 #include "internal/nelem.h"
 #include "internal/time.h"
@@ -1080,6 +1081,78 @@ static int test_multi_shared_pkey_release(void)
     return testresult;
 }
 
+#ifndef OPENSSL_NO_EC
+static unsigned char shared_sig[256];
+static size_t shared_siglen;
+static const unsigned char shared_dgst[32] = { 1, 2, 3, 4 };
+
+/*
+ * Verify ECDSA signatures with a shared key, while requesting a new table of
+ * multiples of its public key from time to time.  The tables that are
+ * replaced must stay valid while other threads still use them.
+ */
+static void thread_shared_ec_verify(void)
+{
+    EVP_PKEY_CTX *ctx = NULL;
+    OSSL_PARAM params[2];
+    int precompute = 1, i;
+
+    params[0] = OSSL_PARAM_construct_int(OSSL_SIGNATURE_PARAM_KEY_PRECOMPUTE,
+                                         &precompute);
+    params[1] = OSSL_PARAM_construct_end();
+    for (i = 0; i < 64; i++) {
+        if (!TEST_ptr(ctx = EVP_PKEY_CTX_new_from_pkey(multi_libctx,
+                                                       shared_evp_pkey, NULL))
+                || !TEST_int_eq(EVP_PKEY_verify_init_ex(ctx, i % 8 == 0
+                                                             ? params : NULL),
+                                1)
+                || !TEST_int_eq(EVP_PKEY_verify(ctx, shared_sig, shared_siglen,
+                                                shared_dgst,
+                                                sizeof(shared_dgst)), 1)) {
+            multi_set_success(0);
+            break;
+        }
+        EVP_PKEY_CTX_free(ctx);
+        ctx = NULL;
+    }
+    EVP_PKEY_CTX_free(ctx);
+}
+
+static int test_multi_ec_pub_precomp(void)
+{
+    EVP_PKEY_CTX *ctx = NULL;
+    int testresult = 0;
+
+    multi_intialise();
+    shared_siglen = sizeof(shared_sig);
+    if (!thread_setup_libctx(1, default_provider)
+            || !TEST_ptr(shared_evp_pkey = EVP_PKEY_Q_keygen(multi_libctx,
+                                                             NULL, "EC",
+                                                             "brainpoolP256r1"))
+            || !TEST_ptr(ctx = EVP_PKEY_CTX_new_from_pkey(multi_libctx,
+                                                          shared_evp_pkey,
+                                                          NULL))
+            || !TEST_int_eq(EVP_PKEY_sign_init(ctx), 1)
+            || !TEST_int_eq(EVP_PKEY_sign(ctx, shared_sig, &shared_siglen,
+                                          shared_dgst, sizeof(shared_dgst)), 1)
+            || !start_threads(4, &thread_shared_ec_verify))
+        goto err;
+
+    thread_shared_ec_verify();
+
+    if (!teardown_threads()
+            || !TEST_true(multi_success))
+        goto err;
+    testresult = 1;
+ err:
+    EVP_PKEY_CTX_free(ctx);
+    EVP_PKEY_free(shared_evp_pkey);
+    shared_evp_pkey = NULL;
+    thead_teardown_libctx();
+    return testresult;
+}
+#endif
+
 static int test_multi_load_unload_provider(void)
 {
     EVP_MD *sha256 = NULL;
@@ -1373,6 +1446,9 @@ int setup_tests(void)
     ADD_TEST(test_multi_downgrade_shared_pkey);
 #endif
     ADD_TEST(test_multi_shared_pkey_release);
+#ifndef OPENSSL_NO_EC
+    ADD_TEST(test_multi_ec_pub_precomp);
+#endif
     ADD_TEST(test_multi_load_unload_provider);
     ADD_TEST(test_obj_add);
 #if !defined(OPENSSL_NO_DGRAM) && !defined(OPENSSL_NO_SOCK)
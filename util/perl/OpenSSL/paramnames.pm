@@ -495,6 +495,7 @@ my %params = (
     'SIGNATURE_PARAM_MU' =>                 "mu", # int
     'SIGNATURE_PARAM_TEST_ENTROPY' =>       "test-entropy",
     'SIGNATURE_PARAM_ADD_RANDOM' =>         "additional-random",
+    'SIGNATURE_PARAM_KEY_PRECOMPUTE' =>     "key-precompute", # int
 
 # Asym cipher parameters
     'ASYM_CIPHER_PARAM_DIGEST' =>                   '*PKEY_PARAM_DIGEST',
@@ -622,6 +623,9 @@ my %params = (
     'LIBSSL_RECORD_LAYER_PARAM_MAX_EARLY_DATA' => "max_early_data",
     'LIBSSL_RECORD_LAYER_PARAM_BLOCK_PADDING' =>  "block_padding",
     'LIBSSL_RECORD_LAYER_PARAM_HS_PADDING' =>     "hs_padding",
+    'LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_SIZE' => "dyn_record_size",
+    'LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_RAMP' => "dyn_record_ramp",
+    'LIBSSL_RECORD_LAYER_PARAM_DYN_RECORD_IDLE' => "dyn_record_idle",
 
 # Symmetric Key parametes
     'SKEY_PARAM_RAW_BYTES' => "raw-bytes",